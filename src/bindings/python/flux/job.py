@@ -576,6 +576,27 @@ class JobListRPC(RPC):
         return self.get()["jobs"]
 
 
+class JobListPagesRPC(JobListRPC):
+    """A streaming job-info.list RPC, which returns jobs in pages"""
+
+    def pages(self):
+        """Generator yielding each page of jobs as it is received"""
+        while True:
+            try:
+                jobs = self.get_jobs()
+            except OSError as exc:
+                if exc.errno == errno.ENODATA:
+                    return
+                raise
+            self.reset()
+            yield jobs
+
+    def jobs(self):
+        """Generator yielding individual jobs as their page is received"""
+        for page in self.pages():
+            yield from page
+
+
 # Due to subtleties in the python bindings and this call, this binding
 # is more of a reimplementation of flux_job_list() instead of calling
 # the flux_job_list() C function directly.  Some reasons:
@@ -597,6 +618,33 @@ def job_list(
     return JobListRPC(flux_handle, "job-info.list", payload)
 
 
+# pylint: disable=dangerous-default-value
+def job_list_pages(
+    flux_handle,
+    max_entries=1000,
+    attrs=[],
+    userid=os.getuid(),
+    states=0,
+    results=0,
+    page_size=0,
+):
+    """Like job_list(), but jobs are streamed back in pages of at most
+    page_size jobs (0 = module default), so that callers can process
+    jobs incrementally instead of waiting for one large response.
+    """
+    payload = {
+        "max_entries": int(max_entries),
+        "attrs": attrs,
+        "userid": int(userid),
+        "states": states,
+        "results": results,
+        "page_size": int(page_size),
+    }
+    return JobListPagesRPC(
+        flux_handle, "job-info.list", payload, flags=constants.FLUX_RPC_STREAMING
+    )
+
+
 def job_list_inactive(flux_handle, since=0.0, max_entries=1000, attrs=[], name=None):
     payload = {"since": float(since), "max_entries": int(max_entries), "attrs": attrs}
     if name:
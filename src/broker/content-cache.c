@@ -18,6 +18,7 @@
 #include <flux/core.h>
 #include "src/common/libutil/errno_safe.h"
 #include "src/common/libutil/blobref.h"
+#include "src/common/libutil/blobvec.h"
 #include "src/common/libutil/iterators.h"
 #include "src/common/libutil/log.h"
 
@@ -51,9 +52,31 @@ struct cache_entry {
     uint8_t store_pending:1;
     zlist_t *load_requests;
     zlist_t *store_requests;
+    zlist_t *load_batches;
+    zlist_t *store_batches;
     int lastused;
 };
 
+/* A content.load-batch or content.store-batch request.  Items are
+ * answered as their cache entries become ready, and the response is sent
+ * once all items have been answered.
+ */
+struct batch {
+    flux_t *h;
+    const flux_msg_t *msg;
+    const char *type;
+    struct blobvec *response;
+    int pending;
+    int errnum;
+};
+
+/* A batch item waiting on a cache entry.
+ */
+struct batch_wait {
+    struct batch *b;
+    uint32_t index;
+};
+
 struct content_cache {
     flux_t *h;
     flux_msg_handler_t **handlers;
@@ -151,6 +174,138 @@ static int request_list_add (zlist_t **l, const flux_msg_t *msg)
     return 0;
 }
 
+static void batch_destroy (struct batch *b)
+{
+    if (b) {
+        int saved_errno = errno;
+        flux_msg_decref (b->msg);
+        blobvec_destroy (b->response);
+        free (b);
+        errno = saved_errno;
+    }
+}
+
+/* Create a batch holding one reference, dropped with batch_decref()
+ * once the request has been fully parsed.
+ */
+static struct batch *batch_create (flux_t *h,
+                                   const flux_msg_t *msg,
+                                   const char *type)
+{
+    struct batch *b;
+
+    if (!(b = calloc (1, sizeof (*b)))) {
+        errno = ENOMEM;
+        return NULL;
+    }
+    if (!(b->response = blobvec_create ())) {
+        free (b);
+        return NULL;
+    }
+    b->h = h;
+    b->msg = flux_msg_incref (msg);
+    b->type = type;
+    b->pending = 1;
+    return b;
+}
+
+/* Drop a reference on the batch.  When the last reference is dropped,
+ * send the response and destroy the batch.
+ */
+static void batch_decref (struct batch *b)
+{
+    if (--b->pending > 0)
+        return;
+    if (b->errnum == 0) {
+        const void *data;
+        int len;
+
+        data = blobvec_data (b->response, &len);
+        if (flux_respond_raw (b->h, b->msg, data, len) < 0)
+            flux_log_error (b->h, "content %s: flux_respond_raw", b->type);
+    }
+    else {
+        if (flux_respond_error (b->h, b->msg, b->errnum, NULL) < 0)
+            flux_log_error (b->h, "content %s: flux_respond_error", b->type);
+    }
+    batch_destroy (b);
+}
+
+/* Answer item 'index' of a batch, dropping the reference it held.
+ */
+static void batch_item_respond (struct batch *b,
+                                uint32_t index,
+                                int errnum,
+                                const void *data,
+                                int len)
+{
+    if (blobvec_append (b->response, index, errnum, data, len) < 0) {
+        flux_log_error (b->h, "content %s", b->type);
+        b->errnum = errno;
+    }
+    batch_decref (b);
+}
+
+/* Add a batch item to a list, creating the list as needed.
+ * Returns 0 on success, -1 on failure with errno set.
+ */
+static int batch_list_add (zlist_t **l, struct batch *b, uint32_t index)
+{
+    struct batch_wait *bw;
+
+    if (!*l) {
+        if (!(*l = zlist_new ())) {
+            errno = ENOMEM;
+            return -1;
+        }
+    }
+    if (!(bw = calloc (1, sizeof (*bw)))) {
+        errno = ENOMEM;
+        return -1;
+    }
+    bw->b = b;
+    bw->index = index;
+    if (zlist_append (*l, bw) < 0) {
+        free (bw);
+        errno = ENOMEM;
+        return -1;
+    }
+    return 0;
+}
+
+/* Answer a list of batch items identically.
+ * The list is always run to completion, then destroyed.
+ */
+static void batch_list_respond (zlist_t **l,
+                                int errnum,
+                                const void *data,
+                                int len)
+{
+    if (*l) {
+        struct batch_wait *bw;
+        while ((bw = zlist_pop (*l))) {
+            batch_item_respond (bw->b, bw->index, errnum, data, len);
+            free (bw);
+        }
+        zlist_destroy (l);
+    }
+}
+
+/* Destroy a list of batch items without answering them.
+ */
+static void batch_list_destroy (zlist_t **l)
+{
+    if (*l) {
+        struct batch_wait *bw;
+        while ((bw = zlist_pop (*l))) {
+            if (--bw->b->pending == 0)
+                batch_destroy (bw->b);
+            free (bw);
+        }
+        zlist_destroy (l);
+    }
+}
+
 /* Destroy a cache entry
  */
 static void cache_entry_destroy (void *arg)
@@ -167,8 +322,16 @@ static void cache_entry_destroy (void *arg)
         if (e->store_requests && zlist_size (e->store_requests) > 0)
             flux_log (e->h, LOG_ERR, "%s: store_requests not empty",
                       __FUNCTION__);
+        if (e->load_batches && zlist_size (e->load_batches) > 0)
+            flux_log (e->h, LOG_ERR, "%s: load_batches not empty",
+                      __FUNCTION__);
+        if (e->store_batches && zlist_size (e->store_batches) > 0)
+            flux_log (e->h, LOG_ERR, "%s: store_batches not empty",
+                      __FUNCTION__);
         request_list_destroy (&e->load_requests);
         request_list_destroy (&e->store_requests);
+        batch_list_destroy (&e->load_batches);
+        batch_list_destroy (&e->store_batches);
         free (e);
     }
 }
@@ -253,6 +416,8 @@ static void remove_entry (content_cache_t *cache, struct cache_entry *e)
 {
     assert (!e->load_requests || zlist_size (e->load_requests) == 0);
     assert (!e->store_requests || zlist_size (e->store_requests) == 0);
+    assert (!e->load_batches || zlist_size (e->load_batches) == 0);
+    assert (!e->store_batches || zlist_size (e->store_batches) == 0);
     if (e->valid) {
         cache->acct_size -= e->len;
         cache->acct_valid--;
@@ -273,22 +438,20 @@ static void remove_entry (content_cache_t *cache, struct cache_entry *e)
  * an error such as ENOENT.
  */
 
-static void cache_load_continuation (flux_future_t *f, void *arg)
+/* Complete a load of entry 'e', responding to all its waiters.
+ * On error, the entry is removed.
+ */
+static void cache_load_result (content_cache_t *cache,
+                               struct cache_entry *e,
+                               int errnum,
+                               const void *data,
+                               int len)
 {
-    content_cache_t *cache = arg;
-    struct cache_entry *e = flux_future_aux_get (f, "entry");
-    const void *data = NULL;
-    int len = 0;
-
     e->load_pending = 0;
-    if (flux_content_load_get (f, &data, &len) < 0) {
-        if (errno == ENOSYS && cache->rank == 0)
-            errno = ENOENT;
-        if (errno != ENOENT)
-            flux_log_error (cache->h, "content load");
+    if (errnum != 0)
         goto error;
-    }
     if (cache_entry_fill (e, data, len) < 0) {
+        errnum = errno;
         flux_log_error (cache->h, "content load");
         goto error;
     }
@@ -303,15 +466,34 @@ static void cache_load_continuation (flux_future_t *f, void *arg)
                               e->data,
                               e->len,
                               "load");
-    flux_future_destroy (f);
+    batch_list_respond (&e->load_batches, 0, e->data, e->len);
     return;
 error:
     request_list_respond_error (&e->load_requests,
                                 cache->h,
-                                errno,
+                                errnum,
                                 NULL,
                                 "load");
+    batch_list_respond (&e->load_batches, errnum, NULL, 0);
     remove_entry (cache, e);
+}
+
+static void cache_load_continuation (flux_future_t *f, void *arg)
+{
+    content_cache_t *cache = arg;
+    struct cache_entry *e = flux_future_aux_get (f, "entry");
+    const void *data = NULL;
+    int len = 0;
+
+    if (flux_content_load_get (f, &data, &len) < 0) {
+        if (errno == ENOSYS && cache->rank == 0)
+            errno = ENOENT;
+        if (errno != ENOENT)
+            flux_log_error (cache->h, "content load");
+        cache_load_result (cache, e, errno, NULL, 0);
+    }
+    else
+        cache_load_result (cache, e, 0, data, len);
     flux_future_destroy (f);
 }
 
@@ -400,6 +582,165 @@ error:
         flux_log_error (h, "content load: flux_respond_error");
 }
 
+/* Batched load
+ *
+ * A content.load-batch request carries many blobrefs, and its response
+ * carries a blob or an errno for each.  Items are answered from cache
+ * where possible.  Invalid entries are loaded like single requests, except
+ * that on ranks > 0, the misses are sent upstream in one load-batch
+ * request rather than one request each.
+ */
+
+static void cache_load_batch_continuation (flux_future_t *f, void *arg)
+{
+    content_cache_t *cache = arg;
+    struct cache_entry **entries = flux_future_aux_get (f, "entries");
+    int count = (intptr_t)flux_future_aux_get (f, "count");
+    const void *data;
+    int len;
+    int i;
+
+    for (i = 0; i < count; i++) {
+        if (flux_content_load_batch_get (f, i, &data, &len) < 0) {
+            if (errno != ENOENT)
+                flux_log_error (cache->h, "content load-batch");
+            cache_load_result (cache, entries[i], errno, NULL, 0);
+        }
+        else
+            cache_load_result (cache, entries[i], 0, data, len);
+    }
+    flux_future_destroy (f);
+}
+
+/* Send one upstream load-batch request for a list of entries, which the
+ * caller has already marked load_pending.  On failure, the entries are
+ * completed with an error, and -1 is returned with errno set.
+ */
+static int cache_load_batch (content_cache_t *cache, zlist_t *l)
+{
+    int count = zlist_size (l);
+    struct cache_entry **entries = NULL;
+    const char **refs = NULL;
+    flux_future_t *f = NULL;
+    struct cache_entry *e;
+    int i;
+
+    if (!(entries = calloc (count, sizeof (entries[0])))
+        || !(refs = calloc (count, sizeof (refs[0])))) {
+        errno = ENOMEM;
+        goto error;
+    }
+    i = 0;
+    FOREACH_ZLIST (l, e) {
+        entries[i] = e;
+        refs[i] = e->blobref;
+        i++;
+    }
+    if (!(f = flux_content_load_batch (cache->h,
+                                       refs,
+                                       count,
+                                       CONTENT_FLAG_UPSTREAM))
+        || flux_future_aux_set (f, "count", (void *)(intptr_t)count, NULL) < 0
+        || flux_future_aux_set (f, "entries", entries, free) < 0)
+        goto error;
+    entries = NULL; // owned by 'f' now
+    if (flux_future_then (f, -1., cache_load_batch_continuation, cache) < 0)
+        goto error;
+    free (refs);
+    return 0;
+error:
+    flux_log_error (cache->h, "content load-batch");
+    i = errno;
+    while ((e = zlist_pop (l)))
+        cache_load_result (cache, e, i, NULL, 0);
+    flux_future_destroy (f);
+    free (entries);
+    free (refs);
+    errno = i;
+    return -1;
+}
+
+static void content_load_batch_request (flux_t *h,
+                                        flux_msg_handler_t *mh,
+                                        const flux_msg_t *msg,
+                                        void *arg)
+{
+    content_cache_t *cache = arg;
+    const void *payload;
+    int payload_len;
+    struct batch *b = NULL;
+    zlist_t *upstream = NULL;
+    int cursor = 0;
+    uint32_t index;
+    const void *data;
+    int len;
+    int rc;
+    struct cache_entry *e;
+
+    if (flux_request_decode_raw (msg, NULL, &payload, &payload_len) < 0)
+        goto error;
+    if (!(b = batch_create (h, msg, "load-batch"))
+        || !(upstream = zlist_new ())) {
+        errno = ENOMEM;
+        goto error;
+    }
+    while ((rc = blobvec_decode (payload, payload_len, &cursor,
+                                 &index, NULL, &data, &len)) > 0) {
+        const char *blobref = data;
+
+        b->pending++;
+        if (!blobref || blobref[len - 1] != '\0') {
+            batch_item_respond (b, index, EPROTO, NULL, 0);
+            continue;
+        }
+        if (!(e = lookup_entry (cache, blobref))) {
+            if (cache->rank == 0 && !cache->backing) {
+                batch_item_respond (b, index, ENOENT, NULL, 0);
+                continue;
+            }
+            if (!(e = cache_entry_create (h, blobref))
+                                            || insert_entry (cache, e) < 0) {
+                flux_log_error (h, "content load-batch");
+                batch_item_respond (b, index, errno, NULL, 0);
+                continue; /* insert destroys 'e' on failure */
+            }
+        }
+        if (!e->valid) {
+            if (batch_list_add (&e->load_batches, b, index) < 0) {
+                flux_log_error (h, "content load-batch");
+                batch_item_respond (b, index, errno, NULL, 0);
+                continue;
+            }
+            if (e->load_pending)
+                continue;
+            if (cache->rank > 0) {
+                if (zlist_append (upstream, e) < 0) {
+                    cache_load_result (cache, e, ENOMEM, NULL, 0);
+                    continue;
+                }
+                e->load_pending = 1;
+            }
+            else if (cache_load (cache, e) < 0)
+                cache_load_result (cache, e, errno, NULL, 0);
+            continue;
+        }
+        e->lastused = cache->epoch;
+        batch_item_respond (b, index, 0, e->data, e->len);
+    }
+    if (rc < 0)
+        b->errnum = errno;
+    if (zlist_size (upstream) > 0)
+        (void)cache_load_batch (cache, upstream);
+    zlist_destroy (&upstream);
+    batch_decref (b);
+    return;
+error:
+    if (flux_respond_error (h, msg, errno, NULL) < 0)
+        flux_log_error (h, "content load-batch: flux_respond_error");
+    batch_destroy (b);
+    zlist_destroy (&upstream);
+}
+
 /* Store operation
  *
  * If a cache entry is already valid and not dirty, response is immediate.
@@ -435,26 +776,29 @@ static void cache_resume_flush (content_cache_t *cache)
         (void)cache_flush (cache); /* resume flushing */
 }
 
-static void cache_store_continuation (flux_future_t *f, void *arg)
+/* Complete a store of entry 'e', responding to all its waiters.
+ * The caller should call cache_resume_flush() afterwards.
+ */
+static void cache_store_result (content_cache_t *cache,
+                                struct cache_entry *e,
+                                int errnum,
+                                const char *blobref)
 {
-    content_cache_t *cache = arg;
-    struct cache_entry *e = flux_future_aux_get (f, "entry");
-    const char *blobref;
-
     e->store_pending = 0;
     assert (cache->flush_batch_count > 0);
     cache->flush_batch_count--;
-    if (flux_content_store_get (f, &blobref) < 0) {
-        if (cache->rank == 0 && errno == ENOSYS)
+    if (errnum != 0) {
+        if (cache->rank == 0 && errnum == ENOSYS)
             flux_log (cache->h, LOG_DEBUG, "content store: %s",
                       "backing store service unavailable");
         else
-            flux_log_error (cache->h, "content store");
+            flux_log (cache->h, LOG_ERR, "content store: %s",
+                      flux_strerror (errnum));
         goto error;
     }
     if (strcmp (blobref, e->blobref)) {
         flux_log (cache->h, LOG_ERR, "content store: wrong blobref");
-        errno = EIO;
+        errnum = EIO;
         goto error;
     }
     if (e->dirty) {
@@ -466,15 +810,30 @@ static void cache_store_continuation (flux_future_t *f, void *arg)
                               e->blobref,
                               strlen (e->blobref) + 1,
                               "store");
-    flux_future_destroy (f);
-    cache_resume_flush (cache);
+    batch_list_respond (&e->store_batches,
+                        0,
+                        e->blobref,
+                        strlen (e->blobref) + 1);
     return;
 error:
     request_list_respond_error (&e->store_requests,
                                 cache->h,
-                                errno,
+                                errnum,
                                 NULL,
                                 "store");
+    batch_list_respond (&e->store_batches, errnum, NULL, 0);
+}
+
+static void cache_store_continuation (flux_future_t *f, void *arg)
+{
+    content_cache_t *cache = arg;
+    struct cache_entry *e = flux_future_aux_get (f, "entry");
+    const char *blobref;
+
+    if (flux_content_store_get (f, &blobref) < 0)
+        cache_store_result (cache, e, errno, NULL);
+    else
+        cache_store_result (cache, e, 0, blobref);
     flux_future_destroy (f);
     cache_resume_flush (cache);
 }
@@ -519,34 +878,34 @@ done:
     return rc;
 }
 
-static void content_store_request (flux_t *h, flux_msg_handler_t *mh,
-                                   const flux_msg_t *msg, void *arg)
+/* Hash a blob and make its cache entry valid, dirtying it if it
+ * was not already valid.
+ * Returns entry on success, NULL on failure with errno set.
+ */
+static struct cache_entry *cache_store_entry (content_cache_t *cache,
+                                              const void *data,
+                                              int len)
 {
-    content_cache_t *cache = arg;
-    const void *data;
-    int len;
     struct cache_entry *e = NULL;
     char blobref[BLOBREF_MAX_STRING_SIZE];
 
-    if (flux_request_decode_raw (msg, NULL, &data, &len) < 0)
-        goto error;
     if (len > cache->blob_size_limit) {
         errno = EFBIG;
-        goto error;
+        return NULL;
     }
     if (blobref_hash (cache->hash_name, (uint8_t *)data, len, blobref,
                       sizeof (blobref)) < 0)
-        goto error;
+        return NULL;
 
     if (!(e = lookup_entry (cache, blobref))) {
-        if (!(e = cache_entry_create (h, blobref)))
-            goto error;
+        if (!(e = cache_entry_create (cache->h, blobref)))
+            return NULL;
         if (insert_entry (cache, e) < 0)
-            goto error; /* insert destroys 'e' on failure */
+            return NULL; /* insert destroys 'e' on failure */
     }
     if (!e->valid) {
         if (cache_entry_fill (e, data, len) < 0)
-            goto error;
+            return NULL;
         if (!e->valid) {
             e->valid = 1;
             cache->acct_valid++;
@@ -557,23 +916,13 @@ static void content_store_request (flux_t *h, flux_msg_handler_t *mh,
                                   e->data,
                                   e->len,
                                   "load");
+        batch_list_respond (&e->load_batches, 0, e->data, e->len);
         if (!e->dirty) {
             e->dirty = 1;
             cache->acct_dirty++;
         }
     }
-    e->lastused = cache->epoch;
-    if (e->dirty) {
-        if (cache->rank > 0 || cache->backing) {
-            if (cache_store (cache, e) < 0)
-                goto error;
-            if (cache->rank > 0) {  /* write-through */
-                if (request_list_add (&e->store_requests, msg) < 0)
-                    goto error;
-                return;
-            }
-        }
-    } else {
+    else if (!e->dirty) {
         /* When a backing store module is unloaded, it will clear
          * cache->backing then attempt to store all its blobs.  Any of
          * those still in cache need to be marked dirty.
@@ -583,7 +932,32 @@ static void content_store_request (flux_t *h, flux_msg_handler_t *mh,
             cache->acct_dirty++;
         }
     }
-    if (flux_respond_raw (h, msg, blobref, strlen (blobref) + 1) < 0)
+    e->lastused = cache->epoch;
+    return e;
+}
+
+static void content_store_request (flux_t *h, flux_msg_handler_t *mh,
+                                   const flux_msg_t *msg, void *arg)
+{
+    content_cache_t *cache = arg;
+    const void *data;
+    int len;
+    struct cache_entry *e;
+
+    if (flux_request_decode_raw (msg, NULL, &data, &len) < 0)
+        goto error;
+    if (!(e = cache_store_entry (cache, data, len)))
+        goto error;
+    if (e->dirty && (cache->rank > 0 || cache->backing)) {
+        if (cache_store (cache, e) < 0)
+            goto error;
+        if (cache->rank > 0) {  /* write-through */
+            if (request_list_add (&e->store_requests, msg) < 0)
+                goto error;
+            return;
+        }
+    }
+    if (flux_respond_raw (h, msg, e->blobref, strlen (e->blobref) + 1) < 0)
         flux_log_error (h, "content store: flux_respond_raw");
     return;
 error:
@@ -591,6 +965,156 @@ error:
         flux_log_error (h, "content store: flux_respond_error");
 }
 
+/* Batched store
+ *
+ * A content.store-batch request carries many blobs, and its response
+ * carries a blobref or an errno for each.  Entries are made valid and
+ * dirty as for single requests.  On ranks > 0 the dirty entries are
+ * written through in one upstream store-batch request, and items are
+ * answered when that completes.
+ */
+
+static void cache_store_batch_continuation (flux_future_t *f, void *arg)
+{
+    content_cache_t *cache = arg;
+    struct cache_entry **entries = flux_future_aux_get (f, "entries");
+    int count = (intptr_t)flux_future_aux_get (f, "count");
+    const char *blobref;
+    int i;
+
+    for (i = 0; i < count; i++) {
+        if (flux_content_store_batch_get (f, i, &blobref) < 0)
+            cache_store_result (cache, entries[i], errno, NULL);
+        else
+            cache_store_result (cache, entries[i], 0, blobref);
+    }
+    flux_future_destroy (f);
+    cache_resume_flush (cache);
+}
+
+/* Send one upstream store-batch request for a list of entries, which the
+ * caller has already marked store_pending and counted in
+ * flush_batch_count.  On failure, the entries are completed with an error,
+ * and -1 is returned with errno set.
+ */
+static int cache_store_batch (content_cache_t *cache, zlist_t *l)
+{
+    int count = zlist_size (l);
+    struct cache_entry **entries = NULL;
+    const void **bufs = NULL;
+    int *lens = NULL;
+    flux_future_t *f = NULL;
+    struct cache_entry *e;
+    int i;
+
+    if (!(entries = calloc (count, sizeof (entries[0])))
+        || !(bufs = calloc (count, sizeof (bufs[0])))
+        || !(lens = calloc (count, sizeof (lens[0])))) {
+        errno = ENOMEM;
+        goto error;
+    }
+    i = 0;
+    FOREACH_ZLIST (l, e) {
+        entries[i] = e;
+        bufs[i] = e->data;
+        lens[i] = e->len;
+        i++;
+    }
+    if (!(f = flux_content_store_batch (cache->h,
+                                        bufs,
+                                        lens,
+                                        count,
+                                        CONTENT_FLAG_UPSTREAM))
+        || flux_future_aux_set (f, "count", (void *)(intptr_t)count, NULL) < 0
+        || flux_future_aux_set (f, "entries", entries, free) < 0)
+        goto error;
+    entries = NULL; // owned by 'f' now
+    if (flux_future_then (f, -1., cache_store_batch_continuation, cache) < 0)
+        goto error;
+    free (bufs);
+    free (lens);
+    return 0;
+error:
+    flux_log_error (cache->h, "content store-batch");
+    i = errno;
+    while ((e = zlist_pop (l)))
+        cache_store_result (cache, e, i, NULL);
+    flux_future_destroy (f);
+    free (entries);
+    free (bufs);
+    free (lens);
+    errno = i;
+    return -1;
+}
+
+static void content_store_batch_request (flux_t *h,
+                                         flux_msg_handler_t *mh,
+                                         const flux_msg_t *msg,
+                                         void *arg)
+{
+    content_cache_t *cache = arg;
+    const void *payload;
+    int payload_len;
+    struct batch *b = NULL;
+    zlist_t *upstream = NULL;
+    int cursor = 0;
+    uint32_t index;
+    const void *data;
+    int len;
+    int rc;
+    struct cache_entry *e;
+
+    if (flux_request_decode_raw (msg, NULL, &payload, &payload_len) < 0)
+        goto error;
+    if (!(b = batch_create (h, msg, "store-batch"))
+        || !(upstream = zlist_new ())) {
+        errno = ENOMEM;
+        goto error;
+    }
+    while ((rc = blobvec_decode (payload, payload_len, &cursor,
+                                 &index, NULL, &data, &len)) > 0) {
+        b->pending++;
+        if (!(e = cache_store_entry (cache, data, len))) {
+            batch_item_respond (b, index, errno, NULL, 0);
+            continue;
+        }
+        if (e->dirty && cache->rank > 0) {  /* write-through */
+            if (batch_list_add (&e->store_batches, b, index) < 0) {
+                batch_item_respond (b, index, errno, NULL, 0);
+                continue;
+            }
+            if (e->store_pending)
+                continue;
+            if (zlist_append (upstream, e) < 0) {
+                batch_list_respond (&e->store_batches, ENOMEM, NULL, 0);
+                continue;
+            }
+            e->store_pending = 1;
+            cache->flush_batch_count++;
+            continue;
+        }
+        if (e->dirty && cache->backing) {
+            if (cache_store (cache, e) < 0) {
+                batch_item_respond (b, index, errno, NULL, 0);
+                continue;
+            }
+        }
+        batch_item_respond (b, index, 0, e->blobref, strlen (e->blobref) + 1);
+    }
+    if (rc < 0)
+        b->errnum = errno;
+    if (zlist_size (upstream) > 0)
+        (void)cache_store_batch (cache, upstream);
+    zlist_destroy (&upstream);
+    batch_decref (b);
+    return;
+error:
+    if (flux_respond_error (h, msg, errno, NULL) < 0)
+        flux_log_error (h, "content store-batch: flux_respond_error");
+    batch_destroy (b);
+    zlist_destroy (&upstream);
+}
+
 /* Backing store is enabled/disabled by modules that provide the
  * 'content.backing' service.  At module load time, the backing module
  * informs the content service of its availability, and entries are
@@ -611,16 +1135,47 @@ static int cache_flush (content_cache_t *cache)
         return 0;
 
     flux_log (cache->h, LOG_DEBUG, "content flush begin");
-    FOREACH_ZHASH (cache->entries, key, e) {
-        if (!e->dirty || e->store_pending)
-            continue;
-        if (cache_store (cache, e) < 0) {
+    if (cache->rank > 0) {
+        zlist_t *upstream;
+
+        /* Write through in one store-batch request.
+         */
+        if (!(upstream = zlist_new ())) {
+            errno = ENOMEM;
+            return -1;
+        }
+        FOREACH_ZHASH (cache->entries, key, e) {
+            if (!e->dirty || e->store_pending)
+                continue;
+            if (zlist_append (upstream, e) < 0) {
+                saved_errno = ENOMEM;
+                rc = -1;
+                break;
+            }
+            e->store_pending = 1;
+            cache->flush_batch_count++;
+            count++;
+            if (cache->flush_batch_count >= cache->flush_batch_limit)
+                break;
+        }
+        if (count > 0 && cache_store_batch (cache, upstream) < 0) {
             saved_errno = errno;
             rc = -1;
         }
-        count++;
-        if (cache->flush_batch_count >= cache->flush_batch_limit)
-            break;
+        zlist_destroy (&upstream);
+    }
+    else {
+        FOREACH_ZHASH (cache->entries, key, e) {
+            if (!e->dirty || e->store_pending)
+                continue;
+            if (cache_store (cache, e) < 0) {
+                saved_errno = errno;
+                rc = -1;
+            }
+            count++;
+            if (cache->flush_batch_count >= cache->flush_batch_limit)
+                break;
+        }
     }
     flux_log (cache->h, LOG_DEBUG, "content flush +%d (dirty=%d pending=%d)",
               count, cache->acct_dirty, cache->flush_batch_count);
@@ -897,6 +1452,18 @@ static const struct flux_msg_handler_spec htab[] = {
         content_store_request,
         FLUX_ROLE_USER
     },
+    {
+        FLUX_MSGTYPE_REQUEST,
+        "content.load-batch",
+        content_load_batch_request,
+        FLUX_ROLE_USER
+    },
+    {
+        FLUX_MSGTYPE_REQUEST,
+        "content.store-batch",
+        content_store_batch_request,
+        FLUX_ROLE_USER
+    },
     {
         FLUX_MSGTYPE_REQUEST,
         "content.unregister-backing",
@@ -294,7 +294,6 @@ static void r_reduce (flux_reduce_t *r, int batch, void *arg)
 {
     struct idset *new = NULL;
     struct idset *item;
-    unsigned int rank;
 
     assert (batch == 0);
 
@@ -302,12 +301,8 @@ static void r_reduce (flux_reduce_t *r, int batch, void *arg)
         if (!new)
             new = item;
         else {
-            rank = idset_first (item);
-            while (rank != IDSET_INVALID_ID) {
-                if (idset_set (new, rank) < 0)
-                    log_err_exit ("hello: idset_set");
-                rank = idset_next (item, rank);
-            }
+            if (idset_add (new, item) < 0)
+                log_err_exit ("hello: idset_add");
             idset_destroy (item);
         }
     }
@@ -329,7 +324,6 @@ static void r_sink (flux_reduce_t *r, int batch, void *arg)
 {
     struct hello *hello = arg;
     struct idset *item = flux_reduce_pop (r);
-    unsigned int rank;
 
     assert (batch == 0);
     assert (item != NULL);
@@ -337,12 +331,8 @@ static void r_sink (flux_reduce_t *r, int batch, void *arg)
     if (!hello->idset)
         hello->idset = item;
     else {
-        rank = idset_first (item);
-        while (rank != IDSET_INVALID_ID) {
-            if (idset_set (hello->idset, rank) < 0)
-                log_err_exit ("hello: idset_set");
-            rank = idset_next (item, rank);
-        }
+        if (idset_add (hello->idset, item) < 0)
+            log_err_exit ("hello: idset_add");
         idset_destroy (item);
     }
     if (hello->cb)
@@ -8,6 +8,8 @@
  * SPDX-License-Identifier: LGPL-3.0
 \************************************************************/
 
+#include <string.h>
+#include <jansson.h>
 #include "builtin.h"
 
 static int internal_config_reload (optparse_t *p, int ac, char *av[])
@@ -30,6 +32,80 @@ static int internal_config_reload (optparse_t *p, int ac, char *av[])
     return (0);
 }
 
+/* Look up dotted 'name' in the config object, e.g. "exec.launch".
+ */
+static json_t *config_lookup (json_t *obj, const char *name)
+{
+    char *cpy;
+    char *key;
+    char *saveptr = NULL;
+    char *s;
+
+    if (!(cpy = strdup (name)))
+        log_msg_exit ("out of memory");
+    s = cpy;
+    while (obj && (key = strtok_r (s, ".", &saveptr))) {
+        obj = json_object_get (obj, key);
+        s = NULL;
+    }
+    free (cpy);
+    return obj;
+}
+
+/* Print the value of a config key, read from the instance's config.path.
+ * Strings are printed without quotes, other values as JSON.
+ */
+static int internal_config_get (optparse_t *p, int ac, char *av[])
+{
+    int n = optparse_option_index (p);
+    flux_t *h;
+    const char *path;
+    flux_conf_t *conf = NULL;
+    flux_conf_error_t error;
+    json_t *obj = NULL;
+    json_t *val = NULL;
+    const char *dflt;
+
+    if (n != ac - 1) {
+        optparse_print_usage (p);
+        exit (1);
+    }
+    if (!(h = builtin_get_flux_handle (p)))
+        log_err_exit ("flux_open");
+    if ((path = flux_attr_get (h, "config.path"))) {
+        if (!(conf = flux_conf_parse (path, &error)))
+            log_msg_exit ("%s: %s", path, error.errbuf);
+        if (flux_conf_unpack (conf, &error, "o", &obj) < 0)
+            log_msg_exit ("%s", error.errbuf);
+        val = config_lookup (obj, av[n]);
+    }
+    if (val) {
+        if (json_is_string (val))
+            printf ("%s\n", json_string_value (val));
+        else {
+            char *s;
+            if (!(s = json_dumps (val, JSON_ENCODE_ANY | JSON_COMPACT)))
+                log_msg_exit ("error encoding %s", av[n]);
+            printf ("%s\n", s);
+            free (s);
+        }
+    }
+    else if ((dflt = optparse_get_str (p, "default", NULL)))
+        printf ("%s\n", dflt);
+    else
+        log_msg_exit ("%s is not set", av[n]);
+    flux_conf_decref (conf);
+    flux_close (h);
+    return (0);
+}
+
+static struct optparse_option get_opts[] = {
+    { .name = "default", .key = 'd', .has_arg = 1, .arginfo = "VALUE",
+      .usage = "Print VALUE if the key is not set",
+    },
+    OPTPARSE_TABLE_END
+};
+
 int cmd_config (optparse_t *p, int ac, char *av[])
 {
     log_init ("flux-config");
@@ -47,6 +123,13 @@ static struct optparse_subcommand config_subcmds[] = {
       0,
       NULL,
     },
+    { "get",
+      "[OPTIONS] NAME",
+      "Print the value of a config key, e.g. exec.launch",
+      internal_config_get,
+      0,
+      get_opts,
+    },
     OPTPARSE_SUBCMD_END
 };
 
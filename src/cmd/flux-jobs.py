@@ -308,15 +308,18 @@ def fetch_jobs_ids(flux_handle, args, attrs):
 
 
 def fetch_jobs_all(flux_handle, args, attrs, userid, states, results):
-    rpc_handle = flux.job.job_list(
+    """
+    Generator yielding jobs as each page of the streaming job-info.list
+    response arrives, so output can begin before all jobs are received.
+    """
+    rpc_handle = flux.job.job_list_pages(
         flux_handle, args.count, list(attrs), userid, states, results
     )
     try:
-        jobs = rpc_handle.get_jobs()
+        yield from rpc_handle.jobs()
     except EnvironmentError as err:
         print("{}: {}".format("rpc", err.strerror), file=sys.stderr)
         sys.exit(1)
-    return jobs
 
 
 def calc_filters(args):
@@ -433,13 +436,13 @@ def fetch_jobs_flux(args, fields):
 def fetch_jobs(args, fields):
     """
     Fetch jobs from flux or optionally stdin.
-    Returns a list of JobInfo objects
+    Returns an iterator of JobInfo objects
     """
     if args.from_stdin:
         lst = fetch_jobs_stdin()
     else:
         lst = fetch_jobs_flux(args, fields)
-    return [JobInfo(job) for job in lst]
+    return (JobInfo(job) for job in lst)
 
 
 class FilterAction(argparse.Action):
@@ -440,6 +440,7 @@ int cmd_namespace_create (optparse_t *p, int argc, char **argv)
     flux_future_t *f;
     int optindex, i;
     uint32_t owner = FLUX_USERID_UNKNOWN;
+    uint32_t rank = 0;
     const char *str;
 
     optindex = optparse_option_index (p);
@@ -455,10 +456,18 @@ int cmd_namespace_create (optparse_t *p, int argc, char **argv)
             log_msg_exit ("--owner requires an unsigned integer argument");
     }
 
+    if ((str = optparse_get_str (p, "rank", NULL))) {
+        char *endptr;
+        rank = strtoul (str, &endptr, 10);
+        if (*endptr != '\0')
+            log_msg_exit ("--rank requires an unsigned integer argument");
+    }
+
     for (i = optindex; i < argc; i++) {
         const char *name = argv[i];
         int flags = 0;
-        if (!(f = flux_kvs_namespace_create (h, name, owner, flags))
+        if (!(f = flux_kvs_namespace_create_rank (h, name, owner, rank,
+                                                  flags))
             || flux_future_get (f, NULL) < 0)
             log_err_exit ("%s", name);
         flux_future_destroy (f);
@@ -536,6 +545,9 @@ static struct optparse_option namespace_create_opts[] =  {
     { .name = "owner", .key = 'o', .has_arg = 1,
       .usage = "Specify alternate namespace owner via userid",
     },
+    { .name = "rank", .key = 'r', .has_arg = 1,
+      .usage = "Apply commits to the namespace on broker rank",
+    },
     OPTPARSE_TABLE_END
 };
 
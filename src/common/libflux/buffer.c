@@ -11,19 +11,21 @@
 #if HAVE_CONFIG_H
 #include "config.h"
 #endif
+#include <sys/uio.h>
 #include <assert.h>
 #include <errno.h>
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 #include <stdbool.h>
 #include <stdarg.h>
+#include <unistd.h>
 
 #include "buffer.h"
 #include "buffer_private.h"
 
-#include "src/common/liblsd/cbuf.h"
-
 #define FLUX_BUFFER_MIN   4096
+#define FLUX_BUFFER_CHUNK 1000
 #define FLUX_BUFFER_MAGIC 0xeb4feb4f
 
 enum {
@@ -33,11 +35,18 @@ enum {
     FLUX_BUFFER_CB_TYPE_WRITE,
 };
 
+/* Data is stored in a ring that starts out small and doubles on demand,
+ * up to the user specified size.  A buffer is only ever accessed from
+ * one reactor thread, so no locking is performed.
+ */
 struct flux_buffer {
     int magic;
     int size;
     bool readonly;
-    cbuf_t cbuf;
+    char *data;                 /* ring storage */
+    int cap;                    /* allocated size of ring */
+    int start;                  /* offset of first byte in ring */
+    int used;                   /* bytes stored in ring */
     char *buf;                  /* internal buffer for user reads */
     int buflen;
     int cb_type;
@@ -46,6 +55,183 @@ struct flux_buffer {
     void *cb_arg;
 };
 
+/* Fill [iov] with up to two segments covering [len] stored bytes,
+ * starting [off] bytes into the stored data.  Returns segment count.
+ */
+static int ring_data_iov (flux_buffer_t *fb,
+                          int off,
+                          int len,
+                          struct iovec iov[2])
+{
+    int pos;
+    int n;
+
+    if (len <= 0)
+        return 0;
+    assert (off + len <= fb->used);
+    pos = (fb->start + off) % fb->cap;
+    n = fb->cap - pos < len ? fb->cap - pos : len;
+    iov[0].iov_base = fb->data + pos;
+    iov[0].iov_len = n;
+    if (n == len)
+        return 1;
+    iov[1].iov_base = fb->data;
+    iov[1].iov_len = len - n;
+    return 2;
+}
+
+/* Fill [iov] with up to two segments covering up to [len] bytes of
+ * unused ring space.  Returns segment count.
+ */
+static int ring_space_iov (flux_buffer_t *fb, int len, struct iovec iov[2])
+{
+    int space = fb->cap - fb->used;
+    int pos;
+    int n;
+
+    if (len > space)
+        len = space;
+    if (len <= 0)
+        return 0;
+    pos = (fb->start + fb->used) % fb->cap;
+    n = fb->cap - pos < len ? fb->cap - pos : len;
+    iov[0].iov_base = fb->data + pos;
+    iov[0].iov_len = n;
+    if (n == len)
+        return 1;
+    iov[1].iov_base = fb->data;
+    iov[1].iov_len = len - n;
+    return 2;
+}
+
+/* Grow the ring so that at least [len] bytes of space are available,
+ * without exceeding the buffer size.  Data is moved to the start of
+ * the new ring.
+ */
+static int ring_reserve (flux_buffer_t *fb, int len)
+{
+    struct iovec iov[2];
+    int newcap = fb->cap;
+    char *newdata;
+    int i, n, off = 0;
+
+    if (len > fb->size - fb->used)
+        len = fb->size - fb->used;
+    if (fb->cap - fb->used >= len)
+        return 0;
+    while (newcap - fb->used < len) {
+        if (newcap > fb->size / 2) {
+            newcap = fb->size;
+            break;
+        }
+        newcap *= 2;
+    }
+    if (!(newdata = malloc (newcap))) {
+        errno = ENOMEM;
+        return -1;
+    }
+    n = ring_data_iov (fb, 0, fb->used, iov);
+    for (i = 0; i < n; i++) {
+        memcpy (newdata + off, iov[i].iov_base, iov[i].iov_len);
+        off += iov[i].iov_len;
+    }
+    free (fb->data);
+    fb->data = newdata;
+    fb->cap = newcap;
+    fb->start = 0;
+    return 0;
+}
+
+static void ring_copyout (flux_buffer_t *fb, char *dst, int len)
+{
+    struct iovec iov[2];
+    int i, n;
+
+    n = ring_data_iov (fb, 0, len, iov);
+    for (i = 0; i < n; i++) {
+        memcpy (dst, iov[i].iov_base, iov[i].iov_len);
+        dst += iov[i].iov_len;
+    }
+}
+
+static void ring_copyin (flux_buffer_t *fb, const char *src, int len)
+{
+    struct iovec iov[2];
+    int i, n;
+
+    n = ring_space_iov (fb, len, iov);
+    for (i = 0; i < n; i++) {
+        memcpy (iov[i].iov_base, src, iov[i].iov_len);
+        src += iov[i].iov_len;
+    }
+    fb->used += len;
+}
+
+static void ring_drop (flux_buffer_t *fb, int len)
+{
+    assert (len <= fb->used);
+    fb->used -= len;
+    /* keep data contiguous when possible */
+    if (fb->used == 0)
+        fb->start = 0;
+    else
+        fb->start = (fb->start + len) % fb->cap;
+}
+
+/* Return the length of the first line, including its newline, or 0
+ * if no complete line is stored.
+ */
+static int ring_find_line (flux_buffer_t *fb)
+{
+    struct iovec iov[2];
+    int i, n, off = 0;
+
+    n = ring_data_iov (fb, 0, fb->used, iov);
+    for (i = 0; i < n; i++) {
+        char *nl = memchr (iov[i].iov_base, '\n', iov[i].iov_len);
+        if (nl)
+            return off + (nl - (char *)iov[i].iov_base) + 1;
+        off += iov[i].iov_len;
+    }
+    return 0;
+}
+
+static int ring_count_lines (flux_buffer_t *fb)
+{
+    struct iovec iov[2];
+    int i, n, count = 0;
+
+    n = ring_data_iov (fb, 0, fb->used, iov);
+    for (i = 0; i < n; i++) {
+        char *p = iov[i].iov_base;
+        char *end = p + iov[i].iov_len;
+        while (p < end && (p = memchr (p, '\n', end - p))) {
+            count++;
+            p++;
+        }
+    }
+    return count;
+}
+
+/* Write stored data to [fd] with at most one writev(2) call.
+ */
+static int ring_to_fd (flux_buffer_t *fb, int fd, int len)
+{
+    struct iovec iov[2];
+    int n;
+    ssize_t ret;
+
+    if (len < 0 || len > fb->used)
+        len = fb->used;
+    if (len == 0)
+        return 0;
+    n = ring_data_iov (fb, 0, len, iov);
+    do {
+        ret = writev (fd, iov, n);
+    } while (ret < 0 && errno == EINTR);
+    return ret;
+}
+
 flux_buffer_t *flux_buffer_create (int size)
 {
     flux_buffer_t *fb = NULL;
@@ -69,12 +255,12 @@ flux_buffer_t *flux_buffer_create (int size)
         minsize = FLUX_BUFFER_MIN;
     fb->readonly = false;
 
-    /* buffer can grow to size specified by user */
-    if (!(fb->cbuf = cbuf_create (minsize, fb->size)))
-        goto cleanup;
-
-    if (cbuf_opt_set (fb->cbuf, CBUF_OPT_OVERWRITE, CBUF_NO_DROP) < 0)
+    /* ring can grow to size specified by user */
+    fb->cap = minsize;
+    if (!(fb->data = malloc (fb->cap))) {
+        errno = ENOMEM;
         goto cleanup;
+    }
 
     /* +1 for possible NUL on line reads */
     fb->buflen = minsize + 1;
@@ -98,7 +284,7 @@ void flux_buffer_destroy (void *data)
     flux_buffer_t *fb = data;
     if (fb && fb->magic == FLUX_BUFFER_MAGIC) {
         fb->magic = ~FLUX_BUFFER_MAGIC;
-        cbuf_destroy (fb->cbuf);
+        free (fb->data);
         free (fb->buf);
         free (fb);
     }
@@ -121,7 +307,7 @@ int flux_buffer_bytes (flux_buffer_t *fb)
         return -1;
     }
 
-    return cbuf_used (fb->cbuf);
+    return fb->used;
 }
 
 int flux_buffer_space (flux_buffer_t *fb)
@@ -131,7 +317,7 @@ int flux_buffer_space (flux_buffer_t *fb)
         return -1;
     }
 
-    return cbuf_free (fb->cbuf);
+    return fb->size - fb->used;
 }
 
 int flux_buffer_readonly (flux_buffer_t *fb)
@@ -259,28 +445,40 @@ void check_read_cb (flux_buffer_t *fb)
 
 int flux_buffer_drop (flux_buffer_t *fb, int len)
 {
-    int ret;
-
-    if (!fb || fb->magic != FLUX_BUFFER_MAGIC) {
+    if (!fb || fb->magic != FLUX_BUFFER_MAGIC || len < -1) {
         errno = EINVAL;
         return -1;
     }
 
-    if ((ret = cbuf_drop (fb->cbuf, len)) < 0)
-        return -1;
+    if (len == -1 || len > fb->used)
+        len = fb->used;
+    if (len == 0)
+        return 0;
+
+    ring_drop (fb, len);
 
     check_write_cb (fb);
 
-    return ret;
+    return len;
+}
+
+int flux_buffer_peek_iov (flux_buffer_t *fb, int len, struct iovec iov[2])
+{
+    if (!fb || fb->magic != FLUX_BUFFER_MAGIC || !iov) {
+        errno = EINVAL;
+        return -1;
+    }
+
+    if (len < 0 || len > fb->used)
+        len = fb->used;
+
+    return ring_data_iov (fb, 0, len, iov);
 }
 
 /* check if internal buffer can hold data from user */
 static int return_buffer_check (flux_buffer_t *fb)
 {
-    int used = cbuf_used (fb->cbuf);
-
-    if (used < 0)
-        return -1;
+    int used = fb->used;
 
     assert (used <= fb->size);
 
@@ -306,8 +504,6 @@ static int return_buffer_check (flux_buffer_t *fb)
 
 const void *flux_buffer_peek (flux_buffer_t *fb, int len, int *lenp)
 {
-    int ret;
-
     if (!fb || fb->magic != FLUX_BUFFER_MAGIC) {
         errno = EINVAL;
         return NULL;
@@ -316,26 +512,20 @@ const void *flux_buffer_peek (flux_buffer_t *fb, int len, int *lenp)
     if (return_buffer_check (fb) < 0)
         return NULL;
 
-    if (len < 0)
-        len = cbuf_used (fb->cbuf);
+    if (len < 0 || len > fb->used)
+        len = fb->used;
 
-    if (len > fb->buflen)
-        len = fb->buflen;
-
-    if ((ret = cbuf_peek (fb->cbuf, fb->buf, len)) < 0)
-        return NULL;
-    fb->buf[ret] = '\0';
+    ring_copyout (fb, fb->buf, len);
+    fb->buf[len] = '\0';
 
     if (lenp)
-        (*lenp) = ret;
+        (*lenp) = len;
 
     return fb->buf;
 }
 
 const void *flux_buffer_read (flux_buffer_t *fb, int len, int *lenp)
 {
-    int ret;
-
     if (!fb || fb->magic != FLUX_BUFFER_MAGIC) {
         errno = EINVAL;
         return NULL;
@@ -344,18 +534,16 @@ const void *flux_buffer_read (flux_buffer_t *fb, int len, int *lenp)
     if (return_buffer_check (fb) < 0)
         return NULL;
 
-    if (len < 0)
-        len = cbuf_used (fb->cbuf);
+    if (len < 0 || len > fb->used)
+        len = fb->used;
 
-    if (len > fb->buflen)
-        len = fb->buflen;
-
-    if ((ret = cbuf_read (fb->cbuf, fb->buf, len)) < 0)
-        return NULL;
-    fb->buf[ret] = '\0';
+    ring_copyout (fb, fb->buf, len);
+    fb->buf[len] = '\0';
+    if (len > 0)
+        ring_drop (fb, len);
 
     if (lenp)
-        (*lenp) = ret;
+        (*lenp) = len;
 
     check_write_cb (fb);
 
@@ -364,8 +552,6 @@ const void *flux_buffer_read (flux_buffer_t *fb, int len, int *lenp)
 
 int flux_buffer_write (flux_buffer_t *fb, const void *data, int len)
 {
-    int ret;
-
     if (!fb
         || fb->magic != FLUX_BUFFER_MAGIC
         || !data
@@ -379,12 +565,25 @@ int flux_buffer_write (flux_buffer_t *fb, const void *data, int len)
         return -1;
     }
 
-    if ((ret = cbuf_write (fb->cbuf, (void *)data, len, NULL)) < 0)
+    if (len == 0)
+        return 0;
+
+    if (fb->used == fb->size) {
+        errno = ENOSPC;
         return -1;
+    }
+
+    if (len > fb->size - fb->used)
+        len = fb->size - fb->used;
+
+    if (ring_reserve (fb, len) < 0)
+        return -1;
+
+    ring_copyin (fb, data, len);
 
     check_read_cb (fb);
 
-    return ret;
+    return len;
 }
 
 int flux_buffer_lines (flux_buffer_t *fb)
@@ -394,17 +593,16 @@ int flux_buffer_lines (flux_buffer_t *fb)
         return -1;
     }
 
-    return cbuf_lines_used (fb->cbuf);
+    return ring_count_lines (fb);
 }
 
 bool flux_buffer_has_line (flux_buffer_t *fb)
 {
-    char buf[1];
     if (!fb || fb->magic != FLUX_BUFFER_MAGIC) {
         errno = EINVAL;
         return false;
     }
-    return (cbuf_peek_line (fb->cbuf, buf, 0, 1) > 0);
+    return (ring_find_line (fb) > 0);
 }
 
 int flux_buffer_drop_line (flux_buffer_t *fb)
@@ -416,8 +614,8 @@ int flux_buffer_drop_line (flux_buffer_t *fb)
         return -1;
     }
 
-    if ((ret = cbuf_drop_line (fb->cbuf, fb->buflen, 1)) < 0)
-        return -1;
+    if ((ret = ring_find_line (fb)) > 0)
+        ring_drop (fb, ret);
 
     check_write_cb (fb);
 
@@ -436,8 +634,9 @@ const void *flux_buffer_peek_line (flux_buffer_t *fb, int *lenp)
     if (return_buffer_check (fb) < 0)
         return NULL;
 
-    if ((ret = cbuf_peek_line (fb->cbuf, fb->buf, fb->buflen, 1)) < 0)
-        return NULL;
+    ret = ring_find_line (fb);
+    ring_copyout (fb, fb->buf, ret);
+    fb->buf[ret] = '\0';
 
     if (lenp)
         (*lenp) = ret;
@@ -476,8 +675,11 @@ const void *flux_buffer_read_line (flux_buffer_t *fb, int *lenp)
     if (return_buffer_check (fb) < 0)
         return NULL;
 
-    if ((ret = cbuf_read_line (fb->cbuf, fb->buf, fb->buflen, 1)) < 0)
-        return NULL;
+    if ((ret = ring_find_line (fb)) > 0) {
+        ring_copyout (fb, fb->buf, ret);
+        ring_drop (fb, ret);
+    }
+    fb->buf[ret] = '\0';
 
     if (lenp)
         (*lenp) = ret;
@@ -508,7 +710,8 @@ const void *flux_buffer_read_trimmed_line (flux_buffer_t *fb, int *lenp)
 
 int flux_buffer_write_line (flux_buffer_t *fb, const char *data)
 {
-    int ret;
+    int len;
+    int total;
 
     if (!fb
         || fb->magic != FLUX_BUFFER_MAGIC
@@ -522,36 +725,54 @@ int flux_buffer_write_line (flux_buffer_t *fb, const char *data)
         return -1;
     }
 
-    if ((ret = cbuf_write_line (fb->cbuf, (char *)data, NULL)) < 0)
+    /* all or nothing, reserve space for newline if needed */
+    len = strlen (data);
+    total = len;
+    if (len == 0 || data[len - 1] != '\n')
+        total++;
+
+    if (total > fb->size - fb->used) {
+        errno = ENOSPC;
+        return -1;
+    }
+
+    if (ring_reserve (fb, total) < 0)
         return -1;
 
+    ring_copyin (fb, data, len);
+    if (total > len)
+        ring_copyin (fb, "\n", 1);
+
     check_read_cb (fb);
 
-    return ret;
+    return total;
 }
 
 int flux_buffer_peek_to_fd (flux_buffer_t *fb, int fd, int len)
 {
-    if (!fb || fb->magic != FLUX_BUFFER_MAGIC) {
+    if (!fb || fb->magic != FLUX_BUFFER_MAGIC || fd < 0 || len < -1) {
         errno = EINVAL;
         return -1;
     }
 
-    return cbuf_peek_to_fd (fb->cbuf, fd, len);
+    return ring_to_fd (fb, fd, len);
 }
 
 int flux_buffer_read_to_fd (flux_buffer_t *fb, int fd, int len)
 {
     int ret;
 
-    if (!fb || fb->magic != FLUX_BUFFER_MAGIC) {
+    if (!fb || fb->magic != FLUX_BUFFER_MAGIC || fd < 0 || len < -1) {
         errno = EINVAL;
         return -1;
     }
 
-    if ((ret = cbuf_read_to_fd (fb->cbuf, fd, len)) < 0)
+    if ((ret = ring_to_fd (fb, fd, len)) < 0)
         return -1;
 
+    if (ret > 0)
+        ring_drop (fb, ret);
+
     check_write_cb (fb);
 
     return ret;
@@ -559,9 +780,11 @@ int flux_buffer_read_to_fd (flux_buffer_t *fb, int fd, int len)
 
 int flux_buffer_write_from_fd (flux_buffer_t *fb, int fd, int len)
 {
-    int ret;
+    struct iovec iov[2];
+    int n;
+    ssize_t ret;
 
-    if (!fb || fb->magic != FLUX_BUFFER_MAGIC) {
+    if (!fb || fb->magic != FLUX_BUFFER_MAGIC || fd < 0 || len < -1) {
         errno = EINVAL;
         return -1;
     }
@@ -571,8 +794,37 @@ int flux_buffer_write_from_fd (flux_buffer_t *fb, int fd, int len)
         return -1;
     }
 
-    if ((ret = cbuf_write_from_fd (fb->cbuf, fd, len, NULL)) < 0)
+    /* Try to use the free space already allocated.  If there is none,
+     * grow the ring by a chunk.
+     */
+    if (len == -1) {
+        len = fb->cap - fb->used;
+        if (len == 0)
+            len = FLUX_BUFFER_CHUNK;
+    }
+    if (len == 0)
+        return 0;
+
+    if (fb->used == fb->size) {
+        errno = ENOSPC;
+        return -1;
+    }
+
+    /* Grow only when the allocated ring is full.  A short read is
+     * harmless, since callers are driven by level-triggered readiness.
+     */
+    if (fb->cap == fb->used
+        && ring_reserve (fb, len < fb->cap ? len : fb->cap) < 0)
+        return -1;
+
+    /* one readv(2) fills both free segments of the ring */
+    n = ring_space_iov (fb, len, iov);
+    do {
+        ret = readv (fd, iov, n);
+    } while (ret < 0 && errno == EINTR);
+    if (ret < 0)
         return -1;
+    fb->used += ret;
 
     check_read_cb (fb);
 
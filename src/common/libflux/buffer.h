@@ -12,6 +12,7 @@
 #define FLUX_BUFFER_H
 
 #include <stdbool.h>
+#include <sys/uio.h>
 
 typedef struct flux_buffer flux_buffer_t;
 
@@ -66,6 +67,15 @@ const void *flux_buffer_peek (flux_buffer_t *fb, int len, int *lenp);
  */
 const void *flux_buffer_read (flux_buffer_t *fb, int len, int *lenp);
 
+/* Get pointers to up to [len] bytes of data in the buffer without
+ * copying or consuming it.  Set [len] to -1 for all data.  Data may
+ * wrap around the end of the internal ring, so up to two segments are
+ * stored in [iov].  Returns the number of segments (0 if the buffer is
+ * empty) or -1 on error.  Pointers are valid until the buffer is next
+ * modified.  Use flux_buffer_drop() to consume the data.
+ */
+int flux_buffer_peek_iov (flux_buffer_t *fb, int len, struct iovec iov[2]);
+
 /* Write [len] bytes of data into the buffer.  Returns number of bytes
  * written on success.
  */
@@ -14,11 +14,30 @@
 #include <assert.h>
 #include <stdlib.h>
 #include <errno.h>
+#include <string.h>
 #include <flux/core.h>
 
 #include "content.h"
 
 #include "src/common/libutil/blobref.h"
+#include "src/common/libutil/blobvec.h"
+
+/* Batch results are decoded once from the response payload, then
+ * accessed by index.
+ */
+struct batch_item {
+    int errnum;
+    const void *data;
+    int len;
+};
+
+struct batch_result {
+    int count;
+    bool decoded;
+    struct batch_item item[];
+};
+
+static const char *auxkey = "flux::content_batch";
 
 flux_future_t *flux_content_load (flux_t *h, const char *blobref, int flags)
 {
@@ -73,6 +92,183 @@ int flux_content_store_get (flux_future_t *f, const char **blobref)
     return 0;
 }
 
+static flux_future_t *batch_rpc (flux_t *h,
+                                 const char *topic,
+                                 struct blobvec *bv,
+                                 int count,
+                                 int flags)
+{
+    flux_future_t *f;
+    struct batch_result *res;
+    const void *payload;
+    int len;
+    int i;
+
+    if (!(res = calloc (1, sizeof (*res)
+                           + count * sizeof (res->item[0])))) {
+        errno = ENOMEM;
+        return NULL;
+    }
+    res->count = count;
+    for (i = 0; i < count; i++)
+        res->item[i].errnum = EPROTO; /* until a response record is seen */
+    payload = blobvec_data (bv, &len);
+    if (!(f = flux_rpc_raw (h,
+                            topic,
+                            payload,
+                            len,
+                            (flags & CONTENT_FLAG_UPSTREAM)
+                                ? FLUX_NODEID_UPSTREAM : FLUX_NODEID_ANY,
+                            0)))
+        goto error;
+    if (flux_future_aux_set (f, auxkey, res, free) < 0)
+        goto error;
+    return f;
+error:
+    free (res);
+    flux_future_destroy (f);
+    return NULL;
+}
+
+static struct batch_item *batch_get (flux_future_t *f, int index)
+{
+    struct batch_result *res;
+    const void *buf;
+    int len;
+    int cursor = 0;
+    uint32_t i;
+    int errnum;
+    const void *data;
+    int datalen;
+    int rc;
+
+    if (flux_rpc_get_raw (f, &buf, &len) < 0)
+        return NULL;
+    if (!(res = flux_future_aux_get (f, auxkey))
+        || index < 0
+        || index >= res->count) {
+        errno = EINVAL;
+        return NULL;
+    }
+    if (!res->decoded) {
+        while ((rc = blobvec_decode (buf, len, &cursor,
+                                     &i, &errnum, &data, &datalen)) > 0) {
+            if (i >= res->count) {
+                errno = EPROTO;
+                return NULL;
+            }
+            res->item[i].errnum = errnum;
+            res->item[i].data = data;
+            res->item[i].len = datalen;
+        }
+        if (rc < 0)
+            return NULL;
+        res->decoded = true;
+    }
+    if (res->item[index].errnum != 0) {
+        errno = res->item[index].errnum;
+        return NULL;
+    }
+    return &res->item[index];
+}
+
+flux_future_t *flux_content_load_batch (flux_t *h,
+                                        const char **blobrefs,
+                                        int count,
+                                        int flags)
+{
+    struct blobvec *bv;
+    flux_future_t *f;
+    int i;
+
+    if (!h || !blobrefs || count <= 0
+           || (flags & CONTENT_FLAG_CACHE_BYPASS)) {
+        errno = EINVAL;
+        return NULL;
+    }
+    if (!(bv = blobvec_create ()))
+        return NULL;
+    for (i = 0; i < count; i++) {
+        if (!blobrefs[i] || blobref_validate (blobrefs[i]) < 0) {
+            errno = EINVAL;
+            goto error;
+        }
+        if (blobvec_append (bv, i, 0, blobrefs[i],
+                            strlen (blobrefs[i]) + 1) < 0)
+            goto error;
+    }
+    f = batch_rpc (h, "content.load-batch", bv, count, flags);
+    blobvec_destroy (bv);
+    return f;
+error:
+    blobvec_destroy (bv);
+    return NULL;
+}
+
+int flux_content_load_batch_get (flux_future_t *f,
+                                 int index,
+                                 const void **buf,
+                                 int *len)
+{
+    struct batch_item *item;
+
+    if (!(item = batch_get (f, index)))
+        return -1;
+    if (buf)
+        *buf = item->data;
+    if (len)
+        *len = item->len;
+    return 0;
+}
+
+flux_future_t *flux_content_store_batch (flux_t *h,
+                                         const void **bufs,
+                                         const int *lens,
+                                         int count,
+                                         int flags)
+{
+    struct blobvec *bv;
+    flux_future_t *f;
+    int i;
+
+    if (!h || !bufs || !lens || count <= 0
+           || (flags & CONTENT_FLAG_CACHE_BYPASS)) {
+        errno = EINVAL;
+        return NULL;
+    }
+    if (!(bv = blobvec_create ()))
+        return NULL;
+    for (i = 0; i < count; i++) {
+        if (blobvec_append (bv, i, 0, bufs[i], lens[i]) < 0)
+            goto error;
+    }
+    f = batch_rpc (h, "content.store-batch", bv, count, flags);
+    blobvec_destroy (bv);
+    return f;
+error:
+    blobvec_destroy (bv);
+    return NULL;
+}
+
+int flux_content_store_batch_get (flux_future_t *f,
+                                  int index,
+                                  const char **blobref)
+{
+    struct batch_item *item;
+    const char *ref;
+
+    if (!(item = batch_get (f, index)))
+        return -1;
+    ref = item->data;
+    if (!ref || ref[item->len - 1] != '\0' || blobref_validate (ref) < 0) {
+        errno = EPROTO;
+        return -1;
+    }
+    if (blobref)
+        *blobref = ref;
+    return 0;
+}
+
 /*
  * vi:tabstop=4 shiftwidth=4 expandtab
  */
@@ -46,6 +46,42 @@ flux_future_t *flux_content_store (flux_t *h,
  */
 int flux_content_store_get (flux_future_t *f, const char **blobref);
 
+/* Send one request to load 'count' blobs by blobref.
+ * CONTENT_FLAG_CACHE_BYPASS is not supported.
+ */
+flux_future_t *flux_content_load_batch (flux_t *h,
+                                        const char **blobrefs,
+                                        int count,
+                                        int flags);
+
+/* Get result 'index' of load batch request (blob), where 'index' is
+ * the position of its blobref in the request.  A failure to load that
+ * blob, e.g. ENOENT, is reported here.
+ * Storage for 'buf' belongs to 'f' and is valid until 'f' is destroyed.
+ * Returns 0 on success, -1 on failure with errno set.
+ */
+int flux_content_load_batch_get (flux_future_t *f,
+                                 int index,
+                                 const void **buf,
+                                 int *len);
+
+/* Send one request to store 'count' blobs.
+ * CONTENT_FLAG_CACHE_BYPASS is not supported.
+ */
+flux_future_t *flux_content_store_batch (flux_t *h,
+                                         const void **bufs,
+                                         const int *lens,
+                                         int count,
+                                         int flags);
+
+/* Get result 'index' of store batch request (blobref).
+ * Storage for 'blobref' belongs to 'f' and is valid until 'f' is destroyed.
+ * Returns 0 on success, -1 on failure with errno set.
+ */
+int flux_content_store_batch_get (flux_future_t *f,
+                                  int index,
+                                  const char **blobref);
+
 #ifdef __cplusplus
 }
 #endif
@@ -8,12 +8,15 @@
  * SPDX-License-Identifier: LGPL-3.0
 \************************************************************/
 
+#include <sys/uio.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
 #include <unistd.h>
 #include <errno.h>
 
+#include "src/common/libutil/monotime.h"
+
 #include "src/common/libflux/buffer.h"
 #include "src/common/libflux/buffer_private.h"
 #include "src/common/libtap/tap.h"
@@ -1209,6 +1212,116 @@ void large_data (void)
     flux_buffer_destroy (fb);
 }
 
+/* Data wraps around the end of the internal ring once the read offset
+ * has advanced.  Buffer size of 8 keeps the ring at its full size.
+ */
+void wrap_around (void)
+{
+    flux_buffer_t *fb;
+    struct iovec iov[2];
+    const char *ptr;
+    int len;
+    int pipefds[2];
+    char buf[16];
+
+    ok ((fb = flux_buffer_create (8)) != NULL,
+        "flux_buffer_create works");
+    ok (flux_buffer_write (fb, "abcdef", 6) == 6
+        && flux_buffer_drop (fb, 4) == 4,
+        "write 6 bytes, drop 4");
+    ok (flux_buffer_write (fb, "gh\nij", 5) == 5,
+        "write 5 bytes that wrap around end of ring");
+    ok (flux_buffer_bytes (fb) == 7 && flux_buffer_space (fb) == 1,
+        "bytes and space are correct");
+    ok (flux_buffer_peek_iov (fb, -1, iov) == 2
+        && iov[0].iov_len + iov[1].iov_len == 7
+        && !memcmp (iov[0].iov_base, "efgh\nij", iov[0].iov_len)
+        && !memcmp (iov[1].iov_base, "efgh\nij" + iov[0].iov_len,
+                    iov[1].iov_len),
+        "flux_buffer_peek_iov returns two segments");
+    ok (flux_buffer_peek_iov (fb, 2, iov) == 1
+        && iov[0].iov_len == 2
+        && !memcmp (iov[0].iov_base, "ef", 2),
+        "flux_buffer_peek_iov respects len");
+    ok (flux_buffer_lines (fb) == 1 && flux_buffer_has_line (fb),
+        "line found across wrap");
+    ok ((ptr = flux_buffer_read_line (fb, &len)) != NULL
+        && len == 5
+        && !strcmp (ptr, "efgh\n"),
+        "flux_buffer_read_line returns wrapped line");
+    ok ((ptr = flux_buffer_peek (fb, -1, &len)) != NULL
+        && len == 2
+        && !strcmp (ptr, "ij"),
+        "flux_buffer_peek returns remaining data");
+    ok (flux_buffer_write (fb, "klmnopq", 7) == 6,
+        "flux_buffer_write writes only available space");
+    ok ((ptr = flux_buffer_read (fb, -1, &len)) != NULL
+        && len == 8
+        && !strcmp (ptr, "ijklmnop"),
+        "flux_buffer_read returns wrapped data");
+    ok (flux_buffer_peek_iov (fb, -1, iov) == 0,
+        "flux_buffer_peek_iov returns 0 on empty buffer");
+
+    ok (pipe (pipefds) == 0,
+        "pipe succeeded");
+    ok (flux_buffer_write (fb, "123456", 6) == 6
+        && flux_buffer_drop (fb, 5) == 5
+        && flux_buffer_write (fb, "7890", 4) == 4,
+        "buffer data wraps around end of ring");
+    ok (flux_buffer_read_to_fd (fb, pipefds[1], -1) == 5,
+        "flux_buffer_read_to_fd writes wrapped data");
+    ok (read (pipefds[0], buf, sizeof (buf)) == 5
+        && !memcmp (buf, "67890", 5),
+        "read correct data from pipe");
+    ok (write (pipefds[1], "ABCDEFGHIJ", 10) == 10,
+        "write to pipe works");
+    ok (flux_buffer_write_from_fd (fb, pipefds[0], -1) == 8,
+        "flux_buffer_write_from_fd fills wrapped free space");
+    ok ((ptr = flux_buffer_read (fb, -1, &len)) != NULL
+        && len == 8
+        && !strcmp (ptr, "ABCDEFGH"),
+        "flux_buffer_read returns correct data");
+    ok (flux_buffer_peek_iov (NULL, -1, iov) < 0 && errno == EINVAL,
+        "flux_buffer_peek_iov fails on NULL pointer");
+
+    flux_buffer_destroy (fb);
+    close (pipefds[0]);
+    close (pipefds[1]);
+}
+
+/* Report write/read throughput.  Not a pass/fail test.
+ */
+void throughput (void)
+{
+    flux_buffer_t *fb;
+    char data[4096];
+    struct timespec t0;
+    double t;
+    long long total = 0;
+    int i;
+
+    memset (data, 'x', sizeof (data));
+    data[sizeof (data) - 1] = '\n';
+    if (!(fb = flux_buffer_create (FLUX_BUFFER_TEST_MAXSIZE)))
+        BAIL_OUT ("flux_buffer_create failed");
+
+    monotime (&t0);
+    for (i = 0; i < 65536; i++) {
+        int len;
+        if (flux_buffer_write (fb, data, sizeof (data)) != sizeof (data)
+            || !flux_buffer_read_line (fb, &len)
+            || len != sizeof (data))
+            break;
+        total += len;
+    }
+    t = monotime_since (t0) / 1000.;
+    ok (i == 65536,
+        "wrote and read %lld bytes by line", total);
+    diag ("write/read_line: %.1f MB/s", t > 0 ? total / t / 1048576 : 0.);
+
+    flux_buffer_destroy (fb);
+}
+
 int main (int argc, char *argv[])
 {
     plan (NO_PLAN);
@@ -1221,6 +1334,8 @@ int main (int argc, char *argv[])
     full_buffer ();
     readonly_buffer ();
     large_data ();
+    wrap_around ();
+    throughput ();
 
     done_testing();
 
@@ -35,17 +35,22 @@ struct idset *idset_create (size_t size, int flags)
 {
     struct idset *idset;
 
-    if (validate_idset_flags (flags, IDSET_FLAG_AUTOGROW) < 0)
+    if (validate_idset_flags (flags, IDSET_FLAG_AUTOGROW
+                                   | IDSET_FLAG_RUNS) < 0)
         return NULL;
     if (size == 0)
         size = IDSET_DEFAULT_SIZE;
-    if (!(idset = malloc (sizeof (*idset))))
-        return NULL;
-    idset->T = vebnew (size, 0);
-    if (!idset->T.D) {
-        free (idset);
-        errno = ENOMEM;
+    if (!(idset = calloc (1, sizeof (*idset))))
         return NULL;
+    if ((flags & IDSET_FLAG_RUNS))
+        idset->T.M = size;
+    else {
+        idset->T = vebnew (size, 0);
+        if (!idset->T.D) {
+            free (idset);
+            errno = ENOMEM;
+            return NULL;
+        }
     }
     idset->flags = flags;
     idset->count = 0;
@@ -57,6 +62,7 @@ void idset_destroy (struct idset *idset)
     if (idset) {
         int saved_errno = errno;
         free (idset->T.D);
+        free (idset->runs);
         free (idset);
         errno = saved_errno;
     }
@@ -82,13 +88,22 @@ struct idset *idset_copy (const struct idset *idset)
         errno = EINVAL;
         return NULL;
     }
-    if (!(cpy = malloc (sizeof (*idset))))
+    if (!(cpy = calloc (1, sizeof (*idset))))
         return NULL;
     cpy->flags = idset->flags;
-    cpy->T = vebdup (idset->T);
-    if (!cpy->T.D) {
-        idset_destroy (cpy);
-        return NULL;
+    if ((idset->flags & IDSET_FLAG_RUNS)) {
+        cpy->T = idset->T;
+        if (runs_copy (cpy, idset) < 0) {
+            idset_destroy (cpy);
+            return NULL;
+        }
+    }
+    else {
+        cpy->T = vebdup (idset->T);
+        if (!cpy->T.D) {
+            idset_destroy (cpy);
+            return NULL;
+        }
     }
     cpy->count = idset->count;
     return cpy;
@@ -118,6 +133,10 @@ static int idset_grow (struct idset *idset, size_t size)
             errno = EINVAL;
             return -1;
         }
+        if ((idset->flags & IDSET_FLAG_RUNS)) {
+            idset->T.M = newsize;
+            return 0;
+        }
         T = vebnew (newsize, 0);
         if (!T.D)
             return -1;
@@ -133,22 +152,41 @@ static int idset_grow (struct idset *idset, size_t size)
     return 0;
 }
 
-/* Wrapper for vebput() which increments idset count if needed
+/* Add ids [lo-hi] to idset, updating idset count.
+ * The caller must ensure the range fits within the idset size.
+ * Return 0 on success, -1 on failure with errno set.
  */
-static void idset_put (struct idset *idset, unsigned int id)
+static int idset_put (struct idset *idset, unsigned int lo, unsigned int hi)
 {
-    if (!idset_test (idset, id))
-        idset->count++;
-    vebput (idset->T, id);
+    unsigned int id;
+
+    if ((idset->flags & IDSET_FLAG_RUNS))
+        return runs_insert (idset, lo, hi);
+    for (id = lo; id <= hi; id++) {
+        if (!idset_test (idset, id)) {
+            idset->count++;
+            vebput (idset->T, id);
+        }
+    }
+    return 0;
 }
 
-/* Wrapper for vebdel() which decrements idset count if needed
+/* Remove ids [lo-hi] from idset, updating idset count.
+ * Return 0 on success, -1 on failure with errno set.
  */
-static void idset_del (struct idset *idset, unsigned int id)
+static int idset_del (struct idset *idset, unsigned int lo, unsigned int hi)
 {
-    if (idset_test (idset, id))
-        idset->count--;
-    vebdel (idset->T, id);
+    unsigned int id;
+
+    if ((idset->flags & IDSET_FLAG_RUNS))
+        return runs_remove (idset, lo, hi);
+    for (id = lo; id <= hi && id < idset->T.M; id++) {
+        if (idset_test (idset, id)) {
+            idset->count--;
+            vebdel (idset->T, id);
+        }
+    }
+    return 0;
 }
 
 int idset_set (struct idset *idset, unsigned int id)
@@ -159,8 +197,7 @@ int idset_set (struct idset *idset, unsigned int id)
     }
     if (idset_grow (idset, id + 1) < 0)
         return -1;
-    idset_put (idset, id);
-    return 0;
+    return idset_put (idset, id, id);
 }
 
 static void normalize_range (unsigned int *lo, unsigned int *hi)
@@ -174,8 +211,6 @@ static void normalize_range (unsigned int *lo, unsigned int *hi)
 
 int idset_range_set (struct idset *idset, unsigned int lo, unsigned int hi)
 {
-    unsigned int id;
-
     if (!idset || !valid_id (lo) || !valid_id (hi)) {
         errno = EINVAL;
         return -1;
@@ -183,9 +218,7 @@ int idset_range_set (struct idset *idset, unsigned int lo, unsigned int hi)
     normalize_range (&lo, &hi);
     if (idset_grow (idset, hi + 1) < 0)
         return -1;
-    for (id = lo; id <= hi; id++)
-        idset_put (idset, id);
-    return 0;
+    return idset_put (idset, lo, hi);
 }
 
 int idset_clear (struct idset *idset, unsigned int id)
@@ -194,40 +227,67 @@ int idset_clear (struct idset *idset, unsigned int id)
         errno = EINVAL;
         return -1;
     }
-    idset_del (idset, id);
-    return 0;
+    return idset_del (idset, id, id);
 }
 
 int idset_range_clear (struct idset *idset, unsigned int lo, unsigned int hi)
 {
-    unsigned int id;
-
     if (!idset || !valid_id (lo) || !valid_id (hi)) {
         errno = EINVAL;
         return -1;
     }
     normalize_range (&lo, &hi);
-    for (id = lo; id <= hi && id < idset->T.M; id++)
-        idset_del (idset, id);
-    return 0;
+    return idset_del (idset, lo, hi);
 }
 
 bool idset_test (const struct idset *idset, unsigned int id)
 {
     if (!idset || !valid_id (id) || id >= idset->T.M)
         return false;
+    if ((idset->flags & IDSET_FLAG_RUNS))
+        return runs_test (idset, id);
     return (vebsucc (idset->T, id) == id);
 }
 
+unsigned int idset_succ (const struct idset *idset, unsigned int id)
+{
+    unsigned int next;
+
+    if (id >= idset->T.M)
+        return IDSET_INVALID_ID;
+    if ((idset->flags & IDSET_FLAG_RUNS))
+        return runs_succ (idset, id, NULL);
+    next = vebsucc (idset->T, id);
+    if (next == idset->T.M)
+        return IDSET_INVALID_ID;
+    return next;
+}
+
+unsigned int idset_next_run (const struct idset *idset,
+                             unsigned int id,
+                             unsigned int *hi)
+{
+    unsigned int lo;
+
+    if (id >= idset->T.M)
+        return IDSET_INVALID_ID;
+    if ((idset->flags & IDSET_FLAG_RUNS))
+        return runs_succ (idset, id, hi);
+    if ((lo = idset_succ (idset, id)) != IDSET_INVALID_ID) {
+        id = lo;
+        while (id + 1 < idset->T.M && vebsucc (idset->T, id + 1) == id + 1)
+            id++;
+        *hi = id;
+    }
+    return lo;
+}
+
 unsigned int idset_first (const struct idset *idset)
 {
     unsigned int next = IDSET_INVALID_ID;
 
-    if (idset) {
-        next = vebsucc (idset->T, 0);
-        if (next == idset->T.M)
-            next = IDSET_INVALID_ID;
-    }
+    if (idset)
+        next = idset_succ (idset, 0);
     return next;
 }
 
@@ -236,11 +296,8 @@ unsigned int idset_next (const struct idset *idset, unsigned int prev)
 {
     unsigned int next = IDSET_INVALID_ID;
 
-    if (idset) {
-        next = vebsucc (idset->T, prev + 1);
-        if (next == idset->T.M)
-            next = IDSET_INVALID_ID;
-    }
+    if (idset)
+        next = idset_succ (idset, prev + 1);
     return next;
 }
 
@@ -249,6 +306,8 @@ unsigned int idset_last (const struct idset *idset)
     unsigned int last = IDSET_INVALID_ID;
 
     if (idset) {
+        if ((idset->flags & IDSET_FLAG_RUNS))
+            return runs_last (idset);
         last = vebpred (idset->T, idset->T.M - 1);
         if (last == idset->T.M)
             last = IDSET_INVALID_ID;
@@ -266,26 +325,226 @@ size_t idset_count (const struct idset *idset)
 bool idset_equal (const struct idset *idset1,
                   const struct idset *idset2)
 {
-    unsigned int id;
-
     if (!idset1 || !idset2)
         return false;
     if (idset_count (idset1) != idset_count (idset2))
         return false;
+    return idset_is_subset (idset1, idset2);
+}
+
+/* Return the last id of the run of consecutive ids containing 'id',
+ * but no greater than 'limit'.  'id' must be in idset.
+ */
+static unsigned int run_end (const struct idset *idset,
+                             unsigned int id,
+                             unsigned int limit)
+{
+    unsigned int hi;
+
+    if ((idset->flags & IDSET_FLAG_RUNS)) {
+        (void)runs_succ (idset, id, &hi);
+        return MIN (hi, limit);
+    }
+    while (id < limit && idset_succ (idset, id + 1) == id + 1)
+        id++;
+    return id;
+}
+
+/* Find the first run of consecutive ids >= 'id' that are in both set1
+ * and set2.  Return the first id of the run and set '*hi' to its last,
+ * or return IDSET_INVALID_ID if none.  Alternate successor queries
+ * between the two sets so that ids present in only one set are skipped
+ * rather than tested one by one.
+ */
+static unsigned int intersect_run (const struct idset *set1,
+                                   const struct idset *set2,
+                                   unsigned int id,
+                                   unsigned int *hi)
+{
+    unsigned int x = idset_succ (set1, id);
 
-    id = vebsucc (idset1->T, 0);
-    while (id < idset1->T.M) {
-        if (vebsucc (idset2->T, id) != id)
-            return false; // id in idset1 not set in idset2
-        id = vebsucc (idset1->T, id + 1);
+    while (x != IDSET_INVALID_ID) {
+        unsigned int y = idset_succ (set2, x);
+
+        if (y == IDSET_INVALID_ID)
+            break;
+        if (y != x) {
+            x = idset_succ (set1, y);
+            continue;
+        }
+        /* Bound the bitmap walk by the end of the run-length run, if any,
+         * so that the cost is proportional to the common run length.
+         */
+        if ((set2->flags & IDSET_FLAG_RUNS))
+            *hi = run_end (set1, x, run_end (set2, x, IDSET_INVALID_ID));
+        else if ((set1->flags & IDSET_FLAG_RUNS))
+            *hi = run_end (set2, x, run_end (set1, x, IDSET_INVALID_ID));
+        else {
+            *hi = x;
+            while (idset_succ (set1, *hi + 1) == *hi + 1
+                   && idset_succ (set2, *hi + 1) == *hi + 1)
+                (*hi)++;
+        }
+        return x;
     }
-    id = vebsucc (idset2->T, 0);
-    while (id < idset2->T.M) {
-        if (vebsucc (idset1->T, id) != id)
-            return false; // id in idset2 not set in idset1
-        id = vebsucc (idset2->T, id + 1);
+    return IDSET_INVALID_ID;
+}
+
+size_t idset_count_range (const struct idset *idset,
+                          unsigned int lo,
+                          unsigned int hi)
+{
+    unsigned int id;
+    unsigned int last;
+    size_t count = 0;
+
+    if (!idset || idset->count == 0)
+        return 0;
+    normalize_range (&lo, &hi);
+    if (lo <= idset_first (idset) && hi >= idset_last (idset))
+        return idset->count;
+    id = idset_next_run (idset, lo, &last);
+    while (id != IDSET_INVALID_ID && id <= hi) {
+        count += MIN (last, hi) - id + 1;
+        id = idset_next_run (idset, last + 1, &last);
     }
-    return true;
+    return count;
+}
+
+int idset_add (struct idset *set1, const struct idset *set2)
+{
+    unsigned int id;
+    unsigned int hi;
+
+    if (!set1 || !set2) {
+        errno = EINVAL;
+        return -1;
+    }
+    if ((id = idset_last (set2)) == IDSET_INVALID_ID)
+        return 0;
+    if (idset_grow (set1, id + 1) < 0)
+        return -1;
+    id = idset_next_run (set2, 0, &hi);
+    while (id != IDSET_INVALID_ID) {
+        if (idset_put (set1, id, hi) < 0)
+            return -1;
+        id = idset_next_run (set2, hi + 1, &hi);
+    }
+    return 0;
+}
+
+int idset_subtract (struct idset *set1, const struct idset *set2)
+{
+    unsigned int id;
+    unsigned int hi;
+
+    if (!set1 || !set2) {
+        errno = EINVAL;
+        return -1;
+    }
+    id = intersect_run (set1, set2, 0, &hi);
+    while (id != IDSET_INVALID_ID) {
+        if (idset_del (set1, id, hi) < 0)
+            return -1;
+        id = intersect_run (set1, set2, hi + 1, &hi);
+    }
+    return 0;
+}
+
+struct idset *idset_union (const struct idset *set1,
+                           const struct idset *set2)
+{
+    struct idset *result;
+
+    if (!set1 || !set2) {
+        errno = EINVAL;
+        return NULL;
+    }
+    if (set1->T.M >= set2->T.M) {
+        if (!(result = idset_copy (set1)))
+            return NULL;
+    }
+    else {
+        if (!(result = idset_create (set2->T.M, set1->flags))
+            || idset_add (result, set1) < 0)
+            goto error;
+    }
+    if (idset_add (result, set2) < 0)
+        goto error;
+    return result;
+error:
+    idset_destroy (result);
+    return NULL;
+}
+
+struct idset *idset_intersect (const struct idset *set1,
+                               const struct idset *set2)
+{
+    struct idset *result;
+    unsigned int id;
+    unsigned int hi;
+
+    if (!set1 || !set2) {
+        errno = EINVAL;
+        return NULL;
+    }
+    if (!(result = idset_create (MIN (set1->T.M, set2->T.M), set1->flags)))
+        return NULL;
+    id = intersect_run (set1, set2, 0, &hi);
+    while (id != IDSET_INVALID_ID) {
+        if (idset_put (result, id, hi) < 0) {
+            idset_destroy (result);
+            return NULL;
+        }
+        id = intersect_run (set1, set2, hi + 1, &hi);
+    }
+    return result;
+}
+
+struct idset *idset_difference (const struct idset *set1,
+                                const struct idset *set2)
+{
+    struct idset *result;
+
+    if (!set1 || !set2) {
+        errno = EINVAL;
+        return NULL;
+    }
+    if (!(result = idset_copy (set1)))
+        return NULL;
+    if (idset_subtract (result, set2) < 0) {
+        idset_destroy (result);
+        return NULL;
+    }
+    return result;
+}
+
+bool idset_has_intersection (const struct idset *set1,
+                             const struct idset *set2)
+{
+    unsigned int hi;
+
+    if (!set1 || !set2)
+        return false;
+    return (intersect_run (set1, set2, 0, &hi) != IDSET_INVALID_ID);
+}
+
+bool idset_is_subset (const struct idset *set1, const struct idset *set2)
+{
+    unsigned int id;
+    unsigned int hi;
+    size_t count = 0;
+
+    if (!set1 || !set2)
+        return false;
+    if (set1->count > set2->count)
+        return false;
+    id = intersect_run (set1, set2, 0, &hi);
+    while (id != IDSET_INVALID_ID) {
+        count += hi - id + 1;
+        id = intersect_run (set1, set2, hi + 1, &hi);
+    }
+    return (count == set1->count);
 }
 
 /*
@@ -23,6 +23,7 @@ enum idset_flags {
     IDSET_FLAG_AUTOGROW = 1, // allow idset size to automatically grow
     IDSET_FLAG_BRACKETS = 2, // encode non-singleton idset with brackets
     IDSET_FLAG_RANGE = 4,    // encode with ranges ("2,3,4,8" -> "2-4,8")
+    IDSET_FLAG_RUNS = 8,     // store ids as runs, e.g. for large sparse sets
 };
 
 #define IDSET_INVALID_ID    (UINT_MAX - 1)
@@ -31,6 +32,9 @@ enum idset_flags {
  * Set the initial size to 'size' (0 means implementation uses a default size).
  * If 'flags' includes IDSET_FLAG_AUTOGROW, the idset is resized to fit if
  * an id >= size is set.
+ * If 'flags' includes IDSET_FLAG_RUNS, ids are stored as sorted runs of
+ * consecutive ids, so memory is proportional to the number of runs
+ * rather than the idset size.
  * Returns idset on success, or NULL on failure with errno set.
  */
 struct idset *idset_create (size_t size, int flags);
@@ -48,6 +52,8 @@ struct idset *idset_copy (const struct idset *idset);
 char *idset_encode (const struct idset *idset, int flags);
 
 /* Decode string 's' to an idset.
+ * The idset has IDSET_FLAG_AUTOGROW set, and IDSET_FLAG_RUNS if it is
+ * large and consists mostly of long ranges.
  * Returns idset on success, or NULL on failure with errno set.
  */
 struct idset *idset_decode (const char *s);
@@ -100,6 +106,42 @@ size_t idset_count (const struct idset *idset);
  */
 bool idset_equal (const struct idset *set1, const struct idset *set2);
 
+/* Return the number of id's in idset within the range [lo-hi].
+ * If idset is invalid, return 0.
+ */
+size_t idset_count_range (const struct idset *idset,
+                          unsigned int lo,
+                          unsigned int hi);
+
+/* Add (subtract) all ids in 'set2' to (from) 'set1' in place.
+ * idset_add() fails with EINVAL if 'set1' is too small to hold all ids
+ * in 'set2' and does not have IDSET_FLAG_AUTOGROW.
+ * Return 0 on success, -1 on failure with errno set.
+ */
+int idset_add (struct idset *set1, const struct idset *set2);
+int idset_subtract (struct idset *set1, const struct idset *set2);
+
+/* Return a new idset containing the union, intersection, or difference
+ * (ids in 'set1' that are not in 'set2') of 'set1' and 'set2'.
+ * The result inherits the flags of 'set1'.
+ * Returns idset on success, or NULL on failure with errno set.
+ */
+struct idset *idset_union (const struct idset *set1,
+                           const struct idset *set2);
+struct idset *idset_intersect (const struct idset *set1,
+                               const struct idset *set2);
+struct idset *idset_difference (const struct idset *set1,
+                                const struct idset *set2);
+
+/* Return true if 'set1' and 'set2' have at least one id in common.
+ */
+bool idset_has_intersection (const struct idset *set1,
+                             const struct idset *set2);
+
+/* Return true if all ids in 'set1' are also in 'set2'.
+ */
+bool idset_is_subset (const struct idset *set1, const struct idset *set2);
+
 /* Expand bracketed idset string(s) in 's', calling 'fun()' for each
  * expanded string.  'fun()' should return 0 on success, or -1 on failure
  * with errno set.  A fun() failure causes idset_format_map () to immediately
@@ -61,44 +61,99 @@ static char *trim_brackets (char *s)
     return p;
 }
 
+/* Parse comma-separated ranges in 's' (modified in place) to an array
+ * of runs, which the caller must free.  The runs may overlap and are in
+ * the order given.  Set '*maxp' to the index of the run containing the
+ * largest id and '*countp' to the sum of the run lengths.
+ * Returns the number of runs, or -1 on failure with errno set.
+ */
+static ssize_t parse_runs (char *s,
+                           struct idset_run **runsp,
+                           size_t *maxp,
+                           size_t *countp)
+{
+    struct idset_run *runs = NULL;
+    size_t nruns = 0;
+    size_t maxruns = 0;
+    size_t max = 0;
+    size_t count = 0;
+    char *tok, *saveptr = NULL;
+
+    while ((tok = strtok_r (s, ",", &saveptr))) {
+        unsigned int hi, lo;
+        if (parse_range (tok, &hi, &lo) < 0) {
+            free (runs);
+            errno = EINVAL;
+            return -1;
+        }
+        if (nruns == maxruns) {
+            struct idset_run *p;
+            maxruns += IDSET_RUNS_CHUNK;
+            if (!(p = realloc (runs, maxruns * sizeof (runs[0])))) {
+                free (runs);
+                errno = ENOMEM;
+                return -1;
+            }
+            runs = p;
+        }
+        runs[nruns].lo = lo;
+        runs[nruns].hi = hi;
+        if (hi > runs[max].hi)
+            max = nruns;
+        count += (size_t)(hi - lo) + 1;
+        nruns++;
+        s = NULL;
+    }
+    *runsp = runs;
+    *maxp = max;
+    *countp = count;
+    return nruns;
+}
+
 struct idset *idset_ndecode (const char *str, size_t size)
 {
-    struct idset *idset;
+    struct idset *idset = NULL;
     char *cpy = NULL;
-    char *tok, *saveptr, *a1;
+    struct idset_run *runs = NULL;
+    ssize_t nruns;
+    size_t max;
+    size_t count;
+    int flags = IDSET_FLAG_AUTOGROW;
     int saved_errno;
+    ssize_t i;
 
     if (!str) {
         errno = EINVAL;
         return NULL;
     }
-    if (!(idset = idset_create (0, IDSET_FLAG_AUTOGROW)))
-        return NULL;
     if (!(cpy = strndup (str, size)))
         goto error;
-    a1 = trim_brackets (cpy);
-    saveptr = NULL;
-    while ((tok = strtok_r (a1, ",", &saveptr))) {
-        unsigned int hi, lo, i;
-        if (parse_range (tok, &hi, &lo) < 0)
-            goto inval;
-        /* Count backwards so that idset_set() can grow the
-         * idset to the maximum size on the first access,
-         * rather than possibly doing it multiple times.
-         */
-        for (i = hi; i >= lo && i != UINT_MAX; i--) {
-            if (idset_set (idset, i) < 0)
-                goto error;
-        }
-        a1 = NULL;
+    if ((nruns = parse_runs (trim_brackets (cpy), &runs, &max, &count)) < 0)
+        goto error;
+    /* Use run-length storage if a bitmap would be large and the ranges
+     * are long enough that runs are a more compact representation.
+     */
+    if (nruns > 0
+        && runs[max].hi >= IDSET_DEFAULT_SIZE
+        && count / nruns >= IDSET_RUNS_MIN_AVG)
+        flags |= IDSET_FLAG_RUNS;
+    if (!(idset = idset_create (0, flags)))
+        goto error;
+    /* Set the run containing the largest id first so that the idset
+     * grows to its final size at most once.
+     */
+    for (i = 0; i < nruns; i++) {
+        struct idset_run *run = &runs[(max + i) % nruns];
+        if (idset_range_set (idset, run->lo, run->hi) < 0)
+            goto error;
     }
+    free (runs);
     free (cpy);
     return idset;
-inval:
-    errno = EINVAL;
 error:
     saved_errno = errno;
     idset_destroy (idset);
+    free (runs);
     free (cpy);
     errno = saved_errno;
     return NULL;
@@ -80,35 +80,21 @@ static int catrange (char **s, size_t *sz, size_t *len,
 static int encode_ranged (const struct idset *idset,
                           char **s, size_t *sz, size_t *len)
 {
-    int count = 0;
-    unsigned int id;
-    unsigned int lo = 0;
-    unsigned int hi = 0;
-    bool first = true;
+    unsigned int lo;
+    unsigned int hi;
 
-    lo = hi = id = vebsucc (idset->T, 0);
-    while (id < idset->T.M) {
-        unsigned int next = vebsucc (idset->T, id + 1);;
-        bool last = (next == idset->T.M);
+    lo = idset_next_run (idset, 0, &hi);
+    while (lo != IDSET_INVALID_ID) {
+        unsigned int next_hi;
+        unsigned int next = idset_next_run (idset, hi + 1, &next_hi);
+        bool last = (next == IDSET_INVALID_ID);
 
-        if (first)                  // first iteration
-            first = false;
-        else if (id == hi + 1)      // id is in range
-            hi++;
-        else {                      // id is NOT in range
-            if (catrange (s, sz, len, lo, hi, ",") < 0)
-                return -1;
-            lo = hi = id;
-        }
-        if (last) {                 // last iteration
-            if (catrange (s, sz, len, lo, hi, last ? "" : ",") < 0)
-                return -1;
-        }
-        if (count < INT_MAX)
-            count++;
-        id = next;
+        if (catrange (s, sz, len, lo, hi, last ? "" : ",") < 0)
+            return -1;
+        lo = next;
+        hi = next_hi;
     }
-    return count;
+    return idset->count < INT_MAX ? idset->count : INT_MAX;
 }
 
 /* Return value: count of id's in set, or -1 on failure.
@@ -120,11 +106,11 @@ static int encode_simple (const struct idset *idset,
     int count = 0;
     unsigned int id;
 
-    id = vebsucc (idset->T, 0);
-    while (id != idset->T.M) {
-        int next = vebsucc (idset->T, id + 1);
-        char *sep = next == idset->T.M ? "" : ",";
-        if (catprintf (s, sz, len, "%d%s", id, sep) < 0)
+    id = idset_succ (idset, 0);
+    while (id != IDSET_INVALID_ID) {
+        unsigned int next = idset_succ (idset, id + 1);
+        char *sep = next == IDSET_INVALID_ID ? "" : ",";
+        if (catprintf (s, sz, len, "%u%s", id, sep) < 0)
             return -1;
         if (count < INT_MAX)
             count++;
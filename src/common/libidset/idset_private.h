@@ -14,22 +14,63 @@
 /* Implemented as a Van Emde Boas tree using code.google.com/p/libveb.
  * T.D is data; T.M is size
  * All ops are O(log m), for key bitsize m: 2^m == T.M.
+ *
+ * With IDSET_FLAG_RUNS, ids are instead stored as a sorted array of
+ * runs of consecutive ids (see idset_runs.c).  T.D is NULL and T.M is
+ * the idset size.
  */
 
 #include "src/common/libutil/veb.h"
 #include "idset.h"
 
+struct idset_run {
+    unsigned int lo;
+    unsigned int hi;
+};
+
 struct idset {
     size_t count;
     Veb T;
+    struct idset_run *runs;
+    size_t nruns;
+    size_t maxruns;
     int flags;
 };
 
 #define IDSET_ENCODE_CHUNK 1024
 #define IDSET_DEFAULT_SIZE 1024 // default idset size if size=0
+#define IDSET_RUNS_CHUNK 16     // initial runs array size
+
+/* idset_decode() uses IDSET_FLAG_RUNS if the decoded idset is larger
+ * than IDSET_DEFAULT_SIZE and its runs average at least this many ids.
+ */
+#define IDSET_RUNS_MIN_AVG 64
 
 int validate_idset_flags (int flags, int allowed);
 
+/* Return the first id >= 'id' in idset, or IDSET_INVALID_ID if none.
+ * Unlike idset_next(), 'id' may be beyond the end of the idset.
+ */
+unsigned int idset_succ (const struct idset *idset, unsigned int id);
+
+/* Like idset_succ(), but also set '*hi' to the last id of the run of
+ * consecutive ids that begins with the returned id.
+ */
+unsigned int idset_next_run (const struct idset *idset,
+                             unsigned int id,
+                             unsigned int *hi);
+
+/* Run-length storage, used if idset->flags includes IDSET_FLAG_RUNS.
+ */
+int runs_insert (struct idset *idset, unsigned int lo, unsigned int hi);
+int runs_remove (struct idset *idset, unsigned int lo, unsigned int hi);
+bool runs_test (const struct idset *idset, unsigned int id);
+unsigned int runs_succ (const struct idset *idset,
+                        unsigned int id,
+                        unsigned int *hi);
+unsigned int runs_last (const struct idset *idset);
+int runs_copy (struct idset *dst, const struct idset *src);
+
 int format_first (char *buf,
                   size_t bufsz,
                   const char *fmt,
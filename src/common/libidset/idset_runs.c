@@ -0,0 +1,192 @@
+/************************************************************\
+ * Copyright 2026 Lawrence Livermore National Security, LLC
+ * (c.f. AUTHORS, NOTICE.LLNS, COPYING)
+ *
+ * This file is part of the Flux resource manager framework.
+ * For details, see https://github.com/flux-framework.
+ *
+ * SPDX-License-Identifier: LGPL-3.0
+\************************************************************/
+
+/* idset_runs.c - run-length idset storage (IDSET_FLAG_RUNS)
+ *
+ * Ids are stored in idset->runs as a sorted array of disjoint,
+ * non-adjacent runs of consecutive ids.  Lookups are O(log r) for r runs.
+ * Inserting or removing a run is O(log r) plus a memmove of the runs
+ * that follow it, which is O(1) when runs are appended in order.
+ *
+ * These functions maintain idset->count.  Callers check ids against
+ * the idset size.
+ */
+
+#if HAVE_CONFIG_H
+#include "config.h"
+#endif
+#include <sys/param.h>
+#include <errno.h>
+#include <string.h>
+#include <stdlib.h>
+#include <stdbool.h>
+
+#include "idset.h"
+#include "idset_private.h"
+
+/* Return the index of the first run with hi >= id, or nruns if none.
+ */
+static size_t runs_search (const struct idset *idset, unsigned int id)
+{
+    size_t lo = 0;
+    size_t hi = idset->nruns;
+
+    while (lo < hi) {
+        size_t mid = lo + (hi - lo) / 2;
+        if (idset->runs[mid].hi < id)
+            lo = mid + 1;
+        else
+            hi = mid;
+    }
+    return lo;
+}
+
+/* Ensure there is room for at least 'n' runs.
+ * Return 0 on success, -1 on failure with errno = ENOMEM.
+ */
+static int runs_reserve (struct idset *idset, size_t n)
+{
+    size_t newmax = idset->maxruns;
+    struct idset_run *runs;
+
+    if (n <= idset->maxruns)
+        return 0;
+    while (newmax < n)
+        newmax = newmax ? newmax * 2 : IDSET_RUNS_CHUNK;
+    if (!(runs = realloc (idset->runs, newmax * sizeof (runs[0])))) {
+        errno = ENOMEM;
+        return -1;
+    }
+    idset->runs = runs;
+    idset->maxruns = newmax;
+    return 0;
+}
+
+static void runs_delete (struct idset *idset, size_t i, size_t n)
+{
+    memmove (&idset->runs[i],
+             &idset->runs[i + n],
+             (idset->nruns - i - n) * sizeof (idset->runs[0]));
+    idset->nruns -= n;
+}
+
+static int runs_open (struct idset *idset, size_t i)
+{
+    if (runs_reserve (idset, idset->nruns + 1) < 0)
+        return -1;
+    memmove (&idset->runs[i + 1],
+             &idset->runs[i],
+             (idset->nruns - i) * sizeof (idset->runs[0]));
+    idset->nruns++;
+    return 0;
+}
+
+int runs_insert (struct idset *idset, unsigned int lo, unsigned int hi)
+{
+    size_t i, j;
+    size_t covered = 0;
+    unsigned int newlo = lo;
+    unsigned int newhi = hi;
+
+    /* Runs i to j-1 overlap or are adjacent to [lo-hi].
+     */
+    i = runs_search (idset, lo > 0 ? lo - 1 : 0);
+    for (j = i; j < idset->nruns && idset->runs[j].lo <= hi + 1; j++) {
+        newlo = MIN (newlo, idset->runs[j].lo);
+        newhi = MAX (newhi, idset->runs[j].hi);
+        covered += idset->runs[j].hi - idset->runs[j].lo + 1;
+    }
+    if (i == j) {
+        if (runs_open (idset, i) < 0)
+            return -1;
+    }
+    else if (j - i > 1)
+        runs_delete (idset, i + 1, j - i - 1);
+    idset->runs[i].lo = newlo;
+    idset->runs[i].hi = newhi;
+    idset->count += (size_t)(newhi - newlo) + 1 - covered;
+    return 0;
+}
+
+int runs_remove (struct idset *idset, unsigned int lo, unsigned int hi)
+{
+    size_t i = runs_search (idset, lo);
+
+    while (i < idset->nruns && idset->runs[i].lo <= hi) {
+        struct idset_run *run = &idset->runs[i];
+
+        if (run->lo < lo && run->hi > hi) { // split run
+            if (runs_open (idset, i) < 0)
+                return -1;
+            idset->runs[i].hi = lo - 1;
+            idset->runs[i + 1].lo = hi + 1;
+            idset->count -= (size_t)(hi - lo) + 1;
+            break;
+        }
+        else if (run->lo < lo) {            // trim end of run
+            idset->count -= (size_t)(run->hi - lo) + 1;
+            run->hi = lo - 1;
+            i++;
+        }
+        else if (run->hi > hi) {            // trim start of run
+            idset->count -= (size_t)(hi - run->lo) + 1;
+            run->lo = hi + 1;
+            break;
+        }
+        else {                              // drop entire run
+            idset->count -= (size_t)(run->hi - run->lo) + 1;
+            runs_delete (idset, i, 1);
+        }
+    }
+    return 0;
+}
+
+bool runs_test (const struct idset *idset, unsigned int id)
+{
+    size_t i = runs_search (idset, id);
+
+    return (i < idset->nruns && idset->runs[i].lo <= id);
+}
+
+unsigned int runs_succ (const struct idset *idset,
+                        unsigned int id,
+                        unsigned int *hi)
+{
+    size_t i = runs_search (idset, id);
+
+    if (i == idset->nruns)
+        return IDSET_INVALID_ID;
+    if (hi)
+        *hi = idset->runs[i].hi;
+    return MAX (idset->runs[i].lo, id);
+}
+
+unsigned int runs_last (const struct idset *idset)
+{
+    if (idset->nruns == 0)
+        return IDSET_INVALID_ID;
+    return idset->runs[idset->nruns - 1].hi;
+}
+
+int runs_copy (struct idset *dst, const struct idset *src)
+{
+    dst->runs = NULL;
+    dst->nruns = dst->maxruns = 0;
+    if (runs_reserve (dst, src->nruns) < 0)
+        return -1;
+    if (src->nruns > 0)
+        memcpy (dst->runs, src->runs, src->nruns * sizeof (src->runs[0]));
+    dst->nruns = src->nruns;
+    return 0;
+}
+
+/*
+ * vi:tabstop=4 shiftwidth=4 expandtab
+ */
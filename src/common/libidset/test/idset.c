@@ -465,6 +465,275 @@ void test_equal (void)
     idset_destroy (set2);
 }
 
+/* Decode 'expected' and compare to 'set'.
+ */
+bool check_set (const struct idset *set, const char *expected)
+{
+    struct idset *x;
+    bool rc;
+
+    if (!(x = idset_decode (expected)))
+        BAIL_OUT ("idset_decode %s failed", expected);
+    rc = idset_equal (set, x);
+    idset_destroy (x);
+    return rc;
+}
+
+struct setop_test {
+    const char *set1;
+    const char *set2;
+    const char *union_result;
+    const char *intersect_result;
+    const char *difference_result;
+};
+
+struct setop_test setop_tests[] = {
+    { "",           "",         "",             "",         "" },
+    { "1-10",       "",         "1-10",         "",         "1-10" },
+    { "",           "1-10",     "1-10",         "",         "" },
+    { "1-10",       "5-15",     "1-15",         "5-10",     "1-4" },
+    { "0,2,4,6",    "1,3,5,7",  "0-7",          "",         "0,2,4,6" },
+    { "0-1023",     "1000-2000","0-2000",       "1000-1023","0-999" },
+    { "3000",       "0-5",      "0-5,3000",     "",         "3000" },
+    { "0-100",      "50",       "0-100",        "50",       "0-49,51-100" },
+    { NULL, NULL, NULL, NULL, NULL },
+};
+
+/* Decode 's' into an idset with storage 'flags' (0 or IDSET_FLAG_RUNS).
+ */
+struct idset *decode_flags (const char *s, int flags)
+{
+    struct idset *x;
+    struct idset *idset = NULL;
+
+    if (!(x = idset_decode (s))
+        || !(idset = idset_create (0, IDSET_FLAG_AUTOGROW | flags))
+        || idset_add (idset, x) < 0)
+        BAIL_OUT ("decode_flags %s failed", s);
+    idset_destroy (x);
+    return idset;
+}
+
+void test_setops (int flags1, int flags2)
+{
+    struct setop_test *t;
+
+    diag ("set1 %s, set2 %s",
+          flags1 ? "runs" : "veb",
+          flags2 ? "runs" : "veb");
+    for (t = &setop_tests[0]; t->set1 != NULL; t++) {
+        struct idset *set1 = decode_flags (t->set1, flags1);
+        struct idset *set2 = decode_flags (t->set2, flags2);
+        struct idset *result;
+
+        result = idset_union (set1, set2);
+        ok (result != NULL && check_set (result, t->union_result),
+            "idset_union [%s] [%s] = [%s]",
+            t->set1, t->set2, t->union_result);
+        idset_destroy (result);
+
+        result = idset_intersect (set1, set2);
+        ok (result != NULL && check_set (result, t->intersect_result),
+            "idset_intersect [%s] [%s] = [%s]",
+            t->set1, t->set2, t->intersect_result);
+        ok (idset_has_intersection (set1, set2) == (idset_count (result) > 0),
+            "idset_has_intersection [%s] [%s] = %s",
+            t->set1, t->set2, idset_count (result) > 0 ? "true" : "false");
+        idset_destroy (result);
+
+        result = idset_difference (set1, set2);
+        ok (result != NULL && check_set (result, t->difference_result),
+            "idset_difference [%s] [%s] = [%s]",
+            t->set1, t->set2, t->difference_result);
+        idset_destroy (result);
+
+        ok (idset_add (set1, set2) == 0 && check_set (set1, t->union_result),
+            "idset_add [%s] [%s] = [%s]",
+            t->set1, t->set2, t->union_result);
+        ok (idset_is_subset (set2, set1),
+            "idset_is_subset [%s] [%s] after idset_add",
+            t->set2, t->union_result);
+        ok (idset_subtract (set1, set2) == 0
+            && idset_has_intersection (set1, set2) == false,
+            "idset_subtract [%s] [%s] removes all common ids",
+            t->union_result, t->set2);
+
+        idset_destroy (set1);
+        idset_destroy (set2);
+    }
+}
+
+void test_setops_badparam (void)
+{
+    struct idset *set;
+
+    if (!(set = idset_decode ("0-7")))
+        BAIL_OUT ("idset_decode failed");
+    errno = 0;
+    ok (idset_add (NULL, set) < 0 && errno == EINVAL,
+        "idset_add set1=NULL fails with EINVAL");
+    errno = 0;
+    ok (idset_add (set, NULL) < 0 && errno == EINVAL,
+        "idset_add set2=NULL fails with EINVAL");
+    errno = 0;
+    ok (idset_subtract (NULL, set) < 0 && errno == EINVAL,
+        "idset_subtract set1=NULL fails with EINVAL");
+    errno = 0;
+    ok (idset_union (set, NULL) == NULL && errno == EINVAL,
+        "idset_union set2=NULL fails with EINVAL");
+    errno = 0;
+    ok (idset_intersect (NULL, set) == NULL && errno == EINVAL,
+        "idset_intersect set1=NULL fails with EINVAL");
+    errno = 0;
+    ok (idset_difference (NULL, set) == NULL && errno == EINVAL,
+        "idset_difference set1=NULL fails with EINVAL");
+    ok (idset_has_intersection (set, NULL) == false,
+        "idset_has_intersection set2=NULL returns false");
+    ok (idset_is_subset (NULL, set) == false,
+        "idset_is_subset set1=NULL returns false");
+    ok (idset_count_range (NULL, 0, 1) == 0,
+        "idset_count_range idset=NULL returns 0");
+    idset_destroy (set);
+}
+
+void test_setops_size (int flags)
+{
+    struct idset *set1;
+    struct idset *set2;
+    struct idset *result;
+
+    if (!(set1 = idset_create (16, flags))
+        || !(set2 = idset_create (64, flags)))
+        BAIL_OUT ("idset_create failed");
+    if (idset_set (set2, 63) < 0 || idset_set (set1, 1) < 0)
+        BAIL_OUT ("idset_set failed");
+    errno = 0;
+    ok (idset_add (set1, set2) < 0 && errno == EINVAL,
+        "idset_add fails with EINVAL if set1 is too small without autogrow");
+    ok (idset_count (set1) == 1,
+        "and set1 was not modified");
+    result = idset_union (set1, set2);
+    ok (result != NULL && check_set (result, "1,63"),
+        "idset_union works on sets of different size");
+    idset_destroy (result);
+    ok (idset_subtract (set1, set2) == 0 && idset_count (set1) == 1,
+        "idset_subtract works on sets of different size");
+    idset_destroy (set1);
+    idset_destroy (set2);
+}
+
+void test_count_range (int flags)
+{
+    struct idset *set = decode_flags ("0-9,100-199,1000", flags);
+
+    ok (idset_count_range (set, 0, 2000) == 111,
+        "idset_count_range [0-2000] = 111");
+    ok (idset_count_range (set, 5, 150) == 56,
+        "idset_count_range [5-150] = 56");
+    ok (idset_count_range (set, 150, 5) == 56,
+        "idset_count_range [150-5] = 56");
+    ok (idset_count_range (set, 10, 99) == 0,
+        "idset_count_range [10-99] = 0");
+    ok (idset_count_range (set, 1000, 1000) == 1,
+        "idset_count_range [1000-1000] = 1");
+    ok (idset_count_range (set, 5000, 6000) == 0,
+        "idset_count_range beyond end of set = 0");
+    idset_destroy (set);
+}
+
+void test_runs (void)
+{
+    struct idset *idset;
+    struct idset *cpy;
+    char *s;
+
+    idset = idset_create (100, IDSET_FLAG_RUNS);
+    ok (idset != NULL && idset->T.D == NULL,
+        "idset_create flags=RUNS does not allocate a bitmap");
+    ok (idset_range_set (idset, 10, 19) == 0
+        && idset_range_set (idset, 30, 39) == 0
+        && idset_set (idset, 20) == 0,
+        "idset_range_set [10-19,30-39] and idset_set 20 works");
+    ok (idset->nruns == 2 && idset_count (idset) == 21,
+        "adjacent ids were merged into 2 runs of 21 ids");
+    ok (idset_range_set (idset, 15, 35) == 0,
+        "idset_range_set [15-35] works");
+    ok (idset->nruns == 1 && idset_count (idset) == 30,
+        "overlapping runs were merged into 1 run of 30 ids");
+    ok (idset_first (idset) == 10 && idset_last (idset) == 39,
+        "idset_first/idset_last return 10/39");
+    ok (idset_clear (idset, 25) == 0,
+        "idset_clear 25 works");
+    ok (idset->nruns == 2 && idset_count (idset) == 29,
+        "run was split into 2 runs of 29 ids");
+    ok (idset_next (idset, 24) == 26 && !idset_test (idset, 25),
+        "idset_next skips cleared id");
+    ok (idset_range_clear (idset, 0, 12) == 0
+        && idset_range_clear (idset, 37, 99) == 0,
+        "idset_range_clear [0-12] and [37-99] works");
+    ok ((s = idset_encode (idset, IDSET_FLAG_RANGE)) != NULL
+        && !strcmp (s, "13-24,26-36"),
+        "idset_encode returns 13-24,26-36");
+    free (s);
+    errno = 0;
+    ok (idset_set (idset, 100) < 0 && errno == EINVAL,
+        "idset_set 100 fails with EINVAL without autogrow");
+    cpy = idset_copy (idset);
+    ok (cpy != NULL && idset_equal (idset, cpy) && cpy->nruns == 2,
+        "idset_copy works");
+    ok (idset_range_clear (cpy, 0, 99) == 0
+        && idset_count (cpy) == 0
+        && idset_first (cpy) == IDSET_INVALID_ID
+        && idset_last (cpy) == IDSET_INVALID_ID,
+        "idset_range_clear of all ids leaves an empty set");
+    ok (idset_count (idset) == 23,
+        "original is unchanged");
+    idset_destroy (cpy);
+    idset_destroy (idset);
+
+    idset = idset_create (1, IDSET_FLAG_RUNS | IDSET_FLAG_AUTOGROW);
+    ok (idset != NULL
+        && idset_range_set (idset, 0, 1000000) == 0
+        && idset->nruns == 1
+        && idset_count (idset) == 1000001,
+        "idset_range_set [0-1000000] with autogrow is stored as 1 run");
+    ok (idset->T.M > 1000000,
+        "idset internal size grew");
+    idset_destroy (idset);
+}
+
+void test_runs_decode (void)
+{
+    struct idset *idset;
+    char *s;
+
+    idset = idset_decode ("0-3,5");
+    ok (idset != NULL && !(idset->flags & IDSET_FLAG_RUNS),
+        "idset_decode of small idset uses bitmap storage");
+    idset_destroy (idset);
+
+    idset = idset_decode ("0,2,4,6,8,2000");
+    ok (idset != NULL && !(idset->flags & IDSET_FLAG_RUNS),
+        "idset_decode of large idset with short ranges uses bitmap storage");
+    idset_destroy (idset);
+
+    idset = idset_decode ("[0-4095,1000000-1999999]");
+    ok (idset != NULL && (idset->flags & IDSET_FLAG_RUNS),
+        "idset_decode of large idset with long ranges uses run storage");
+    ok (idset_count (idset) == 1004096 && idset->nruns == 2,
+        "idset has expected count and number of runs");
+    ok ((s = idset_encode (idset, IDSET_FLAG_RANGE | IDSET_FLAG_BRACKETS))
+        && !strcmp (s, "[0-4095,1000000-1999999]"),
+        "idset_encode returns original string");
+    free (s);
+    idset_destroy (idset);
+
+    idset = idset_decode ("5000-9999,0-4999");
+    ok (idset != NULL && idset->nruns == 1 && idset_count (idset) == 10000,
+        "idset_decode merges out of order adjacent ranges");
+    idset_destroy (idset);
+}
+
 void test_copy (void)
 {
     struct idset *idset;
@@ -759,6 +1028,17 @@ int main (int argc, char *argv[])
     test_range_clear ();
     test_equal ();
     test_copy ();
+    test_setops (0, 0);
+    test_setops (IDSET_FLAG_RUNS, 0);
+    test_setops (0, IDSET_FLAG_RUNS);
+    test_setops (IDSET_FLAG_RUNS, IDSET_FLAG_RUNS);
+    test_setops_badparam ();
+    test_setops_size (0);
+    test_setops_size (IDSET_FLAG_RUNS);
+    test_count_range (0);
+    test_count_range (IDSET_FLAG_RUNS);
+    test_runs ();
+    test_runs_decode ();
     test_autogrow ();
     test_format_first ();
     test_format_map ();
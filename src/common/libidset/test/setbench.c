@@ -0,0 +1,198 @@
+/************************************************************\
+ * Copyright 2026 Lawrence Livermore National Security, LLC
+ * (c.f. AUTHORS, NOTICE.LLNS, COPYING)
+ *
+ * This file is part of the Flux resource manager framework.
+ * For details, see https://github.com/flux-framework.
+ *
+ * SPDX-License-Identifier: LGPL-3.0
+\************************************************************/
+
+/* setbench - compare idset set operations with per-id iteration
+ *
+ * Usage: setbench [nids] [repeat]
+ *
+ * Two idsets of 'nids' ids (default 100000) are created: one containing
+ * alternating blocks of BLOCKSIZE ids, the other a contiguous range
+ * overlapping half of it.
+ * Each operation is run 'repeat' times (default 10) using the idset
+ * set operations and an equivalent idset_first/idset_next loop, and the
+ * mean time of each is reported in milliseconds.  This is repeated for
+ * bitmap and run-length (IDSET_FLAG_RUNS) storage.
+ */
+
+#if HAVE_CONFIG_H
+#include "config.h"
+#endif
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "src/common/libidset/idset.h"
+#include "src/common/libutil/monotime.h"
+#include "src/common/libutil/log.h"
+
+#define BLOCKSIZE 16
+
+static int loop_add (struct idset *set1, const struct idset *set2)
+{
+    unsigned int id = idset_first (set2);
+    while (id != IDSET_INVALID_ID) {
+        if (idset_set (set1, id) < 0)
+            return -1;
+        id = idset_next (set2, id);
+    }
+    return 0;
+}
+
+static int loop_subtract (struct idset *set1, const struct idset *set2)
+{
+    unsigned int id = idset_first (set2);
+    while (id != IDSET_INVALID_ID) {
+        if (idset_clear (set1, id) < 0)
+            return -1;
+        id = idset_next (set2, id);
+    }
+    return 0;
+}
+
+static bool loop_has_intersection (const struct idset *set1,
+                                   const struct idset *set2)
+{
+    unsigned int id = idset_first (set1);
+    while (id != IDSET_INVALID_ID) {
+        if (idset_test (set2, id))
+            return true;
+        id = idset_next (set1, id);
+    }
+    return false;
+}
+
+static size_t loop_count_range (const struct idset *set,
+                                unsigned int lo,
+                                unsigned int hi)
+{
+    size_t count = 0;
+    unsigned int id = idset_first (set);
+    while (id != IDSET_INVALID_ID && id <= hi) {
+        if (id >= lo)
+            count++;
+        id = idset_next (set, id);
+    }
+    return count;
+}
+
+enum op { OP_ADD, OP_SUBTRACT, OP_HAS_INTERSECTION, OP_COUNT_RANGE };
+
+static const char *opname[] = {
+    "add", "subtract", "has_intersection", "count_range",
+};
+
+static double bench (enum op op,
+                     bool loop,
+                     const struct idset *set1,
+                     const struct idset *set2,
+                     int repeat)
+{
+    struct timespec t0;
+    double total = 0.;
+    int i;
+
+    for (i = 0; i < repeat; i++) {
+        struct idset *cpy;
+        unsigned int last = idset_last (set2);
+
+        if (!(cpy = idset_copy (set1)))
+            log_err_exit ("idset_copy");
+        monotime (&t0);
+        switch (op) {
+            case OP_ADD:
+                if ((loop ? loop_add (cpy, set2) : idset_add (cpy, set2)) < 0)
+                    log_err_exit ("add");
+                break;
+            case OP_SUBTRACT:
+                if ((loop ? loop_subtract (cpy, set2)
+                          : idset_subtract (cpy, set2)) < 0)
+                    log_err_exit ("subtract");
+                break;
+            case OP_HAS_INTERSECTION:
+                if (loop ? loop_has_intersection (cpy, set2)
+                         : idset_has_intersection (cpy, set2))
+                    log_msg_exit ("has_intersection: unexpected result");
+                break;
+            case OP_COUNT_RANGE:
+                if ((loop ? loop_count_range (cpy, last / 2, last)
+                          : idset_count_range (cpy, last / 2, last)) == 0)
+                    log_msg_exit ("count_range: unexpected result");
+                break;
+        }
+        total += monotime_since (t0);
+        idset_destroy (cpy);
+    }
+    return total / repeat;
+}
+
+static void run_benchmarks (unsigned int nids, int repeat, int flags)
+{
+    struct idset *set1;
+    struct idset *set2;
+    struct idset *set3;
+    unsigned int id;
+    int op;
+
+    flags |= IDSET_FLAG_AUTOGROW;
+    if (!(set1 = idset_create (0, flags))
+        || !(set2 = idset_create (0, flags))
+        || !(set3 = idset_create (0, flags)))
+        log_err_exit ("idset_create");
+    for (id = 0; id < nids * 2; id++) {
+        struct idset *set = (id / BLOCKSIZE) % 2 == 0 ? set1 : set3;
+        if (idset_set (set, id) < 0)
+            log_err_exit ("idset_set");
+    }
+    if (idset_range_set (set2, nids, nids * 2 - 1) < 0)
+        log_err_exit ("idset_range_set");
+
+    printf ("%-20s %12s %12s\n",
+            (flags & IDSET_FLAG_RUNS) ? "operation (runs)" : "operation",
+            "loop (ms)",
+            "setop (ms)");
+    for (op = OP_ADD; op <= OP_COUNT_RANGE; op++) {
+        /* Disjoint sets are used for has_intersection, so that the
+         * entire set must be searched.
+         */
+        const struct idset *other = op == OP_HAS_INTERSECTION ? set3 : set2;
+
+        printf ("%-20s %12.3f %12.3f\n",
+                opname[op],
+                bench (op, true, set1, other, repeat),
+                bench (op, false, set1, other, repeat));
+    }
+
+    idset_destroy (set1);
+    idset_destroy (set2);
+    idset_destroy (set3);
+}
+
+int main (int argc, char *argv[])
+{
+    unsigned int nids = 100000;
+    int repeat = 10;
+
+    log_init ("setbench");
+
+    if (argc > 1)
+        nids = strtoul (argv[1], NULL, 10);
+    if (argc > 2)
+        repeat = strtoul (argv[2], NULL, 10);
+    if (nids == 0 || repeat <= 0)
+        log_msg_exit ("Usage: setbench [nids] [repeat]");
+
+    run_benchmarks (nids, repeat, 0);
+    run_benchmarks (nids, repeat, IDSET_FLAG_RUNS);
+    return 0;
+}
+
+/*
+ * vi:tabstop=4 shiftwidth=4 expandtab
+ */
@@ -20,18 +20,26 @@
 
 flux_future_t *flux_kvs_namespace_create (flux_t *h, const char *ns,
                                           uint32_t owner, int flags)
+{
+    return flux_kvs_namespace_create_rank (h, ns, owner, 0, flags);
+}
+
+flux_future_t *flux_kvs_namespace_create_rank (flux_t *h, const char *ns,
+                                               uint32_t owner, uint32_t rank,
+                                               int flags)
 {
     if (!ns || flags) {
         errno = EINVAL;
         return NULL;
     }
 
-    /* N.B. owner cast to int */
+    /* N.B. owner and rank cast to int */
     return flux_rpc_pack (h, "kvs.namespace-create", 0, 0,
-                          "{ s:s s:i s:i }",
+                          "{ s:s s:i s:i s:i }",
                           "namespace", ns,
                           "owner", owner,
-                          "flags", flags);
+                          "flags", flags,
+                          "rank", rank);
 }
 
 flux_future_t *flux_kvs_namespace_remove (flux_t *h, const char *ns)
@@ -42,6 +42,11 @@ enum kvs_op {
  * - namespace create only creates the namespace on rank 0.  Other
  *   ranks initialize against that namespace the first time they use
  *   it.
+ * - commits and fences to a namespace are applied on its leader rank,
+ *   rank 0 unless the namespace was created with
+ *   flux_kvs_namespace_create_rank().  A namespace used mostly by a
+ *   subset of ranks, such as a job's, may be led by one of them to
+ *   take load off rank 0.
  * - namespace remove marks the namespace for removal on all ranks.
  *   Garbage collection will happen in the background and the
  *   namespace will official be removed.  The removal is "eventually
@@ -49,6 +54,9 @@ enum kvs_op {
  */
 flux_future_t *flux_kvs_namespace_create (flux_t *h, const char *ns,
                                           uint32_t owner, int flags);
+flux_future_t *flux_kvs_namespace_create_rank (flux_t *h, const char *ns,
+                                               uint32_t owner, uint32_t rank,
+                                               int flags);
 flux_future_t *flux_kvs_namespace_remove (flux_t *h, const char *ns);
 
 /* Synchronization:
@@ -27,6 +27,11 @@ void errors (void)
     ok (flux_kvs_namespace_create (NULL, NULL, 0, 5) == NULL && errno == EINVAL,
         "flux_kvs_namespace_create fails on bad input");
 
+    errno = 0;
+    ok (flux_kvs_namespace_create_rank (NULL, NULL, 0, 1, 0) == NULL
+        && errno == EINVAL,
+        "flux_kvs_namespace_create_rank fails on bad input");
+
     errno = 0;
     ok (flux_kvs_namespace_remove (NULL, NULL) == NULL && errno == EINVAL,
         "flux_kvs_namespace_remove fails on bad input");
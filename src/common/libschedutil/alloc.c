@@ -11,6 +11,7 @@
 #if HAVE_CONFIG_H
 #include "config.h"
 #endif
+#include <czmq.h>
 #include <flux/core.h>
 #include <jansson.h>
 
@@ -91,17 +92,32 @@ int schedutil_alloc_respond_cancel (schedutil_t *util, const flux_msg_t *msg)
                                     NULL, NULL);
 }
 
+/* R for successful allocations is written to the KVS in batches.
+ * Puts from consecutive alloc responses are gathered into a shared
+ * transaction, which is committed when ALLOC_BATCH_TIMEOUT expires or
+ * ALLOC_BATCH_MAX allocations have been added. Responses for all jobs
+ * in a batch are sent, in order, once its commit completes.
+ */
+#define ALLOC_BATCH_TIMEOUT 0.01
+#define ALLOC_BATCH_MAX 1024
+
 struct alloc {
     json_t *annotations;
     const flux_msg_t *msg;
+};
+
+struct alloc_batch {
+    schedutil_t *util;
     flux_kvs_txn_t *txn;
+    zlistx_t *allocs;
+    flux_future_t *f;
+    void *handle;           /* entry in util->alloc_batches */
 };
 
 static void alloc_destroy (struct alloc *ctx)
 {
     if (ctx) {
         int saved_errno = errno;
-        flux_kvs_txn_destroy (ctx->txn);
         flux_msg_decref (ctx->msg);
         json_decref (ctx->annotations);
         free (ctx);
@@ -109,19 +125,19 @@ static void alloc_destroy (struct alloc *ctx)
     }
 }
 
-static struct alloc *alloc_create (const flux_msg_t *msg, const char *R,
+static void alloc_destructor (void **item)
+{
+    if (item) {
+        alloc_destroy (*item);
+        *item = NULL;
+    }
+}
+
+static struct alloc *alloc_create (const flux_msg_t *msg,
                                    const char *fmt, va_list ap)
 {
     struct alloc *ctx;
-    flux_jobid_t id;
-    char key[64];
 
-    if (flux_request_unpack (msg, NULL, "{s:I}", "id", &id) < 0)
-        return NULL;
-    if (flux_job_kvs_key (key, sizeof (key), id, "R") < 0) {
-        errno = EINVAL;
-        return NULL;
-    }
     if (!(ctx = calloc (1, sizeof (*ctx))))
         return NULL;
     ctx->msg = flux_msg_incref (msg);
@@ -129,38 +145,113 @@ static struct alloc *alloc_create (const flux_msg_t *msg, const char *R,
         if (!(ctx->annotations = json_vpack_ex (NULL, 0, fmt, ap)))
             goto error;
     }
-    if (!(ctx->txn = flux_kvs_txn_create ()))
-        goto error;
-    if (flux_kvs_txn_put (ctx->txn, 0, key, R) < 0)
-        goto error;
     return ctx;
 error:
     alloc_destroy (ctx);
     return NULL;
 }
 
+static void alloc_batch_destroy (struct alloc_batch *b)
+{
+    if (b) {
+        int saved_errno = errno;
+        flux_future_destroy (b->f);
+        zlistx_destroy (&b->allocs);
+        flux_kvs_txn_destroy (b->txn);
+        free (b);
+        errno = saved_errno;
+    }
+}
+
+static struct alloc_batch *alloc_batch_create (schedutil_t *util)
+{
+    struct alloc_batch *b;
+
+    if (!(b = calloc (1, sizeof (*b))))
+        return NULL;
+    b->util = util;
+    if (!(b->txn = flux_kvs_txn_create ()))
+        goto error;
+    if (!(b->allocs = zlistx_new ())) {
+        errno = ENOMEM;
+        goto error;
+    }
+    zlistx_set_destructor (b->allocs, alloc_destructor);
+    return b;
+error:
+    alloc_batch_destroy (b);
+    return NULL;
+}
+
+/* Batch commit has completed. Respond to each alloc request in the batch.
+ * On error, leave the batch on util->alloc_batches so that its requests
+ * receive ENOSYS when schedutil is destroyed.
+ */
 static void alloc_continuation (flux_future_t *f, void *arg)
 {
-    schedutil_t *util = arg;
+    struct alloc_batch *b = arg;
+    schedutil_t *util = b->util;
     flux_t *h = util->h;
-    struct alloc *ctx = flux_future_aux_get (f, "flux::alloc_ctx");
+    struct alloc *ctx;
 
     if (flux_future_get (f, NULL) < 0) {
         flux_log_error (h, "commit R");
         goto error;
     }
-    schedutil_remove_outstanding_future (util, f);
-    if (schedutil_alloc_respond (h, ctx->msg, FLUX_SCHED_ALLOC_SUCCESS,
-                                 NULL, ctx->annotations) < 0) {
-        flux_log_error (h, "alloc response");
+    zlistx_detach (util->alloc_batches, b->handle);
+    ctx = zlistx_first (b->allocs);
+    while (ctx) {
+        if (schedutil_alloc_respond (h, ctx->msg, FLUX_SCHED_ALLOC_SUCCESS,
+                                     NULL, ctx->annotations) < 0) {
+            flux_log_error (h, "alloc response");
+            flux_reactor_stop_error (flux_get_reactor (h)); // XXX
+        }
+        ctx = zlistx_next (b->allocs);
+    }
+    alloc_batch_destroy (b);
+    return;
+error:
+    flux_reactor_stop_error (flux_get_reactor (h)); // XXX
+}
+
+/* Close the current batch, if any, and commit it.
+ */
+static void alloc_batch_commit (schedutil_t *util)
+{
+    struct alloc_batch *b = util->alloc_batch;
+    flux_t *h = util->h;
+
+    flux_watcher_stop (util->alloc_batch_timer);
+    if (!b)
+        return;
+    util->alloc_batch = NULL;
+    if (!(b->handle = zlistx_add_end (util->alloc_batches, b))) {
+        errno = ENOMEM;
+        goto error_destroy;
+    }
+    if (!(b->f = flux_kvs_commit (h, NULL, 0, b->txn)))
         goto error;
+    if (!schedutil_hang_responses (util)) {
+        if (flux_future_then (b->f, -1, alloc_continuation, b) < 0)
+            goto error;
     }
-    flux_future_destroy (f);
+    /* else: intentionally do not register a continuation to force
+     * a permanent outstanding request for testing
+     */
     return;
+error_destroy:
+    alloc_batch_destroy (b);
 error:
+    flux_log_error (h, "commit R");
     flux_reactor_stop_error (flux_get_reactor (h)); // XXX
-    alloc_destroy (ctx);
-    flux_future_destroy (f);
+}
+
+static void alloc_batch_timer_cb (flux_reactor_t *r,
+                                  flux_watcher_t *w,
+                                  int revents,
+                                  void *arg)
+{
+    alloc_batch_commit (arg);
 }
 
 int schedutil_alloc_respond_success_pack (schedutil_t *util,
@@ -169,36 +260,101 @@ int schedutil_alloc_respond_success_pack (schedutil_t *util,
                                           const char *fmt, ...)
 {
     struct alloc *ctx;
-    flux_future_t *f;
-    flux_t *h = util->h;
+    struct alloc_batch *b;
+    flux_jobid_t id;
+    char key[64];
+    void *handle;
     va_list ap;
 
+    if (flux_request_unpack (msg, NULL, "{s:I}", "id", &id) < 0)
+        return -1;
+    if (flux_job_kvs_key (key, sizeof (key), id, "R") < 0) {
+        errno = EINVAL;
+        return -1;
+    }
+    if (!(b = util->alloc_batch)) {
+        if (!(b = alloc_batch_create (util)))
+            return -1;
+        util->alloc_batch = b;
+        flux_timer_watcher_reset (util->alloc_batch_timer,
+                                  ALLOC_BATCH_TIMEOUT,
+                                  0.);
+        flux_watcher_start (util->alloc_batch_timer);
+    }
     va_start (ap, fmt);
-    ctx = alloc_create (msg, R, fmt, ap);
+    ctx = alloc_create (msg, fmt, ap);
     va_end (ap);
     if (!ctx)
         return -1;
-    if (!(f = flux_kvs_commit (h, NULL, 0, ctx->txn)))
-        goto error;
-    if (flux_future_aux_set (f, "flux::alloc_ctx",
-                             ctx, (flux_free_f)alloc_destroy) < 0) {
-        goto error;
+    if (!(handle = zlistx_add_end (b->allocs, ctx))) {
+        alloc_destroy (ctx);
+        errno = ENOMEM;
+        return -1;
     }
-    if (flux_future_then (f, -1, alloc_continuation, ctx) < 0)
-        goto error;
-    if (!schedutil_hang_responses (util)) {
-        if (flux_future_then (f, -1, alloc_continuation, util) < 0)
-            goto error;
+    if (flux_kvs_txn_put (b->txn, 0, key, R) < 0) {
+        int saved_errno = errno;
+        zlistx_delete (b->allocs, handle);
+        errno = saved_errno;
+        return -1;
     }
-    /* else: intentionally do not register a continuation to force
-     * a permanent outstanding request for testing
-     */
-    schedutil_add_outstanding_future (util, f);
+    if (zlistx_size (b->allocs) >= ALLOC_BATCH_MAX)
+        alloc_batch_commit (util);
     return 0;
-error:
-    alloc_destroy (ctx);
-    flux_future_destroy (f);
-    return -1;
+}
+
+int schedutil_alloc_batch_init (schedutil_t *util)
+{
+    flux_reactor_t *r = flux_get_reactor (util->h);
+
+    if (!(util->alloc_batches = zlistx_new ())) {
+        errno = ENOMEM;
+        return -1;
+    }
+    if (!(util->alloc_batch_timer = flux_timer_watcher_create (r,
+                                                    ALLOC_BATCH_TIMEOUT,
+                                                    0.,
+                                                    alloc_batch_timer_cb,
+                                                    util)))
+        return -1;
+    return 0;
+}
+
+static void alloc_batch_respond_enosys (schedutil_t *util,
+                                        struct alloc_batch *b)
+{
+    struct alloc *ctx = zlistx_first (b->allocs);
+    while (ctx) {
+        if (flux_respond_error (util->h,
+                                ctx->msg,
+                                ENOSYS,
+                                "automatic ENOSYS response "
+                                "from schedutil") < 0)
+            flux_log (util->h,
+                      LOG_ERR,
+                      "schedutil: error in responding to "
+                      "outstanding messages");
+        ctx = zlistx_next (b->allocs);
+    }
+}
+
+void schedutil_alloc_batch_destroy (schedutil_t *util)
+{
+    struct alloc_batch *b;
+
+    if (util->alloc_batch) {
+        alloc_batch_respond_enosys (util, util->alloc_batch);
+        alloc_batch_destroy (util->alloc_batch);
+        util->alloc_batch = NULL;
+    }
+    if (util->alloc_batches) {
+        while ((b = zlistx_detach (util->alloc_batches, NULL))) {
+            alloc_batch_respond_enosys (util, b);
+            alloc_batch_destroy (b);
+        }
+        zlistx_destroy (&util->alloc_batches);
+    }
+    flux_watcher_destroy (util->alloc_batch_timer);
+    util->alloc_batch_timer = NULL;
 }
 
 /*
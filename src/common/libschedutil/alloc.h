@@ -50,6 +50,8 @@ int schedutil_alloc_respond_deny (schedutil_t *util, const flux_msg_t *msg,
 
 /* Respond to alloc request message - success, allocate R.
  * R is committed to the KVS first, then the response is sent.
+ * Commits of R for consecutive calls are batched, so the response may be
+ * delayed briefly after this function returns.
  * If something goes wrong after this function returns, the reactor is stopped.
  */
 int schedutil_alloc_respond_success_pack (schedutil_t *util,
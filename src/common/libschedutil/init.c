@@ -51,6 +51,8 @@ schedutil_t *schedutil_create (flux_t *h,
     if (!(util->outstanding_futures = zlistx_new ())
         || !(util->alloc_queue = zlistx_new ()))
         goto error;
+    if (schedutil_alloc_batch_init (util) < 0)
+        goto error;
     if (schedutil_ops_register (util) < 0)
         goto error;
 
@@ -92,6 +94,7 @@ void schedutil_destroy (schedutil_t *util)
     if (util) {
         int saved_errno = errno;
         respond_to_outstanding_msgs (util);
+        schedutil_alloc_batch_destroy (util);
         zlistx_destroy (&util->outstanding_futures);
         zlistx_destroy (&util->alloc_queue);
         schedutil_ops_unregister (util);
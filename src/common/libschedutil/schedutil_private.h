@@ -26,6 +26,9 @@ struct schedutil_ctx {
     void *cb_arg;
     zlistx_t *outstanding_futures;
     zlistx_t *alloc_queue;
+    struct alloc_batch *alloc_batch;     /* open batch of R commits */
+    flux_watcher_t *alloc_batch_timer;
+    zlistx_t *alloc_batches;             /* batches being committed */
 };
 
 /*
@@ -47,6 +50,13 @@ int schedutil_enqueue_alloc (schedutil_t *util, flux_future_t *f);
 flux_future_t *schedutil_peek_alloc (schedutil_t *util);
 int schedutil_dequeue_alloc (schedutil_t *util);
 
+/* Set up and tear down batching of R commits for alloc responses.
+ *  Any alloc requests still waiting on a batch commit at teardown are
+ *  answered with ENOSYS.
+ */
+int schedutil_alloc_batch_init (schedutil_t *util);
+void schedutil_alloc_batch_destroy (schedutil_t *util);
+
 /* (Un-)register callbacks for alloc, free, cancel.
  */
 int schedutil_ops_register (schedutil_t *util);
@@ -0,0 +1,115 @@
+/************************************************************\
+ * Copyright 2026 Lawrence Livermore National Security, LLC
+ * (c.f. AUTHORS, NOTICE.LLNS, COPYING)
+ *
+ * This file is part of the Flux resource manager framework.
+ * For details, see https://github.com/flux-framework.
+ *
+ * SPDX-License-Identifier: LGPL-3.0
+\************************************************************/
+
+#if HAVE_CONFIG_H
+# include "config.h"
+#endif
+
+#include <sys/types.h>
+#include <arpa/inet.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+
+#include "ioframe.h"
+
+bool ioframe_is_frame (const void *buf, int len)
+{
+    return (buf && len >= IOFRAME_HDRSIZE
+            && ((const unsigned char *)buf)[0] == IOFRAME_MAGIC);
+}
+
+void *ioframe_encode (const char *stream,
+                      int rank,
+                      pid_t pid,
+                      const void *data,
+                      int len,
+                      bool eof,
+                      int *framelen)
+{
+    unsigned char *frame;
+    size_t namelen;
+    size_t size;
+    uint32_t n;
+
+    if (!stream || !framelen || len < 0 || (len > 0 && !data)) {
+        errno = EINVAL;
+        return NULL;
+    }
+    namelen = strlen (stream) + 1;
+    size = IOFRAME_HDRSIZE + namelen + len;
+    if (size > INT32_MAX) {
+        errno = EOVERFLOW;
+        return NULL;
+    }
+    if (!(frame = malloc (size)))
+        return NULL;
+    frame[0] = IOFRAME_MAGIC;
+    frame[1] = eof ? IOFRAME_EOF : 0;
+    n = htonl ((uint32_t)rank);
+    memcpy (frame + 2, &n, sizeof (n));
+    n = htonl ((uint32_t)pid);
+    memcpy (frame + 6, &n, sizeof (n));
+    memcpy (frame + IOFRAME_HDRSIZE, stream, namelen);
+    if (len > 0)
+        memcpy (frame + IOFRAME_HDRSIZE + namelen, data, len);
+    *framelen = size;
+    return frame;
+}
+
+int ioframe_decode (const void *frame,
+                    int framelen,
+                    const char **stream,
+                    int *rank,
+                    pid_t *pid,
+                    const void **data,
+                    int *len,
+                    bool *eof)
+{
+    const unsigned char *buf = frame;
+    const unsigned char *name;
+    const unsigned char *end;
+    uint32_t n;
+
+    if (!ioframe_is_frame (frame, framelen)
+        || (buf[1] & ~IOFRAME_EOF) != 0) {
+        errno = EPROTO;
+        return -1;
+    }
+    name = buf + IOFRAME_HDRSIZE;
+    if (!(end = memchr (name, '\0', framelen - IOFRAME_HDRSIZE))
+        || end == name) {
+        errno = EPROTO;
+        return -1;
+    }
+    end++;
+    if (stream)
+        *stream = (const char *)name;
+    if (rank) {
+        memcpy (&n, buf + 2, sizeof (n));
+        *rank = ntohl (n);
+    }
+    if (pid) {
+        memcpy (&n, buf + 6, sizeof (n));
+        *pid = ntohl (n);
+    }
+    if (data)
+        *data = end < buf + framelen ? end : NULL;
+    if (len)
+        *len = framelen - (end - buf);
+    if (eof)
+        *eof = (buf[1] & IOFRAME_EOF) ? true : false;
+    return 0;
+}
+
+/*
+ * vi: ts=4 sw=4 expandtab
+ */
@@ -0,0 +1,68 @@
+/************************************************************\
+ * Copyright 2026 Lawrence Livermore National Security, LLC
+ * (c.f. AUTHORS, NOTICE.LLNS, COPYING)
+ *
+ * This file is part of the Flux resource manager framework.
+ * For details, see https://github.com/flux-framework.
+ *
+ * SPDX-License-Identifier: LGPL-3.0
+\************************************************************/
+
+#ifndef _SUBPROCESS_IOFRAME_H
+#define _SUBPROCESS_IOFRAME_H
+
+#include <sys/types.h>
+#include <stdbool.h>
+
+/* Binary framing of remote subprocess I/O, sent as a raw message payload
+ * in place of a JSON ioencode() object:
+ *
+ *   byte 0      IOFRAME_MAGIC (a JSON payload cannot begin with this)
+ *   byte 1      flags (IOFRAME_EOF)
+ *   bytes 2-5   rank, network byte order
+ *   bytes 6-9   pid, network byte order
+ *   stream name, NUL terminated
+ *   data (remainder of frame, may be empty)
+ */
+
+#define IOFRAME_MAGIC   0x01
+#define IOFRAME_HDRSIZE 10
+
+enum {
+    IOFRAME_EOF = 1,
+};
+
+/* Return true if 'buf' of length 'len' begins with IOFRAME_MAGIC.
+ */
+bool ioframe_is_frame (const void *buf, int len);
+
+/* Encode a frame in a newly allocated buffer, which the caller must free.
+ * 'data' may be NULL if 'len' is 0.  The frame length is returned in
+ * 'framelen'.  Returns NULL with errno set on failure.
+ */
+void *ioframe_encode (const char *stream,
+                      int rank,
+                      pid_t pid,
+                      const void *data,
+                      int len,
+                      bool eof,
+                      int *framelen);
+
+/* Decode a frame.  'stream' and 'data' point into 'frame'.  Any output
+ * parameter may be NULL.  Returns 0 on success, -1 with errno = EPROTO
+ * if the frame is malformed.
+ */
+int ioframe_decode (const void *frame,
+                    int framelen,
+                    const char **stream,
+                    int *rank,
+                    pid_t *pid,
+                    const void **data,
+                    int *len,
+                    bool *eof);
+
+#endif /* !_SUBPROCESS_IOFRAME_H */
+
+/*
+ * vi: ts=4 sw=4 expandtab
+ */
@@ -30,6 +30,7 @@
 #include "subprocess.h"
 #include "subprocess_private.h"
 #include "command.h"
+#include "ioframe.h"
 #include "remote.h"
 #include "util.h"
 
@@ -160,62 +161,51 @@ static void remote_in_prep_cb (flux_reactor_t *r,
         flux_watcher_start (c->in_idle_w);
 }
 
-static int remote_write (struct subprocess_channel *c)
+static int remote_send_frame (struct subprocess_channel *c,
+                              const void *data,
+                              int len,
+                              bool eof)
 {
     flux_future_t *f = NULL;
-    json_t *io = NULL;
-    const void *ptr;
-    int lenp;
-    bool eof = false;
+    void *frame;
+    int framelen;
     int rv = -1;
 
-    if (!(ptr = flux_buffer_read (c->write_buffer, -1, &lenp))) {
-        flux_log_error (c->p->h, "flux_buffer_read");
-        goto error;
-    }
-
-    assert (lenp);
-
-    /* if closed / EOF about to be sent, can attach to this RPC to
-     * avoid extra RPC */
-    if (!flux_buffer_bytes (c->write_buffer)
-        && c->closed
-        && !c->write_eof_sent)
-        eof = true;
-
     /* rank not needed, set to 0 */
-    if (!(io = ioencode (c->name, "0", ptr, lenp, eof))) {
-        flux_log_error (c->p->h, "ioencode");
-        goto error;
+    if (!(frame = ioframe_encode (c->name, 0, c->p->pid,
+                                  data, len, eof, &framelen))) {
+        flux_log_error (c->p->h, "ioframe_encode");
+        return -1;
     }
 
-    if (!(f = flux_rpc_pack (c->p->h, "cmb.rexec.write", c->p->rank,
-                             FLUX_RPC_NORESPONSE,
-                             "{ s:i s:O }",
-                             "pid", c->p->pid,
-                             "io", io))) {
-        flux_log_error (c->p->h, "flux_rpc_pack");
+    if (!(f = flux_rpc_raw (c->p->h, "cmb.rexec.write",
+                            frame, framelen,
+                            c->p->rank, FLUX_RPC_NORESPONSE))) {
+        flux_log_error (c->p->h, "flux_rpc_raw");
         goto error;
     }
 
-    if (eof)
-        c->write_eof_sent = true;
     rv = 0;
 error:
     /* no response */
     flux_future_destroy (f);
-    json_decref (io);
+    free (frame);
     return rv;
 }
 
-static int remote_close (struct subprocess_channel *c)
+/* Servers that did not acknowledge framed stdin get the JSON encoding.
+ */
+static int remote_send_json (struct subprocess_channel *c,
+                             const void *data,
+                             int len,
+                             bool eof)
 {
     flux_future_t *f = NULL;
     json_t *io = NULL;
     int rv = -1;
 
     /* rank not needed, set to 0 */
-    if (!(io = ioencode (c->name, "0", NULL, 0, true))) {
+    if (!(io = ioencode (c->name, "0", data, len, eof))) {
         flux_log_error (c->p->h, "ioencode");
         goto error;
     }
@@ -234,10 +224,52 @@ error:
     /* no response */
     flux_future_destroy (f);
     json_decref (io);
+    return rv;
+}
+
+static int remote_send (struct subprocess_channel *c,
+                        const void *data,
+                        int len,
+                        bool eof)
+{
+    if (c->p->remote_stdin_frames)
+        return remote_send_frame (c, data, len, eof);
+    return remote_send_json (c, data, len, eof);
+}
 
+static int remote_write (struct subprocess_channel *c)
+{
+    const void *ptr;
+    int lenp;
+    bool eof = false;
+
+    if (!(ptr = flux_buffer_read (c->write_buffer, -1, &lenp))) {
+        flux_log_error (c->p->h, "flux_buffer_read");
+        return -1;
+    }
+
+    assert (lenp);
+
+    /* if closed / EOF about to be sent, can attach to this RPC to
+     * avoid extra RPC */
+    if (!flux_buffer_bytes (c->write_buffer)
+        && c->closed
+        && !c->write_eof_sent)
+        eof = true;
+
+    if (remote_send (c, ptr, lenp, eof) < 0)
+        return -1;
+
+    if (eof)
+        c->write_eof_sent = true;
+    return 0;
+}
+
+static int remote_close (struct subprocess_channel *c)
+{
     /* No need to do a "channel_flush", normal io reactor will handle
      * flush of any data in read buffer */
-    return rv;
+    return remote_send (c, NULL, 0, true);
 }
 
 static void remote_in_check_cb (flux_reactor_t *r,
@@ -302,6 +334,36 @@ static void remote_out_prep_cb (flux_reactor_t *r,
         flux_watcher_start (c->out_idle_w);
 }
 
+/* Return credit for output consumed from the read buffer, so the server
+ * may send more.  Credit is returned in chunks of at least half the
+ * window to limit the number of messages.
+ */
+static int remote_credit (struct subprocess_channel *c, int consumed)
+{
+    flux_future_t *f;
+
+    if (consumed > 0)
+        c->credit_unacked += consumed;
+    if (c->read_eof_received
+        || c->credit_unacked == 0
+        || c->credit_unacked < c->credit_window / 2)
+        return 0;
+
+    if (!(f = flux_rpc_pack (c->p->h, "cmb.rexec.credit", c->p->rank,
+                             FLUX_RPC_NORESPONSE,
+                             "{ s:i s:s s:i }",
+                             "pid", c->p->pid,
+                             "stream", c->name,
+                             "credit", c->credit_unacked))) {
+        flux_log_error (c->p->h, "%s: flux_rpc_pack", __FUNCTION__);
+        return -1;
+    }
+    /* no response */
+    flux_future_destroy (f);
+    c->credit_unacked = 0;
+    return 0;
+}
+
 static void remote_out_check_cb (flux_reactor_t *r,
                                  flux_watcher_t *w,
                                  int revents,
@@ -316,7 +378,12 @@ static void remote_out_check_cb (flux_reactor_t *r,
              || (c->read_eof_received
                  && flux_buffer_bytes (c->read_buffer) > 0)))
         || (!c->line_buffered && flux_buffer_bytes (c->read_buffer) > 0)) {
+        int bytes = flux_buffer_bytes (c->read_buffer);
+
         c->output_f (c->p, c->name);
+
+        if (remote_credit (c, bytes - flux_buffer_bytes (c->read_buffer)) < 0)
+            flux_log_error (c->p->h, "remote_credit");
     }
 
     if (!flux_buffer_bytes (c->read_buffer)
@@ -411,6 +478,10 @@ static int remote_channel_setup (flux_subprocess_t *p,
             flux_log_error (p->h, "flux_buffer_create");
             goto error;
         }
+        /* The server sends no more output than fits in the read buffer
+         * until credit is returned, so the buffer cannot overflow.
+         */
+        c->credit_window = buffer_size;
         p->channels_eof_expected++;
 
         if (!(c->out_prep_w = flux_prepare_watcher_create (p->reactor,
@@ -573,32 +644,21 @@ static int remote_state (flux_subprocess_t *p, flux_future_t *f,
     return 0;
 }
 
-static int remote_output (flux_subprocess_t *p, flux_future_t *f,
-                          int rank, pid_t pid)
+static int remote_output_buffer (flux_subprocess_t *p,
+                                 const char *stream,
+                                 int rank,
+                                 pid_t pid,
+                                 const void *data,
+                                 int len,
+                                 bool eof)
 {
     struct subprocess_channel *c;
-    const char *stream = NULL;
-    char *data = NULL;
-    int len = 0;
-    bool eof = false;
-    json_t *io = NULL;
-    int rv = -1;
-
-    if (flux_rpc_get_unpack (f, "{ s:o }", "io", &io)) {
-        flux_log_error (p->h, "flux_rpc_get_unpack EPROTO io");
-        goto cleanup;
-    }
-
-    if (iodecode (io, &stream, NULL, &data, &len, &eof) < 0) {
-        flux_log_error (p->h, "iodecode");
-        goto cleanup;
-    }
 
     if (!(c = zhash_lookup (p->channels, stream))) {
         flux_log_error (p->h, "invalid channel received: rank = %d, pid = %d, stream = %s",
                  rank, pid, stream);
         errno = EPROTO;
-        goto cleanup;
+        return -1;
     }
 
     if (data && len) {
@@ -606,16 +666,16 @@ static int remote_output (flux_subprocess_t *p, flux_future_t *f,
 
         if ((tmp = flux_buffer_write (c->read_buffer, data, len)) < 0) {
             flux_log_error (p->h, "flux_buffer_write");
-            goto cleanup;
+            return -1;
         }
 
-        /* add list of msgs if there is overflow? */
+        /* server exceeded the credit granted to it */
 
         if (tmp != len) {
             flux_log_error (p->h, "channel buffer error: rank = %d pid = %d, stream = %s, len = %d",
                             rank, pid, stream, len);
             errno = EOVERFLOW;
-            goto cleanup;
+            return -1;
         }
     }
     if (eof) {
@@ -623,6 +683,31 @@ static int remote_output (flux_subprocess_t *p, flux_future_t *f,
         if (flux_buffer_readonly (c->read_buffer) < 0)
             flux_log_error (p->h, "flux_buffer_readonly");
     }
+    return 0;
+}
+
+static int remote_output (flux_subprocess_t *p, flux_future_t *f,
+                          int rank, pid_t pid)
+{
+    const char *stream = NULL;
+    char *data = NULL;
+    int len = 0;
+    bool eof = false;
+    json_t *io = NULL;
+    int rv = -1;
+
+    if (flux_rpc_get_unpack (f, "{ s:o }", "io", &io)) {
+        flux_log_error (p->h, "flux_rpc_get_unpack EPROTO io");
+        goto cleanup;
+    }
+
+    if (iodecode (io, &stream, NULL, &data, &len, &eof) < 0) {
+        flux_log_error (p->h, "iodecode");
+        goto cleanup;
+    }
+
+    if (remote_output_buffer (p, stream, rank, pid, data, len, eof) < 0)
+        goto cleanup;
 
     rv = 0;
 cleanup:
@@ -630,6 +715,26 @@ cleanup:
     return rv;
 }
 
+static int remote_output_frame (flux_subprocess_t *p,
+                                const void *frame,
+                                int framelen)
+{
+    const char *stream;
+    const void *data;
+    int len;
+    bool eof;
+    int rank;
+    pid_t pid;
+
+    if (ioframe_decode (frame, framelen,
+                        &stream, &rank, &pid,
+                        &data, &len, &eof) < 0) {
+        flux_log_error (p->h, "ioframe_decode");
+        return -1;
+    }
+    return remote_output_buffer (p, stream, rank, pid, data, len, eof);
+}
+
 static void remote_completion (flux_subprocess_t *p)
 {
     p->remote_completed = true;
@@ -645,6 +750,20 @@ static void remote_exec_cb (flux_future_t *f, void *arg)
     const char *type;
     int rank;
     pid_t pid;
+    const void *payload;
+    int payload_len;
+
+    /* output is sent as raw ioframes, everything else as JSON */
+    if (flux_rpc_get_raw (f, &payload, &payload_len) < 0) {
+        flux_log_error (p->h, "%s: flux_rpc_get_raw", __FUNCTION__);
+        goto error;
+    }
+    if (ioframe_is_frame (payload, payload_len)) {
+        if (remote_output_frame (p, payload, payload_len) < 0)
+            goto error;
+        flux_future_reset (f);
+        return;
+    }
 
     if (flux_rpc_get_unpack (f, "{ s:s s:i }",
                              "type", &type,
@@ -715,6 +834,15 @@ static void remote_continuation_cb (flux_future_t *f, void *arg)
     }
 
     if (!strcmp (type, "start")) {
+        int stdin_frames = 0;
+
+        /* older servers do not acknowledge framed stdin */
+        if (flux_rpc_get_unpack (f, "{ s?b }",
+                                 "stdin_frames", &stdin_frames) < 0) {
+            flux_log_error (p->h, "%s: flux_rpc_get_unpack", __FUNCTION__);
+            goto error;
+        }
+        p->remote_stdin_frames = stdin_frames ? true : false;
         flux_future_reset (f);
         if (flux_future_then (f, -1., remote_exec_cb, p) < 0) {
             flux_log_error (p->h, "flux_future_then");
@@ -741,10 +869,39 @@ error:
     return;
 }
 
+/* Build the initial output credit for each readable channel.
+ */
+static json_t *remote_credit_create (flux_subprocess_t *p)
+{
+    struct subprocess_channel *c;
+    json_t *credit;
+
+    if (!(credit = json_object ()))
+        goto nomem;
+    c = zhash_first (p->channels);
+    while (c) {
+        if ((c->flags & CHANNEL_READ)) {
+            json_t *o;
+            if (!(o = json_integer (c->credit_window))
+                || json_object_set_new (credit, c->name, o) < 0) {
+                json_decref (o);
+                goto nomem;
+            }
+        }
+        c = zhash_next (p->channels);
+    }
+    return credit;
+nomem:
+    json_decref (credit);
+    errno = ENOMEM;
+    return NULL;
+}
+
 int remote_exec (flux_subprocess_t *p)
 {
     flux_future_t *f = NULL;
     char *cmd_str = NULL;
+    json_t *credit = NULL;
     int save_errno;
 
     if (!(cmd_str = flux_cmd_tojson (p->cmd))) {
@@ -752,16 +909,24 @@ int remote_exec (flux_subprocess_t *p)
         goto error;
     }
 
+    if (!(credit = remote_credit_create (p))) {
+        flux_log_error (p->h, "remote_credit_create");
+        goto error;
+    }
+
     /* completion & state_change cbs always required b/c we use it
      * internally in this code.  But output callbacks are optional, we
      * don't care if user doesn't want it.
      */
     if (!(f = flux_rpc_pack (p->h, "cmb.rexec", p->rank, 0,
-                             "{s:s s:i s:i s:i}",
+                             "{s:s s:i s:i s:i s:b s:b s:O}",
                              "cmd", cmd_str,
                              "on_channel_out", p->ops.on_channel_out ? 1 : 0,
                              "on_stdout", p->ops.on_stdout ? 1 : 0,
-                             "on_stderr", p->ops.on_stderr ? 1 : 0))) {
+                             "on_stderr", p->ops.on_stderr ? 1 : 0,
+                             "raw", true,
+                             "stdin_frames", true,
+                             "credit", credit))) {
         flux_log_error (p->h, "flux_rpc");
         goto error;
     }
@@ -773,12 +938,14 @@ int remote_exec (flux_subprocess_t *p)
 
     p->f = f;
     free (cmd_str);
+    json_decref (credit);
     return 0;
 
  error:
     save_errno = errno;
     flux_future_destroy (f);
     free (cmd_str);
+    json_decref (credit);
     errno = save_errno;
     return -1;
 }
@@ -31,33 +31,84 @@
 #include "subprocess.h"
 #include "subprocess_private.h"
 #include "command.h"
+#include "ioframe.h"
 #include "remote.h"
 #include "server.h"
 #include "util.h"
 
 static const char *auxkey = "flux::rexec";
 
+/* Output flow control.  If the client grants an initial credit for a
+ * stream in the rexec request, at most that many bytes of output are sent
+ * before the client returns credit with rexec.credit.  When credit is
+ * exhausted, the stream is stopped, which stops reading from the child.
+ */
+struct rexec_credit {
+    int avail;                      // bytes that may be sent
+    bool stopped;                   // stream stopped for lack of credit
+};
+
 struct rexec {
     const flux_msg_t *msg;          // rexec request message
     flux_subprocess_server_t *s;    // server context
+    bool raw;                       // send output as ioframes
+    zhash_t *credit;                // stream name => struct rexec_credit
 };
 
 static void rexec_destroy (struct rexec *rex)
 {
     if (rex) {
         flux_msg_decref (rex->msg);
+        zhash_destroy (&rex->credit);
         ERRNO_SAFE_WRAP (free, rex);
     }
 }
 
+static int rexec_credit_init (struct rexec *rex, json_t *credit)
+{
+    const char *stream;
+    json_t *val;
+
+    if (!(rex->credit = zhash_new ())) {
+        errno = ENOMEM;
+        return -1;
+    }
+    json_object_foreach (credit, stream, val) {
+        struct rexec_credit *cr;
+
+        if (!json_is_integer (val) || json_integer_value (val) <= 0
+            || json_integer_value (val) > INT_MAX) {
+            errno = EPROTO;
+            return -1;
+        }
+        if (!(cr = calloc (1, sizeof (*cr))))
+            return -1;
+        cr->avail = json_integer_value (val);
+        if (zhash_insert (rex->credit, stream, cr) < 0) {
+            free (cr);
+            errno = EEXIST;
+            return -1;
+        }
+        zhash_freefn (rex->credit, stream, free);
+    }
+    return 0;
+}
+
 static struct rexec *rexec_create (const flux_msg_t *msg,
-                                   flux_subprocess_server_t *s)
+                                   flux_subprocess_server_t *s,
+                                   bool raw,
+                                   json_t *credit)
 {
     struct rexec *rex;
 
-    if ((rex = calloc (1, sizeof (*rex)))) {
-        rex->msg = flux_msg_incref (msg);
-        rex->s = s;
+    if (!(rex = calloc (1, sizeof (*rex))))
+        return NULL;
+    rex->msg = flux_msg_incref (msg);
+    rex->s = s;
+    rex->raw = raw;
+    if (credit && rexec_credit_init (rex, credit) < 0) {
+        rexec_destroy (rex);
+        return NULL;
     }
     return rex;
 }
@@ -229,6 +280,38 @@ error:
     internal_fatal (rex->s, p);
 }
 
+static int rexec_output_raw (flux_subprocess_t *p,
+                             const char *stream,
+                             flux_subprocess_server_t *s,
+                             const flux_msg_t *msg,
+                             const char *data,
+                             int len,
+                             bool eof)
+{
+    void *frame;
+    int framelen;
+    int rv = -1;
+
+    if (!(frame = ioframe_encode (stream,
+                                  s->rank,
+                                  flux_subprocess_pid (p),
+                                  data,
+                                  len,
+                                  eof,
+                                  &framelen))) {
+        flux_log_error (s->h, "%s: ioframe_encode", __FUNCTION__);
+        return -1;
+    }
+    if (flux_respond_raw (s->h, msg, frame, framelen) < 0) {
+        flux_log_error (s->h, "%s: flux_respond_raw", __FUNCTION__);
+        goto error;
+    }
+    rv = 0;
+error:
+    ERRNO_SAFE_WRAP (free, frame);
+    return rv;
+}
+
 static int rexec_output (flux_subprocess_t *p,
                          const char *stream,
                          flux_subprocess_server_t *s,
@@ -237,10 +320,14 @@ static int rexec_output (flux_subprocess_t *p,
                          int len,
                          bool eof)
 {
+    struct rexec *rex = flux_subprocess_aux_get (p, auxkey);
     json_t *io = NULL;
     char rankstr[64];
     int rv = -1;
 
+    if (rex && rex->raw)
+        return rexec_output_raw (p, stream, s, msg, data, len, eof);
+
     snprintf (rankstr, sizeof (rankstr), "%d", s->rank);
     if (!(io = ioencode (stream, rankstr, data, len, eof))) {
         flux_log_error (s->h, "%s: ioencode", __FUNCTION__);
@@ -262,15 +349,48 @@ error:
     return rv;
 }
 
+static int rexec_credit_stop (struct rexec *rex,
+                              flux_subprocess_t *p,
+                              const char *stream,
+                              struct rexec_credit *cr)
+{
+    if (!cr->stopped) {
+        if (flux_subprocess_stream_stop (p, stream) < 0) {
+            flux_log_error (rex->s->h, "%s: flux_subprocess_stream_stop",
+                            __FUNCTION__);
+            return -1;
+        }
+        cr->stopped = true;
+    }
+    return 0;
+}
+
 static void rexec_output_cb (flux_subprocess_t *p, const char *stream)
 {
     struct rexec *rex = flux_subprocess_aux_get (p, auxkey);
+    struct rexec_credit *cr = NULL;
     const char *ptr;
     int lenp;
+    int max = -1;
 
     assert (rex != NULL);
 
-    if (!(ptr = flux_subprocess_read (p, stream, -1, &lenp))) {
+    if (rex->credit && (cr = zhash_lookup (rex->credit, stream))) {
+        struct subprocess_channel *c = zhash_lookup (p->channels, stream);
+
+        /* EOF consumes no credit.  The stream is stopped as soon as
+         * credit runs out, so this should not normally be reached.
+         */
+        if (cr->avail == 0 && !(c && c->eof_sent_to_caller)) {
+            if (rexec_credit_stop (rex, p, stream, cr) < 0)
+                goto error;
+            return;
+        }
+        if (cr->avail > 0)
+            max = cr->avail;
+    }
+
+    if (!(ptr = flux_subprocess_read (p, stream, max, &lenp))) {
         flux_log_error (rex->s->h, "%s: flux_subprocess_read", __FUNCTION__);
         goto error;
     }
@@ -278,6 +398,11 @@ static void rexec_output_cb (flux_subprocess_t *p, const char *stream)
     if (lenp) {
         if (rexec_output (p, stream, rex->s, rex->msg, ptr, lenp, false) < 0)
             goto error;
+        if (cr) {
+            cr->avail -= lenp;
+            if (cr->avail == 0 && rexec_credit_stop (rex, p, stream, cr) < 0)
+                goto error;
+        }
     }
     else {
         if (rexec_output (p, stream, rex->s, rex->msg, NULL, 0, true) < 0)
@@ -306,14 +431,24 @@ static void server_exec_cb (flux_t *h, flux_msg_handler_t *mh,
         .on_stderr = rexec_output_cb,
     };
     int on_channel_out, on_stdout, on_stderr;
+    int raw = 0;
+    int stdin_frames = 0;
+    json_t *credit = NULL;
     char **env = NULL;
 
-    if (flux_request_unpack (msg, NULL, "{s:s s:i s:i s:i}",
+    if (flux_request_unpack (msg, NULL, "{s:s s:i s:i s:i s?b s?b s?o}",
                              "cmd", &cmd_str,
                              "on_channel_out", &on_channel_out,
                              "on_stdout", &on_stdout,
-                             "on_stderr", &on_stderr))
+                             "on_stderr", &on_stderr,
+                             "raw", &raw,
+                             "stdin_frames", &stdin_frames,
+                             "credit", &credit))
+        goto error;
+    if (credit && !json_is_object (credit)) {
+        errno = EPROTO;
         goto error;
+    }
 
     if (!on_channel_out)
         ops.on_channel_out = NULL;
@@ -349,9 +484,13 @@ static void server_exec_cb (flux_t *h, flux_msg_handler_t *mh,
     if (flux_cmd_setenvf (cmd, 1, "FLUX_URI", "%s", s->local_uri) < 0)
         goto error;
 
-    if (flux_respond_pack (s->h, msg, "{s:s s:i}",
+    /* Acknowledge framed stdin so the client knows it may send it.
+     * Clients that did not ask for it continue to send JSON.
+     */
+    if (flux_respond_pack (s->h, msg, "{s:s s:i s:b}",
                            "type", "start",
-                           "rank", s->rank) < 0) {
+                           "rank", s->rank,
+                           "stdin_frames", stdin_frames ? true : false) < 0) {
         flux_log_error (s->h, "%s: flux_respond_pack", __FUNCTION__);
         goto error;
     }
@@ -373,7 +512,7 @@ static void server_exec_cb (flux_t *h, flux_msg_handler_t *mh,
         goto cleanup;
     }
 
-    if (!(rex = rexec_create (msg, s)))
+    if (!(rex = rexec_create (msg, s, raw ? true : false, credit)))
         goto error;
     if (flux_subprocess_aux_set (p,
                                 auxkey,
@@ -435,24 +574,42 @@ static void server_write_cb (flux_t *h, flux_msg_handler_t *mh,
     flux_subprocess_t *p;
     flux_subprocess_server_t *s = arg;
     const char *stream = NULL;
+    const void *payload;
+    int payload_len;
+    const void *framedata = NULL;
     char *data = NULL;
     int len = 0;
     bool eof = false;
     pid_t pid;
     json_t *io = NULL;
 
-    if (flux_request_unpack (msg, NULL, "{ s:i s:o }",
-                             "pid", &pid,
-                             "io", &io) < 0) {
-        /* can't handle error, no pid to sent errno back to, so just
-         * return */
-        flux_log_error (s->h, "%s: flux_request_unpack", __FUNCTION__);
+    if (flux_request_decode_raw (msg, NULL, &payload, &payload_len) < 0) {
+        flux_log_error (s->h, "%s: flux_request_decode_raw", __FUNCTION__);
         return;
     }
+    if (ioframe_is_frame (payload, payload_len)) {
+        if (ioframe_decode (payload, payload_len,
+                            &stream, NULL, &pid,
+                            &framedata, &len, &eof) < 0) {
+            flux_log_error (s->h, "%s: ioframe_decode", __FUNCTION__);
+            return;
+        }
+    }
+    else {
+        if (flux_request_unpack (msg, NULL, "{ s:i s:o }",
+                                 "pid", &pid,
+                                 "io", &io) < 0) {
+            /* can't handle error, no pid to sent errno back to, so just
+             * return */
+            flux_log_error (s->h, "%s: flux_request_unpack", __FUNCTION__);
+            return;
+        }
 
-    if (iodecode (io, &stream, NULL, &data, &len, &eof) < 0) {
-        flux_log_error (s->h, "%s: iodecode", __FUNCTION__);
-        return;
+        if (iodecode (io, &stream, NULL, &data, &len, &eof) < 0) {
+            flux_log_error (s->h, "%s: iodecode", __FUNCTION__);
+            return;
+        }
+        framedata = data;
     }
 
     if (!(p = lookup_pid (s, pid))) {
@@ -474,8 +631,8 @@ static void server_write_cb (flux_t *h, flux_msg_handler_t *mh,
     if (p->state != FLUX_SUBPROCESS_RUNNING)
         goto out;
 
-    if (data && len) {
-        if (write_subprocess (s, p, stream, data, len) < 0)
+    if (framedata && len) {
+        if (write_subprocess (s, p, stream, framedata, len) < 0)
             goto error;
     }
     if (eof) {
@@ -492,6 +649,50 @@ error:
     internal_fatal (s, p);
 }
 
+/* Return output credit to a subprocess stream, restarting the stream
+ * if it was stopped for lack of credit.  No response is sent.
+ */
+static void server_credit_cb (flux_t *h, flux_msg_handler_t *mh,
+                              const flux_msg_t *msg, void *arg)
+{
+    flux_subprocess_server_t *s = arg;
+    flux_subprocess_t *p;
+    struct rexec *rex;
+    struct rexec_credit *cr;
+    const char *stream;
+    pid_t pid;
+    int credit;
+
+    if (flux_request_unpack (msg, NULL, "{ s:i s:s s:i }",
+                             "pid", &pid,
+                             "stream", &stream,
+                             "credit", &credit) < 0
+        || credit <= 0) {
+        flux_log_error (s->h, "%s: flux_request_unpack", __FUNCTION__);
+        return;
+    }
+    /* Process may have exited since credit was sent.
+     */
+    if (!(p = lookup_pid (s, pid))
+        || !(rex = flux_subprocess_aux_get (p, auxkey))
+        || !rex->credit
+        || !(cr = zhash_lookup (rex->credit, stream)))
+        return;
+    if (credit > INT_MAX - cr->avail)
+        cr->avail = INT_MAX;
+    else
+        cr->avail += credit;
+    if (cr->stopped) {
+        if (flux_subprocess_stream_start (p, stream) < 0) {
+            flux_log_error (s->h, "%s: flux_subprocess_stream_start",
+                            __FUNCTION__);
+            internal_fatal (s, p);
+            return;
+        }
+        cr->stopped = false;
+    }
+}
+
 static void server_signal_cb (flux_t *h, flux_msg_handler_t *mh,
                               const flux_msg_t *msg, void *arg)
 {
@@ -610,9 +811,10 @@ int server_start (flux_subprocess_server_t *s, const char *prefix)
         { FLUX_MSGTYPE_REQUEST, "rexec.write",  server_write_cb, 0 },
         { FLUX_MSGTYPE_REQUEST, "rexec.signal", server_signal_cb, 0 },
         { FLUX_MSGTYPE_REQUEST, "rexec.processes", server_processes_cb, 0 },
+        { FLUX_MSGTYPE_REQUEST, "rexec.credit", server_credit_cb, 0 },
         FLUX_MSGHANDLER_TABLE_END,
     };
-    char *topic_globs[4] = {NULL, NULL, NULL, NULL};
+    char *topic_globs[5] = {NULL, NULL, NULL, NULL, NULL};
     int rv = -1;
 
     assert (prefix);
@@ -625,11 +827,14 @@ int server_start (flux_subprocess_server_t *s, const char *prefix)
         goto cleanup;
     if (asprintf (&topic_globs[3], "%s.rexec.processes", prefix) < 0)
         goto cleanup;
+    if (asprintf (&topic_globs[4], "%s.rexec.credit", prefix) < 0)
+        goto cleanup;
 
     htab[0].topic_glob = (const char *)topic_globs[0];
     htab[1].topic_glob = (const char *)topic_globs[1];
     htab[2].topic_glob = (const char *)topic_globs[2];
     htab[3].topic_glob = (const char *)topic_globs[3];
+    htab[4].topic_glob = (const char *)topic_globs[4];
 
     if (flux_msg_handler_addvec (s->h, htab, s, &s->handlers) < 0)
         goto cleanup;
@@ -640,6 +845,7 @@ cleanup:
     free (topic_globs[1]);
     free (topic_globs[2]);
     free (topic_globs[3]);
+    free (topic_globs[4]);
     return rv;
 }
 
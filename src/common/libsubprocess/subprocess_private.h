@@ -60,6 +60,8 @@ struct subprocess_channel {
     flux_watcher_t *out_prep_w;
     flux_watcher_t *out_idle_w;
     flux_watcher_t *out_check_w;
+    int credit_window;          /* output credit granted at exec */
+    int credit_unacked;         /* bytes consumed, credit not yet returned */
 
     /* misc */
     bool line_buffered;         /* for buffer_read_w / read_buffer */
@@ -114,6 +116,7 @@ struct flux_subprocess {
 
     flux_future_t *f;           /* primary future reactor */
     bool remote_completed;      /* if remote has completed */
+    bool remote_stdin_frames;   /* server accepts framed stdin */
     int failed_errno;           /* Holds errno if FAILED state reached */
     int signal_pending;         /* signal sent while starting */
 };
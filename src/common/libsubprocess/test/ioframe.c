@@ -0,0 +1,131 @@
+/************************************************************\
+ * Copyright 2026 Lawrence Livermore National Security, LLC
+ * (c.f. AUTHORS, NOTICE.LLNS, COPYING)
+ *
+ * This file is part of the Flux resource manager framework.
+ * For details, see https://github.com/flux-framework.
+ *
+ * SPDX-License-Identifier: LGPL-3.0
+\************************************************************/
+
+#include <errno.h>
+#include <string.h>
+#include <stdlib.h>
+
+#include "src/common/libtap/tap.h"
+#include "src/common/libsubprocess/ioframe.h"
+
+void check_roundtrip (void)
+{
+    const char *stream;
+    int rank;
+    pid_t pid;
+    const void *data;
+    int len;
+    bool eof;
+    void *frame;
+    int framelen;
+
+    frame = ioframe_encode ("stdout", 42, 12345, "hello", 5, false, &framelen);
+    ok (frame != NULL,
+        "ioframe_encode works");
+    ok (framelen == IOFRAME_HDRSIZE + 7 + 5,
+        "frame has expected length");
+    ok (ioframe_is_frame (frame, framelen),
+        "ioframe_is_frame returns true");
+    ok (ioframe_decode (frame, framelen,
+                        &stream, &rank, &pid, &data, &len, &eof) == 0,
+        "ioframe_decode works");
+    is (stream, "stdout",
+        "stream decoded");
+    ok (rank == 42 && pid == 12345,
+        "rank and pid decoded");
+    ok (len == 5 && data != NULL && !memcmp (data, "hello", 5),
+        "data decoded");
+    ok (eof == false,
+        "eof is false");
+    free (frame);
+
+    frame = ioframe_encode ("TEST_CHANNEL", 0, 1, NULL, 0, true, &framelen);
+    ok (frame != NULL,
+        "ioframe_encode works with no data");
+    ok (ioframe_decode (frame, framelen,
+                        &stream, NULL, NULL, &data, &len, &eof) == 0,
+        "ioframe_decode works with no data");
+    is (stream, "TEST_CHANNEL",
+        "stream decoded");
+    ok (len == 0 && data == NULL,
+        "no data decoded");
+    ok (eof == true,
+        "eof is true");
+    free (frame);
+}
+
+void check_invalid (void)
+{
+    unsigned char buf[64];
+    int framelen;
+    void *frame;
+
+    errno = 0;
+    ok (ioframe_encode (NULL, 0, 0, NULL, 0, true, &framelen) == NULL
+        && errno == EINVAL,
+        "ioframe_encode stream=NULL fails with EINVAL");
+    errno = 0;
+    ok (ioframe_encode ("stdout", 0, 0, NULL, 1, false, &framelen) == NULL
+        && errno == EINVAL,
+        "ioframe_encode data=NULL len=1 fails with EINVAL");
+    errno = 0;
+    ok (ioframe_encode ("stdout", 0, 0, "x", 1, false, NULL) == NULL
+        && errno == EINVAL,
+        "ioframe_encode framelen=NULL fails with EINVAL");
+
+    ok (!ioframe_is_frame ("{\"io\":1}", 8),
+        "ioframe_is_frame returns false for JSON");
+    ok (!ioframe_is_frame (NULL, 0),
+        "ioframe_is_frame returns false for NULL");
+
+    errno = 0;
+    ok (ioframe_decode ("{}", 2, NULL, NULL, NULL, NULL, NULL, NULL) < 0
+        && errno == EPROTO,
+        "ioframe_decode short frame fails with EPROTO");
+
+    if (!(frame = ioframe_encode ("stdout", 0, 0, "x", 1, false, &framelen)))
+        BAIL_OUT ("ioframe_encode failed");
+    memcpy (buf, frame, framelen);
+    free (frame);
+
+    buf[1] = 0x80;
+    errno = 0;
+    ok (ioframe_decode (buf, framelen, NULL, NULL, NULL, NULL, NULL, NULL) < 0
+        && errno == EPROTO,
+        "ioframe_decode unknown flag fails with EPROTO");
+    buf[1] = 0;
+
+    errno = 0;
+    ok (ioframe_decode (buf, IOFRAME_HDRSIZE + 3,
+                        NULL, NULL, NULL, NULL, NULL, NULL) < 0
+        && errno == EPROTO,
+        "ioframe_decode unterminated stream fails with EPROTO");
+
+    buf[IOFRAME_HDRSIZE] = '\0';
+    errno = 0;
+    ok (ioframe_decode (buf, framelen, NULL, NULL, NULL, NULL, NULL, NULL) < 0
+        && errno == EPROTO,
+        "ioframe_decode empty stream fails with EPROTO");
+}
+
+int main (int argc, char *argv[])
+{
+    plan (NO_PLAN);
+
+    check_roundtrip ();
+    check_invalid ();
+
+    done_testing ();
+    return 0;
+}
+
+/*
+ * vi: ts=4 sw=4 expandtab
+ */
@@ -0,0 +1,324 @@
+/************************************************************\
+ * Copyright 2026 Lawrence Livermore National Security, LLC
+ * (c.f. AUTHORS, NOTICE.LLNS, COPYING)
+ *
+ * This file is part of the Flux resource manager framework.
+ * For details, see https://github.com/flux-framework.
+ *
+ * SPDX-License-Identifier: LGPL-3.0
+\************************************************************/
+
+/* blake3.c - portable BLAKE3, following the structure of the reference
+ * implementation in the BLAKE3 specification.  Input is split into 1K
+ * chunks, each hashed to a chaining value; chaining values are merged
+ * pairwise into a binary tree using a stack, as chunks complete.
+ */
+
+#if HAVE_CONFIG_H
+#include "config.h"
+#endif
+#include <string.h>
+
+#include "blake3.h"
+
+enum {
+    CHUNK_START = 1 << 0,
+    CHUNK_END = 1 << 1,
+    PARENT = 1 << 2,
+    ROOT = 1 << 3,
+};
+
+static const uint32_t IV[8] = {
+    0x6A09E667, 0xBB67AE85, 0x3C6EF372, 0xA54FF53A,
+    0x510E527F, 0x9B05688C, 0x1F83D9AB, 0x5BE0CD19,
+};
+
+static const uint8_t MSG_SCHEDULE[7][16] = {
+    {0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15},
+    {2, 6, 3, 10, 7, 0, 4, 13, 1, 11, 12, 5, 9, 14, 15, 8},
+    {3, 4, 10, 12, 13, 2, 7, 14, 6, 5, 9, 0, 11, 15, 8, 1},
+    {10, 7, 12, 9, 14, 3, 13, 15, 4, 0, 11, 2, 5, 8, 1, 6},
+    {12, 13, 9, 11, 15, 10, 14, 8, 7, 2, 5, 3, 0, 1, 6, 4},
+    {9, 14, 11, 5, 8, 12, 15, 1, 13, 3, 0, 10, 2, 6, 4, 7},
+    {11, 15, 5, 0, 1, 9, 8, 6, 14, 10, 2, 12, 3, 4, 7, 13},
+};
+
+/* Parked output of a chunk or parent node, which may become the root.
+ */
+struct output {
+    uint32_t input_cv[8];
+    uint32_t block_words[16];
+    uint64_t counter;
+    uint32_t block_len;
+    uint32_t flags;
+};
+
+static inline uint32_t rotr32 (uint32_t w, uint32_t c)
+{
+    return (w >> c) | (w << (32 - c));
+}
+
+static inline uint32_t load32 (const uint8_t *p)
+{
+    return ((uint32_t)p[0]) | ((uint32_t)p[1] << 8)
+         | ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+
+static inline void store32 (uint8_t *p, uint32_t w)
+{
+    p[0] = w;
+    p[1] = w >> 8;
+    p[2] = w >> 16;
+    p[3] = w >> 24;
+}
+
+static void words_from_block (const uint8_t block[BLAKE3_BLOCK_LEN],
+                              uint32_t words[16])
+{
+    int i;
+    for (i = 0; i < 16; i++)
+        words[i] = load32 (&block[i * 4]);
+}
+
+static inline void g (uint32_t *state,
+                      int a, int b, int c, int d,
+                      uint32_t x, uint32_t y)
+{
+    state[a] = state[a] + state[b] + x;
+    state[d] = rotr32 (state[d] ^ state[a], 16);
+    state[c] = state[c] + state[d];
+    state[b] = rotr32 (state[b] ^ state[c], 12);
+    state[a] = state[a] + state[b] + y;
+    state[d] = rotr32 (state[d] ^ state[a], 8);
+    state[c] = state[c] + state[d];
+    state[b] = rotr32 (state[b] ^ state[c], 7);
+}
+
+static inline void round_fn (uint32_t state[16],
+                             const uint32_t m[16],
+                             int r)
+{
+    const uint8_t *s = MSG_SCHEDULE[r];
+
+    /* columns */
+    g (state, 0, 4, 8, 12, m[s[0]], m[s[1]]);
+    g (state, 1, 5, 9, 13, m[s[2]], m[s[3]]);
+    g (state, 2, 6, 10, 14, m[s[4]], m[s[5]]);
+    g (state, 3, 7, 11, 15, m[s[6]], m[s[7]]);
+    /* diagonals */
+    g (state, 0, 5, 10, 15, m[s[8]], m[s[9]]);
+    g (state, 1, 6, 11, 12, m[s[10]], m[s[11]]);
+    g (state, 2, 7, 8, 13, m[s[12]], m[s[13]]);
+    g (state, 3, 4, 9, 14, m[s[14]], m[s[15]]);
+}
+
+static void compress (const uint32_t cv[8],
+                      const uint32_t block_words[16],
+                      uint64_t counter,
+                      uint32_t block_len,
+                      uint32_t flags,
+                      uint32_t out[16])
+{
+    uint32_t state[16] = {
+        cv[0], cv[1], cv[2], cv[3],
+        cv[4], cv[5], cv[6], cv[7],
+        IV[0], IV[1], IV[2], IV[3],
+        (uint32_t)counter, (uint32_t)(counter >> 32), block_len, flags,
+    };
+    int i;
+
+    for (i = 0; i < 7; i++)
+        round_fn (state, block_words, i);
+    for (i = 0; i < 8; i++) {
+        out[i] = state[i] ^ state[i + 8];
+        out[i + 8] = state[i + 8] ^ cv[i];
+    }
+}
+
+static void output_chaining_value (const struct output *o, uint32_t cv[8])
+{
+    uint32_t out[16];
+
+    compress (o->input_cv, o->block_words, o->counter,
+              o->block_len, o->flags, out);
+    memcpy (cv, out, 8 * sizeof (uint32_t));
+}
+
+static void output_root_bytes (const struct output *o,
+                               uint8_t *out,
+                               size_t out_len)
+{
+    uint64_t counter = 0;
+    uint32_t words[16];
+    int i;
+
+    while (out_len > 0) {
+        compress (o->input_cv, o->block_words, counter,
+                  o->block_len, o->flags | ROOT, words);
+        for (i = 0; i < 16 && out_len > 0; i++) {
+            uint8_t buf[4];
+            size_t n = out_len < 4 ? out_len : 4;
+
+            store32 (buf, words[i]);
+            memcpy (out, buf, n);
+            out += n;
+            out_len -= n;
+        }
+        counter++;
+    }
+}
+
+static void chunk_init (struct blake3_chunk_state *cs,
+                        const uint32_t key[8],
+                        uint64_t chunk_counter)
+{
+    memcpy (cs->cv, key, sizeof (cs->cv));
+    cs->chunk_counter = chunk_counter;
+    memset (cs->block, 0, sizeof (cs->block));
+    cs->block_len = 0;
+    cs->blocks_compressed = 0;
+    cs->flags = 0;
+}
+
+static size_t chunk_len (const struct blake3_chunk_state *cs)
+{
+    return BLAKE3_BLOCK_LEN * (size_t)cs->blocks_compressed + cs->block_len;
+}
+
+static uint32_t chunk_start_flag (const struct blake3_chunk_state *cs)
+{
+    return cs->blocks_compressed == 0 ? CHUNK_START : 0;
+}
+
+static void chunk_update (struct blake3_chunk_state *cs,
+                          const uint8_t *input,
+                          size_t len)
+{
+    uint32_t words[16];
+    uint32_t out[16];
+
+    while (len > 0) {
+        size_t take;
+
+        /* Compress a full block only when more input follows, since the
+         * last block of a chunk is compressed with CHUNK_END.
+         */
+        if (cs->block_len == BLAKE3_BLOCK_LEN) {
+            words_from_block (cs->block, words);
+            compress (cs->cv, words, cs->chunk_counter, BLAKE3_BLOCK_LEN,
+                      cs->flags | chunk_start_flag (cs), out);
+            memcpy (cs->cv, out, sizeof (cs->cv));
+            cs->blocks_compressed++;
+            memset (cs->block, 0, sizeof (cs->block));
+            cs->block_len = 0;
+        }
+        take = BLAKE3_BLOCK_LEN - cs->block_len;
+        if (take > len)
+            take = len;
+        memcpy (cs->block + cs->block_len, input, take);
+        cs->block_len += take;
+        input += take;
+        len -= take;
+    }
+}
+
+static void chunk_output (const struct blake3_chunk_state *cs,
+                          struct output *o)
+{
+    memcpy (o->input_cv, cs->cv, sizeof (o->input_cv));
+    words_from_block (cs->block, o->block_words);
+    o->counter = cs->chunk_counter;
+    o->block_len = cs->block_len;
+    o->flags = cs->flags | chunk_start_flag (cs) | CHUNK_END;
+}
+
+static void parent_output (const uint32_t left[8],
+                           const uint32_t right[8],
+                           const uint32_t key[8],
+                           struct output *o)
+{
+    memcpy (o->input_cv, key, sizeof (o->input_cv));
+    memcpy (o->block_words, left, 8 * sizeof (uint32_t));
+    memcpy (o->block_words + 8, right, 8 * sizeof (uint32_t));
+    o->counter = 0;
+    o->block_len = BLAKE3_BLOCK_LEN;
+    o->flags = PARENT;
+}
+
+/* Push the chaining value of a completed chunk onto the stack, first
+ * merging completed subtrees.  The number of trailing zero bits in the
+ * chunk count is the number of subtrees that are now complete.
+ */
+static void add_chunk_cv (blake3_hasher *self,
+                          uint32_t cv[8],
+                          uint64_t total_chunks)
+{
+    struct output o;
+
+    while ((total_chunks & 1) == 0) {
+        self->cv_stack_len--;
+        parent_output (self->cv_stack[self->cv_stack_len], cv, self->key, &o);
+        output_chaining_value (&o, cv);
+        total_chunks >>= 1;
+    }
+    memcpy (self->cv_stack[self->cv_stack_len], cv, 8 * sizeof (uint32_t));
+    self->cv_stack_len++;
+}
+
+void blake3_hasher_init (blake3_hasher *self)
+{
+    memcpy (self->key, IV, sizeof (self->key));
+    chunk_init (&self->chunk, self->key, 0);
+    self->cv_stack_len = 0;
+}
+
+void blake3_hasher_update (blake3_hasher *self, const void *input, size_t len)
+{
+    const uint8_t *in = input;
+
+    while (len > 0) {
+        size_t take;
+
+        /* Finalize a full chunk only when more input follows, since the
+         * last chunk may be the root.
+         */
+        if (chunk_len (&self->chunk) == BLAKE3_CHUNK_LEN) {
+            struct output o;
+            uint32_t cv[8];
+            uint64_t total_chunks = self->chunk.chunk_counter + 1;
+
+            chunk_output (&self->chunk, &o);
+            output_chaining_value (&o, cv);
+            add_chunk_cv (self, cv, total_chunks);
+            chunk_init (&self->chunk, self->key, total_chunks);
+        }
+        take = BLAKE3_CHUNK_LEN - chunk_len (&self->chunk);
+        if (take > len)
+            take = len;
+        chunk_update (&self->chunk, in, take);
+        in += take;
+        len -= take;
+    }
+}
+
+void blake3_hasher_finalize (const blake3_hasher *self,
+                             uint8_t *out,
+                             size_t out_len)
+{
+    struct output o;
+    int remaining = self->cv_stack_len;
+
+    chunk_output (&self->chunk, &o);
+    while (remaining > 0) {
+        uint32_t cv[8];
+
+        remaining--;
+        output_chaining_value (&o, cv);
+        parent_output (self->cv_stack[remaining], cv, self->key, &o);
+    }
+    output_root_bytes (&o, out, out_len);
+}
+
+/*
+ * vi:tabstop=4 shiftwidth=4 expandtab
+ */
@@ -0,0 +1,56 @@
+/************************************************************\
+ * Copyright 2026 Lawrence Livermore National Security, LLC
+ * (c.f. AUTHORS, NOTICE.LLNS, COPYING)
+ *
+ * This file is part of the Flux resource manager framework.
+ * For details, see https://github.com/flux-framework.
+ *
+ * SPDX-License-Identifier: LGPL-3.0
+\************************************************************/
+
+#ifndef _UTIL_BLAKE3_H
+#define _UTIL_BLAKE3_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+/* Portable BLAKE3 hash (unkeyed mode only).
+ * See https://github.com/BLAKE3-team/BLAKE3-specs
+ *
+ * There are no SIMD code paths, so this is much slower than the
+ * optimized BLAKE3 implementations, and slower than sha256 with the
+ * x86 SHA extensions (see sha_ni.h).
+ */
+
+#define BLAKE3_OUT_LEN      32
+#define BLAKE3_BLOCK_LEN    64
+#define BLAKE3_CHUNK_LEN    1024
+#define BLAKE3_MAX_DEPTH    54
+
+struct blake3_chunk_state {
+    uint32_t cv[8];
+    uint64_t chunk_counter;
+    uint8_t block[BLAKE3_BLOCK_LEN];
+    uint8_t block_len;
+    uint8_t blocks_compressed;
+    uint8_t flags;
+};
+
+typedef struct {
+    uint32_t key[8];
+    struct blake3_chunk_state chunk;
+    uint8_t cv_stack_len;
+    uint32_t cv_stack[BLAKE3_MAX_DEPTH][8];
+} blake3_hasher;
+
+void blake3_hasher_init (blake3_hasher *self);
+void blake3_hasher_update (blake3_hasher *self, const void *input, size_t len);
+void blake3_hasher_finalize (const blake3_hasher *self,
+                             uint8_t *out,
+                             size_t out_len);
+
+#endif /* !_UTIL_BLAKE3_H */
+
+/*
+ * vi:tabstop=4 shiftwidth=4 expandtab
+ */
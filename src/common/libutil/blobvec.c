@@ -0,0 +1,160 @@
+/************************************************************\
+ * Copyright 2026 Lawrence Livermore National Security, LLC
+ * (c.f. AUTHORS, NOTICE.LLNS, COPYING)
+ *
+ * This file is part of the Flux resource manager framework.
+ * For details, see https://github.com/flux-framework.
+ *
+ * SPDX-License-Identifier: LGPL-3.0
+\************************************************************/
+
+#if HAVE_CONFIG_H
+#include "config.h"
+#endif
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <limits.h>
+#include <arpa/inet.h>
+
+#include "blobvec.h"
+
+struct blobvec {
+    char *buf;
+    int len;
+    int size;
+    int count;
+};
+
+struct blobvec *blobvec_create (void)
+{
+    struct blobvec *bv;
+
+    if (!(bv = calloc (1, sizeof (*bv)))) {
+        errno = ENOMEM;
+        return NULL;
+    }
+    return bv;
+}
+
+void blobvec_destroy (struct blobvec *bv)
+{
+    if (bv) {
+        int saved_errno = errno;
+        free (bv->buf);
+        free (bv);
+        errno = saved_errno;
+    }
+}
+
+static int blobvec_reserve (struct blobvec *bv, int need)
+{
+    char *nbuf;
+    int nsize;
+
+    if (need > INT_MAX - bv->len) {
+        errno = EOVERFLOW;
+        return -1;
+    }
+    if (bv->len + need <= bv->size)
+        return 0;
+    nsize = bv->size ? bv->size : 4096;
+    while (nsize < bv->len + need)
+        nsize = nsize > INT_MAX / 2 ? INT_MAX : nsize * 2;
+    if (!(nbuf = realloc (bv->buf, nsize))) {
+        errno = ENOMEM;
+        return -1;
+    }
+    bv->buf = nbuf;
+    bv->size = nsize;
+    return 0;
+}
+
+int blobvec_append (struct blobvec *bv,
+                    uint32_t index,
+                    int errnum,
+                    const void *data,
+                    int len)
+{
+    uint32_t hdr[2];
+
+    if (!bv || errnum < 0 || (!errnum && (len < 0 || (len > 0 && !data)))) {
+        errno = EINVAL;
+        return -1;
+    }
+    if (errnum)
+        len = 0;
+    if (len > INT_MAX - BLOBVEC_HDRSIZE) {
+        errno = EOVERFLOW;
+        return -1;
+    }
+    if (blobvec_reserve (bv, BLOBVEC_HDRSIZE + len) < 0)
+        return -1;
+    hdr[0] = htonl (index);
+    hdr[1] = htonl (errnum ? (uint32_t)-errnum : (uint32_t)len);
+    memcpy (bv->buf + bv->len, hdr, BLOBVEC_HDRSIZE);
+    if (len > 0)
+        memcpy (bv->buf + bv->len + BLOBVEC_HDRSIZE, data, len);
+    bv->len += BLOBVEC_HDRSIZE + len;
+    bv->count++;
+    return 0;
+}
+
+const void *blobvec_data (struct blobvec *bv, int *len)
+{
+    if (!bv) {
+        errno = EINVAL;
+        return NULL;
+    }
+    if (len)
+        *len = bv->len;
+    return bv->buf;
+}
+
+int blobvec_count (struct blobvec *bv)
+{
+    return bv ? bv->count : 0;
+}
+
+int blobvec_decode (const void *buf,
+                    int len,
+                    int *cursor,
+                    uint32_t *index,
+                    int *errnum,
+                    const void **data,
+                    int *datalen)
+{
+    const char *p = buf;
+    uint32_t hdr[2];
+    int32_t status;
+
+    if (!cursor || *cursor < 0 || len < 0 || (len > 0 && !buf)) {
+        errno = EINVAL;
+        return -1;
+    }
+    if (*cursor == len)
+        return 0;
+    if (len - *cursor < BLOBVEC_HDRSIZE)
+        goto proto;
+    memcpy (hdr, p + *cursor, BLOBVEC_HDRSIZE);
+    status = (int32_t)ntohl (hdr[1]);
+    if (status == INT32_MIN || status > len - *cursor - BLOBVEC_HDRSIZE)
+        goto proto;
+    if (index)
+        *index = ntohl (hdr[0]);
+    if (errnum)
+        *errnum = status < 0 ? -status : 0;
+    if (data)
+        *data = status > 0 ? p + *cursor + BLOBVEC_HDRSIZE : NULL;
+    if (datalen)
+        *datalen = status > 0 ? status : 0;
+    *cursor += BLOBVEC_HDRSIZE + (status > 0 ? status : 0);
+    return 1;
+proto:
+    errno = EPROTO;
+    return -1;
+}
+
+/*
+ * vi:tabstop=4 shiftwidth=4 expandtab
+ */
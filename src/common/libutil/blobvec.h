@@ -0,0 +1,63 @@
+/************************************************************\
+ * Copyright 2026 Lawrence Livermore National Security, LLC
+ * (c.f. AUTHORS, NOTICE.LLNS, COPYING)
+ *
+ * This file is part of the Flux resource manager framework.
+ * For details, see https://github.com/flux-framework.
+ *
+ * SPDX-License-Identifier: LGPL-3.0
+\************************************************************/
+
+#ifndef _UTIL_BLOBVEC_H
+#define _UTIL_BLOBVEC_H
+
+#include <stdint.h>
+
+/* Encode a vector of indexed blobs into one message payload, as used by
+ * the content.load-batch and content.store-batch RPCs.
+ *
+ * Each record is a 4 byte index and a 4 byte status, both in network
+ * byte order, followed by 'status' bytes of data.  A negative status
+ * carries an errno value for the item, and no data.  Records need not
+ * appear in index order.
+ */
+
+#define BLOBVEC_HDRSIZE 8
+
+struct blobvec;
+
+struct blobvec *blobvec_create (void);
+void blobvec_destroy (struct blobvec *bv);
+
+/* Append a record.  If errnum is nonzero, data and len are ignored.
+ * Returns 0 on success, -1 on failure with errno set.
+ */
+int blobvec_append (struct blobvec *bv,
+                    uint32_t index,
+                    int errnum,
+                    const void *data,
+                    int len);
+
+/* Access the encoded payload and the number of records appended.
+ */
+const void *blobvec_data (struct blobvec *bv, int *len);
+int blobvec_count (struct blobvec *bv);
+
+/* Decode the record at '*cursor' in 'buf', advancing '*cursor' past it.
+ * 'data' points into 'buf'.
+ * Returns 1 if a record was decoded, 0 at the end of 'buf', or -1 with
+ * errno set to EPROTO if the record is malformed.
+ */
+int blobvec_decode (const void *buf,
+                    int len,
+                    int *cursor,
+                    uint32_t *index,
+                    int *errnum,
+                    const void **data,
+                    int *datalen);
+
+#endif /* !_UTIL_BLOBVEC_H */
+
+/*
+ * vi:tabstop=4 shiftwidth=4 expandtab
+ */
@@ -87,6 +87,7 @@ A million repetitions of "a"
 
 //#include "os_types.h"
 #include "sha1.h"
+#include "sha_ni.h"
 
 void SHA1_Transform(uint32_t state[5], const uint8_t buffer[64]);
 
@@ -211,9 +212,17 @@ void SHA1_Update(SHA1_CTX* context, const uint8_t* data, const size_t len)
     context->count[1] += (len >> 29);
     if ((j + len) > 63) {
         memcpy(&context->buffer[j], data, (i = 64-j));
-        SHA1_Transform(context->state, context->buffer);
-        for ( ; i + 63 < len; i += 64) {
-            SHA1_Transform(context->state, data + i);
+        if (sha_ni_available()) {
+            /* use the SHA extensions, see sha_ni.c */
+            sha1_ni_transform(context->state, context->buffer, 1);
+            sha1_ni_transform(context->state, data + i, (len - i) / 64);
+            i += ((len - i) / 64) * 64;
+        }
+        else {
+            SHA1_Transform(context->state, context->buffer);
+            for ( ; i + 63 < len; i += 64) {
+                SHA1_Transform(context->state, data + i);
+            }
         }
         j = 0;
     }
@@ -16,6 +16,7 @@
 #include <stdlib.h>
 #include <memory.h>
 #include "sha256.h"
+#include "sha_ni.h"
 
 /****************************** MACROS ******************************/
 #define ROTLEFT(a,b) (((a) << (b)) | ((a) >> (32-(b))))
@@ -82,6 +83,19 @@ void sha256_transform(SHA256_CTX *ctx, const BYTE data[])
 	ctx->state[7] += h;
 }
 
+// Use the SHA extensions if the CPU supports them.
+static void sha256_transform_blocks(SHA256_CTX *ctx, const BYTE data[], size_t nblocks)
+{
+	if (sha_ni_available()) {
+		sha256_ni_transform(ctx->state, data, nblocks);
+		return;
+	}
+	while (nblocks-- > 0) {
+		sha256_transform(ctx, data);
+		data += 64;
+	}
+}
+
 void sha256_init(SHA256_CTX *ctx)
 {
 	ctx->datalen = 0;
@@ -98,17 +112,32 @@ void sha256_init(SHA256_CTX *ctx)
 
 void sha256_update(SHA256_CTX *ctx, const BYTE data[], size_t len)
 {
-	WORD i;
-
-	for (i = 0; i < len; ++i) {
-		ctx->data[ctx->datalen] = data[i];
-		ctx->datalen++;
-		if (ctx->datalen == 64) {
-			sha256_transform(ctx, ctx->data);
-			ctx->bitlen += 512;
-			ctx->datalen = 0;
-		}
+	size_t n;
+
+	// Top up a partial block first.
+	if (ctx->datalen > 0) {
+		n = 64 - ctx->datalen;
+		if (n > len)
+			n = len;
+		memcpy(ctx->data + ctx->datalen, data, n);
+		ctx->datalen += n;
+		data += n;
+		len -= n;
+		if (ctx->datalen < 64)
+			return;
+		sha256_transform_blocks(ctx, ctx->data, 1);
+		ctx->bitlen += 512;
+		ctx->datalen = 0;
+	}
+	// Hash full blocks directly from the input.
+	if ((n = len / 64) > 0) {
+		sha256_transform_blocks(ctx, data, n);
+		ctx->bitlen += 512 * n;
+		data += 64 * n;
+		len -= 64 * n;
 	}
+	memcpy(ctx->data, data, len);
+	ctx->datalen = len;
 }
 
 void sha256_final(SHA256_CTX *ctx, BYTE hash[])
@@ -127,7 +156,7 @@ void sha256_final(SHA256_CTX *ctx, BYTE hash[])
 		ctx->data[i++] = 0x80;
 		while (i < 64)
 			ctx->data[i++] = 0x00;
-		sha256_transform(ctx, ctx->data);
+		sha256_transform_blocks(ctx, ctx->data, 1);
 		memset(ctx->data, 0, 56);
 	}
 
@@ -141,7 +170,7 @@ void sha256_final(SHA256_CTX *ctx, BYTE hash[])
 	ctx->data[58] = ctx->bitlen >> 40;
 	ctx->data[57] = ctx->bitlen >> 48;
 	ctx->data[56] = ctx->bitlen >> 56;
-	sha256_transform(ctx, ctx->data);
+	sha256_transform_blocks(ctx, ctx->data, 1);
 
 	// Since this implementation uses little endian byte ordering and SHA uses big endian,
 	// reverse all the bytes when copying the final state to the output hash.
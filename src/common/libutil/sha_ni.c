@@ -0,0 +1,246 @@
+/************************************************************\
+ * Copyright 2026 Lawrence Livermore National Security, LLC
+ * (c.f. AUTHORS, NOTICE.LLNS, COPYING)
+ *
+ * This file is part of the Flux resource manager framework.
+ * For details, see https://github.com/flux-framework.
+ *
+ * SPDX-License-Identifier: LGPL-3.0
+\************************************************************/
+
+/* sha_ni.c - SHA-1 and SHA-256 block transforms using the x86 SHA
+ * extensions (SHA-NI).
+ *
+ * Functions are compiled with target attributes, so the rest of the
+ * library is built for the baseline ISA and these are only called
+ * after a runtime cpuid check.
+ */
+
+#if HAVE_CONFIG_H
+#include "config.h"
+#endif
+#include <stdlib.h>
+#include <pthread.h>
+
+#include "sha_ni.h"
+
+#if defined(__x86_64__) && HAVE_SHA_NI_INTRINSICS
+#define HAVE_SHA_NI 1
+#include <cpuid.h>
+#include <immintrin.h>
+#endif
+
+#if HAVE_SHA_NI
+
+static bool cpu_has_sha_ni (void)
+{
+    unsigned int eax, ebx, ecx, edx;
+
+    /* SSSE3 and SSE4.1 are needed for the byte shuffles and blends */
+    if (!__get_cpuid (1, &eax, &ebx, &ecx, &edx)
+        || !(ecx & bit_SSSE3)
+        || !(ecx & bit_SSE4_1))
+        return false;
+    if (!__get_cpuid_count (7, 0, &eax, &ebx, &ecx, &edx)
+        || !(ebx & (1 << 29)))
+        return false;
+    return true;
+}
+
+static pthread_once_t available_once = PTHREAD_ONCE_INIT;
+static bool available;
+
+static void available_init (void)
+{
+    available = (!getenv ("FLUX_HASH_NO_ACCEL") && cpu_has_sha_ni ());
+}
+
+/* May be called concurrently, e.g. from workpool threads.
+ */
+bool sha_ni_available (void)
+{
+    pthread_once (&available_once, available_init);
+    return available;
+}
+
+#define SHA_NI_TARGET __attribute__((target ("sha,ssse3,sse4.1")))
+
+/* The round loops must be fully unrolled so the round function selector
+ * and message schedule indices become constants.
+ */
+#if defined(__clang__) || __GNUC__ >= 8
+#define SHA_NI_UNROLL _Pragma ("GCC unroll 20")
+#else
+#define SHA_NI_UNROLL
+#endif
+
+SHA_NI_TARGET
+void sha1_ni_transform (uint32_t state[5],
+                        const uint8_t *data,
+                        size_t nblocks)
+{
+    const __m128i mask = _mm_set_epi64x (0x0001020304050607ULL,
+                                         0x08090a0b0c0d0e0fULL);
+    __m128i abcd, abcd_save, e0, e0_save, e;
+    __m128i e_next = _mm_setzero_si128 ();
+    __m128i w[4];
+    int g;
+
+    abcd = _mm_shuffle_epi32 (_mm_loadu_si128 ((const __m128i *)state),
+                              0x1B);
+    e0 = _mm_set_epi32 (state[4], 0, 0, 0);
+
+    while (nblocks-- > 0) {
+        abcd_save = abcd;
+        e0_save = e0;
+
+        /* 20 groups of 4 rounds.  Message words for group g are in
+         * w[g % 4]; the schedule for later groups is computed in place.
+         */
+        SHA_NI_UNROLL
+        for (g = 0; g < 20; g++) {
+            if (g < 4) {
+                w[g] = _mm_loadu_si128 ((const __m128i *)(data + g * 16));
+                w[g] = _mm_shuffle_epi8 (w[g], mask);
+            }
+            if (g == 0)
+                e = _mm_add_epi32 (e0, w[0]);
+            else
+                e = _mm_sha1nexte_epu32 (e_next, w[g & 3]);
+            e_next = abcd;
+            if (g >= 3 && g <= 18)
+                w[(g + 1) & 3] = _mm_sha1msg2_epu32 (w[(g + 1) & 3], w[g & 3]);
+            switch (g / 5) {
+                case 0:
+                    abcd = _mm_sha1rnds4_epu32 (abcd, e, 0);
+                    break;
+                case 1:
+                    abcd = _mm_sha1rnds4_epu32 (abcd, e, 1);
+                    break;
+                case 2:
+                    abcd = _mm_sha1rnds4_epu32 (abcd, e, 2);
+                    break;
+                default:
+                    abcd = _mm_sha1rnds4_epu32 (abcd, e, 3);
+                    break;
+            }
+            if (g >= 1 && g <= 16)
+                w[(g - 1) & 3] = _mm_sha1msg1_epu32 (w[(g - 1) & 3], w[g & 3]);
+            if (g >= 2 && g <= 17)
+                w[(g - 2) & 3] = _mm_xor_si128 (w[(g - 2) & 3], w[g & 3]);
+        }
+        e0 = _mm_sha1nexte_epu32 (e_next, e0_save);
+        abcd = _mm_add_epi32 (abcd, abcd_save);
+        data += 64;
+    }
+
+    abcd = _mm_shuffle_epi32 (abcd, 0x1B);
+    _mm_storeu_si128 ((__m128i *)state, abcd);
+    state[4] = _mm_extract_epi32 (e0, 3);
+}
+
+static const uint32_t k256[64] = {
+    0x428a2f98, 0x71374491, 0xb5c0fbcf, 0xe9b5dba5,
+    0x3956c25b, 0x59f111f1, 0x923f82a4, 0xab1c5ed5,
+    0xd807aa98, 0x12835b01, 0x243185be, 0x550c7dc3,
+    0x72be5d74, 0x80deb1fe, 0x9bdc06a7, 0xc19bf174,
+    0xe49b69c1, 0xefbe4786, 0x0fc19dc6, 0x240ca1cc,
+    0x2de92c6f, 0x4a7484aa, 0x5cb0a9dc, 0x76f988da,
+    0x983e5152, 0xa831c66d, 0xb00327c8, 0xbf597fc7,
+    0xc6e00bf3, 0xd5a79147, 0x06ca6351, 0x14292967,
+    0x27b70a85, 0x2e1b2138, 0x4d2c6dfc, 0x53380d13,
+    0x650a7354, 0x766a0abb, 0x81c2c92e, 0x92722c85,
+    0xa2bfe8a1, 0xa81a664b, 0xc24b8b70, 0xc76c51a3,
+    0xd192e819, 0xd6990624, 0xf40e3585, 0x106aa070,
+    0x19a4c116, 0x1e376c08, 0x2748774c, 0x34b0bcb5,
+    0x391c0cb3, 0x4ed8aa4a, 0x5b9cca4f, 0x682e6ff3,
+    0x748f82ee, 0x78a5636f, 0x84c87814, 0x8cc70208,
+    0x90befffa, 0xa4506ceb, 0xbef9a3f7, 0xc67178f2,
+};
+
+SHA_NI_TARGET
+void sha256_ni_transform (uint32_t state[8],
+                          const uint8_t *data,
+                          size_t nblocks)
+{
+    const __m128i mask = _mm_set_epi64x (0x0c0d0e0f08090a0bULL,
+                                         0x0405060700010203ULL);
+    __m128i state0, state1, abef_save, cdgh_save, msg, tmp;
+    __m128i w[4];
+    int g;
+
+    /* reorder state words for sha256rnds2: ABEF and CDGH */
+    tmp = _mm_loadu_si128 ((const __m128i *)&state[0]);
+    state1 = _mm_loadu_si128 ((const __m128i *)&state[4]);
+    tmp = _mm_shuffle_epi32 (tmp, 0xB1);
+    state1 = _mm_shuffle_epi32 (state1, 0x1B);
+    state0 = _mm_alignr_epi8 (tmp, state1, 8);
+    state1 = _mm_blend_epi16 (state1, tmp, 0xF0);
+
+    while (nblocks-- > 0) {
+        abef_save = state0;
+        cdgh_save = state1;
+
+        /* 16 groups of 4 rounds.  Message words for group g are in
+         * w[g % 4]; the schedule for later groups is computed in place.
+         */
+        SHA_NI_UNROLL
+        for (g = 0; g < 16; g++) {
+            if (g < 4) {
+                w[g] = _mm_loadu_si128 ((const __m128i *)(data + g * 16));
+                w[g] = _mm_shuffle_epi8 (w[g], mask);
+            }
+            msg = _mm_add_epi32 (w[g & 3],
+                                 _mm_loadu_si128 ((const __m128i *)&k256[g * 4]));
+            state1 = _mm_sha256rnds2_epu32 (state1, state0, msg);
+            if (g >= 3 && g <= 14) {
+                tmp = _mm_alignr_epi8 (w[g & 3], w[(g - 1) & 3], 4);
+                w[(g + 1) & 3] = _mm_add_epi32 (w[(g + 1) & 3], tmp);
+                w[(g + 1) & 3] = _mm_sha256msg2_epu32 (w[(g + 1) & 3],
+                                                       w[g & 3]);
+            }
+            msg = _mm_shuffle_epi32 (msg, 0x0E);
+            state0 = _mm_sha256rnds2_epu32 (state0, state1, msg);
+            if (g >= 1 && g <= 12)
+                w[(g - 1) & 3] = _mm_sha256msg1_epu32 (w[(g - 1) & 3],
+                                                       w[g & 3]);
+        }
+        state0 = _mm_add_epi32 (state0, abef_save);
+        state1 = _mm_add_epi32 (state1, cdgh_save);
+        data += 64;
+    }
+
+    tmp = _mm_shuffle_epi32 (state0, 0x1B);
+    state1 = _mm_shuffle_epi32 (state1, 0xB1);
+    state0 = _mm_blend_epi16 (tmp, state1, 0xF0);
+    state1 = _mm_alignr_epi8 (state1, tmp, 8);
+    _mm_storeu_si128 ((__m128i *)&state[0], state0);
+    _mm_storeu_si128 ((__m128i *)&state[4], state1);
+}
+
+#else /* !HAVE_SHA_NI */
+
+bool sha_ni_available (void)
+{
+    return false;
+}
+
+void sha1_ni_transform (uint32_t state[5],
+                        const uint8_t *data,
+                        size_t nblocks)
+{
+    abort ();
+}
+
+void sha256_ni_transform (uint32_t state[8],
+                          const uint8_t *data,
+                          size_t nblocks)
+{
+    abort ();
+}
+
+#endif /* !HAVE_SHA_NI */
+
+/*
+ * vi:tabstop=4 shiftwidth=4 expandtab
+ */
@@ -0,0 +1,43 @@
+/************************************************************\
+ * Copyright 2026 Lawrence Livermore National Security, LLC
+ * (c.f. AUTHORS, NOTICE.LLNS, COPYING)
+ *
+ * This file is part of the Flux resource manager framework.
+ * For details, see https://github.com/flux-framework.
+ *
+ * SPDX-License-Identifier: LGPL-3.0
+\************************************************************/
+
+#ifndef _UTIL_SHA_NI_H
+#define _UTIL_SHA_NI_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdbool.h>
+
+/* SHA-1 and SHA-256 block transforms using the x86 SHA extensions.
+ * sha1.c and sha256.c select these at runtime when the CPU supports them.
+ */
+
+/* Return true if the CPU supports the SHA extensions and this build
+ * includes the accelerated transforms.  The result is cached.
+ * Setting FLUX_HASH_NO_ACCEL in the environment forces false, so the
+ * portable code can be exercised on any machine.
+ */
+bool sha_ni_available (void);
+
+/* Hash 'nblocks' consecutive 64 byte blocks of 'data' into 'state'.
+ * Only call these if sha_ni_available() returns true.
+ */
+void sha1_ni_transform (uint32_t state[5],
+                        const uint8_t *data,
+                        size_t nblocks);
+void sha256_ni_transform (uint32_t state[8],
+                          const uint8_t *data,
+                          size_t nblocks);
+
+#endif /* !_UTIL_SHA_NI_H */
+
+/*
+ * vi:tabstop=4 shiftwidth=4 expandtab
+ */
@@ -0,0 +1,209 @@
+/************************************************************\
+ * Copyright 2026 Lawrence Livermore National Security, LLC
+ * (c.f. AUTHORS, NOTICE.LLNS, COPYING)
+ *
+ * This file is part of the Flux resource manager framework.
+ * For details, see https://github.com/flux-framework.
+ *
+ * SPDX-License-Identifier: LGPL-3.0
+\************************************************************/
+
+/* Known answer tests for the blobref hash functions over message
+ * lengths that exercise partial and whole block paths, plus a throughput
+ * diagnostic.  Whichever SHA implementation is selected at runtime is
+ * tested;  run with FLUX_HASH_NO_ACCEL=1 to test the portable code.
+ */
+
+#include <string.h>
+#include <stdlib.h>
+#include <stdio.h>
+
+#include "src/common/libtap/tap.h"
+#include "src/common/libutil/sha1.h"
+#include "src/common/libutil/sha256.h"
+#include "src/common/libutil/blake3.h"
+#include "src/common/libutil/sha_ni.h"
+#include "src/common/libutil/blobref.h"
+#include "src/common/libutil/monotime.h"
+
+/* Digests of 'len' bytes of the pattern (i % 251).
+ */
+struct vector {
+    size_t len;
+    const char *sha1;
+    const char *sha256;
+    const char *blake3;
+};
+
+static const struct vector vectors[] = {
+    { 0,
+      "da39a3ee5e6b4b0d3255bfef95601890afd80709",
+      "e3b0c44298fc1c149afbf4c8996fb92427ae41e4649b934ca495991b7852b855",
+      "af1349b9f5f9a1a6a0404dea36dcc9499bcb25c9adc112b7cc9a93cae41f3262" },
+    { 1,
+      "5ba93c9db0cff93f52b521d7420e43f6eda2784f",
+      "6e340b9cffb37a989ca544e6bb780a2c78901d3fb33738768511a30617afa01d",
+      "2d3adedff11b61f14c886e35afa036736dcd87a74d27b5c1510225d0f592e213" },
+    { 55,
+      "8ae2d46729cfe68ff927af5eec9c7d1b66d65ac2",
+      "463eb28e72f82e0a96c0a4cc53690c571281131f672aa229e0d45ae59b598b59",
+      "d04ec5f6f5e7daf5ced7a1671fbe912580a56576c8bf6a2ed4b80e35548f9c13" },
+    { 56,
+      "636e2ec698dac903498e648bd2f3af641d3c88cb",
+      "da2ae4d6b36748f2a318f23e7ab1dfdf45acdc9d049bd80e59de82a60895f562",
+      "60f238116f2936698a88cda03d8df79d7431249373b048ee7a063849fe6e9742" },
+    { 63,
+      "6d942da0c4392b123528f2905c713a3ce28364bd",
+      "29af2686fd53374a36b0846694cc342177e428d1647515f078784d69cdb9e488",
+      "e9bc37a594daad83be9470df7f7b3798297c3d834ce80ba85d6e207627b7db7b" },
+    { 64,
+      "c6138d514ffa2135bfce0ed0b8fac65669917ec7",
+      "fdeab9acf3710362bd2658cdc9a29e8f9c757fcf9811603a8c447cd1d9151108",
+      "4eed7141ea4a5cd4b788606bd23f46e212af9cacebacdc7d1f4c6dc7f2511b98" },
+    { 65,
+      "69bd728ad6e13cd76ff19751fde427b00e395746",
+      "4bfd2c8b6f1eec7a2afeb48b934ee4b2694182027e6d0fc075074f2fabb31781",
+      "de1e5fa0be70df6d2be8fffd0e99ceaa8eb6e8c93a63f2d8d1c30ecb6b263dee" },
+    { 127,
+      "89d7312a903f65cd2b3e34a975e55dbea9033353",
+      "92ca0fa6651ee2f97b884b7246a562fa71250fedefe5ebf270d31c546bfea976",
+      "d81293fda863f008c09e92fc382a81f5a0b4a1251cba1634016a0f86a6bd640d" },
+    { 128,
+      "e6434bc401f98603d7eda504790c98c67385d535",
+      "471fb943aa23c511f6f72f8d1652d9c880cfa392ad80503120547703e56a2be5",
+      "f17e570564b26578c33bb7f44643f539624b05df1a76c81f30acd548c44b45ef" },
+    { 1000,
+      "c9c960a0b925474fab83942cc27d504fc24ac37b",
+      "4e4c294b331f7a2099a379bec34b9f9fc03dc46ab465d998f4d683da53487e6d",
+      "b43670a52d1af24abdac5d2c3ed19ff4e62b60a618e823ad555888b1b0b91cff" },
+    { 4113,
+      "3d15084b2da07627880f8c35530fafd8697dd724",
+      "d855ba636ffdfea364522538421fa585c1927fe5ef4d8065b89549c6bf744213",
+      "24d325a6d64532db4ffd77827446df2b5bc09adaf63036c45f3444bb9a2d508c" },
+    { 100003,
+      "6f0200be609eb1859ce568a4ba3ebe5b043d4a63",
+      "635e9a7d2f64ce04a46b1503cbe287b8721795f215f4b8cf24b256908acaab1a",
+      "ecbf9ff05e2ec5fd331a6fb97fa198df8e18b631c7abca6e8ebaa3bf5a5c0493" },
+};
+
+static void tohex (const uint8_t *digest, size_t len, char *s)
+{
+    size_t i;
+    for (i = 0; i < len; i++)
+        sprintf (s + i * 2, "%02x", digest[i]);
+}
+
+/* Hash 'data' with all three functions, feeding it in 'step' byte
+ * pieces, and compare with the expected digests in 'v'.
+ */
+static void check_vector (const struct vector *v,
+                          const uint8_t *data,
+                          size_t step)
+{
+    SHA1_CTX sha1;
+    SHA256_CTX sha256;
+    blake3_hasher blake3;
+    uint8_t digest[32];
+    char hex[65];
+    size_t i, n;
+
+    SHA1_Init (&sha1);
+    sha256_init (&sha256);
+    blake3_hasher_init (&blake3);
+    for (i = 0; i < v->len; i += n) {
+        n = v->len - i < step ? v->len - i : step;
+        SHA1_Update (&sha1, data + i, n);
+        sha256_update (&sha256, data + i, n);
+        blake3_hasher_update (&blake3, data + i, n);
+    }
+
+    SHA1_Final (&sha1, digest);
+    tohex (digest, SHA1_DIGEST_SIZE, hex);
+    is (hex, v->sha1,
+        "sha1 len=%zu step=%zu has expected digest", v->len, step);
+    sha256_final (&sha256, digest);
+    tohex (digest, SHA256_BLOCK_SIZE, hex);
+    is (hex, v->sha256,
+        "sha256 len=%zu step=%zu has expected digest", v->len, step);
+    blake3_hasher_finalize (&blake3, digest, BLAKE3_OUT_LEN);
+    tohex (digest, BLAKE3_OUT_LEN, hex);
+    is (hex, v->blake3,
+        "blake3 len=%zu step=%zu has expected digest", v->len, step);
+}
+
+static void check_vectors (void)
+{
+    size_t maxlen = vectors[sizeof (vectors) / sizeof (vectors[0]) - 1].len;
+    uint8_t *data;
+    size_t i;
+
+    if (!(data = malloc (maxlen)))
+        BAIL_OUT ("out of memory");
+    for (i = 0; i < maxlen; i++)
+        data[i] = i % 251;
+    for (i = 0; i < sizeof (vectors) / sizeof (vectors[0]); i++) {
+        check_vector (&vectors[i], data, vectors[i].len ? vectors[i].len : 1);
+        check_vector (&vectors[i], data, 7);
+        check_vector (&vectors[i], data, 4096 + 3);
+    }
+    free (data);
+}
+
+static void check_blake3_abc (void)
+{
+    char ref[BLOBREF_MAX_STRING_SIZE];
+
+    ok (blobref_hash ("blake3", "abc", 3, ref, sizeof (ref)) == 0,
+        "blobref_hash blake3 works");
+    is (ref,
+        "blake3-6437b3ac38465133ffb63b75273a8db548c558465d79db03fd359c6cd5bd9d85",
+        "blobref_hash blake3 abc has expected value");
+}
+
+/* Report throughput of blobref_hash() on a large buffer.
+ */
+static void throughput (const char *hashtype, const uint8_t *data, int len)
+{
+    char ref[BLOBREF_MAX_STRING_SIZE];
+    struct timespec t0;
+    double ms;
+
+    monotime (&t0);
+    ok (blobref_hash (hashtype, data, len, ref, sizeof (ref)) == 0,
+        "blobref_hash %s hashed %d bytes", hashtype, len);
+    ms = monotime_since (t0);
+    diag ("%s: %.0f MB/s", hashtype, ms > 0 ? (len / 1E6) / (ms / 1E3) : 0.);
+}
+
+static void check_throughput (void)
+{
+    int len = 32 * 1024 * 1024;
+    uint8_t *data;
+    int i;
+
+    if (!(data = malloc (len)))
+        BAIL_OUT ("out of memory");
+    for (i = 0; i < len; i++)
+        data[i] = i % 251;
+    diag ("SHA extensions: %s", sha_ni_available () ? "in use" : "not in use");
+    throughput ("sha1", data, len);
+    throughput ("sha256", data, len);
+    throughput ("blake3", data, len);
+    free (data);
+}
+
+int main (int argc, char *argv[])
+{
+    plan (NO_PLAN);
+
+    check_vectors ();
+    check_blake3_abc ();
+    check_throughput ();
+
+    done_testing ();
+    return 0;
+}
+
+/*
+ * vi:tabstop=4 shiftwidth=4 expandtab
+ */
@@ -0,0 +1,172 @@
+/************************************************************\
+ * Copyright 2026 Lawrence Livermore National Security, LLC
+ * (c.f. AUTHORS, NOTICE.LLNS, COPYING)
+ *
+ * This file is part of the Flux resource manager framework.
+ * For details, see https://github.com/flux-framework.
+ *
+ * SPDX-License-Identifier: LGPL-3.0
+\************************************************************/
+
+#include <errno.h>
+#include <string.h>
+#include <stdlib.h>
+
+#include "src/common/libtap/tap.h"
+#include "src/common/libutil/blobvec.h"
+
+void check_roundtrip (void)
+{
+    struct blobvec *bv;
+    const void *buf;
+    int len;
+    int cursor = 0;
+    uint32_t index;
+    int errnum;
+    const void *data;
+    int datalen;
+
+    bv = blobvec_create ();
+    ok (bv != NULL,
+        "blobvec_create works");
+    buf = blobvec_data (bv, &len);
+    ok (len == 0 && blobvec_count (bv) == 0,
+        "empty blobvec has zero length and count");
+    ok (blobvec_decode (buf, len, &cursor, NULL, NULL, NULL, NULL) == 0,
+        "blobvec_decode of empty blobvec returns 0");
+
+    ok (blobvec_append (bv, 3, 0, "hello", 5) == 0,
+        "blobvec_append index=3 data=hello works");
+    ok (blobvec_append (bv, 1, ENOENT, NULL, 0) == 0,
+        "blobvec_append index=1 errnum=ENOENT works");
+    ok (blobvec_append (bv, 0, 0, NULL, 0) == 0,
+        "blobvec_append index=0 empty data works");
+    ok (blobvec_count (bv) == 3,
+        "blobvec_count returns 3");
+    buf = blobvec_data (bv, &len);
+    ok (buf != NULL && len == 3 * BLOBVEC_HDRSIZE + 5,
+        "blobvec_data returns expected length");
+
+    cursor = 0;
+    ok (blobvec_decode (buf, len, &cursor, &index, &errnum,
+                        &data, &datalen) == 1
+        && index == 3 && errnum == 0
+        && datalen == 5 && !memcmp (data, "hello", 5),
+        "blobvec_decode returned first record");
+    ok (blobvec_decode (buf, len, &cursor, &index, &errnum,
+                        &data, &datalen) == 1
+        && index == 1 && errnum == ENOENT
+        && datalen == 0 && data == NULL,
+        "blobvec_decode returned second record with errnum");
+    ok (blobvec_decode (buf, len, &cursor, &index, &errnum,
+                        &data, &datalen) == 1
+        && index == 0 && errnum == 0
+        && datalen == 0 && data == NULL,
+        "blobvec_decode returned third record with no data");
+    ok (blobvec_decode (buf, len, &cursor, &index, &errnum,
+                        &data, &datalen) == 0,
+        "blobvec_decode returned 0 at end");
+    blobvec_destroy (bv);
+}
+
+void check_large (void)
+{
+    struct blobvec *bv;
+    char *big;
+    int biglen = 1024 * 1024;
+    const void *buf;
+    int len;
+    int cursor = 0;
+    uint32_t index;
+    const void *data;
+    int datalen;
+    int i;
+    int errors = 0;
+
+    if (!(bv = blobvec_create ()) || !(big = malloc (biglen)))
+        BAIL_OUT ("out of memory");
+    memset (big, 'x', biglen);
+    for (i = 0; i < 16; i++) {
+        if (blobvec_append (bv, i, 0, big, biglen - i) < 0)
+            errors++;
+    }
+    ok (errors == 0,
+        "blobvec_append of 16 1MB blobs works");
+    buf = blobvec_data (bv, &len);
+    for (i = 0; i < 16; i++) {
+        if (blobvec_decode (buf, len, &cursor, &index, NULL,
+                            &data, &datalen) != 1
+            || index != i
+            || datalen != biglen - i
+            || memcmp (data, big, datalen) != 0)
+            errors++;
+    }
+    ok (errors == 0 && cursor == len,
+        "blobvec_decode of 16 1MB blobs works");
+    blobvec_destroy (bv);
+    free (big);
+}
+
+void check_invalid (void)
+{
+    struct blobvec *bv;
+    const void *buf;
+    char tmp[64];
+    int len;
+    int cursor;
+
+    if (!(bv = blobvec_create ()))
+        BAIL_OUT ("blobvec_create failed");
+
+    errno = 0;
+    ok (blobvec_append (NULL, 0, 0, "x", 1) < 0 && errno == EINVAL,
+        "blobvec_append bv=NULL fails with EINVAL");
+    errno = 0;
+    ok (blobvec_append (bv, 0, 0, NULL, 1) < 0 && errno == EINVAL,
+        "blobvec_append data=NULL len=1 fails with EINVAL");
+    errno = 0;
+    ok (blobvec_append (bv, 0, -1, NULL, 0) < 0 && errno == EINVAL,
+        "blobvec_append errnum=-1 fails with EINVAL");
+    errno = 0;
+    ok (blobvec_data (NULL, &len) == NULL && errno == EINVAL,
+        "blobvec_data bv=NULL fails with EINVAL");
+
+    if (blobvec_append (bv, 0, 0, "abcd", 4) < 0)
+        BAIL_OUT ("blobvec_append failed");
+    buf = blobvec_data (bv, &len);
+    memcpy (tmp, buf, len);
+
+    cursor = 0;
+    errno = 0;
+    ok (blobvec_decode (tmp, BLOBVEC_HDRSIZE - 1, &cursor,
+                        NULL, NULL, NULL, NULL) < 0 && errno == EPROTO,
+        "blobvec_decode truncated header fails with EPROTO");
+    cursor = 0;
+    errno = 0;
+    ok (blobvec_decode (tmp, len - 1, &cursor,
+                        NULL, NULL, NULL, NULL) < 0 && errno == EPROTO,
+        "blobvec_decode truncated data fails with EPROTO");
+    cursor = 0;
+    errno = 0;
+    ok (blobvec_decode (tmp, len, NULL, NULL, NULL, NULL, NULL) < 0
+        && errno == EINVAL,
+        "blobvec_decode cursor=NULL fails with EINVAL");
+
+    blobvec_destroy (bv);
+}
+
+int main (int argc, char *argv[])
+{
+    plan (NO_PLAN);
+
+    check_roundtrip ();
+    check_large ();
+    check_invalid ();
+
+    done_testing ();
+    return 0;
+}
+
+/*
+ * vi:tabstop=4 shiftwidth=4 expandtab
+ */
@@ -0,0 +1,124 @@
+/************************************************************\
+ * Copyright 2026 Lawrence Livermore National Security, LLC
+ * (c.f. AUTHORS, NOTICE.LLNS, COPYING)
+ *
+ * This file is part of the Flux resource manager framework.
+ * For details, see https://github.com/flux-framework.
+ *
+ * SPDX-License-Identifier: LGPL-3.0
+\************************************************************/
+
+#include <errno.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "src/common/libtap/tap.h"
+#include "src/common/libutil/workpool.h"
+
+struct item {
+    int in;
+    int out;
+};
+
+static void square (void *arg, void *data)
+{
+    struct item *item = arg;
+    int *calls = data;
+
+    item->out = item->in * item->in;
+    __sync_fetch_and_add (calls, 1);
+}
+
+static void run_batch (struct workpool *wp, int count, const char *name)
+{
+    struct item *items;
+    void **ptrs;
+    int calls = 0;
+    int errors = 0;
+    int i;
+
+    if (!(items = calloc (count, sizeof (items[0])))
+        || !(ptrs = calloc (count, sizeof (ptrs[0]))))
+        BAIL_OUT ("out of memory");
+    for (i = 0; i < count; i++) {
+        items[i].in = i;
+        ptrs[i] = &items[i];
+    }
+    ok (workpool_map (wp, ptrs, count, square, &calls) == 0,
+        "%s: workpool_map count=%d works", name, count);
+    for (i = 0; i < count; i++) {
+        if (items[i].out != i * i)
+            errors++;
+    }
+    ok (calls == count && errors == 0,
+        "%s: each item was processed once", name);
+    free (ptrs);
+    free (items);
+}
+
+void check_pool (int nthreads)
+{
+    struct workpool *wp;
+    char name[32];
+    int i;
+
+    snprintf (name, sizeof (name), "nthreads=%d", nthreads);
+    ok ((wp = workpool_create (nthreads)) != NULL,
+        "%s: workpool_create works", name);
+    ok (workpool_size (wp) == nthreads,
+        "%s: workpool_size returns %d", name, nthreads);
+    run_batch (wp, 0, name);
+    run_batch (wp, 1, name);
+    run_batch (wp, 2, name);
+    run_batch (wp, 1000, name);
+    /* reuse the pool for many small batches */
+    for (i = 0; i < 100; i++)
+        run_batch (wp, 7, name);
+    workpool_destroy (wp);
+}
+
+void check_invalid (void)
+{
+    struct workpool *wp;
+    void *items[1] = { NULL };
+    int calls = 0;
+
+    errno = 0;
+    ok (workpool_create (-1) == NULL && errno == EINVAL,
+        "workpool_create nthreads=-1 fails with EINVAL");
+    if (!(wp = workpool_create (1)))
+        BAIL_OUT ("workpool_create failed");
+    errno = 0;
+    ok (workpool_map (wp, NULL, 1, square, &calls) < 0 && errno == EINVAL,
+        "workpool_map items=NULL fails with EINVAL");
+    errno = 0;
+    ok (workpool_map (wp, items, 1, NULL, &calls) < 0 && errno == EINVAL,
+        "workpool_map fn=NULL fails with EINVAL");
+    errno = 0;
+    ok (workpool_map (wp, items, -1, square, &calls) < 0 && errno == EINVAL,
+        "workpool_map count=-1 fails with EINVAL");
+    workpool_destroy (wp);
+
+    run_batch (NULL, 10, "NULL pool");
+    ok (workpool_size (NULL) == 0,
+        "workpool_size of NULL pool is 0");
+    lives_ok ({workpool_destroy (NULL);},
+        "workpool_destroy NULL doesn't crash");
+}
+
+int main (int argc, char *argv[])
+{
+    plan (NO_PLAN);
+
+    check_pool (0);
+    check_pool (1);
+    check_pool (4);
+    check_invalid ();
+
+    done_testing ();
+    return 0;
+}
+
+/*
+ * vi:tabstop=4 shiftwidth=4 expandtab
+ */
@@ -0,0 +1,183 @@
+/************************************************************\
+ * Copyright 2026 Lawrence Livermore National Security, LLC
+ * (c.f. AUTHORS, NOTICE.LLNS, COPYING)
+ *
+ * This file is part of the Flux resource manager framework.
+ * For details, see https://github.com/flux-framework.
+ *
+ * SPDX-License-Identifier: LGPL-3.0
+\************************************************************/
+
+#if HAVE_CONFIG_H
+#include "config.h"
+#endif
+#include <stdlib.h>
+#include <errno.h>
+#include <signal.h>
+#include <stdbool.h>
+#include <pthread.h>
+
+#include "workpool.h"
+
+struct workpool {
+    pthread_mutex_t lock;
+    pthread_cond_t work_cond;   /* batch posted, or shutdown */
+    pthread_cond_t done_cond;   /* last item of batch completed */
+    pthread_t *threads;
+    int nthreads;
+    bool shutdown;
+
+    /* current batch, protected by 'lock' */
+    void **items;
+    int count;
+    int next;                   /* index of next item to be taken */
+    int pending;                /* items not yet completed */
+    workpool_f fn;
+    void *arg;
+};
+
+/* Take items from the current batch until none are left.
+ * Called with wp->lock held.
+ */
+static void workpool_run_locked (struct workpool *wp)
+{
+    while (wp->next < wp->count) {
+        void *item = wp->items[wp->next++];
+        workpool_f fn = wp->fn;
+        void *arg = wp->arg;
+
+        pthread_mutex_unlock (&wp->lock);
+        fn (item, arg);
+        pthread_mutex_lock (&wp->lock);
+        if (--wp->pending == 0)
+            pthread_cond_signal (&wp->done_cond);
+    }
+}
+
+static void *workpool_thread (void *arg)
+{
+    struct workpool *wp = arg;
+
+    pthread_mutex_lock (&wp->lock);
+    for (;;) {
+        while (!wp->shutdown && wp->next >= wp->count)
+            pthread_cond_wait (&wp->work_cond, &wp->lock);
+        if (wp->shutdown)
+            break;
+        workpool_run_locked (wp);
+    }
+    pthread_mutex_unlock (&wp->lock);
+    return NULL;
+}
+
+int workpool_map (struct workpool *wp,
+                  void **items,
+                  int count,
+                  workpool_f fn,
+                  void *arg)
+{
+    int i;
+
+    if (count < 0 || (count > 0 && (!items || !fn))) {
+        errno = EINVAL;
+        return -1;
+    }
+    /* Not worth waking threads for a single item.
+     */
+    if (!wp || wp->nthreads == 0 || count < 2) {
+        for (i = 0; i < count; i++)
+            fn (items[i], arg);
+        return 0;
+    }
+    pthread_mutex_lock (&wp->lock);
+    wp->items = items;
+    wp->count = count;
+    wp->next = 0;
+    wp->pending = count;
+    wp->fn = fn;
+    wp->arg = arg;
+    pthread_cond_broadcast (&wp->work_cond);
+    workpool_run_locked (wp);
+    while (wp->pending > 0)
+        pthread_cond_wait (&wp->done_cond, &wp->lock);
+    wp->items = NULL;
+    wp->count = 0;
+    wp->next = 0;
+    pthread_mutex_unlock (&wp->lock);
+    return 0;
+}
+
+int workpool_size (struct workpool *wp)
+{
+    return wp ? wp->nthreads : 0;
+}
+
+void workpool_destroy (struct workpool *wp)
+{
+    if (wp) {
+        int saved_errno = errno;
+        int i;
+
+        pthread_mutex_lock (&wp->lock);
+        wp->shutdown = true;
+        pthread_cond_broadcast (&wp->work_cond);
+        pthread_mutex_unlock (&wp->lock);
+        for (i = 0; i < wp->nthreads; i++)
+            pthread_join (wp->threads[i], NULL);
+        pthread_cond_destroy (&wp->done_cond);
+        pthread_cond_destroy (&wp->work_cond);
+        pthread_mutex_destroy (&wp->lock);
+        free (wp->threads);
+        free (wp);
+        errno = saved_errno;
+    }
+}
+
+struct workpool *workpool_create (int nthreads)
+{
+    struct workpool *wp;
+    sigset_t sigs, oldsigs;
+    int e;
+
+    if (nthreads < 0) {
+        errno = EINVAL;
+        return NULL;
+    }
+    if (!(wp = calloc (1, sizeof (*wp)))) {
+        errno = ENOMEM;
+        return NULL;
+    }
+    pthread_mutex_init (&wp->lock, NULL);
+    pthread_cond_init (&wp->work_cond, NULL);
+    pthread_cond_init (&wp->done_cond, NULL);
+    if (nthreads > 0 && !(wp->threads = calloc (nthreads,
+                                                sizeof (wp->threads[0])))) {
+        errno = ENOMEM;
+        goto error;
+    }
+    /* Workers inherit a full signal mask, so signals are only
+     * delivered to the threads that expect them.
+     */
+    sigfillset (&sigs);
+    pthread_sigmask (SIG_SETMASK, &sigs, &oldsigs);
+    while (wp->nthreads < nthreads) {
+        if ((e = pthread_create (&wp->threads[wp->nthreads],
+                                 NULL,
+                                 workpool_thread,
+                                 wp))) {
+            pthread_sigmask (SIG_SETMASK, &oldsigs, NULL);
+            errno = e;
+            goto error;
+        }
+        wp->nthreads++;
+    }
+    pthread_sigmask (SIG_SETMASK, &oldsigs, NULL);
+    return wp;
+error:
+    workpool_destroy (wp);
+    return NULL;
+}
+
+/*
+ * vi:tabstop=4 shiftwidth=4 expandtab
+ */
@@ -0,0 +1,53 @@
+/************************************************************\
+ * Copyright 2026 Lawrence Livermore National Security, LLC
+ * (c.f. AUTHORS, NOTICE.LLNS, COPYING)
+ *
+ * This file is part of the Flux resource manager framework.
+ * For details, see https://github.com/flux-framework.
+ *
+ * SPDX-License-Identifier: LGPL-3.0
+\************************************************************/
+
+#ifndef _UTIL_WORKPOOL_H
+#define _UTIL_WORKPOOL_H
+
+/* A fixed pool of threads for running a batch of independent,
+ * CPU bound work items in parallel.  The calling thread takes part
+ * in the work and blocks until the whole batch is done.
+ *
+ * Work functions must not touch state shared with other items or
+ * with the calling thread, e.g. the flux_t handle.
+ */
+
+typedef void (*workpool_f)(void *item, void *arg);
+
+struct workpool;
+
+/* Create a pool of 'nthreads' worker threads.  With zero threads, all
+ * work is done by the calling thread.
+ * Returns NULL on failure with errno set.
+ */
+struct workpool *workpool_create (int nthreads);
+void workpool_destroy (struct workpool *wp);
+
+/* Call fn (items[i], arg) once for each of 'count' items, spread over
+ * the pool and the calling thread, and return when all calls are done.
+ * If 'wp' is NULL, items are processed by the calling thread.
+ * Only one thread may call workpool_map() on a given pool at a time.
+ * Returns 0 on success, -1 on failure with errno set.
+ */
+int workpool_map (struct workpool *wp,
+                  void **items,
+                  int count,
+                  workpool_f fn,
+                  void *arg);
+
+/* Return the number of worker threads in the pool.
+ */
+int workpool_size (struct workpool *wp);
+
+#endif /* !_UTIL_WORKPOOL_H */
+
+/*
+ * vi:tabstop=4 shiftwidth=4 expandtab
+ */
@@ -16,17 +16,55 @@
 #include <sqlite3.h>
 #include <czmq.h>
 #include <lz4.h>
+#if HAVE_ZSTD
+#include <zstd.h>
+#include <zdict.h>
+#include <pthread.h>
+#include <signal.h>
+#include <unistd.h>
+#include <sys/eventfd.h>
+#endif
 #include <flux/core.h>
 
 #include "src/common/libutil/blobref.h"
 #include "src/common/libutil/log.h"
 #include "src/common/libutil/errno_safe.h"
+#include "src/common/libutil/monotime.h"
 
 #include "src/common/libcontent/content-util.h"
 
 const size_t lzo_buf_chunksize = 1024*1024;
 const size_t compression_threshold = 256; /* compress blobs >= this size */
 
+/* The 'size' column of the objects table records how 'object' is encoded,
+ * so rows written under one compression setting load under any other:
+ *   -1     uncompressed
+ *   >= 0   LZ4, 'size' is the uncompressed size
+ *   <= -2  zstd, the uncompressed size is (-2 - size).  The frame header
+ *          carries the ID of the dictionary used, or zero if none.
+ *
+ * zstd dictionaries are trained from a sample of stored objects, then
+ * stored uncompressed in the objects table.  The checkpt table maps
+ * "content-sqlite.zstd-dict.<ID>" to each dictionary's blobref, and
+ * "content-sqlite.zstd-dict" to the ID used for new objects.  All
+ * dictionaries are loaded when the module starts.
+ */
+#if HAVE_ZSTD
+const size_t zstd_threshold = 64;           /* compress blobs >= this size */
+const int zstd_default_level = 3;
+const size_t zstd_dict_capacity = 16384;
+const size_t zstd_sample_max = 16384;       /* largest blob sampled */
+const size_t zstd_train_bytes = 256*1024;   /* sample this much, then train */
+const double zstd_retry_min = 60.;          /* after failed training, wait */
+const double zstd_retry_max = 3600.;        /*   this long, doubling, to max */
+const char *zstd_dict_key = "content-sqlite.zstd-dict";
+#endif
+
+enum {
+    COMPRESS_LZ4 = 0,
+    COMPRESS_ZSTD = 1,
+};
+
 const char *sql_create_table = "CREATE TABLE if not exists objects("
                                "  hash CHAR(20) PRIMARY KEY,"
                                "  size INT,"
@@ -45,6 +83,20 @@ const char *sql_checkpt_get = "SELECT value FROM checkpt"
                               "  WHERE key = ?1";
 const char *sql_checkpt_put = "REPLACE INTO checkpt (key,value) "
                               "  values (?1, ?2)";
+const char *sql_checkpt_zstd_dicts = "SELECT key,value FROM checkpt"
+                              "  WHERE key LIKE 'content-sqlite.zstd-dict.%'";
+
+struct content_stats {
+    int store_raw;
+    int store_lz4;
+    int store_zstd;
+    int64_t store_bytes;            /* object bytes stored */
+    int64_t store_bytes_written;    /* object bytes stored after compression */
+    int64_t compress_bytes;
+    double compress_ms;
+    int64_t decompress_bytes;
+    double decompress_ms;
+};
 
 struct content_sqlite {
     flux_msg_handler_t **handlers;
@@ -58,6 +110,25 @@ struct content_sqlite {
     const char *hashfun;
     size_t lzo_bufsize;
     void *lzo_buf;
+    int compression;
+    struct content_stats stats;
+#if HAVE_ZSTD
+    int zstd_level;
+    ZSTD_CCtx *cctx;
+    ZSTD_DCtx *dctx;
+    ZSTD_CDict *cdict;          /* dictionary for new objects, if any */
+    unsigned int dict_id;
+    zhashx_t *ddicts;           /* dictionary ID => ZSTD_DDict */
+    char *samples;              /* training samples, concatenated */
+    size_t samples_len;
+    size_t samples_size;
+    size_t *sample_sizes;
+    unsigned int nsamples;
+    unsigned int samples_max;
+    struct zstd_train *train;   /* training in progress, if any */
+    double train_retry;         /* delay after next failure */
+    double train_after;         /* don't sample before this time */
+#endif
 };
 
 static void log_sqlite_error (struct content_sqlite *ctx, const char *fmt, ...)
@@ -123,6 +194,82 @@ static int grow_lzo_buf (struct content_sqlite *ctx, size_t size)
     return 0;
 }
 
+static int decompress_lz4 (struct content_sqlite *ctx,
+                           const void *data,
+                           int size,
+                           int uncompressed_size)
+{
+    int r;
+
+    if (ctx->lzo_bufsize < uncompressed_size
+                            && grow_lzo_buf (ctx, uncompressed_size) < 0)
+        return -1;
+    r = LZ4_decompress_safe (data, ctx->lzo_buf, size, uncompressed_size);
+    if (r < 0) {
+        errno = EINVAL;
+        return -1;
+    }
+    if (r != uncompressed_size) {
+        flux_log (ctx->h, LOG_ERR, "load: blob size mismatch");
+        errno = EINVAL;
+        return -1;
+    }
+    return 0;
+}
+
+static int decompress_zstd (struct content_sqlite *ctx,
+                            const void *data,
+                            int size,
+                            int uncompressed_size)
+{
+#if HAVE_ZSTD
+    unsigned int id;
+    size_t r;
+
+    if (ctx->lzo_bufsize < uncompressed_size
+                            && grow_lzo_buf (ctx, uncompressed_size) < 0)
+        return -1;
+    if ((id = ZSTD_getDictID_fromFrame (data, size)) != 0) {
+        char key[16];
+        ZSTD_DDict *ddict;
+
+        snprintf (key, sizeof (key), "%u", id);
+        if (!(ddict = zhashx_lookup (ctx->ddicts, key))) {
+            flux_log (ctx->h, LOG_ERR, "load: unknown zstd dictionary %u", id);
+            errno = EINVAL;
+            return -1;
+        }
+        r = ZSTD_decompress_usingDDict (ctx->dctx,
+                                        ctx->lzo_buf,
+                                        uncompressed_size,
+                                        data,
+                                        size,
+                                        ddict);
+    }
+    else
+        r = ZSTD_decompressDCtx (ctx->dctx,
+                                 ctx->lzo_buf,
+                                 uncompressed_size,
+                                 data,
+                                 size);
+    if (ZSTD_isError (r)) {
+        flux_log (ctx->h, LOG_ERR, "load: zstd: %s", ZSTD_getErrorName (r));
+        errno = EINVAL;
+        return -1;
+    }
+    if (r != uncompressed_size) {
+        flux_log (ctx->h, LOG_ERR, "load: blob size mismatch");
+        errno = EINVAL;
+        return -1;
+    }
+    return 0;
+#else
+    flux_log (ctx->h, LOG_ERR, "load: zstd blob but built without zstd");
+    errno = EINVAL;
+    return -1;
+#endif
+}
+
 /* Load blob from objects table, uncompressing if necessary.
  * Returns 0 on success, -1 on error with errno set.
  * On successful return, must call sqlite3_reset (ctx->load_stmt),
@@ -137,7 +284,7 @@ static int content_sqlite_load (struct content_sqlite *ctx,
     int hash_len;
     const void *data = NULL;
     int size = 0;
-    int uncompressed_size;
+    int size_col;
 
     if ((hash_len = blobref_strtohash (blobref, hash, sizeof (hash))) < 0) {
         errno = ENOENT;
@@ -170,24 +317,22 @@ static int content_sqlite_load (struct content_sqlite *ctx,
         errno = EINVAL;
         goto error;
     }
-    uncompressed_size = sqlite3_column_int (ctx->load_stmt, 1);
-    if (uncompressed_size != -1) {
-        if (ctx->lzo_bufsize < uncompressed_size
-                                && grow_lzo_buf (ctx, uncompressed_size) < 0)
-            goto error;
-        int r = LZ4_decompress_safe (data,
-                                     ctx->lzo_buf,
-                                     size,
-                                     uncompressed_size);
-        if (r < 0) {
-            errno = EINVAL;
-            goto error;
+    size_col = sqlite3_column_int (ctx->load_stmt, 1);
+    if (size_col != -1) {
+        int uncompressed_size = size_col >= 0 ? size_col : -2 - size_col;
+        struct timespec t0;
+
+        monotime (&t0);
+        if (size_col >= 0) {
+            if (decompress_lz4 (ctx, data, size, uncompressed_size) < 0)
+                goto error;
         }
-        if (r != uncompressed_size) {
-            flux_log (ctx->h, LOG_ERR, "load: blob size mismatch");
-            errno = EINVAL;
-            goto error;
+        else {
+            if (decompress_zstd (ctx, data, size, uncompressed_size) < 0)
+                goto error;
         }
+        ctx->stats.decompress_ms += monotime_since (t0);
+        ctx->stats.decompress_bytes += uncompressed_size;
         data = ctx->lzo_buf;
         size = uncompressed_size;
     }
@@ -199,19 +344,95 @@ error:
     return -1;
 }
 
-/* Store blob to objects table, compressing if necessary.
+/* Compress 'size' bytes of 'data' into ctx->lzo_buf, setting '*outsizep'
+ * to the compressed size and '*size_colp' to the value of the 'size' column
+ * that describes it.  If compression is not worthwhile, '*outsizep' is
+ * set to zero.  Returns 0 on success, -1 on error with errno set.
+ */
+static int compress_lz4 (struct content_sqlite *ctx,
+                         const void *data,
+                         int size,
+                         int *outsizep,
+                         int *size_colp)
+{
+    int out_len;
+    int r;
+
+    *outsizep = 0;
+    if (size < compression_threshold)
+        return 0;
+    out_len = LZ4_compressBound (size);
+    if (ctx->lzo_bufsize < out_len && grow_lzo_buf (ctx, out_len) < 0)
+        return -1;
+    r = LZ4_compress_default (data, ctx->lzo_buf, size, out_len);
+    if (r == 0) {
+        errno = EINVAL;
+        return -1;
+    }
+    *outsizep = r;
+    *size_colp = size;
+    return 0;
+}
+
+#if HAVE_ZSTD
+static int compress_zstd (struct content_sqlite *ctx,
+                          const void *data,
+                          int size,
+                          int *outsizep,
+                          int *size_colp)
+{
+    size_t out_len;
+    size_t r;
+
+    *outsizep = 0;
+    if (size < zstd_threshold)
+        return 0;
+    out_len = ZSTD_compressBound (size);
+    if (ctx->lzo_bufsize < out_len && grow_lzo_buf (ctx, out_len) < 0)
+        return -1;
+    if (ctx->cdict)
+        r = ZSTD_compress_usingCDict (ctx->cctx,
+                                      ctx->lzo_buf,
+                                      out_len,
+                                      data,
+                                      size,
+                                      ctx->cdict);
+    else
+        r = ZSTD_compressCCtx (ctx->cctx,
+                               ctx->lzo_buf,
+                               out_len,
+                               data,
+                               size,
+                               ctx->zstd_level);
+    if (ZSTD_isError (r)) {
+        flux_log (ctx->h, LOG_ERR, "store: zstd: %s", ZSTD_getErrorName (r));
+        errno = EINVAL;
+        return -1;
+    }
+    if (r < size) {
+        *outsizep = r;
+        *size_colp = -2 - size;
+    }
+    return 0;
+}
+#endif
+
+/* Store blob to objects table, compressing if 'compress' is true and
+ * it makes the blob smaller.
  * Blobref resulting from hash over 'data' is stored to 'blobref'.
  * Returns 0 on success, -1 on error with errno set.
  */
-static int content_sqlite_store (struct content_sqlite *ctx,
-                                 const void *data,
-                                 int size,
-                                 char *blobref,
-                                 int blobrefsz)
+static int content_sqlite_store_object (struct content_sqlite *ctx,
+                                        const void *data,
+                                        int size,
+                                        bool compress,
+                                        char *blobref,
+                                        int blobrefsz)
 {
     uint8_t hash[BLOBREF_MAX_DIGEST_SIZE];
     int hash_len;
-    int uncompressed_size = -1;
+    int size_col = -1;
+    int compressed_size = 0;
 
     if (blobref_hash (ctx->hashfun,
                       (uint8_t *)data,
@@ -221,20 +442,34 @@ static int content_sqlite_store (struct content_sqlite *ctx,
         return -1;
     if ((hash_len = blobref_strtohash (blobref, hash, sizeof (hash))) < 0)
         return -1;
-    if (size >= compression_threshold) {
-        int r;
-        int out_len = LZ4_compressBound(size);
-        if (ctx->lzo_bufsize < out_len && grow_lzo_buf (ctx, out_len) < 0)
-            return -1;
-        r = LZ4_compress_default (data, ctx->lzo_buf, size, out_len);
-        if (r == 0) {
-            errno = EINVAL;
+    ctx->stats.store_bytes += size;
+    if (compress) {
+        struct timespec t0;
+        int rc;
+
+        monotime (&t0);
+#if HAVE_ZSTD
+        if (ctx->compression == COMPRESS_ZSTD)
+            rc = compress_zstd (ctx, data, size, &compressed_size, &size_col);
+        else
+#endif
+            rc = compress_lz4 (ctx, data, size, &compressed_size, &size_col);
+        if (rc < 0)
             return -1;
+        if (compressed_size > 0) {
+            ctx->stats.compress_ms += monotime_since (t0);
+            ctx->stats.compress_bytes += size;
+            if (size_col >= 0)
+                ctx->stats.store_lz4++;
+            else
+                ctx->stats.store_zstd++;
+            size = compressed_size;
+            data = ctx->lzo_buf;
         }
-        uncompressed_size = size;
-        size = r;
-        data = ctx->lzo_buf;
     }
+    if (compressed_size == 0)
+        ctx->stats.store_raw++;
+    ctx->stats.store_bytes_written += size;
     if (sqlite3_bind_text (ctx->store_stmt,
                            1,
                            (char *)hash,
@@ -246,7 +481,7 @@ static int content_sqlite_store (struct content_sqlite *ctx,
     }
     if (sqlite3_bind_int (ctx->store_stmt,
                           2,
-                          uncompressed_size) != SQLITE_OK) {
+                          size_col) != SQLITE_OK) {
         log_sqlite_error (ctx, "store: binding size");
         set_errno_from_sqlite_error (ctx);
         goto error;
@@ -273,6 +508,454 @@ error:
     return -1;
 }
 
+/* Get 'key' from the checkpt table.  On success, '*valuep' is set to a
+ * copy of the value, which the caller must free.
+ * Returns 0 on success, -1 on error with errno set (ENOENT if not found).
+ */
+static int checkpt_get (struct content_sqlite *ctx,
+                        const char *key,
+                        char **valuep)
+{
+    const char *value;
+    char *cpy;
+
+    if (sqlite3_bind_text (ctx->checkpt_get_stmt,
+                           1,
+                           (char *)key,
+                           strlen (key),
+                           SQLITE_STATIC) != SQLITE_OK) {
+        log_sqlite_error (ctx, "checkpt_get: binding key");
+        set_errno_from_sqlite_error (ctx);
+        goto error;
+    }
+    if (sqlite3_step (ctx->checkpt_get_stmt) != SQLITE_ROW) {
+        errno = ENOENT;
+        goto error;
+    }
+    if (!(value = (const char *)sqlite3_column_text (ctx->checkpt_get_stmt,
+                                                     0))) {
+        errno = EINVAL;
+        goto error;
+    }
+    if (!(cpy = strdup (value)))
+        goto error;
+    (void )sqlite3_reset (ctx->checkpt_get_stmt);
+    *valuep = cpy;
+    return 0;
+error:
+    ERRNO_SAFE_WRAP (sqlite3_reset, ctx->checkpt_get_stmt);
+    return -1;
+}
+
+/* Set 'key' to 'value' in the checkpt table.
+ * Returns 0 on success, -1 on error with errno set.
+ */
+static int checkpt_put (struct content_sqlite *ctx,
+                        const char *key,
+                        const char *value)
+{
+    if (sqlite3_bind_text (ctx->checkpt_put_stmt,
+                           1,
+                           (char *)key,
+                           strlen (key),
+                           SQLITE_STATIC) != SQLITE_OK) {
+        log_sqlite_error (ctx, "checkpt_put: binding key");
+        set_errno_from_sqlite_error (ctx);
+        goto error;
+    }
+    if (sqlite3_bind_text (ctx->checkpt_put_stmt,
+                           2,
+                           (char *)value,
+                           strlen (value),
+                           SQLITE_STATIC) != SQLITE_OK) {
+        log_sqlite_error (ctx, "checkpt_put: binding value");
+        set_errno_from_sqlite_error (ctx);
+        goto error;
+    }
+    if (sqlite3_step (ctx->checkpt_put_stmt) != SQLITE_DONE
+                    && sqlite3_errcode (ctx->db) != SQLITE_CONSTRAINT) {
+        log_sqlite_error (ctx, "checkpt_put: executing stmt");
+        set_errno_from_sqlite_error (ctx);
+        goto error;
+    }
+    (void )sqlite3_reset (ctx->checkpt_put_stmt);
+    return 0;
+error:
+    ERRNO_SAFE_WRAP (sqlite3_reset, ctx->checkpt_put_stmt);
+    return -1;
+}
+
+#if HAVE_ZSTD
+static void ddict_destroy (void **item)
+{
+    if (item) {
+        ZSTD_freeDDict (*item);
+        *item = NULL;
+    }
+}
+
+/* Make dictionary 'id' available for decompression and, if 'current'
+ * is true, use it to compress new objects.
+ */
+static int zstd_dict_add (struct content_sqlite *ctx,
+                          unsigned int id,
+                          const void *dict,
+                          size_t size,
+                          bool current)
+{
+    char key[16];
+
+    snprintf (key, sizeof (key), "%u", id);
+    if (!zhashx_lookup (ctx->ddicts, key)) {
+        ZSTD_DDict *ddict;
+
+        if (!(ddict = ZSTD_createDDict (dict, size))) {
+            errno = ENOMEM;
+            return -1;
+        }
+        (void)zhashx_insert (ctx->ddicts, key, ddict);
+    }
+    if (current) {
+        ZSTD_CDict *cdict;
+
+        if (!(cdict = ZSTD_createCDict (dict, size, ctx->zstd_level))) {
+            errno = ENOMEM;
+            return -1;
+        }
+        ZSTD_freeCDict (ctx->cdict);
+        ctx->cdict = cdict;
+        ctx->dict_id = id;
+    }
+    return 0;
+}
+
+/* Store dictionary 'id' as an object and record it in the checkpt table
+ * as the current dictionary.  A different dictionary with the same ID is
+ * a collision, and fails with EEXIST.
+ */
+static int zstd_dict_save (struct content_sqlite *ctx,
+                           unsigned int id,
+                           const void *dict,
+                           size_t size)
+{
+    char blobref[BLOBREF_MAX_STRING_SIZE];
+    char key[64];
+    char idstr[16];
+    char *value;
+
+    if (content_sqlite_store_object (ctx,
+                                     dict,
+                                     size,
+                                     false,
+                                     blobref,
+                                     sizeof (blobref)) < 0)
+        return -1;
+    snprintf (key, sizeof (key), "%s.%u", zstd_dict_key, id);
+    if (checkpt_get (ctx, key, &value) == 0) {
+        bool match = !strcmp (value, blobref);
+        free (value);
+        if (!match) {
+            errno = EEXIST;
+            return -1;
+        }
+    }
+    else if (errno != ENOENT || checkpt_put (ctx, key, blobref) < 0)
+        return -1;
+    snprintf (idstr, sizeof (idstr), "%u", id);
+    return checkpt_put (ctx, zstd_dict_key, idstr);
+}
+
+/* Load all dictionaries listed in the checkpt table.
+ */
+static int zstd_dict_load_all (struct content_sqlite *ctx)
+{
+    sqlite3_stmt *stmt = NULL;
+    unsigned int current = 0;
+    char *value;
+    int rc;
+
+    if (checkpt_get (ctx, zstd_dict_key, &value) == 0) {
+        current = strtoul (value, NULL, 10);
+        free (value);
+    }
+    else if (errno != ENOENT)
+        return -1;
+    if (sqlite3_prepare_v2 (ctx->db,
+                            sql_checkpt_zstd_dicts,
+                            -1,
+                            &stmt,
+                            NULL) != SQLITE_OK) {
+        log_sqlite_error (ctx, "preparing checkpt_zstd_dicts stmt");
+        set_errno_from_sqlite_error (ctx);
+        return -1;
+    }
+    while ((rc = sqlite3_step (stmt)) == SQLITE_ROW) {
+        const char *key = (const char *)sqlite3_column_text (stmt, 0);
+        const char *blobref = (const char *)sqlite3_column_text (stmt, 1);
+        unsigned int id;
+        const void *data;
+        int size;
+
+        if (!key || !blobref)
+            continue;
+        id = strtoul (key + strlen (zstd_dict_key) + 1, NULL, 10);
+        if (content_sqlite_load (ctx, blobref, &data, &size) < 0) {
+            flux_log_error (ctx->h, "loading zstd dictionary %u", id);
+            goto error;
+        }
+        rc = zstd_dict_add (ctx, id, data, size, id == current);
+        (void )sqlite3_reset (ctx->load_stmt);
+        if (rc < 0) {
+            flux_log_error (ctx->h, "zstd dictionary %u", id);
+            goto error;
+        }
+    }
+    if (rc != SQLITE_DONE) {
+        log_sqlite_error (ctx, "checkpt_zstd_dicts: executing stmt");
+        set_errno_from_sqlite_error (ctx);
+        goto error;
+    }
+    (void )sqlite3_finalize (stmt);
+    if (current != 0 && !ctx->cdict)
+        flux_log (ctx->h, LOG_ERR, "zstd dictionary %u not found", current);
+    return 0;
+error:
+    ERRNO_SAFE_WRAP (sqlite3_finalize, stmt);
+    return -1;
+}
+
+static void zstd_samples_clear (struct content_sqlite *ctx)
+{
+    free (ctx->samples);
+    free (ctx->sample_sizes);
+    ctx->samples = NULL;
+    ctx->sample_sizes = NULL;
+    ctx->samples_len = ctx->samples_size = 0;
+    ctx->nsamples = ctx->samples_max = 0;
+}
+
+/* Dictionary training runs on its own thread, over samples handed
+ * off by the module thread, so stores are not held up while it runs.
+ * The thread signals completion on an eventfd, and the result is saved
+ * and applied on the module thread, which owns sqlite and the
+ * dictionaries.
+ */
+struct zstd_train {
+    char *samples;
+    size_t *sample_sizes;
+    unsigned int nsamples;
+    void *dict;
+    size_t size;                /* dict size, or ZDICT error code */
+    pthread_t thread;
+    bool started;
+    int efd;
+    flux_watcher_t *w;
+};
+
+static void zstd_train_destroy (struct zstd_train *t)
+{
+    if (t) {
+        int saved_errno = errno;
+        if (t->started)
+            (void)pthread_join (t->thread, NULL);
+        flux_watcher_destroy (t->w);
+        if (t->efd >= 0)
+            close (t->efd);
+        free (t->samples);
+        free (t->sample_sizes);
+        free (t->dict);
+        free (t);
+        errno = saved_errno;
+    }
+}
+
+/* Training thread - only touches 't', not 'ctx'.
+ */
+static void *zstd_train_thread (void *arg)
+{
+    struct zstd_train *t = arg;
+    uint64_t val = 1;
+
+    if (!(t->dict = malloc (zstd_dict_capacity)))
+        t->size = (size_t)-1;
+    else
+        t->size = ZDICT_trainFromBuffer (t->dict,
+                                         zstd_dict_capacity,
+                                         t->samples,
+                                         t->sample_sizes,
+                                         t->nsamples);
+    if (write (t->efd, &val, sizeof (val)) < 0) {
+        /* eventfd write cannot fail unless the counter overflows */
+    }
+    return NULL;
+}
+
+/* After a failure, sample again after a delay that doubles on each
+ * failure, up to zstd_retry_max.
+ */
+static void zstd_train_failed (struct content_sqlite *ctx, unsigned int n)
+{
+    flux_log (ctx->h,
+              LOG_INFO,
+              "zstd dictionary training failed with %u samples,"
+              " retrying in %.0fs",
+              n,
+              ctx->train_retry);
+    ctx->train_after = flux_reactor_now (flux_get_reactor (ctx->h))
+                       + ctx->train_retry;
+    ctx->train_retry *= 2;
+    if (ctx->train_retry > zstd_retry_max)
+        ctx->train_retry = zstd_retry_max;
+}
+
+static void zstd_train_done_cb (flux_reactor_t *r,
+                                flux_watcher_t *w,
+                                int revents,
+                                void *arg)
+{
+    struct content_sqlite *ctx = arg;
+    struct zstd_train *t = ctx->train;
+    unsigned int id = 0;
+    uint64_t val;
+
+    if (read (t->efd, &val, sizeof (val)) < 0) {
+        if (errno == EAGAIN)
+            return;
+        flux_log_error (ctx->h, "zstd dictionary training");
+    }
+    (void)pthread_join (t->thread, NULL);
+    t->started = false;
+
+    if (!t->dict
+        || ZDICT_isError (t->size)
+        || (id = ZDICT_getDictID (t->dict, t->size)) == 0)
+        zstd_train_failed (ctx, t->nsamples);
+    else if (zstd_dict_save (ctx, id, t->dict, t->size) < 0
+        || zstd_dict_add (ctx, id, t->dict, t->size, true) < 0)
+        flux_log_error (ctx->h, "zstd dictionary %u", id);
+    else {
+        flux_log (ctx->h,
+                  LOG_INFO,
+                  "trained zstd dictionary %u from %u objects",
+                  id,
+                  t->nsamples);
+        ctx->train_retry = zstd_retry_min;
+    }
+    zstd_train_destroy (t);
+    ctx->train = NULL;
+}
+
+/* Hand the collected samples to a new training thread.
+ */
+static void zstd_train_start (struct content_sqlite *ctx)
+{
+    struct zstd_train *t;
+    sigset_t sigs, oldsigs;
+    int e;
+
+    if (!(t = calloc (1, sizeof (*t))))
+        goto error;
+    t->efd = eventfd (0, EFD_NONBLOCK | EFD_CLOEXEC);
+    if (t->efd < 0
+        || !(t->w = flux_fd_watcher_create (flux_get_reactor (ctx->h),
+                                            t->efd,
+                                            FLUX_POLLIN,
+                                            zstd_train_done_cb,
+                                            ctx)))
+        goto error;
+    t->samples = ctx->samples;
+    t->sample_sizes = ctx->sample_sizes;
+    t->nsamples = ctx->nsamples;
+    ctx->samples = NULL;
+    ctx->sample_sizes = NULL;
+    zstd_samples_clear (ctx);
+
+    /* Block signals in the thread, like workpool threads.
+     */
+    sigfillset (&sigs);
+    pthread_sigmask (SIG_SETMASK, &sigs, &oldsigs);
+    e = pthread_create (&t->thread, NULL, zstd_train_thread, t);
+    pthread_sigmask (SIG_SETMASK, &oldsigs, NULL);
+    if (e != 0) {
+        errno = e;
+        goto error;
+    }
+    t->started = true;
+    flux_watcher_start (t->w);
+    ctx->train = t;
+    return;
+error:
+    flux_log_error (ctx->h, "zstd dictionary training");
+    zstd_train_destroy (t);
+    zstd_samples_clear (ctx);
+    zstd_train_failed (ctx, 0);
+}
+
+/* Add a stored object to the training samples.
+ * Samples are only taken while there is no current dictionary.
+ */
+static void zstd_sample (struct content_sqlite *ctx,
+                         const void *data,
+                         int size)
+{
+    if (ctx->compression != COMPRESS_ZSTD
+        || ctx->cdict
+        || ctx->train
+        || ctx->samples_len >= zstd_train_bytes
+        || flux_reactor_now (flux_get_reactor (ctx->h)) < ctx->train_after
+        || size < zstd_threshold
+        || size > zstd_sample_max)
+        return;
+    if (ctx->samples_len + size > ctx->samples_size) {
+        size_t newsize = ctx->samples_size ? ctx->samples_size : 65536;
+        char *newbuf;
+        while (newsize < ctx->samples_len + size)
+            newsize *= 2;
+        if (!(newbuf = realloc (ctx->samples, newsize)))
+            return;
+        ctx->samples = newbuf;
+        ctx->samples_size = newsize;
+    }
+    if (ctx->nsamples == ctx->samples_max) {
+        unsigned int newmax = ctx->samples_max ? ctx->samples_max * 2 : 1024;
+        size_t *newsizes;
+        if (!(newsizes = realloc (ctx->sample_sizes,
+                                  sizeof (size_t) * newmax)))
+            return;
+        ctx->sample_sizes = newsizes;
+        ctx->samples_max = newmax;
+    }
+    memcpy (ctx->samples + ctx->samples_len, data, size);
+    ctx->samples_len += size;
+    ctx->sample_sizes[ctx->nsamples++] = size;
+    if (ctx->samples_len >= zstd_train_bytes)
+        zstd_train_start (ctx);
+}
+#endif
+
+/* Store blob to objects table, compressing if necessary.
+ * Blobref resulting from hash over 'data' is stored to 'blobref'.
+ * Returns 0 on success, -1 on error with errno set.
+ */
+static int content_sqlite_store (struct content_sqlite *ctx,
+                                 const void *data,
+                                 int size,
+                                 char *blobref,
+                                 int blobrefsz)
+{
+    if (content_sqlite_store_object (ctx,
+                                     data,
+                                     size,
+                                     true,
+                                     blobref,
+                                     blobrefsz) < 0)
+        return -1;
+#if HAVE_ZSTD
+    zstd_sample (ctx, data, size);
+#endif
+    return 0;
+}
+
 static void load_cb (flux_t *h,
                      flux_msg_handler_t *mh,
                      const flux_msg_t *msg,
@@ -338,34 +1021,19 @@ void checkpoint_get_cb (flux_t *h,
 {
     struct content_sqlite *ctx = arg;
     const char *key;
+    char *value;
 
     if (flux_request_unpack (msg, NULL, "{s:s}", "key", &key) < 0)
         goto error;
-    if (sqlite3_bind_text (ctx->checkpt_get_stmt,
-                           1,
-                           (char *)key,
-                           strlen (key),
-                           SQLITE_STATIC) != SQLITE_OK) {
-        log_sqlite_error (ctx, "checkpt_get: binding key");
-        set_errno_from_sqlite_error (ctx);
-        goto error;
-    }
-    if (sqlite3_step (ctx->checkpt_get_stmt) != SQLITE_ROW) {
-        errno = ENOENT;
+    if (checkpt_get (ctx, key, &value) < 0)
         goto error;
-    }
-    if (flux_respond_pack (h,
-                           msg,
-                           "{s:s}",
-                           "value",
-                           sqlite3_column_text (ctx->checkpt_get_stmt, 0)) < 0)
+    if (flux_respond_pack (h, msg, "{s:s}", "value", value) < 0)
         flux_log_error (h, "flux_respond_pack");
-    (void )sqlite3_reset (ctx->checkpt_get_stmt);
+    free (value);
     return;
 error:
     if (flux_respond_error (h, msg, errno, NULL) < 0)
         flux_log_error (h, "flux_respond_error");
-    (void )sqlite3_reset (ctx->checkpt_get_stmt);
 }
 
 void checkpoint_put_cb (flux_t *h,
@@ -389,38 +1057,65 @@ void checkpoint_put_cb (flux_t *h,
         errno = EINVAL;
         goto error;
     }
-    if (sqlite3_bind_text (ctx->checkpt_put_stmt,
-                           1,
-                           (char *)key,
-                           strlen (key),
-                           SQLITE_STATIC) != SQLITE_OK) {
-        log_sqlite_error (ctx, "checkpt_put: binding key");
-        set_errno_from_sqlite_error (ctx);
-        goto error;
-    }
-    if (sqlite3_bind_text (ctx->checkpt_put_stmt,
-                           2,
-                           (char *)value,
-                           strlen (value),
-                           SQLITE_STATIC) != SQLITE_OK) {
-        log_sqlite_error (ctx, "checkpt_put: binding value");
-        set_errno_from_sqlite_error (ctx);
-        goto error;
-    }
-    if (sqlite3_step (ctx->checkpt_put_stmt) != SQLITE_DONE
-                    && sqlite3_errcode (ctx->db) != SQLITE_CONSTRAINT) {
-        log_sqlite_error (ctx, "checkpt_put: executing stmt");
-        set_errno_from_sqlite_error (ctx);
+    if (checkpt_put (ctx, key, value) < 0)
         goto error;
-    }
     if (flux_respond (h, msg, NULL) < 0)
         flux_log_error (h, "flux_respond");
-    (void )sqlite3_reset (ctx->checkpt_put_stmt);
     return;
 error:
     if (flux_respond_error (h, msg, errno, NULL) < 0)
         flux_log_error (h, "flux_respond_error");
-    (void )sqlite3_reset (ctx->checkpt_put_stmt);
+}
+
+static double mb_per_sec (int64_t bytes, double ms)
+{
+    return ms > 0 ? (bytes / 1E6) / (ms / 1E3) : 0.;
+}
+
+static void stats_get_cb (flux_t *h,
+                          flux_msg_handler_t *mh,
+                          const flux_msg_t *msg,
+                          void *arg)
+{
+    struct content_sqlite *ctx = arg;
+    struct content_stats *stats = &ctx->stats;
+    int dict_id = 0;
+    int dict_count = 0;
+
+#if HAVE_ZSTD
+    dict_id = ctx->dict_id;
+    dict_count = zhashx_size (ctx->ddicts);
+#endif
+    if (flux_respond_pack (h,
+                           msg,
+                           "{s:s s:i s:i s:i s:i s:i s:I s:I s:f s:f s:f}",
+                           "compression",
+                           ctx->compression == COMPRESS_ZSTD ? "zstd" : "lz4",
+                           "zstd dict",
+                           dict_id,
+                           "#zstd dicts",
+                           dict_count,
+                           "#raw stores",
+                           stats->store_raw,
+                           "#lz4 stores",
+                           stats->store_lz4,
+                           "#zstd stores",
+                           stats->store_zstd,
+                           "store bytes",
+                           stats->store_bytes,
+                           "written bytes",
+                           stats->store_bytes_written,
+                           "compression ratio",
+                           stats->store_bytes_written > 0 ?
+                               (double)stats->store_bytes
+                                    / stats->store_bytes_written : 1.,
+                           "compress MB/s",
+                           mb_per_sec (stats->compress_bytes,
+                                       stats->compress_ms),
+                           "decompress MB/s",
+                           mb_per_sec (stats->decompress_bytes,
+                                       stats->decompress_ms)) < 0)
+        flux_log_error (h, "stats: flux_respond_pack");
 }
 
 static void content_sqlite_closedb (struct content_sqlite *ctx)
@@ -546,6 +1241,14 @@ static void content_sqlite_destroy (struct content_sqlite *ctx)
         flux_msg_handler_delvec (ctx->handlers);
         free (ctx->dbfile);
         free (ctx->lzo_buf);
+#if HAVE_ZSTD
+        ZSTD_freeCCtx (ctx->cctx);
+        ZSTD_freeDCtx (ctx->dctx);
+        ZSTD_freeCDict (ctx->cdict);
+        zhashx_destroy (&ctx->ddicts);
+        zstd_train_destroy (ctx->train);
+        zstd_samples_clear (ctx);
+#endif
         free (ctx);
         errno = saved_errno;
     }
@@ -556,6 +1259,7 @@ static const struct flux_msg_handler_spec htab[] = {
     { FLUX_MSGTYPE_REQUEST, "content-backing.store",   store_cb, 0 },
     { FLUX_MSGTYPE_REQUEST, "kvs-checkpoint.get", checkpoint_get_cb, 0 },
     { FLUX_MSGTYPE_REQUEST, "kvs-checkpoint.put", checkpoint_put_cb, 0 },
+    { FLUX_MSGTYPE_REQUEST, "content-sqlite.stats.get", stats_get_cb, 0 },
     FLUX_MSGHANDLER_TABLE_END,
 };
 
@@ -570,6 +1274,17 @@ static struct content_sqlite *content_sqlite_create (flux_t *h)
         goto error;
     ctx->lzo_bufsize = lzo_buf_chunksize;
     ctx->h = h;
+#if HAVE_ZSTD
+    ctx->zstd_level = zstd_default_level;
+    if (!(ctx->cctx = ZSTD_createCCtx ())
+        || !(ctx->dctx = ZSTD_createDCtx ())
+        || !(ctx->ddicts = zhashx_new ())) {
+        errno = ENOMEM;
+        goto error;
+    }
+    ctx->train_retry = zstd_retry_min;
+    zhashx_set_destructor (ctx->ddicts, ddict_destroy);
+#endif
 
     /* Some tunables:
      * - the hash function, e.g. sha1, sha256
@@ -613,6 +1328,34 @@ error:
     return NULL;
 }
 
+static int process_args (struct content_sqlite *ctx, int ac, char **av)
+{
+    int i;
+
+    for (i = 0; i < ac; i++) {
+        if (strncmp (av[i], "compression=", 12) == 0) {
+            if (!strcmp (av[i]+12, "lz4"))
+                ctx->compression = COMPRESS_LZ4;
+#if HAVE_ZSTD
+            else if (!strcmp (av[i]+12, "zstd"))
+                ctx->compression = COMPRESS_ZSTD;
+#endif
+            else {
+                flux_log (ctx->h, LOG_ERR, "Unsupported option `%s'", av[i]);
+                errno = EINVAL;
+                return -1;
+            }
+        }
+#if HAVE_ZSTD
+        else if (strncmp (av[i], "zstd-level=", 11) == 0)
+            ctx->zstd_level = strtol (av[i]+11, NULL, 10);
+#endif
+        else
+            flux_log (ctx->h, LOG_ERR, "Unknown option `%s'", av[i]);
+    }
+    return 0;
+}
+
 int mod_main (flux_t *h, int argc, char **argv)
 {
     struct content_sqlite *ctx;
@@ -621,8 +1364,16 @@ int mod_main (flux_t *h, int argc, char **argv)
         flux_log_error (h, "content_sqlite_create failed");
         return -1;
     }
+    if (process_args (ctx, argc, argv) < 0) {
+        content_sqlite_destroy (ctx);
+        return -1;
+    }
     if (content_sqlite_opendb(ctx) < 0)
         goto done;
+#if HAVE_ZSTD
+    if (zstd_dict_load_all (ctx) < 0)
+        goto done;
+#endif
     if (content_register_backing_store (h, "content-sqlite") < 0)
         goto done;
     if (content_register_service (h, "content-backing") < 0)
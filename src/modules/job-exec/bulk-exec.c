@@ -15,10 +15,12 @@
 #include <sys/wait.h>
 #define EXIT_CODE(x) __W_EXITCODE(x,0)
 
+#include <unistd.h>
 #include <flux/core.h>
 #include <flux/idset.h>
 #include <czmq.h>
 
+#include "src/common/libsubprocess/command.h"
 #include "src/common/libutil/aux.h"
 #include "bulk-exec.h"
 
@@ -28,6 +30,15 @@ struct exec_cmd {
     int flags;
 };
 
+/*  A command launched via the job-exec-relay.launch service (tree mode)
+ */
+struct exec_launch {
+    struct bulk_exec *exec;
+    char *id;
+    struct idset *ranks;     /* Ranks which have not yet exited */
+    flux_future_t *f;
+};
+
 struct bulk_exec {
     flux_t *h;
 
@@ -37,10 +48,12 @@ struct bulk_exec {
     int total;               /* Total processes expected to run */
     int started;             /* Number of processes that have reached start */
     int complete;            /* Number of processes that have completed */
+    int launched;            /* Number of ranks sent in launch requests */
 
     int exit_status;         /* Largest wait status of all complete procs */
 
     unsigned int active:1;
+    unsigned int tree:1;     /* Use job-exec-relay.launch instead of rexec */
 
     flux_watcher_t *prep;
     flux_watcher_t *check;
@@ -53,6 +66,7 @@ struct bulk_exec {
 
     zlist_t *commands;
     zlist_t *processes;
+    zlist_t *launches;
 
     struct bulk_exec_ops *handlers;
     void *arg;
@@ -65,6 +79,8 @@ int bulk_exec_rc (struct bulk_exec *exec)
 
 int bulk_exec_current (struct bulk_exec *exec)
 {
+    if (exec->tree)
+        return exec->launched - exec->complete;
     return zlist_size (exec->processes);
 }
 
@@ -76,7 +92,12 @@ int bulk_exec_total (struct bulk_exec *exec)
 int bulk_exec_write (struct bulk_exec *exec, const char *stream,
                      const char *buf, size_t len)
 {
-    flux_subprocess_t *p = zlist_first (exec->processes);
+    flux_subprocess_t *p;
+    if (exec->tree) {
+        errno = ENOTSUP;
+        return -1;
+    }
+    p = zlist_first (exec->processes);
     while (p) {
         if (flux_subprocess_write (p, stream, buf, len) < len)
             return -1;
@@ -87,7 +108,12 @@ int bulk_exec_write (struct bulk_exec *exec, const char *stream,
 
 int bulk_exec_close (struct bulk_exec *exec, const char *stream)
 {
-    flux_subprocess_t *p = zlist_first (exec->processes);
+    flux_subprocess_t *p;
+    if (exec->tree) {
+        errno = ENOTSUP;
+        return -1;
+    }
+    p = zlist_first (exec->processes);
     while (p) {
         if (flux_subprocess_close (p, stream) < 0)
             return -1;
@@ -115,7 +141,7 @@ static void exit_batch_cb (flux_reactor_t *r, flux_watcher_t *w,
     exec_exit_notify (exec);
 }
 
-/*  Append completed subprocess 'p' to the current batch for exit
+/*  Append completed 'rank' to the current batch for exit
  *   notification. If this is the first exited process in the batch,
  *   then start a timer which will fire and call the function to
  *   notify bulk_exec user of the batch of subprocess exits.
@@ -123,9 +149,8 @@ static void exit_batch_cb (flux_reactor_t *r, flux_watcher_t *w,
  *  This appraoch avoids unecessarily calling into user's callback
  *   multiple times when all tasks exit within 0.01s.
  */
-static void exit_batch_append (struct bulk_exec *exec, flux_subprocess_t *p)
+static void exit_batch_append (struct bulk_exec *exec, int rank)
 {
-    int rank = flux_subprocess_rank (p);
     if (idset_set (exec->exit_batch, rank) < 0) {
         flux_log_error (exec->h, "exit_batch_append:idset_set");
         return;
@@ -145,10 +170,10 @@ static void exit_batch_append (struct bulk_exec *exec, flux_subprocess_t *p)
     }
 }
 
-static void exec_add_completed (struct bulk_exec *exec, flux_subprocess_t *p)
+static void exec_add_completed (struct bulk_exec *exec, int rank)
 {
     /* Append this process to the current batch for notification */
-    exit_batch_append (exec, p);
+    exit_batch_append (exec, rank);
 
     if (++exec->complete == exec->total) {
         exec_exit_notify (exec);
@@ -165,7 +190,7 @@ static void exec_complete_cb (flux_subprocess_t *p)
     if (status > exec->exit_status)
         exec->exit_status = status;
 
-    exec_add_completed (exec, p);
+    exec_add_completed (exec, flux_subprocess_rank (p));
 }
 
 static void exec_state_cb (flux_subprocess_t *p, flux_subprocess_state_t state)
@@ -193,9 +218,12 @@ static void exec_state_cb (flux_subprocess_t *p, flux_subprocess_state_t state)
             exec->exit_status = code;
 
         if (exec->handlers->on_error)
-            (*exec->handlers->on_error) (exec, p, exec->arg);
+            (*exec->handlers->on_error) (exec,
+                                         flux_subprocess_rank (p),
+                                         errnum,
+                                         exec->arg);
 
-        exec_add_completed (exec, p);
+        exec_add_completed (exec, flux_subprocess_rank (p));
     }
 }
 
@@ -212,7 +240,8 @@ static void exec_output_cb (flux_subprocess_t *p, const char *stream)
     if (len) {
         int rank = flux_subprocess_rank (p);
         if (exec->handlers->on_output)
-            (*exec->handlers->on_output) (exec, p, stream, s, len, exec->arg);
+            (*exec->handlers->on_output) (exec, rank, stream, s, len,
+                                          exec->arg);
         else
             flux_log (exec->h, LOG_INFO, "rank %d: %s: %s", rank, stream, s);
     }
@@ -269,12 +298,241 @@ static int subprocess_destroy (flux_t *h, flux_subprocess_t *p)
     return 0;
 }
 
+static void exec_launch_destroy (void *arg)
+{
+    struct exec_launch *el = arg;
+    if (el) {
+        int saved_errno = errno;
+        flux_future_destroy (el->f);
+        idset_destroy (el->ranks);
+        free (el->id);
+        free (el);
+        errno = saved_errno;
+    }
+}
+
+static void exec_launch_running (struct exec_launch *el,
+                                 const struct idset *ids)
+{
+    struct bulk_exec *exec = el->exec;
+    int count = idset_count (ids);
+
+    if (count > 0 && (exec->started += count) == exec->total) {
+        if (exec->handlers->on_start)
+            (*exec->handlers->on_start) (exec, exec->arg);
+    }
+}
+
+static void exec_launch_exited (struct exec_launch *el,
+                                const struct idset *ids,
+                                int status)
+{
+    struct bulk_exec *exec = el->exec;
+    unsigned int rank;
+
+    if (status > exec->exit_status)
+        exec->exit_status = status;
+
+    rank = idset_first (ids);
+    while (rank != IDSET_INVALID_ID) {
+        if (idset_test (el->ranks, rank)) {
+            (void) idset_clear (el->ranks, rank);
+            exec_add_completed (exec, rank);
+        }
+        rank = idset_next (ids, rank);
+    }
+}
+
+static void exec_launch_error (struct exec_launch *el,
+                               const struct idset *ids,
+                               int errnum)
+{
+    struct bulk_exec *exec = el->exec;
+    unsigned int rank;
+
+    if (!exec->handlers->on_error)
+        return;
+    rank = idset_first (ids);
+    while (rank != IDSET_INVALID_ID) {
+        (*exec->handlers->on_error) (exec, rank, errnum, exec->arg);
+        rank = idset_next (ids, rank);
+    }
+}
+
+/*  The launch request failed, so treat all ranks that have not
+ *   exited as failed with EHOSTUNREACH.
+ */
+static void exec_launch_fail (struct exec_launch *el, int errnum)
+{
+    struct idset *ids;
+
+    if (idset_count (el->ranks) == 0)
+        return;
+    if (!(ids = idset_copy (el->ranks))) {
+        flux_log_error (el->exec->h, "exec_launch_fail: idset_copy");
+        return;
+    }
+    flux_log (el->exec->h, LOG_ERR,
+              "launch %s: %s", el->id, flux_strerror (errnum));
+    exec_launch_error (el, ids, errnum);
+    exec_launch_exited (el, ids, EXIT_CODE(68));
+    idset_destroy (ids);
+}
+
+static void exec_launch_state (struct exec_launch *el, json_t *o)
+{
+    const char *running = NULL;
+    const char *exited = NULL;
+    int status = 0;
+    struct idset *ids;
+
+    if (json_unpack (o, "{s?s s?s s:i}",
+                        "running", &running,
+                        "exited", &exited,
+                        "status", &status) < 0) {
+        flux_log (el->exec->h, LOG_ERR, "launch %s: invalid state", el->id);
+        return;
+    }
+    if (running) {
+        if (!(ids = idset_decode (running)))
+            flux_log_error (el->exec->h, "launch %s: running", el->id);
+        else
+            exec_launch_running (el, ids);
+        idset_destroy (ids);
+    }
+    if (exited) {
+        if (!(ids = idset_decode (exited)))
+            flux_log_error (el->exec->h, "launch %s: exited", el->id);
+        else
+            exec_launch_exited (el, ids, status);
+        idset_destroy (ids);
+    }
+}
+
+static void exec_launch_output (struct exec_launch *el, json_t *o)
+{
+    struct bulk_exec *exec = el->exec;
+    const char *stream;
+    const char *data;
+    int rank;
+
+    if (json_unpack (o, "{s:i s:s s:s}",
+                        "rank", &rank,
+                        "stream", &stream,
+                        "data", &data) < 0) {
+        flux_log (exec->h, LOG_ERR, "launch %s: invalid output", el->id);
+        return;
+    }
+    if (exec->handlers->on_output)
+        (*exec->handlers->on_output) (exec, rank, stream, data,
+                                      strlen (data), exec->arg);
+    else
+        flux_log (exec->h, LOG_INFO, "rank %d: %s: %s", rank, stream, data);
+}
+
+static void exec_launch_errors (struct exec_launch *el, json_t *o)
+{
+    const char *ranks;
+    int errnum;
+    struct idset *ids;
+
+    if (json_unpack (o, "{s:s s:i}",
+                        "ranks", &ranks,
+                        "errnum", &errnum) < 0
+        || !(ids = idset_decode (ranks))) {
+        flux_log (el->exec->h, LOG_ERR, "launch %s: invalid error", el->id);
+        return;
+    }
+    exec_launch_error (el, ids, errnum);
+    idset_destroy (ids);
+}
+
+static void exec_launch_continuation (flux_future_t *f, void *arg)
+{
+    struct exec_launch *el = arg;
+    const char *type;
+    json_t *o;
+
+    if (flux_rpc_get_unpack (f, "o", &o) < 0) {
+        /*  ENODATA terminates the stream, and all ranks should have
+         *   exited by now. Any that have not will never be reported.
+         */
+        exec_launch_fail (el, errno == ENODATA ? EPROTO : errno);
+        return;
+    }
+    if (json_unpack (o, "{s:s}", "type", &type) < 0)
+        flux_log (el->exec->h, LOG_ERR, "launch %s: invalid response", el->id);
+    else if (strcmp (type, "state") == 0)
+        exec_launch_state (el, o);
+    else if (strcmp (type, "output") == 0)
+        exec_launch_output (el, o);
+    else if (strcmp (type, "error") == 0)
+        exec_launch_errors (el, o);
+    flux_future_reset (f);
+}
+
+/*  Send one job-exec-relay.launch request for all ranks of 'cmd' to rank 0,
+ *   from which it is relayed down the TBON. Returns the number of
+ *   requests sent.
+ */
+static int exec_launch_cmd (struct bulk_exec *exec, struct exec_cmd *cmd)
+{
+    static unsigned int seq = 0;
+    struct exec_launch *el;
+    uint32_t rank;
+    char id[64];
+    char *ranks = NULL;
+    char *cmdstr = NULL;
+    int count = idset_count (cmd->ranks);
+
+    if (flux_get_rank (exec->h, &rank) < 0)
+        return -1;
+    (void) snprintf (id, sizeof (id), "%u-%ju-%u",
+                     rank, (uintmax_t) getpid (), seq++);
+    if (!(el = calloc (1, sizeof (*el))))
+        return -1;
+    el->exec = exec;
+    if (!(el->id = strdup (id))
+        || !(el->ranks = idset_copy (cmd->ranks))
+        || !(ranks = idset_encode (cmd->ranks, IDSET_FLAG_RANGE))
+        || !(cmdstr = flux_cmd_tojson (cmd->cmd)))
+        goto error;
+    if (!(el->f = flux_rpc_pack (exec->h,
+                                 "job-exec-relay.launch",
+                                 0,
+                                 FLUX_RPC_STREAMING,
+                                 "{s:s s:s s:s s:i}",
+                                 "id", el->id,
+                                 "ranks", ranks,
+                                 "cmd", cmdstr,
+                                 "flags", cmd->flags))
+        || flux_future_then (el->f, -1., exec_launch_continuation, el) < 0
+        || zlist_append (exec->launches, el) < 0)
+        goto error;
+    zlist_freefn (exec->launches, el, exec_launch_destroy, true);
+
+    idset_range_clear (cmd->ranks, 0, INT_MAX);
+    exec->launched += count;
+    free (ranks);
+    free (cmdstr);
+    return 1;
+error:
+    exec_launch_destroy (el);
+    free (ranks);
+    free (cmdstr);
+    return -1;
+}
+
 static int exec_start_cmd (struct bulk_exec *exec,
                            struct exec_cmd *cmd,
                            int max)
 {
     int count = 0;
     uint32_t rank;
+
+    if (exec->tree)
+        return exec_launch_cmd (exec, cmd);
+
     rank = idset_first (cmd->ranks);
     while (rank != IDSET_INVALID_ID && (max < 0 || count < max)) {
         flux_subprocess_t *p = flux_rexec (exec->h,
@@ -350,7 +608,7 @@ static void check_cb (flux_reactor_t *r, flux_watcher_t *w,
     if (exec_start_cmds (exec, exec->max_start_per_loop) < 0) {
         bulk_exec_stop (exec);
         if (exec->handlers->on_error)
-            (*exec->handlers->on_error) (exec, NULL, exec->arg);
+            (*exec->handlers->on_error) (exec, -1, errno, exec->arg);
     }
 }
 
@@ -358,6 +616,7 @@ void bulk_exec_destroy (struct bulk_exec *exec)
 {
     if (exec) {
         zlist_destroy (&exec->processes);
+        zlist_destroy (&exec->launches);
         zlist_destroy (&exec->commands);
         idset_destroy (exec->exit_batch);
         flux_watcher_destroy (exec->prep);
@@ -383,6 +642,7 @@ struct bulk_exec * bulk_exec_create (struct bulk_exec_ops *ops, void *arg)
     exec->handlers = ops;
     exec->arg = arg;
     exec->processes = zlist_new ();
+    exec->launches = zlist_new ();
     exec->commands = zlist_new ();
     exec->exit_batch = idset_create (0, IDSET_FLAG_AUTOGROW);
     exec->max_start_per_loop = 1;
@@ -400,6 +660,16 @@ int bulk_exec_set_max_per_loop (struct bulk_exec *exec, int max)
     return 0;
 }
 
+int bulk_exec_set_tree_launch (struct bulk_exec *exec, bool tree)
+{
+    if (exec->active) {
+        errno = EINVAL;
+        return -1;
+    }
+    exec->tree = tree;
+    return 0;
+}
+
 int bulk_exec_push_cmd (struct bulk_exec *exec,
                        const struct idset *ranks,
                        flux_cmd_t *cmd,
@@ -466,6 +736,32 @@ int bulk_exec_cancel (struct bulk_exec *exec)
     return 0;
 }
 
+/*  Forward signal to all launches in which some ranks have not exited.
+ */
+static void exec_launch_kill (struct bulk_exec *exec,
+                              flux_future_t *cf,
+                              int signum)
+{
+    struct exec_launch *el = zlist_first (exec->launches);
+
+    while (el) {
+        if (idset_count (el->ranks) > 0) {
+            flux_future_t *f = flux_rpc_pack (exec->h,
+                                              "job-exec-relay.launch-kill",
+                                              0,
+                                              0,
+                                              "{s:s s:i}",
+                                              "id", el->id,
+                                              "signal", signum);
+            if (!f || flux_future_push (cf, el->id, f) < 0) {
+                flux_log_error (exec->h, "launch %s: kill", el->id);
+                flux_future_destroy (f);
+            }
+        }
+        el = zlist_next (exec->launches);
+    }
+}
+
 flux_future_t *bulk_exec_kill (struct bulk_exec *exec, int signum)
 {
     flux_subprocess_t *p = zlist_first (exec->processes);
@@ -475,6 +771,9 @@ flux_future_t *bulk_exec_kill (struct bulk_exec *exec, int signum)
         return NULL;
     flux_future_set_flux (cf, exec->h);
 
+    if (exec->tree)
+        exec_launch_kill (exec, cf, signum);
+
     while (p) {
         if (flux_subprocess_state (p) == FLUX_SUBPROCESS_RUNNING
             || flux_subprocess_state (p) == FLUX_SUBPROCESS_INIT) {
@@ -511,13 +810,12 @@ flux_future_t *bulk_exec_kill (struct bulk_exec *exec, int signum)
 }
 
 static void imp_kill_output (struct bulk_exec *kill,
-                             flux_subprocess_t *p,
+                             int rank,
                              const char *stream,
                              const char *data,
                              int len,
                              void *arg)
 {
-    int rank = flux_subprocess_rank (p);
     flux_log (kill->h, LOG_INFO,
               "rank%d: flux-imp kill: %s: %s",
               rank,
@@ -535,12 +833,14 @@ static void imp_kill_complete (struct bulk_exec *kill, void *arg)
 }
 
 static void imp_kill_error (struct bulk_exec *kill,
-                            flux_subprocess_t *p,
+                            int rank,
+                            int errnum,
                             void *arg)
 {
-    flux_log_error (kill->h,
-                    "imp kill: rank=%d: failed",
-                    flux_subprocess_rank (p));
+    flux_log (kill->h, LOG_ERR,
+              "imp kill: rank=%d: failed: %s",
+              rank,
+              flux_strerror (errnum));
 }
 
 
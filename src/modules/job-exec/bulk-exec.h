@@ -23,14 +23,17 @@ typedef void (*exec_exit_f) (struct bulk_exec *, void *arg,
                              const struct idset *ranks);
 
 typedef void (*exec_io_f)   (struct bulk_exec *,
-                             flux_subprocess_t *,
+                             int rank,
                              const char *stream,
 			     const char *data,
 			     int data_len,
                              void *arg);
 
+/*  'rank' is -1 for errors not associated with a single rank.
+ */
 typedef void (*exec_error_f) (struct bulk_exec *,
-                              flux_subprocess_t *,
+                              int rank,
+                              int errnum,
                               void *arg);
 
 struct bulk_exec_ops {
@@ -55,6 +58,15 @@ int bulk_exec_aux_set (struct bulk_exec *exec,
  */
 int bulk_exec_set_max_per_loop (struct bulk_exec *exec, int max);
 
+/*  Launch each command with a single job-exec-relay.launch request,
+ *   which is relayed down the TBON, instead of one flux_rexec(3) per rank.
+ *   Requires the job-exec-relay module to be loaded on all ranks.
+ *   Must be called before bulk_exec_start(). bulk_exec_write(),
+ *   bulk_exec_close(), and bulk_exec_imp_kill() are not supported
+ *   in this mode.
+ */
+int bulk_exec_set_tree_launch (struct bulk_exec *exec, bool tree);
+
 void bulk_exec_destroy (struct bulk_exec *exec);
 
 int bulk_exec_push_cmd (struct bulk_exec *exec,
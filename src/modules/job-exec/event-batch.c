@@ -0,0 +1,237 @@
+/************************************************************\
+ * Copyright 2026 Lawrence Livermore National Security, LLC
+ * (c.f. AUTHORS, NOTICE.LLNS, COPYING)
+ *
+ * This file is part of the Flux resource manager framework.
+ * For details, see https://github.com/flux-framework.
+ *
+ * SPDX-License-Identifier: LGPL-3.0
+\************************************************************/
+
+/* event-batch.c - combine exec.eventlog updates into fewer commits
+ *
+ * Every job has its own guest namespace, and a KVS commit is limited
+ * to a single namespace, so a batch holds one transaction per namespace
+ * touched during the current window. When the window closes, all open
+ * transactions are committed at once. Callers are handed a future per
+ * append, which is fulfilled from the commit continuation, so code
+ * that waits for an event to be written works as before.
+ *
+ * Commits for a namespace are sent in order, and the KVS applies
+ * commits from a single sender to a namespace in the order received,
+ * so per-job event ordering is preserved across batches.
+ */
+
+#if HAVE_CONFIG_H
+# include "config.h"
+#endif
+
+#include <czmq.h>
+#include <flux/core.h>
+
+#include "event-batch.h"
+
+struct event_batch {
+    flux_t *h;
+    double timeout;
+    flux_watcher_t *timer;
+    zhashx_t *open;          /* namespace => ns_batch, current window */
+    zlistx_t *pending;       /* ns_batch commits in flight */
+};
+
+struct ns_batch {
+    struct event_batch *eb;
+    char *ns;
+    flux_kvs_txn_t *txn;
+    zlist_t *waiters;        /* futures fulfilled when commit completes */
+    flux_future_t *f;
+    void *handle;            /* handle in eb->pending */
+};
+
+static void ns_batch_destroy (struct ns_batch *b)
+{
+    if (b) {
+        int saved_errno = errno;
+        flux_future_t *f;
+        if (b->waiters) {
+            while ((f = zlist_pop (b->waiters)))
+                flux_future_decref (f);
+            zlist_destroy (&b->waiters);
+        }
+        flux_kvs_txn_destroy (b->txn);
+        flux_future_destroy (b->f);
+        free (b->ns);
+        free (b);
+        errno = saved_errno;
+    }
+}
+
+static struct ns_batch *ns_batch_create (struct event_batch *eb,
+                                         const char *ns)
+{
+    struct ns_batch *b = calloc (1, sizeof (*b));
+    if (!b)
+        return NULL;
+    b->eb = eb;
+    if (!(b->ns = strdup (ns))
+        || !(b->txn = flux_kvs_txn_create ())
+        || !(b->waiters = zlist_new ())) {
+        ns_batch_destroy (b);
+        errno = ENOMEM;
+        return NULL;
+    }
+    return b;
+}
+
+/*  Fulfill all waiters with the result of the batch commit.
+ */
+static void ns_batch_notify (struct ns_batch *b, int errnum)
+{
+    flux_future_t *f;
+    while ((f = zlist_pop (b->waiters))) {
+        if (errnum)
+            flux_future_fulfill_error (f, errnum, NULL);
+        else
+            flux_future_fulfill (f, NULL, NULL);
+        flux_future_decref (f);
+    }
+}
+
+static void commit_continuation (flux_future_t *f, void *arg)
+{
+    struct ns_batch *b = arg;
+    struct event_batch *eb = b->eb;
+    int errnum = 0;
+
+    if (flux_future_get (f, NULL) < 0) {
+        errnum = errno;
+        flux_log_error (eb->h, "%s: commit to %s failed", __FUNCTION__, b->ns);
+    }
+    zlistx_detach (eb->pending, b->handle);
+    ns_batch_notify (b, errnum);
+    ns_batch_destroy (b);
+}
+
+static void ns_batch_commit (struct event_batch *eb, struct ns_batch *b)
+{
+    if (!(b->f = flux_kvs_commit (eb->h, b->ns, 0, b->txn))
+        || flux_future_then (b->f, -1., commit_continuation, b) < 0
+        || !(b->handle = zlistx_add_end (eb->pending, b))) {
+        int errnum = errno;
+        flux_log_error (eb->h, "%s: commit to %s", __FUNCTION__, b->ns);
+        ns_batch_notify (b, errnum);
+        ns_batch_destroy (b);
+    }
+}
+
+void event_batch_flush (struct event_batch *eb)
+{
+    struct ns_batch *b;
+
+    flux_watcher_stop (eb->timer);
+    /*  Remove each batch from the open hash before commit, since a commit
+     *   error fulfills waiters, whose continuations may append again.
+     */
+    while ((b = zhashx_first (eb->open))) {
+        zhashx_delete (eb->open, b->ns);
+        ns_batch_commit (eb, b);
+    }
+}
+
+static void timer_cb (flux_reactor_t *r, flux_watcher_t *w,
+                      int revents, void *arg)
+{
+    event_batch_flush (arg);
+}
+
+flux_future_t *event_batch_append (struct event_batch *eb,
+                                   const char *ns,
+                                   const char *key,
+                                   const char *entry)
+{
+    struct ns_batch *b;
+    flux_future_t *f;
+
+    if (!eb || !ns || !key || !entry) {
+        errno = EINVAL;
+        return NULL;
+    }
+    if (!(b = zhashx_lookup (eb->open, ns))) {
+        if (!(b = ns_batch_create (eb, ns)))
+            return NULL;
+        if (zhashx_insert (eb->open, b->ns, b) < 0) {
+            ns_batch_destroy (b);
+            errno = EEXIST;
+            return NULL;
+        }
+        if (zhashx_size (eb->open) == 1) {
+            flux_timer_watcher_reset (eb->timer, eb->timeout, 0.);
+            flux_watcher_start (eb->timer);
+        }
+    }
+    if (flux_kvs_txn_put (b->txn, FLUX_KVS_APPEND, key, entry) < 0)
+        return NULL;
+    if (!(f = flux_future_create (NULL, NULL)))
+        return NULL;
+    flux_future_set_flux (f, eb->h);
+    if (zlist_append (b->waiters, f) < 0) {
+        flux_future_destroy (f);
+        errno = ENOMEM;
+        return NULL;
+    }
+    /*  Batch holds a reference until the future is fulfilled */
+    flux_future_incref (f);
+    return f;
+}
+
+void event_batch_destroy (struct event_batch *eb)
+{
+    if (eb) {
+        int saved_errno = errno;
+        struct ns_batch *b;
+
+        if (eb->open)
+            event_batch_flush (eb);
+        if (eb->pending) {
+            while ((b = zlistx_detach (eb->pending, NULL))) {
+                if (flux_future_wait_for (b->f, -1.) < 0
+                    || flux_future_get (b->f, NULL) < 0)
+                    flux_log_error (eb->h, "%s: commit to %s failed",
+                                    __FUNCTION__, b->ns);
+                ns_batch_destroy (b);
+            }
+            zlistx_destroy (&eb->pending);
+        }
+        zhashx_destroy (&eb->open);
+        flux_watcher_destroy (eb->timer);
+        free (eb);
+        errno = saved_errno;
+    }
+}
+
+struct event_batch *event_batch_create (flux_t *h, double timeout)
+{
+    struct event_batch *eb = calloc (1, sizeof (*eb));
+    if (!eb)
+        return NULL;
+    eb->h = h;
+    eb->timeout = timeout;
+    if (!(eb->open = zhashx_new ())
+        || !(eb->pending = zlistx_new ())) {
+        errno = ENOMEM;
+        goto error;
+    }
+    if (!(eb->timer = flux_timer_watcher_create (flux_get_reactor (h),
+                                                 timeout,
+                                                 0.,
+                                                 timer_cb,
+                                                 eb)))
+        goto error;
+    return eb;
+error:
+    event_batch_destroy (eb);
+    return NULL;
+}
+
+/* vi: ts=4 sw=4 expandtab
+ */
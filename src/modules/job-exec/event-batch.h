@@ -0,0 +1,48 @@
+/************************************************************\
+ * Copyright 2026 Lawrence Livermore National Security, LLC
+ * (c.f. AUTHORS, NOTICE.LLNS, COPYING)
+ *
+ * This file is part of the Flux resource manager framework.
+ * For details, see https://github.com/flux-framework.
+ *
+ * SPDX-License-Identifier: LGPL-3.0
+\************************************************************/
+
+/* Batched eventlog appends for job-exec
+ *
+ * Eventlog entries appended within a short window are combined into
+ * a single KVS transaction per namespace, and committed together when
+ * the window closes or event_batch_flush() is called. Entries for a
+ * namespace are committed in the order they were appended.
+ */
+
+#ifndef HAVE_JOB_EXEC_EVENT_BATCH_H
+#define HAVE_JOB_EXEC_EVENT_BATCH_H 1
+
+#include <flux/core.h>
+
+struct event_batch;
+
+struct event_batch *event_batch_create (flux_t *h, double timeout);
+
+/*  Commit any open batches and wait for all commits in flight.
+ */
+void event_batch_destroy (struct event_batch *eb);
+
+/*  Append encoded eventlog entry 'entry' to 'key' in namespace 'ns'.
+ *   Returns a future which is fulfilled once the commit containing
+ *   the entry completes, or is fulfilled with an error if it fails.
+ */
+flux_future_t *event_batch_append (struct event_batch *eb,
+                                   const char *ns,
+                                   const char *key,
+                                   const char *entry);
+
+/*  Commit open batches now instead of waiting for the timer.
+ */
+void event_batch_flush (struct event_batch *eb);
+
+#endif /* !HAVE_JOB_EXEC_EVENT_BATCH_H */
+
+/* vi: ts=4 sw=4 expandtab
+ */
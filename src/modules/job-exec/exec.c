@@ -14,6 +14,22 @@
  *
  * Launch configured job shell, one per rank.
  *
+ * The jobspec and R are passed to each job shell in the environment
+ * variables FLUX_JOB_JOBSPEC and FLUX_JOB_R, so that shells do not
+ * all need to fetch them from the job-info service at startup.
+ * Objects larger than JOBINFO_ENV_MAX are left for the shell to fetch.
+ *
+ * LAUNCH MODE
+ *
+ * By default, one job shell is started per rank with flux_rexec(3) from
+ * this rank ("direct" launch). With "tree" launch, a single launch
+ * request is sent down the TBON via the job-exec-relay.launch service
+ * (see launch.h), and shell state is aggregated on the way back up.
+ * Tree launch requires the job-exec-relay module on all ranks and is not
+ * supported for multiuser jobs. The default mode is set with exec.launch in the
+ * config file or launch=MODE on the module command line.  rc1 loads
+ * job-exec-relay only if exec.launch is "tree" in the config file.
+ *
  * TEST CONFIGURATION
  *
  * Test and other configuration may be presented in the jobspec
@@ -22,6 +38,7 @@
  * {
  *    "mock_exception":s       - Generate a mock execption in phase:
  *                               "init", or "starting"
+ *    "launch":s               - Override launch mode: "direct" or "tree"
  * }
  *
  */
@@ -40,12 +57,20 @@ extern char **environ;
 static const char *default_cwd = "/tmp";
 static const char *default_job_shell = NULL;
 static const char *flux_imp_path = NULL;
+static const char *default_launch = "direct";
+
+/*  Maximum encoded size of jobspec or R passed in the shell environment.
+ *   Keep this well below the kernel limit for a single environment
+ *   string (MAX_ARG_STRLEN, 128K on Linux).
+ */
+#define JOBINFO_ENV_MAX 65536
 
 /* Configuration for "bulk" execution implementation. Used only for testing
  *  for now.
  */
 struct exec_conf {
     const char *        mock_exception;   /* fake exception */
+    const char *        launch;           /* launch mode override */
 };
 
 static void exec_conf_destroy (struct exec_conf *tc)
@@ -58,11 +83,13 @@ static struct exec_conf *exec_conf_create (json_t *jobspec)
     struct exec_conf *conf = calloc (1, sizeof (*conf));
     if (conf == NULL)
         return NULL;
-    (void) json_unpack (jobspec, "{s:{s:{s:{s:{s:s}}}}}",
+    (void) json_unpack (jobspec, "{s:{s:{s:{s:{s?s s?s}}}}}",
                                  "attributes", "system", "exec",
                                      "bulkexec",
                                          "mock_exception",
-                                         &conf->mock_exception);
+                                         &conf->mock_exception,
+                                         "launch",
+                                         &conf->launch);
     return conf;
 }
 
@@ -74,6 +101,12 @@ static const char * exec_mock_exception (struct bulk_exec *exec)
     return conf->mock_exception;
 }
 
+static bool exec_tree_launch (struct exec_conf *conf)
+{
+    const char *mode = conf->launch ? conf->launch : default_launch;
+    return (strcmp (mode, "tree") == 0);
+}
+
 static const char *jobspec_get_job_shell (json_t *jobspec)
 {
     const char *path = NULL;
@@ -106,6 +139,25 @@ static const char *job_get_cwd (struct jobinfo *job)
     return (cwd);
 }
 
+/*  Set environment variable 'name' in cmd to the compact encoding of 'o'.
+ *   If the encoded object exceeds JOBINFO_ENV_MAX, do nothing, and the
+ *   job shell will fall back to fetching it from the job-info service.
+ */
+static int cmd_setenv_json (flux_cmd_t *cmd, const char *name, const json_t *o)
+{
+    char *s;
+    int rc = 0;
+
+    if (!(s = json_dumps (o, JSON_COMPACT))) {
+        errno = ENOMEM;
+        return -1;
+    }
+    if (strlen (s) < JOBINFO_ENV_MAX)
+        rc = flux_cmd_setenvf (cmd, 1, name, "%s", s);
+    free (s);
+    return rc;
+}
+
 static void start_cb (struct bulk_exec *exec, void *arg)
 {
     struct jobinfo *job = arg;
@@ -137,7 +189,7 @@ static void complete_cb (struct bulk_exec *exec, void *arg)
                             bulk_exec_rc (exec));
 }
 
-static void output_cb (struct bulk_exec *exec, flux_subprocess_t *p,
+static void output_cb (struct bulk_exec *exec, int rank,
                        const char *stream,
                        const char *data,
                        int data_len,
@@ -146,17 +198,20 @@ static void output_cb (struct bulk_exec *exec, flux_subprocess_t *p,
     struct jobinfo *job = arg;
     flux_log (job->h, LOG_INFO, "%ju: %d: %s: %s",
                       (uintmax_t) job->id,
-                      flux_subprocess_rank (p),
+                      rank,
                       stream, data);
 }
 
-static void error_cb (struct bulk_exec *exec, flux_subprocess_t *p, void *arg)
+static void error_cb (struct bulk_exec *exec, int rank, int errnum, void *arg)
 {
     struct jobinfo *job = arg;
-    const char *arg0 = flux_cmd_arg (flux_subprocess_get_cmd (p), 0);
-    jobinfo_fatal_error (job, flux_subprocess_fail_errno (p),
-                              "cmd=%s: rank=%d failed",
-                              arg0, flux_subprocess_rank (p));
+    const char *arg0 = job->multiuser ? flux_imp_path : job_shell_path (job);
+    if (rank < 0)
+        jobinfo_fatal_error (job, errnum, "cmd=%s: launch failed", arg0);
+    else
+        jobinfo_fatal_error (job, errnum,
+                             "cmd=%s: rank=%d failed",
+                             arg0, rank);
 }
 
 static struct bulk_exec_ops exec_ops = {
@@ -198,6 +253,11 @@ static int exec_init (struct jobinfo *job)
         flux_log_error (job->h, "exec_init: bulk_exec_aux_set");
         goto err;
     }
+    if (!job->multiuser && exec_tree_launch (conf)
+        && bulk_exec_set_tree_launch (exec, true) < 0) {
+        flux_log_error (job->h, "exec_init: bulk_exec_set_tree_launch");
+        goto err;
+    }
     if (!(cmd = flux_cmd_create (0, NULL, environ))) {
         flux_log_error (job->h, "exec_init: flux_cmd_create");
         goto err;
@@ -206,6 +266,12 @@ static int exec_init (struct jobinfo *job)
         flux_log_error (job->h, "exec_init: flux_cmd_setenvf");
         goto err;
     }
+    if (cmd_setenv_json (cmd, "FLUX_JOB_JOBSPEC", job->jobspec) < 0
+        || cmd_setenv_json (cmd, "FLUX_JOB_R",
+                            resource_set_get_json (job->R)) < 0) {
+        flux_log_error (job->h, "exec_init: cmd_setenv_json");
+        goto err;
+    }
     if (job->multiuser) {
         flux_cmd_setopt (cmd, "stdin_BUFSIZE", "8192");
         if (flux_cmd_argv_append (cmd, flux_imp_path) < 0
@@ -373,12 +439,32 @@ static int exec_config (flux_t *h, int argc, char **argv)
         return -1;
     }
 
+    /*  Check configuration for exec.launch */
+    if (flux_conf_unpack (flux_get_conf (h),
+                          &err,
+                          "{s?:{s?s}}",
+                          "exec",
+                            "launch", &default_launch) < 0) {
+        flux_log (h, LOG_ERR,
+                  "error reading config value exec.launch: %s",
+                  err.errbuf);
+        return -1;
+    }
+
     /* Finally, override values on cmdline */
     for (int i = 0; i < argc; i++) {
         if (strncmp (argv[i], "job-shell=", 10) == 0)
             default_job_shell = argv[i]+10;
         else if (strncmp (argv[i], "imp=", 4) == 0)
             flux_imp_path = argv[i]+4;
+        else if (strncmp (argv[i], "launch=", 7) == 0)
+            default_launch = argv[i]+7;
+    }
+    if (strcmp (default_launch, "direct") != 0
+        && strcmp (default_launch, "tree") != 0) {
+        flux_log (h, LOG_ERR, "invalid launch mode: %s", default_launch);
+        errno = EINVAL;
+        return -1;
     }
     flux_log (h, LOG_DEBUG, "using default shell path %s", default_job_shell);
     if (flux_imp_path)
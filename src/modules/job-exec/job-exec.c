@@ -66,6 +66,13 @@
  *  - the final "release final=true" response is sent to the job manager
  *  - the local job object is destroyed
  *
+ * EXEC EVENTLOG:
+ *
+ * Events posted to exec.eventlog by this module are combined with other
+ * events posted within a short window into one commit per namespace
+ * (see event-batch.h). Functions which wait for an event to be written
+ * continue once the batch containing it has been committed.
+ *
  * TEST CONFIGURATION
  *
  * The job-exec module supports an object in the jobspec under
@@ -86,8 +93,12 @@
  * {
  *   "mock_exception":s     - cancel job after a certain number of shells
  *                            have been launched.
+ *   "launch":s             - "direct" or "tree" launch of job shells
  * }
  *
+ * The "tree" launch mode requires the job-exec-relay module to be loaded
+ * on all ranks. See launch.h.
+ *
  */
 
 #if HAVE_CONFIG_H
@@ -101,9 +112,13 @@
 #include "src/common/libutil/fsd.h"
 #include "src/common/libutil/errno_safe.h"
 #include "job-exec.h"
+#include "event-batch.h"
 
 static double kill_timeout=5.0;
 
+/*  Time window over which exec.eventlog updates are combined */
+static const double event_batch_timeout = 0.01;
+
 extern struct exec_implementation testexec;
 extern struct exec_implementation bulkexec;
 
@@ -117,6 +132,7 @@ struct job_exec_ctx {
     flux_t *              h;
     flux_msg_handler_t ** handlers;
     zhashx_t *            jobs;
+    struct event_batch *  events;
 };
 
 void jobinfo_incref (struct jobinfo *job)
@@ -151,8 +167,8 @@ static struct jobinfo * jobinfo_new (void)
     return job;
 }
 
-/*  Emit an event to the exec system eventlog and return a future from
- *   flux_kvs_commit().
+/*  Emit an event to the exec system eventlog and return a future
+ *   which is fulfilled when the batched commit containing it completes.
  */
 static flux_future_t * jobinfo_emit_event_vpack (struct jobinfo *job,
                                                  const char *name,
@@ -161,7 +177,6 @@ static flux_future_t * jobinfo_emit_event_vpack (struct jobinfo *job,
 {
     int saved_errno;
     flux_t *h = job->ctx->h;
-    flux_kvs_txn_t *txn = NULL;
     flux_future_t *f = NULL;
     json_t *entry = NULL;
     char *entrystr = NULL;
@@ -175,21 +190,12 @@ static flux_future_t * jobinfo_emit_event_vpack (struct jobinfo *job,
         flux_log_error (h, "emit event: eventlog_entry_encode");
         goto out;
     }
-    if (!(txn = flux_kvs_txn_create ())) {
-        flux_log_error (h, "emit event: flux_kvs_txn_create");
-        goto out;
-    }
-    if (flux_kvs_txn_put (txn, FLUX_KVS_APPEND, key, entrystr) < 0) {
-        flux_log_error (h, "emit event: flux_kvs_txn_put");
-        goto out;
-    }
-    if (!(f = flux_kvs_commit (h, job->ns, 0, txn)))
-        flux_log_error (h, "emit event: flux_kvs_commit");
+    if (!(f = event_batch_append (job->ctx->events, job->ns, key, entrystr)))
+        flux_log_error (h, "emit event: event_batch_append");
 out:
     saved_errno = errno;
     json_decref (entry);
     free (entrystr);
-    flux_kvs_txn_destroy (txn);
     errno = saved_errno;
     return f;
 }
@@ -658,6 +664,10 @@ error_release:
 static int jobinfo_start_execution (struct jobinfo *job)
 {
     jobinfo_emit_event_pack_nowait (job, "starting", NULL);
+    /*  Job shells append to exec.eventlog directly, so commit "starting"
+     *   now to ensure it is ordered before any shell events.
+     */
+    event_batch_flush (job->ctx->events);
     /* Set started flag before calling 'start' method because we want to
      *  be sure to clean up properly if an exception occurs
      */
@@ -785,12 +795,16 @@ static int jobinfo_set_expiration (struct jobinfo *job)
 static void jobinfo_start_continue (flux_future_t *f, void *arg)
 {
     json_error_t error;
-    const char *R = NULL;
     const char *jobspec = NULL;
     struct jobinfo *job = arg;
-
-    if (flux_future_get (flux_future_get_child (f, "ns"), NULL) < 0) {
-        jobinfo_fatal_error (job, errno, "failed to create guest ns");
+    flux_future_t *f_ns = flux_future_get_child (f, "ns");
+
+    if (flux_future_get (f_ns, NULL) < 0) {
+        if (!job->R)
+            jobinfo_fatal_error (job, errno, "reading R: %s",
+                                 future_strerror (f_ns, errno));
+        else
+            jobinfo_fatal_error (job, errno, "failed to create guest ns");
         goto done;
     }
     job->has_namespace = 1;
@@ -805,14 +819,6 @@ static void jobinfo_start_continue (flux_future_t *f, void *arg)
         jobinfo_fatal_error (job, errno, "unable to fetch jobspec");
         goto done;
     }
-    if (!(R = jobinfo_kvs_lookup_get (f, "R"))) {
-        jobinfo_fatal_error (job, errno, "job does not have allocation");
-        goto done;
-    }
-    if (!(job->R = resource_set_create (R, &error))) {
-        jobinfo_fatal_error (job, errno, "reading R: %s", error.text);
-        goto done;
-    }
     if (jobinfo_set_expiration (job) < 0)
         goto done;
     if (job->multiuser) {
@@ -900,12 +906,17 @@ error:
 
 static flux_future_t *ns_create_and_link (flux_t *h,
                                           struct jobinfo *job,
+                                          uint32_t rank,
                                           int flags)
 {
     flux_future_t *f = NULL;
     flux_future_t *f2 = NULL;
 
-    if (!(f = flux_kvs_namespace_create (h, job->ns, job->userid, flags))
+    if (!(f = flux_kvs_namespace_create_rank (h,
+                                              job->ns,
+                                              job->userid,
+                                              rank,
+                                              flags))
         || !(f2 = flux_future_and_then (f, namespace_link, job))) {
         flux_log_error (h, "namespace_move: flux_future_and_then");
         flux_future_destroy (f);
@@ -914,18 +925,51 @@ static flux_future_t *ns_create_and_link (flux_t *h,
     return f2;
 }
 
+/*  Parse R, then create the guest namespace with its first rank as
+ *   leader, so that job shell commits are applied there instead of on
+ *   rank 0.  Fall back to rank 0 if R names no rank of this instance
+ *   (e.g. test R).
+ */
+static void namespace_create (flux_future_t *fprev, void *arg)
+{
+    struct jobinfo *job = arg;
+    flux_t *h = job->ctx->h;
+    flux_future_t *fnext = NULL;
+    json_error_t error;
+    const char *R;
+    uint32_t rank, size;
+
+    if (flux_kvs_lookup_get (fprev, &R) < 0) {
+        flux_future_continue_error (fprev,
+                                    errno,
+                                    "job does not have allocation");
+        goto done;
+    }
+    if (!(job->R = resource_set_create (R, &error))) {
+        flux_future_continue_error (fprev, errno, error.text);
+        goto done;
+    }
+    rank = idset_first (resource_set_ranks (job->R));
+    if (flux_get_size (h, &size) < 0 || rank >= size)
+        rank = 0;
+    if (!(fnext = ns_create_and_link (h, job, rank, 0)))
+        flux_future_continue_error (fprev, errno, NULL);
+    else
+        flux_future_continue (fprev, fnext);
+done:
+    flux_future_destroy (fprev);
+}
+
 /*  Asynchronously fetch job data from KVS and create namespace.
  */
 static flux_future_t *jobinfo_start_init (struct jobinfo *job)
 {
     flux_t *h = job->ctx->h;
     flux_future_t *f_kvs = NULL;
+    flux_future_t *f_ns = NULL;
     flux_future_t *f = flux_future_wait_all_create ();
     flux_future_set_flux (f, job->ctx->h);
 
-    if (!(f_kvs = flux_jobid_kvs_lookup (h, job->id, 0, "R"))
-        || flux_future_push (f, "R", f_kvs) < 0)
-        goto err;
     if (!(f_kvs = flux_jobid_kvs_lookup (h, job->id, 0, "jobspec"))
         || flux_future_push (f, "jobspec", f_kvs) < 0)
         goto err;
@@ -934,13 +978,18 @@ static flux_future_t *jobinfo_start_init (struct jobinfo *job)
         || flux_future_push (f, "J", f_kvs) < 0)) {
         goto err;
     }
-    if (!(f_kvs = ns_create_and_link (h, job, 0))
-        || flux_future_push (f, "ns", f_kvs))
+    /* R is fetched and parsed as part of namespace creation,
+     *  since the namespace leader is chosen from it.
+     */
+    if (!(f_kvs = flux_jobid_kvs_lookup (h, job->id, 0, "R"))
+        || !(f_ns = flux_future_and_then (f_kvs, namespace_create, job))
+        || flux_future_push (f, "ns", f_ns))
         goto err;
 
     return f;
 err:
     flux_log_error (job->ctx->h, "jobinfo_kvs_lookup/namespace_create");
+    flux_future_destroy (f_ns);
     flux_future_destroy (f_kvs);
     flux_future_destroy (f);
     return NULL;
@@ -1059,6 +1108,7 @@ static void job_exec_ctx_destroy (struct job_exec_ctx *ctx)
 {
     if (ctx == NULL)
         return;
+    event_batch_destroy (ctx->events);
     zhashx_destroy (&ctx->jobs);
     flux_msg_handler_delvec (ctx->handlers);
     free (ctx);
@@ -1074,6 +1124,10 @@ static struct job_exec_ctx * job_exec_ctx_create (flux_t *h)
         ERRNO_SAFE_WRAP (free, ctx);
         return NULL;
     }
+    if (!(ctx->events = event_batch_create (h, event_batch_timeout))) {
+        ERRNO_SAFE_WRAP (job_exec_ctx_destroy, ctx);
+        return NULL;
+    }
     return (ctx);
 }
 
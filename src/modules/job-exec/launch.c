@@ -0,0 +1,732 @@
+/************************************************************\
+ * Copyright 2026 Lawrence Livermore National Security, LLC
+ * (c.f. AUTHORS, NOTICE.LLNS, COPYING)
+ *
+ * This file is part of the Flux resource manager framework.
+ * For details, see https://github.com/flux-framework.
+ *
+ * SPDX-License-Identifier: LGPL-3.0
+\************************************************************/
+
+/* Hierarchical launch relay, see launch.h for protocol description.
+ *
+ * A launch request is handled on every rank in the subtree of the
+ * requestor which contains a target rank. Each relay starts the local
+ * process (if the current rank is a target), forwards a single request
+ * to each TBON child whose subtree contains remaining targets, and
+ * aggregates "running" and "exited" notifications from the local process
+ * and children into batches, which are sent upstream at most every
+ * LAUNCH_BATCH_TIMEOUT seconds.
+ */
+
+#if HAVE_CONFIG_H
+# include "config.h"
+#endif
+
+#include <sys/wait.h>
+#define EXIT_CODE(x) __W_EXITCODE(x,0)
+
+#include <limits.h>
+#include <czmq.h>
+#include <jansson.h>
+#include <flux/core.h>
+#include <flux/idset.h>
+
+#include "src/common/libsubprocess/command.h"
+#include "src/common/libutil/kary.h"
+#include "launch.h"
+
+#define LAUNCH_BATCH_TIMEOUT 0.01
+
+struct launch_ctx {
+    flux_t *h;
+    uint32_t rank;
+    uint32_t size;
+    int k;
+
+    flux_msg_handler_t **handlers;
+    zhashx_t *launches;
+};
+
+struct launch_child {
+    struct launch *l;
+    uint32_t rank;
+    struct idset *ranks;      /* target ranks in subtree not yet exited */
+    flux_future_t *f;
+};
+
+struct launch {
+    struct launch_ctx *ctx;
+    char *id;
+    const flux_msg_t *msg;    /* launch request, for streaming responses */
+
+    flux_subprocess_t *p;     /* local process, if this rank is a target */
+    zlistx_t *children;       /* launch_child entries */
+    int pending;              /* local process + active child streams */
+
+    struct idset *running;    /* batched state notification */
+    struct idset *exited;
+    int status;               /* largest wait status in 'exited' batch */
+    flux_watcher_t *timer;
+    unsigned int timer_armed:1;
+    unsigned int local_done:1;  /* local process exited or failed */
+};
+
+static int attr_get_int (flux_t *h, const char *attr)
+{
+    unsigned long l;
+    char *p;
+    const char *s = flux_attr_get (h, attr);
+    if (!s)
+        return (-1);
+    errno = 0;
+    l = strtoul (s, &p, 10);
+    if (*p != '\0' || errno != 0) {
+        flux_log_error (h, "flux_attr_get (%s) = %s", attr, s);
+        return (-1);
+    }
+    return (l);
+}
+
+static void launch_child_destroy (void **item)
+{
+    if (item && *item) {
+        struct launch_child *c = *item;
+        idset_destroy (c->ranks);
+        flux_future_destroy (c->f);
+        free (c);
+        *item = NULL;
+    }
+}
+
+static void launch_destroy (struct launch *l)
+{
+    if (l) {
+        int saved_errno = errno;
+        flux_subprocess_destroy (l->p);
+        zlistx_destroy (&l->children);
+        flux_watcher_destroy (l->timer);
+        idset_destroy (l->running);
+        idset_destroy (l->exited);
+        flux_msg_decref (l->msg);
+        free (l->id);
+        free (l);
+        errno = saved_errno;
+    }
+}
+
+static void launch_destructor (void **item)
+{
+    if (item) {
+        launch_destroy (*item);
+        *item = NULL;
+    }
+}
+
+/*  Send any batched state changes upstream.
+ */
+static void launch_flush (struct launch *l)
+{
+    flux_t *h = l->ctx->h;
+    json_t *o = NULL;
+    char *running = NULL;
+    char *exited = NULL;
+
+    if (l->timer_armed) {
+        flux_watcher_stop (l->timer);
+        l->timer_armed = 0;
+    }
+    if (idset_count (l->running) == 0 && idset_count (l->exited) == 0)
+        return;
+
+    if (!(o = json_pack ("{s:s s:i}", "type", "state", "status", l->status)))
+        goto nomem;
+    if (idset_count (l->running) > 0) {
+        if (!(running = idset_encode (l->running, IDSET_FLAG_RANGE))
+            || json_object_set_new (o, "running", json_string (running)) < 0)
+            goto nomem;
+    }
+    if (idset_count (l->exited) > 0) {
+        if (!(exited = idset_encode (l->exited, IDSET_FLAG_RANGE))
+            || json_object_set_new (o, "exited", json_string (exited)) < 0)
+            goto nomem;
+    }
+    if (flux_respond_pack (h, l->msg, "O", o) < 0)
+        flux_log_error (h, "launch %s: flux_respond_pack", l->id);
+    idset_range_clear (l->running, 0, INT_MAX);
+    idset_range_clear (l->exited, 0, INT_MAX);
+    l->status = 0;
+    goto out;
+nomem:
+    flux_log (h, LOG_ERR, "launch %s: failed to encode state", l->id);
+out:
+    json_decref (o);
+    free (running);
+    free (exited);
+}
+
+static void launch_batch_cb (flux_reactor_t *r, flux_watcher_t *w,
+                             int revents, void *arg)
+{
+    struct launch *l = arg;
+    l->timer_armed = 0;
+    launch_flush (l);
+}
+
+static void launch_batch_arm (struct launch *l)
+{
+    if (!l->timer_armed) {
+        flux_timer_watcher_reset (l->timer, LAUNCH_BATCH_TIMEOUT, 0.);
+        flux_watcher_start (l->timer);
+        l->timer_armed = 1;
+    }
+}
+
+static void launch_running (struct launch *l, uint32_t rank)
+{
+    if (idset_set (l->running, rank) < 0)
+        flux_log_error (l->ctx->h, "launch %s: idset_set", l->id);
+    launch_batch_arm (l);
+}
+
+static void launch_exited (struct launch *l, uint32_t rank, int status)
+{
+    if (idset_set (l->exited, rank) < 0)
+        flux_log_error (l->ctx->h, "launch %s: idset_set", l->id);
+    if (status > l->status)
+        l->status = status;
+    launch_batch_arm (l);
+}
+
+/*  Notify requestor that command failed on 'ranks' with errnum.
+ */
+static void launch_error (struct launch *l, const char *ranks, int errnum)
+{
+    if (flux_respond_pack (l->ctx->h, l->msg,
+                           "{s:s s:s s:i}",
+                           "type", "error",
+                           "ranks", ranks,
+                           "errnum", errnum) < 0)
+        flux_log_error (l->ctx->h, "launch %s: flux_respond_pack", l->id);
+}
+
+/*  Map failure to start a process to an exit code as a shell would.
+ */
+static int launch_failure_status (int errnum)
+{
+    if (errnum == EPERM || errnum == EACCES)
+        return EXIT_CODE(126);
+    else if (errnum == ENOENT)
+        return EXIT_CODE(127);
+    else if (errnum == EHOSTUNREACH)
+        return EXIT_CODE(68);
+    return EXIT_CODE(1);
+}
+
+static void launch_rank_failed (struct launch *l, uint32_t rank, int errnum)
+{
+    char s[16];
+    snprintf (s, sizeof (s), "%u", rank);
+    launch_error (l, s, errnum);
+    launch_exited (l, rank, launch_failure_status (errnum));
+}
+
+/*  Terminate the launch once the local process and all children are done.
+ *   The launch is destroyed, so it must not be accessed after this call
+ *   if it returns true.
+ */
+static bool launch_check_complete (struct launch *l)
+{
+    if (l->pending > 0)
+        return false;
+    launch_flush (l);
+    if (flux_respond_error (l->ctx->h, l->msg, ENODATA, NULL) < 0)
+        flux_log_error (l->ctx->h, "launch %s: flux_respond_error", l->id);
+    zhashx_delete (l->ctx->launches, l->id);
+    return true;
+}
+
+static void launch_pending_decr (struct launch *l)
+{
+    l->pending--;
+    (void) launch_check_complete (l);
+}
+
+/*  All remaining ranks in the subtree of child 'c' are considered lost.
+ */
+static void launch_child_fail (struct launch_child *c, int errnum)
+{
+    struct launch *l = c->l;
+    char *s;
+
+    if (idset_count (c->ranks) == 0)
+        return;
+    if (!(s = idset_encode (c->ranks, IDSET_FLAG_RANGE))
+        || idset_add (l->exited, c->ranks) < 0) {
+        flux_log_error (l->ctx->h, "launch %s: child %u", l->id, c->rank);
+        free (s);
+        return;
+    }
+    flux_log (l->ctx->h, LOG_ERR,
+              "launch %s: rank %u: lost ranks %s: %s",
+              l->id, c->rank, s, flux_strerror (errnum));
+    launch_error (l, s, errnum);
+    if (EXIT_CODE(68) > l->status)
+        l->status = EXIT_CODE(68);
+    launch_batch_arm (l);
+    idset_range_clear (c->ranks, 0, INT_MAX);
+    free (s);
+}
+
+static void launch_child_state (struct launch_child *c, json_t *o)
+{
+    struct launch *l = c->l;
+    const char *running = NULL;
+    const char *exited = NULL;
+    int status = 0;
+    struct idset *ids;
+
+    if (json_unpack (o, "{s?s s?s s:i}",
+                        "running", &running,
+                        "exited", &exited,
+                        "status", &status) < 0) {
+        flux_log (l->ctx->h, LOG_ERR,
+                  "launch %s: rank %u: invalid state response",
+                  l->id, c->rank);
+        return;
+    }
+    if (running) {
+        if (!(ids = idset_decode (running))
+            || idset_add (l->running, ids) < 0)
+            flux_log_error (l->ctx->h, "launch %s: running", l->id);
+        idset_destroy (ids);
+    }
+    if (exited) {
+        if (!(ids = idset_decode (exited))
+            || idset_add (l->exited, ids) < 0
+            || idset_subtract (c->ranks, ids) < 0)
+            flux_log_error (l->ctx->h, "launch %s: exited", l->id);
+        idset_destroy (ids);
+        if (status > l->status)
+            l->status = status;
+    }
+    launch_batch_arm (l);
+}
+
+static void launch_child_continuation (flux_future_t *f, void *arg)
+{
+    struct launch_child *c = arg;
+    struct launch *l = c->l;
+    const char *s;
+    const char *type;
+    json_t *o;
+
+    if (flux_rpc_get (f, &s) < 0) {
+        /*  ENODATA with ranks outstanding indicates a protocol error
+         *   in the child, treat it the same as any other failure.
+         */
+        launch_child_fail (c, errno == ENODATA ? EPROTO : errno);
+        launch_pending_decr (l);
+        return;
+    }
+    if (!(o = json_loads (s, 0, NULL))
+        || json_unpack (o, "{s:s}", "type", &type) < 0) {
+        flux_log (l->ctx->h, LOG_ERR,
+                  "launch %s: rank %u: malformed response",
+                  l->id, c->rank);
+    }
+    else if (strcmp (type, "state") == 0)
+        launch_child_state (c, o);
+    else if (flux_respond (l->ctx->h, l->msg, s) < 0)
+        flux_log_error (l->ctx->h, "launch %s: flux_respond", l->id);
+    json_decref (o);
+    flux_future_reset (f);
+}
+
+static struct launch_child *launch_child_get (struct launch *l, uint32_t rank)
+{
+    struct launch_child *c = zlistx_first (l->children);
+    while (c) {
+        if (c->rank == rank)
+            return c;
+        c = zlistx_next (l->children);
+    }
+    if (!(c = calloc (1, sizeof (*c))))
+        return NULL;
+    c->l = l;
+    c->rank = rank;
+    if (!(c->ranks = idset_create (0, IDSET_FLAG_AUTOGROW))
+        || !zlistx_add_end (l->children, c)) {
+        launch_child_destroy ((void **) &c);
+        errno = ENOMEM;
+        return NULL;
+    }
+    return c;
+}
+
+/* The local process may be reported FAILED after it has exited, or
+ * complete after it has failed.  Only the first of these counts.
+ */
+static bool local_finish (struct launch *l)
+{
+    if (l->local_done)
+        return false;
+    l->local_done = 1;
+    return true;
+}
+
+static void local_completion_cb (flux_subprocess_t *p)
+{
+    struct launch *l = flux_subprocess_aux_get (p, "job-exec::launch");
+    if (!local_finish (l))
+        return;
+    launch_exited (l, l->ctx->rank, flux_subprocess_status (p));
+    launch_pending_decr (l);
+}
+
+static void local_state_cb (flux_subprocess_t *p,
+                            flux_subprocess_state_t state)
+{
+    struct launch *l = flux_subprocess_aux_get (p, "job-exec::launch");
+    if (state == FLUX_SUBPROCESS_RUNNING)
+        launch_running (l, l->ctx->rank);
+    else if ((state == FLUX_SUBPROCESS_FAILED
+              || state == FLUX_SUBPROCESS_EXEC_FAILED)
+             && local_finish (l)) {
+        launch_rank_failed (l, l->ctx->rank, flux_subprocess_fail_errno (p));
+        launch_pending_decr (l);
+    }
+}
+
+static void local_output_cb (flux_subprocess_t *p, const char *stream)
+{
+    struct launch *l = flux_subprocess_aux_get (p, "job-exec::launch");
+    const char *s;
+    int len;
+
+    if (!(s = flux_subprocess_getline (p, stream, &len))) {
+        flux_log_error (l->ctx->h, "flux_subprocess_getline");
+        return;
+    }
+    if (len) {
+        if (flux_respond_pack (l->ctx->h, l->msg,
+                               "{s:s s:i s:s s:s}",
+                               "type", "output",
+                               "rank", l->ctx->rank,
+                               "stream", stream,
+                               "data", s) < 0)
+            flux_log_error (l->ctx->h, "launch %s: flux_respond_pack", l->id);
+    }
+}
+
+static int launch_start_local (struct launch *l, flux_cmd_t *cmd, int flags)
+{
+    flux_subprocess_ops_t ops = {
+        .on_completion =   local_completion_cb,
+        .on_state_change = local_state_cb,
+        .on_stdout =       local_output_cb,
+        .on_stderr =       local_output_cb,
+    };
+    if (!(l->p = flux_rexec (l->ctx->h, l->ctx->rank, flags, cmd, &ops)))
+        return -1;
+    if (flux_subprocess_aux_set (l->p, "job-exec::launch", l, NULL) < 0) {
+        flux_subprocess_destroy (l->p);
+        l->p = NULL;
+        return -1;
+    }
+    l->pending++;
+    return 0;
+}
+
+static int launch_forward (struct launch *l,
+                           struct launch_child *c,
+                           const char *cmd,
+                           int flags)
+{
+    char *ranks;
+
+    if (!(ranks = idset_encode (c->ranks, IDSET_FLAG_RANGE)))
+        return -1;
+    if (!(c->f = flux_rpc_pack (l->ctx->h,
+                                "job-exec-relay.launch",
+                                c->rank,
+                                FLUX_RPC_STREAMING,
+                                "{s:s s:s s:s s:i}",
+                                "id", l->id,
+                                "ranks", ranks,
+                                "cmd", cmd,
+                                "flags", flags))
+        || flux_future_then (c->f, -1., launch_child_continuation, c) < 0) {
+        free (ranks);
+        return -1;
+    }
+    free (ranks);
+    l->pending++;
+    return 0;
+}
+
+/*  Start the local process if this rank is in 'ids', then forward the
+ *   request for remaining ranks to the TBON children on their route.
+ *   Failures are reported per-rank in responses, so this never fails.
+ */
+static void launch_start (struct launch *l,
+                          struct idset *ids,
+                          const char *cmdstr,
+                          flux_cmd_t *cmd,
+                          int flags)
+{
+    struct launch_ctx *ctx = l->ctx;
+    struct launch_child *c;
+    unsigned int rank;
+
+    if (idset_test (ids, ctx->rank)) {
+        if (launch_start_local (l, cmd, flags) < 0)
+            launch_rank_failed (l, ctx->rank, errno);
+        (void) idset_clear (ids, ctx->rank);
+    }
+    rank = idset_first (ids);
+    while (rank != IDSET_INVALID_ID) {
+        uint32_t child = kary_child_route (ctx->k, ctx->size, ctx->rank, rank);
+        if (child == KARY_NONE)
+            launch_rank_failed (l, rank, EHOSTUNREACH);
+        else if (!(c = launch_child_get (l, child))
+                || idset_set (c->ranks, rank) < 0)
+            launch_rank_failed (l, rank, errno);
+        rank = idset_next (ids, rank);
+    }
+    c = zlistx_first (l->children);
+    while (c) {
+        if (launch_forward (l, c, cmdstr, flags) < 0)
+            launch_child_fail (c, errno);
+        c = zlistx_next (l->children);
+    }
+}
+
+static struct launch *launch_create (struct launch_ctx *ctx,
+                                     const char *id,
+                                     const flux_msg_t *msg)
+{
+    flux_reactor_t *r = flux_get_reactor (ctx->h);
+    struct launch *l = calloc (1, sizeof (*l));
+
+    if (!l)
+        return NULL;
+    l->ctx = ctx;
+    l->msg = flux_msg_incref (msg);
+    if (!(l->id = strdup (id))
+        || !(l->children = zlistx_new ())
+        || !(l->running = idset_create (0, IDSET_FLAG_AUTOGROW))
+        || !(l->exited = idset_create (0, IDSET_FLAG_AUTOGROW))
+        || !(l->timer = flux_timer_watcher_create (r,
+                                                   LAUNCH_BATCH_TIMEOUT,
+                                                   0.,
+                                                   launch_batch_cb,
+                                                   l)))
+        goto error;
+    zlistx_set_destructor (l->children, launch_child_destroy);
+    return l;
+error:
+    launch_destroy (l);
+    return NULL;
+}
+
+static void launch_cb (flux_t *h,
+                       flux_msg_handler_t *mh,
+                       const flux_msg_t *msg,
+                       void *arg)
+{
+    struct launch_ctx *ctx = arg;
+    struct launch *l = NULL;
+    struct idset *ids = NULL;
+    flux_cmd_t *cmd = NULL;
+    const char *id;
+    const char *ranks;
+    const char *cmdstr;
+    int flags;
+
+    if (flux_request_unpack (msg, NULL, "{s:s s:s s:s s:i}",
+                                        "id", &id,
+                                        "ranks", &ranks,
+                                        "cmd", &cmdstr,
+                                        "flags", &flags) < 0)
+        goto error;
+    if (!flux_msg_is_streaming (msg)) {
+        errno = EPROTO;
+        goto error;
+    }
+    if (zhashx_lookup (ctx->launches, id)) {
+        errno = EEXIST;
+        goto error;
+    }
+    if (!(ids = idset_decode (ranks)))
+        goto error;
+    if (idset_count (ids) == 0) {
+        errno = EINVAL;
+        goto error;
+    }
+    if (!(cmd = flux_cmd_fromjson (cmdstr, NULL))
+        || !(l = launch_create (ctx, id, msg)))
+        goto error;
+    if (zhashx_insert (ctx->launches, l->id, l) < 0) {
+        launch_destroy (l);
+        errno = EEXIST;
+        goto error;
+    }
+    launch_start (l, ids, cmdstr, cmd, flags);
+    (void) launch_check_complete (l);
+    idset_destroy (ids);
+    flux_cmd_destroy (cmd);
+    return;
+error:
+    if (flux_respond_error (h, msg, errno, NULL) < 0)
+        flux_log_error (h, "%s: flux_respond_error", __FUNCTION__);
+    idset_destroy (ids);
+    flux_cmd_destroy (cmd);
+}
+
+static void launch_kill_continuation (flux_future_t *cf, void *arg)
+{
+    struct launch_ctx *ctx = arg;
+    const flux_msg_t *msg = flux_future_aux_get (cf, "msg");
+    const char *name = flux_future_first_child (cf);
+    int count = 0;
+
+    while (name) {
+        if (flux_future_get (flux_future_get_child (cf, name), NULL) == 0)
+            count++;
+        name = flux_future_next_child (cf);
+    }
+    if (count > 0) {
+        if (flux_respond (ctx->h, msg, NULL) < 0)
+            flux_log_error (ctx->h, "%s: flux_respond", __FUNCTION__);
+    }
+    else if (flux_respond_error (ctx->h, msg, ENOENT, NULL) < 0)
+        flux_log_error (ctx->h, "%s: flux_respond_error", __FUNCTION__);
+    flux_future_destroy (cf);
+}
+
+/*  Signal the local process, if any, and forward the kill request
+ *   to all children with ranks still active. Respond with success if
+ *   any process in this subtree was signaled.
+ */
+static void launch_kill_cb (flux_t *h,
+                            flux_msg_handler_t *mh,
+                            const flux_msg_t *msg,
+                            void *arg)
+{
+    struct launch_ctx *ctx = arg;
+    struct launch *l;
+    struct launch_child *c;
+    flux_future_t *cf = NULL;
+    flux_future_t *f;
+    const char *id;
+    int signum;
+    char name[16];
+
+    if (flux_request_unpack (msg, NULL, "{s:s s:i}",
+                                        "id", &id,
+                                        "signal", &signum) < 0)
+        goto error;
+    if (!(l = zhashx_lookup (ctx->launches, id))) {
+        errno = ENOENT;
+        goto error;
+    }
+    if (!(cf = flux_future_wait_all_create ()))
+        goto error;
+    flux_future_set_flux (cf, h);
+    if (l->p && (flux_subprocess_state (l->p) == FLUX_SUBPROCESS_RUNNING
+                || flux_subprocess_state (l->p) == FLUX_SUBPROCESS_INIT)) {
+        if ((f = flux_subprocess_kill (l->p, signum))) {
+            snprintf (name, sizeof (name), "%u", ctx->rank);
+            if (flux_future_push (cf, name, f) < 0)
+                flux_future_destroy (f);
+        }
+    }
+    c = zlistx_first (l->children);
+    while (c) {
+        if (idset_count (c->ranks) > 0
+            && (f = flux_rpc_pack (h, "job-exec-relay.launch-kill",
+                                   c->rank, 0,
+                                   "{s:s s:i}",
+                                   "id", id,
+                                   "signal", signum))) {
+            snprintf (name, sizeof (name), "%u", c->rank);
+            if (flux_future_push (cf, name, f) < 0)
+                flux_future_destroy (f);
+        }
+        c = zlistx_next (l->children);
+    }
+    if (!flux_future_first_child (cf)) {
+        errno = ENOENT;
+        goto error;
+    }
+    if (flux_future_aux_set (cf, "msg",
+                             (void *) flux_msg_incref (msg),
+                             (flux_free_f) flux_msg_decref) < 0) {
+        flux_msg_decref (msg);
+        goto error;
+    }
+    if (flux_future_then (cf, -1., launch_kill_continuation, ctx) < 0)
+        goto error;
+    return;
+error:
+    if (flux_respond_error (h, msg, errno, NULL) < 0)
+        flux_log_error (h, "%s: flux_respond_error", __FUNCTION__);
+    flux_future_destroy (cf);
+}
+
+static const struct flux_msg_handler_spec htab[] = {
+    { FLUX_MSGTYPE_REQUEST, "job-exec-relay.launch", launch_cb, 0 },
+    { FLUX_MSGTYPE_REQUEST, "job-exec-relay.launch-kill", launch_kill_cb, 0 },
+    FLUX_MSGHANDLER_TABLE_END
+};
+
+void launch_ctx_destroy (struct launch_ctx *ctx)
+{
+    if (ctx) {
+        int saved_errno = errno;
+        flux_msg_handler_delvec (ctx->handlers);
+        if (ctx->launches) {
+            struct launch *l = zhashx_first (ctx->launches);
+            while (l) {
+                if (flux_respond_error (ctx->h, l->msg, ENOSYS, NULL) < 0)
+                    flux_log_error (ctx->h, "launch %s: flux_respond_error",
+                                    l->id);
+                l = zhashx_next (ctx->launches);
+            }
+            zhashx_destroy (&ctx->launches);
+        }
+        free (ctx);
+        errno = saved_errno;
+    }
+}
+
+struct launch_ctx *launch_ctx_create (flux_t *h)
+{
+    struct launch_ctx *ctx = calloc (1, sizeof (*ctx));
+    if (!ctx)
+        return NULL;
+    ctx->h = h;
+    if (flux_get_rank (h, &ctx->rank) < 0
+        || flux_get_size (h, &ctx->size) < 0)
+        goto error;
+    if ((ctx->k = attr_get_int (h, "tbon.arity")) <= 0) {
+        flux_log (h, LOG_ERR, "launch: unable to get tbon.arity");
+        errno = EINVAL;
+        goto error;
+    }
+    if (!(ctx->launches = zhashx_new ())) {
+        errno = ENOMEM;
+        goto error;
+    }
+    zhashx_set_destructor (ctx->launches, launch_destructor);
+    if (flux_msg_handler_addvec (h, htab, ctx, &ctx->handlers) < 0)
+        goto error;
+    return ctx;
+error:
+    launch_ctx_destroy (ctx);
+    return NULL;
+}
+
+/* vi: ts=4 sw=4 expandtab
+ */
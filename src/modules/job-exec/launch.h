@@ -0,0 +1,51 @@
+/************************************************************\
+ * Copyright 2026 Lawrence Livermore National Security, LLC
+ * (c.f. AUTHORS, NOTICE.LLNS, COPYING)
+ *
+ * This file is part of the Flux resource manager framework.
+ * For details, see https://github.com/flux-framework.
+ *
+ * SPDX-License-Identifier: LGPL-3.0
+\************************************************************/
+
+/* Hierarchical (TBON) launch service for bulk-exec
+ *
+ * A launch request has the form
+ *
+ *   {"id":s, "ranks":s, "cmd":s, "flags":i}
+ *
+ * where "id" is unique to the requestor, "ranks" is an idset of targets,
+ * and "cmd" is the command encoded with flux_cmd_tojson(3).
+ *
+ * The job-exec-relay.launch service starts a command on a set of ranks by
+ * running it locally if the current rank is a target, and forwarding
+ * the request for remaining targets to the TBON children whose subtrees
+ * contain them. State changes from the local process and children are
+ * aggregated as idsets and returned in streaming responses:
+ *
+ *   {"type":"state", "running"?:s, "exited"?:s, "status":i}
+ *   {"type":"output", "rank":i, "stream":s, "data":s}
+ *   {"type":"error", "ranks":s, "errnum":i}
+ *
+ * where "status" is the largest wait status of ranks in "exited".
+ * The stream is terminated with ENODATA once all targets have exited.
+ *
+ * The job-exec-relay.launch-kill service, {"id":s, "signal":i}, signals all
+ * active processes of a launch, and fails with ENOENT if there are none.
+ */
+
+#ifndef HAVE_JOB_EXEC_LAUNCH_H
+#define HAVE_JOB_EXEC_LAUNCH_H 1
+
+#include <flux/core.h>
+
+struct launch_ctx;
+
+struct launch_ctx *launch_ctx_create (flux_t *h);
+
+void launch_ctx_destroy (struct launch_ctx *ctx);
+
+#endif /* !HAVE_JOB_EXEC_LAUNCH_H */
+
+/* vi: ts=4 sw=4 expandtab
+ */
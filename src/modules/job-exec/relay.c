@@ -0,0 +1,43 @@
+/************************************************************\
+ * Copyright 2026 Lawrence Livermore National Security, LLC
+ * (c.f. AUTHORS, NOTICE.LLNS, COPYING)
+ *
+ * This file is part of the Flux resource manager framework.
+ * For details, see https://github.com/flux-framework.
+ *
+ * SPDX-License-Identifier: LGPL-3.0
+\************************************************************/
+
+/* job-exec-relay - provide the job-exec-relay.launch service on a rank
+ *
+ * Used by the job-exec "tree" launch mode, which requires this module
+ * on all ranks, including rank 0. See launch.h.
+ */
+
+#if HAVE_CONFIG_H
+# include "config.h"
+#endif
+#include <flux/core.h>
+
+#include "launch.h"
+
+int mod_main (flux_t *h, int argc, char **argv)
+{
+    struct launch_ctx *launch;
+    int rc = -1;
+
+    if (!(launch = launch_ctx_create (h))) {
+        flux_log_error (h, "launch_ctx_create");
+        return -1;
+    }
+    if ((rc = flux_reactor_run (flux_get_reactor (h), 0)) < 0)
+        flux_log_error (h, "flux_reactor_run");
+    launch_ctx_destroy (launch);
+    return rc;
+}
+
+MOD_NAME ("job-exec-relay");
+
+/*
+ * vi: tabstop=4 shiftwidth=4 expandtab
+ */
@@ -25,6 +25,8 @@ double resource_set_starttime (struct resource_set *rset);
 
 double resource_set_expiration (struct resource_set *rset);
 
+const json_t * resource_set_get_json (struct resource_set *rset);
+
 #endif /* !HAVE_JOB_EXEC_RSET_H */
 
 
@@ -30,6 +30,7 @@ void idsync_data_destroy (void *data)
         flux_msg_destroy (isd->msg);
         json_decref (isd->attrs);
         flux_future_destroy (isd->f_lookup);
+        flux_future_destroy (isd->f_load);
         free (isd);
     }
 }
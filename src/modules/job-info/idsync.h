@@ -23,6 +23,7 @@ struct idsync_data {
     json_t *attrs;
 
     flux_future_t *f_lookup;
+    flux_future_t *f_load;      /* read of a purged job from the KVS */
 };
 
 int idsync_setup (struct info_ctx *ctx);
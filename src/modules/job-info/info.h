@@ -25,6 +25,7 @@ struct info_ctx {
     struct job_state_ctx *jsctx;
     zlistx_t *idsync_lookups;
     zhashx_t *idsync_waits;
+    zlistx_t *list_pagers;
 };
 
 #endif /* _FLUX_JOB_INFO_INFO_H */
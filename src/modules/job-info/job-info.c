@@ -14,6 +14,8 @@
 #include <czmq.h>
 #include <flux/core.h>
 
+#include "src/common/libutil/fsd.h"
+
 #include "info.h"
 #include "allow.h"
 #include "job_state.h"
@@ -39,6 +41,7 @@ static void disconnect_cb (flux_t *h, flux_msg_handler_t *mh,
     }
     watchers_cancel (ctx, sender, FLUX_MATCHTAG_NONE);
     guest_watchers_cancel (ctx, sender, FLUX_MATCHTAG_NONE);
+    list_pagers_cancel (ctx, sender);
     free (sender);
 }
 
@@ -52,9 +55,11 @@ static void stats_cb (flux_t *h, flux_msg_handler_t *mh,
     int pending = zlistx_size (ctx->jsctx->pending);
     int running = zlistx_size (ctx->jsctx->running);
     int inactive = zlistx_size (ctx->jsctx->inactive);
+    int inactive_purged = ctx->jsctx->inactive_purged;
     int idsync_lookups = zlistx_size (ctx->idsync_lookups);
     int idsync_waits = zhashx_size (ctx->idsync_waits);
-    if (flux_respond_pack (h, msg, "{s:i s:i s:i s:{s:i s:i s:i} s:{s:i s:i}}",
+    if (flux_respond_pack (h, msg,
+                           "{s:i s:i s:i s:{s:i s:i s:i s:i} s:{s:i s:i}}",
                            "lookups", lookups,
                            "watchers", watchers,
                            "guest_watchers", guest_watchers,
@@ -62,6 +67,7 @@ static void stats_cb (flux_t *h, flux_msg_handler_t *mh,
                            "pending", pending,
                            "running", running,
                            "inactive", inactive,
+                           "inactive_purged", inactive_purged,
                            "idsync",
                            "lookups", idsync_lookups,
                            "waits", idsync_waits) < 0) {
@@ -173,16 +179,6 @@ static const struct flux_msg_handler_spec htab[] = {
       .cb           = stats_cb,
       .rolemask     = 0
     },
-    { .typemask     = FLUX_MSGTYPE_EVENT,
-      .topic_glob   = "job-state",
-      .cb           = job_state_cb,
-      .rolemask     = 0
-    },
-    { .typemask     = FLUX_MSGTYPE_EVENT,
-      .topic_glob   = "job-annotations",
-      .cb           = job_annotations_cb,
-      .rolemask     = 0
-    },
     FLUX_MSGHANDLER_TABLE_END,
 };
 
@@ -202,6 +198,8 @@ static void info_ctx_destroy (struct info_ctx *ctx)
             guest_watch_cleanup (ctx);
             zlist_destroy (&ctx->guest_watchers);
         }
+        if (ctx->list_pagers)
+            list_cleanup (ctx);
         if (ctx->jsctx)
             job_state_destroy (ctx->jsctx);
         if (ctx->idsync_lookups)
@@ -229,12 +227,71 @@ static struct info_ctx *info_ctx_create (flux_t *h)
         goto error;
     if (idsync_setup (ctx) < 0)
         goto error;
+    if (list_setup (ctx) < 0)
+        goto error;
     return ctx;
 error:
     info_ctx_destroy (ctx);
     return NULL;
 }
 
+/* Configure inactive job retention from config file, then module
+ * arguments, in that order.
+ */
+static int process_config (struct info_ctx *ctx, int argc, char **argv)
+{
+    flux_conf_error_t err;
+    int max_count = 0;
+    const char *age_limit = NULL;
+    char *endptr;
+    int i;
+
+    if (flux_conf_unpack (flux_get_conf (ctx->h),
+                          &err,
+                          "{s?{s?i s?s}}",
+                          "job-info",
+                            "inactive-max-count", &max_count,
+                            "inactive-age-limit", &age_limit) < 0) {
+        flux_log (ctx->h, LOG_ERR,
+                  "error reading job-info config: %s",
+                  err.errbuf);
+        return -1;
+    }
+
+    /* module params override config file */
+    for (i = 0; i < argc; i++) {
+        if (strncmp (argv[i], "inactive-max-count=", 19) == 0) {
+            errno = 0;
+            max_count = strtol (argv[i] + 19, &endptr, 10);
+            if (errno != 0 || *endptr != '\0') {
+                flux_log (ctx->h, LOG_ERR, "invalid %s", argv[i]);
+                errno = EINVAL;
+                return -1;
+            }
+        }
+        else if (strncmp (argv[i], "inactive-age-limit=", 19) == 0)
+            age_limit = argv[i] + 19;
+        else
+            flux_log (ctx->h, LOG_ERR, "Unknown option `%s'", argv[i]);
+    }
+
+    if (max_count < 0) {
+        flux_log (ctx->h, LOG_ERR, "inactive-max-count must be >= 0");
+        errno = EINVAL;
+        return -1;
+    }
+    ctx->jsctx->inactive_max_count = max_count;
+    if (age_limit) {
+        if (fsd_parse_duration (age_limit,
+                                &ctx->jsctx->inactive_age_limit) < 0) {
+            flux_log_error (ctx->h, "invalid inactive-age-limit: %s",
+                            age_limit);
+            return -1;
+        }
+    }
+    return 0;
+}
+
 int mod_main (flux_t *h, int argc, char **argv)
 {
     struct info_ctx *ctx;
@@ -244,6 +301,10 @@ int mod_main (flux_t *h, int argc, char **argv)
         flux_log_error (h, "initialization error");
         goto done;
     }
+    if (process_config (ctx, argc, argv) < 0)
+        goto done;
+    if (job_state_journal_start (ctx) < 0)
+        goto done;
     if (job_state_init_from_kvs (ctx) < 0)
         goto done;
     if (flux_reactor_run (flux_get_reactor (h), 0) < 0)
@@ -28,6 +28,12 @@
 
 #define NUMCMP(a,b) ((a)==(b)?0:((a)<(b)?-1:1))
 
+/* Delay before reconnecting to the job-manager journal, doubled on
+ * each failed attempt up to the maximum.
+ */
+#define JOURNAL_RETRY_MIN 0.1
+#define JOURNAL_RETRY_MAX 2.0
+
 struct state_transition {
     flux_job_state_t state;
     bool processed;
@@ -40,7 +46,7 @@ static void process_next_state (struct info_ctx *ctx, struct job *job);
  * before lower priority), t_submit second (earlier submission time
  * first) N.B. zlistx_comparator_fn signature
  */
-static int job_priority_cmp (const void *a1, const void *a2)
+int job_priority_cmp (const void *a1, const void *a2)
 {
     const struct job *j1 = a1;
     const struct job *j2 = a2;
@@ -56,7 +62,7 @@ static int job_priority_cmp (const void *a1, const void *a2)
  * running/completed comes first).  N.B. zlistx_comparator_fn
  * signature
  */
-static int job_running_cmp (const void *a1, const void *a2)
+int job_running_cmp (const void *a1, const void *a2)
 {
     const struct job *j1 = a1;
     const struct job *j2 = a2;
@@ -64,7 +70,7 @@ static int job_running_cmp (const void *a1, const void *a2)
     return NUMCMP (j2->t_run, j1->t_run);
 }
 
-static int job_inactive_cmp (const void *a1, const void *a2)
+int job_inactive_cmp (const void *a1, const void *a2)
 {
     const struct job *j1 = a1;
     const struct job *j2 = a2;
@@ -72,10 +78,150 @@ static int job_inactive_cmp (const void *a1, const void *a2)
     return NUMCMP (j2->t_inactive, j1->t_inactive);
 }
 
+int job_result_index (int result)
+{
+    switch (result) {
+        case FLUX_JOB_RESULT_COMPLETED:
+            return 0;
+        case FLUX_JOB_RESULT_FAILED:
+            return 1;
+        case FLUX_JOB_RESULT_CANCELLED:
+            return 2;
+        case FLUX_JOB_RESULT_TIMEOUT:
+            return 3;
+    }
+    return -1;
+}
+
+/* Hash numerical userid in 'key'.
+ * N.B. zhashx_hash_fn signature
+ */
+static size_t user_hasher (const void *key)
+{
+    const uint32_t *userid = key;
+    return *userid;
+}
+
+/* N.B. zhashx_comparator_fn signature
+ */
+static int user_hash_key_cmp (const void *key1, const void *key2)
+{
+    const uint32_t *u1 = key1;
+    const uint32_t *u2 = key2;
+
+    return NUMCMP (*u1, *u2);
+}
+
+static void user_jobs_destroy (void *data)
+{
+    struct user_jobs *uj = data;
+    if (uj) {
+        zlistx_destroy (&uj->pending);
+        zlistx_destroy (&uj->running);
+        zlistx_destroy (&uj->inactive);
+        free (uj);
+    }
+}
+
+static void user_jobs_destroy_wrapper (void **data)
+{
+    struct user_jobs **uj = (struct user_jobs **)data;
+    user_jobs_destroy (*uj);
+}
+
+static struct user_jobs *user_jobs_create (uint32_t userid)
+{
+    struct user_jobs *uj;
+
+    if (!(uj = calloc (1, sizeof (*uj))))
+        return NULL;
+    uj->userid = userid;
+    if (!(uj->pending = zlistx_new ())
+        || !(uj->running = zlistx_new ())
+        || !(uj->inactive = zlistx_new ())) {
+        user_jobs_destroy (uj);
+        errno = ENOMEM;
+        return NULL;
+    }
+    zlistx_set_comparator (uj->pending, job_priority_cmp);
+    zlistx_set_comparator (uj->running, job_running_cmp);
+    zlistx_set_comparator (uj->inactive, job_inactive_cmp);
+    return uj;
+}
+
+static struct user_jobs *user_jobs_get (struct job_state_ctx *jsctx,
+                                        uint32_t userid)
+{
+    struct user_jobs *uj;
+
+    if (!(uj = zhashx_lookup (jsctx->users, &userid))) {
+        if (!(uj = user_jobs_create (userid)))
+            return NULL;
+        if (zhashx_insert (jsctx->users, &uj->userid, uj) < 0) {
+            user_jobs_destroy (uj);
+            errno = EEXIST;
+            return NULL;
+        }
+    }
+    return uj;
+}
+
+/* Interned strings are stored in a hash keyed by the string itself, and
+ * reference counted.  The key points into the item, so no separate key
+ * copy is made.
+ */
+struct interned {
+    int refcount;
+    char s[];
+};
+
+static void interned_destroy_wrapper (void **data)
+{
+    if (data) {
+        free (*data);
+        *data = NULL;
+    }
+}
+
+static const char *intern_get (struct job_state_ctx *jsctx, const char *s)
+{
+    struct interned *in;
+
+    if (!(in = zhashx_lookup (jsctx->strings, s))) {
+        size_t len = strlen (s) + 1;
+        if (!(in = calloc (1, sizeof (*in) + len)))
+            return NULL;
+        memcpy (in->s, s, len);
+        if (zhashx_insert (jsctx->strings, in->s, in) < 0) {
+            free (in);
+            errno = EEXIST;
+            return NULL;
+        }
+    }
+    in->refcount++;
+    return in->s;
+}
+
+static void intern_put (struct job_state_ctx *jsctx, const char *s)
+{
+    struct interned *in;
+
+    if (s && (in = zhashx_lookup (jsctx->strings, s))) {
+        if (--in->refcount == 0)
+            zhashx_delete (jsctx->strings, s);
+    }
+}
+
 static void job_destroy (void *data)
 {
     struct job *job = data;
     if (job) {
+        if (job->compact) {
+            intern_put (job->ctx->jsctx, job->name);
+            intern_put (job->ctx->jsctx, job->exception_type);
+            intern_put (job->ctx->jsctx, job->exception_note);
+            free (job->annotations_compact);
+        }
         json_decref (job->exception_context);
         json_decref (job->annotations);
         json_decref (job->jobspec_job);
@@ -93,11 +239,11 @@ static void job_destroy_wrapper (void **data)
     job_destroy (*job);
 }
 
-void flux_msg_destroy_wrapper (void **data)
+static void json_decref_wrapper (void **data)
 {
     if (data) {
-        flux_msg_t **ptr = (flux_msg_t **)data;
-        flux_msg_destroy (*ptr);
+        json_t **ptr = (json_t **)data;
+        json_decref (*ptr);
     }
 }
 
@@ -120,10 +266,16 @@ static struct job *job_create (struct info_ctx *ctx, flux_jobid_t id)
     return job;
 }
 
+static void purge_timer_cb (flux_reactor_t *r,
+                            flux_watcher_t *w,
+                            int revents,
+                            void *arg);
+
 struct job_state_ctx *job_state_create (flux_t *h)
 {
     struct job_state_ctx *jsctx = NULL;
     int saved_errno;
+    int i;
 
     if (!(jsctx = calloc (1, sizeof (*jsctx)))) {
         flux_log_error (h, "calloc");
@@ -158,19 +310,39 @@ struct job_state_ctx *job_state_create (flux_t *h)
     if (!(jsctx->futures = zlistx_new ()))
         goto error;
 
-    if (!(jsctx->transitions = zlistx_new ()))
+    if (!(jsctx->users = zhashx_new ()))
         goto error;
-    zlistx_set_destructor (jsctx->transitions, flux_msg_destroy_wrapper);
+    zhashx_set_key_hasher (jsctx->users, user_hasher);
+    zhashx_set_key_comparator (jsctx->users, user_hash_key_cmp);
+    zhashx_set_key_duplicator (jsctx->users, NULL);
+    zhashx_set_key_destructor (jsctx->users, NULL);
+    zhashx_set_destructor (jsctx->users, user_jobs_destroy_wrapper);
+
+    for (i = 0; i < JOB_RESULT_COUNT; i++) {
+        if (!(jsctx->inactive_results[i] = zlistx_new ()))
+            goto error;
+        zlistx_set_comparator (jsctx->inactive_results[i], job_inactive_cmp);
+    }
 
-    if (flux_event_subscribe (h, "job-state") < 0) {
-        flux_log_error (h, "flux_event_subscribe");
+    if (!(jsctx->strings = zhashx_new ()))
         goto error;
-    }
+    zhashx_set_key_duplicator (jsctx->strings, NULL);
+    zhashx_set_key_destructor (jsctx->strings, NULL);
+    zhashx_set_destructor (jsctx->strings, interned_destroy_wrapper);
 
-    if (flux_event_subscribe (h, "job-annotations") < 0) {
-        flux_log_error (h, "flux_event_subscribe");
+    if (!(jsctx->transitions = zlistx_new ()))
         goto error;
-    }
+    zlistx_set_destructor (jsctx->transitions, json_decref_wrapper);
+
+    if (!(jsctx->purge_timer = flux_timer_watcher_create (flux_get_reactor (h),
+                                                          0.,
+                                                          0.,
+                                                          purge_timer_cb,
+                                                          jsctx)))
+        goto error;
+
+    jsctx->journal_seq = -1;
+    jsctx->journal_retry = JOURNAL_RETRY_MIN;
 
     return jsctx;
 
@@ -185,6 +357,7 @@ void job_state_destroy (void *data)
 {
     struct job_state_ctx *jsctx = data;
     if (jsctx) {
+        int i;
         /* Don't destroy processing until futures are complete */
         if (jsctx->futures) {
             flux_future_t *f;
@@ -200,6 +373,12 @@ void job_state_destroy (void *data)
         }
         /* Destroy index last, as it is the one that will actually
          * destroy the job objects */
+        if (jsctx->users)
+            zhashx_destroy (&jsctx->users);
+        for (i = 0; i < JOB_RESULT_COUNT; i++) {
+            if (jsctx->inactive_results[i])
+                zlistx_destroy (&jsctx->inactive_results[i]);
+        }
         if (jsctx->processing)
             zlistx_destroy (&jsctx->processing);
         if (jsctx->inactive)
@@ -210,9 +389,14 @@ void job_state_destroy (void *data)
             zlistx_destroy (&jsctx->pending);
         if (jsctx->index)
             zhashx_destroy (&jsctx->index);
+        /* interned strings are released by job destruction */
+        if (jsctx->strings)
+            zhashx_destroy (&jsctx->strings);
         if (jsctx->transitions)
             zlistx_destroy (&jsctx->transitions);
-        (void)flux_event_unsubscribe (jsctx->h, "job-state");
+        flux_future_destroy (jsctx->journal_f);
+        flux_watcher_destroy (jsctx->journal_timer);
+        flux_watcher_destroy (jsctx->purge_timer);
         free (jsctx);
     }
 }
@@ -281,6 +465,176 @@ static void update_job_state (struct info_ctx *ctx,
         (*increment)++;
 }
 
+/* Undo the state count of a job that will not be tracked, e.g. one
+ * that failed to load.
+ */
+static void job_uncount (struct info_ctx *ctx, struct job *job)
+{
+    int *counter;
+
+    if (job && (counter = state_counter (ctx, job, job->state)))
+        (*counter)--;
+}
+
+/* Release data held by an inactive job that is only needed while the
+ * job is active.  Parsed jobspec and R are dropped, strings that
+ * pointed into them are interned, and annotations are encoded.  On
+ * failure the job is left as is.
+ */
+static int job_compact (struct job_state_ctx *jsctx, struct job *job)
+{
+    const char *name = NULL;
+    const char *type = NULL;
+    const char *note = NULL;
+    char *annotations = NULL;
+    int saved_errno;
+
+    if (job->compact)
+        return 0;
+    if ((job->name && !(name = intern_get (jsctx, job->name)))
+        || (job->exception_type
+            && !(type = intern_get (jsctx, job->exception_type)))
+        || (job->exception_note
+            && !(note = intern_get (jsctx, job->exception_note))))
+        goto error;
+    if (job->annotations
+        && !(annotations = json_dumps (job->annotations, JSON_COMPACT))) {
+        errno = ENOMEM;
+        goto error;
+    }
+    job->name = name;
+    job->exception_type = type;
+    job->exception_note = note;
+    json_decref (job->exception_context);
+    job->exception_context = NULL;
+    json_decref (job->jobspec_job);
+    job->jobspec_job = NULL;
+    json_decref (job->jobspec_cmd);
+    job->jobspec_cmd = NULL;
+    json_decref (job->R);
+    job->R = NULL;
+    json_decref (job->annotations);
+    job->annotations = NULL;
+    job->annotations_compact = annotations;
+    job->compact = true;
+    return 0;
+error:
+    saved_errno = errno;
+    intern_put (jsctx, name);
+    intern_put (jsctx, type);
+    intern_put (jsctx, note);
+    errno = saved_errno;
+    return -1;
+}
+
+/* Remove an inactive job from all lists and indexes and destroy it.
+ */
+static void job_purge (struct job_state_ctx *jsctx, struct job *job)
+{
+    int i;
+
+    if (zlistx_detach (jsctx->inactive, job->list_handle) < 0)
+        flux_log_error (jsctx->h, "%s: zlistx_detach", __FUNCTION__);
+    if (job->user_list
+        && zlistx_detach (job->user_list, job->user_list_handle) < 0)
+        flux_log_error (jsctx->h, "%s: zlistx_detach", __FUNCTION__);
+    if (job->result_list_handle
+        && (i = job_result_index (job->result)) >= 0
+        && zlistx_detach (jsctx->inactive_results[i],
+                          job->result_list_handle) < 0)
+        flux_log_error (jsctx->h, "%s: zlistx_detach", __FUNCTION__);
+    /* index destructor destroys job */
+    zhashx_delete (jsctx->index, &job->id);
+    jsctx->inactive_purged++;
+}
+
+static bool job_expired (struct job_state_ctx *jsctx,
+                         struct job *job,
+                         double now)
+{
+    return (jsctx->inactive_age_limit > 0.
+            && now - job->t_inactive > jsctx->inactive_age_limit);
+}
+
+void job_state_purge_inactive (struct job_state_ctx *jsctx)
+{
+    double now = flux_reactor_now (flux_get_reactor (jsctx->h));
+    struct job *job;
+
+    if (!jsctx->inactive_max_count && !(jsctx->inactive_age_limit > 0.))
+        return;
+    /* inactive list is sorted most recent first, purge from the end */
+    while ((job = zlistx_last (jsctx->inactive))) {
+        if (!(jsctx->inactive_max_count > 0
+              && zlistx_size (jsctx->inactive) > jsctx->inactive_max_count)
+            && !job_expired (jsctx, job, now))
+            break;
+        job_purge (jsctx, job);
+    }
+    /* Purge again when the oldest remaining job expires, so the age
+     * limit is enforced even if no more jobs become inactive.
+     */
+    if (jsctx->inactive_age_limit > 0. && job) {
+        double timeout = job->t_inactive + jsctx->inactive_age_limit - now;
+        flux_timer_watcher_reset (jsctx->purge_timer,
+                                  timeout > 0. ? timeout + 0.01 : 0.01,
+                                  0.);
+        flux_watcher_start (jsctx->purge_timer);
+    }
+    else
+        flux_watcher_stop (jsctx->purge_timer);
+}
+
+static void purge_timer_cb (flux_reactor_t *r,
+                            flux_watcher_t *w,
+                            int revents,
+                            void *arg)
+{
+    job_state_purge_inactive (arg);
+}
+
+/* Add job to the secondary indexes for 'newstate'.  Like the primary
+ * lists, pending jobs are inserted in sorted order and running/inactive
+ * jobs are added to the start.
+ */
+static void job_insert_index (struct job_state_ctx *jsctx,
+                              struct job *job,
+                              flux_job_state_t newstate)
+{
+    struct user_jobs *uj;
+
+    if (!(uj = user_jobs_get (jsctx, job->userid))) {
+        flux_log_error (jsctx->h, "%s: user_jobs_get", __FUNCTION__);
+        return;
+    }
+    if (newstate == FLUX_JOB_DEPEND
+        || newstate == FLUX_JOB_SCHED) {
+        job->user_list = uj->pending;
+        job->user_list_handle = zlistx_insert (uj->pending,
+                                               job,
+                                               search_direction (job));
+    }
+    else if (newstate == FLUX_JOB_RUN
+             || newstate == FLUX_JOB_CLEANUP) {
+        job->user_list = uj->running;
+        job->user_list_handle = zlistx_add_start (uj->running, job);
+    }
+    else { /* newstate == FLUX_JOB_INACTIVE */
+        int i = job_result_index (job->result);
+
+        job->user_list = uj->inactive;
+        job->user_list_handle = zlistx_add_start (uj->inactive, job);
+        if (i >= 0
+            && !(job->result_list_handle =
+                     zlistx_add_start (jsctx->inactive_results[i], job)))
+            flux_log_error (jsctx->h, "%s: zlistx_add_start", __FUNCTION__);
+    }
+    if (!job->user_list_handle) {
+        flux_log_error (jsctx->h, "%s: zlistx_add", __FUNCTION__);
+        job->user_list = NULL;
+    }
+}
+
 static void job_insert_list (struct job_state_ctx *jsctx,
                              struct job *job,
                              flux_job_state_t newstate)
@@ -307,7 +661,10 @@ static void job_insert_list (struct job_state_ctx *jsctx,
                                                    job)))
             flux_log_error (jsctx->h, "%s: zlistx_add_start",
                             __FUNCTION__);
+        if (job_compact (jsctx, job) < 0)
+            flux_log_error (jsctx->h, "%s: job_compact", __FUNCTION__);
     }
+    job_insert_index (jsctx, job, newstate);
 }
 
 /* remove job from one list and move it to another based on the
@@ -321,6 +678,13 @@ static void job_change_list (struct job_state_ctx *jsctx,
         flux_log_error (jsctx->h, "%s: zlistx_detach",
                         __FUNCTION__);
     job->list_handle = NULL;
+    if (job->user_list) {
+        if (zlistx_detach (job->user_list, job->user_list_handle) < 0)
+            flux_log_error (jsctx->h, "%s: zlistx_detach",
+                            __FUNCTION__);
+        job->user_list = NULL;
+        job->user_list_handle = NULL;
+    }
 
     job_insert_list (jsctx, job, newstate);
 }
@@ -733,17 +1097,11 @@ static flux_future_t *state_depend_lookup (struct job_state_ctx *jsctx,
 
 static int idset_add_set (struct idset *set, struct idset *new)
 {
-    unsigned int i = idset_first (new);
-    while (i != IDSET_INVALID_ID) {
-        if (idset_test (set, i)) {
-            errno = EEXIST;
-            return -1;
-        }
-        if (idset_set (set, i) < 0)
-            return -1;
-        i = idset_next (new, i);
+    if (idset_has_intersection (set, new)) {
+        errno = EEXIST;
+        return -1;
     }
-    return 0;
+    return idset_add (set, new);
 }
 
 static int idset_set_string (struct idset *idset, const char *ids)
@@ -1011,6 +1369,9 @@ static void state_inactive_lookup_continuation (flux_future_t *f, void *arg)
     zlist_remove (job->next_states, st);
     process_next_state (ctx, job);
 
+    /* N.B. may destroy 'job' */
+    job_state_purge_inactive (ctx->jsctx);
+
 out:
     handle = zlistx_find (ctx->jsctx->futures, f);
     if (handle)
@@ -1212,38 +1573,6 @@ static void update_jobs (struct info_ctx *ctx, json_t *transitions)
 
 }
 
-void job_state_cb (flux_t *h, flux_msg_handler_t *mh,
-                   const flux_msg_t *msg, void *arg)
-{
-    struct info_ctx *ctx = arg;
-    json_t *transitions;
-
-    if (ctx->jsctx->pause) {
-        flux_msg_t *cpy;
-
-        if (!(cpy = flux_msg_copy (msg, true))) {
-            flux_log_error (h, "%s: flux_msg_copy", __FUNCTION__);
-            return;
-        }
-        if (!zlistx_add_end (ctx->jsctx->transitions, cpy)) {
-            flux_log_error (h, "%s: zlistx_add_end", __FUNCTION__);
-            flux_msg_destroy (cpy);
-        }
-    }
-    else {
-        if (flux_event_unpack (msg, NULL, "{s:o}",
-                               "transitions",
-                               &transitions) < 0) {
-            flux_log_error (h, "%s: flux_event_unpack", __FUNCTION__);
-            return;
-        }
-
-        update_jobs (ctx, transitions);
-    }
-
-    return;
-}
-
 static int parse_annotation (json_t *annotation, flux_jobid_t *id, json_t **aValue)
 {
     json_t *o;
@@ -1289,9 +1618,16 @@ static void update_annotations (struct info_ctx *ctx, json_t *annotations)
 
         if ((job = zhashx_lookup (jsctx->index, &id))) {
             json_decref (job->annotations);
-            if (json_is_null (aValue))
-                job->annotations = NULL;
-            else
+            job->annotations = NULL;
+            if (job->compact) {
+                free (job->annotations_compact);
+                job->annotations_compact = NULL;
+                if (!json_is_null (aValue)
+                    && !(job->annotations_compact = json_dumps (aValue,
+                                                                JSON_COMPACT)))
+                    flux_log_error (jsctx->h, "%s: json_dumps", __FUNCTION__);
+            }
+            else if (!json_is_null (aValue))
                 job->annotations = json_incref (aValue);
         }
         else
@@ -1301,22 +1637,171 @@ static void update_annotations (struct info_ctx *ctx, json_t *annotations)
 
 }
 
-void job_annotations_cb (flux_t *h, flux_msg_handler_t *mh,
-                         const flux_msg_t *msg, void *arg)
+/* Process one job-manager journal entry.  While paused, transitions
+ * are saved for processing on unpause.
+ */
+static void journal_process (struct info_ctx *ctx,
+                             json_t *transitions,
+                             json_t *annotations)
+{
+    struct job_state_ctx *jsctx = ctx->jsctx;
+
+    if (transitions) {
+        if (jsctx->pause) {
+            if (!zlistx_add_end (jsctx->transitions,
+                                 json_incref (transitions))) {
+                flux_log_error (ctx->h, "%s: zlistx_add_end", __FUNCTION__);
+                json_decref (transitions);
+            }
+        }
+        else
+            update_jobs (ctx, transitions);
+    }
+    if (annotations)
+        update_annotations (ctx, annotations);
+}
+
+static void journal_continuation (flux_future_t *f, void *arg);
+static void journal_reconnect (struct info_ctx *ctx, int errnum);
+
+/* Request the job-manager journal stream, resuming after
+ * jsctx->journal_seq if it is not negative.
+ */
+static flux_future_t *journal_request (struct info_ctx *ctx)
+{
+    struct job_state_ctx *jsctx = ctx->jsctx;
+    flux_future_t *f;
+
+    if (jsctx->journal_seq >= 0)
+        f = flux_rpc_pack (ctx->h, "job-manager.events", FLUX_NODEID_ANY,
+                           FLUX_RPC_STREAMING,
+                           "{s:I}", "seq", jsctx->journal_seq);
+    else
+        f = flux_rpc_pack (ctx->h, "job-manager.events", FLUX_NODEID_ANY,
+                           FLUX_RPC_STREAMING,
+                           "{}");
+    if (f)
+        jsctx->journal_connected = false;
+    return f;
+}
+
+static void journal_retry_cb (flux_reactor_t *r, flux_watcher_t *w,
+                              int revents, void *arg)
 {
     struct info_ctx *ctx = arg;
-    json_t *annotations;
+    struct job_state_ctx *jsctx = ctx->jsctx;
 
-    if (flux_event_unpack (msg, NULL, "{s:o}",
-                           "annotations",
-                           &annotations) < 0) {
-        flux_log_error (h, "%s: flux_event_unpack", __FUNCTION__);
+    if (!(jsctx->journal_f = journal_request (ctx))
+        || flux_future_then (jsctx->journal_f,
+                             -1.,
+                             journal_continuation,
+                             ctx) < 0)
+        journal_reconnect (ctx, errno);
+}
+
+/* The journal stream has ended or could not be started.  If the
+ * job-manager was unloaded or is not yet loaded, the journal of its
+ * next instance is replayed from the beginning.  Otherwise, updates may
+ * have been lost, so only new updates are requested.
+ */
+static void journal_reconnect (struct info_ctx *ctx, int errnum)
+{
+    struct job_state_ctx *jsctx = ctx->jsctx;
+
+    if (errnum == ENOSYS || errnum == ENODATA)
+        jsctx->journal_seq = 0;
+    else {
+        flux_log (ctx->h, LOG_ERR, "job-manager journal: %s, "
+                  "some job updates may be lost", flux_strerror (errnum));
+        jsctx->journal_seq = -1;
+    }
+    flux_future_destroy (jsctx->journal_f);
+    jsctx->journal_f = NULL;
+
+    flux_timer_watcher_reset (jsctx->journal_timer, jsctx->journal_retry, 0.);
+    flux_watcher_start (jsctx->journal_timer);
+    jsctx->journal_retry *= 2;
+    if (jsctx->journal_retry > JOURNAL_RETRY_MAX)
+        jsctx->journal_retry = JOURNAL_RETRY_MAX;
+}
+
+/* Handle the first journal response, which carries only the sequence
+ * number of the last entry before the stream begins.
+ */
+static int journal_connected (struct info_ctx *ctx, flux_future_t *f)
+{
+    struct job_state_ctx *jsctx = ctx->jsctx;
+    json_int_t seq;
+
+    if (flux_rpc_get_unpack (f, "{s:I}", "seq", &seq) < 0)
+        return -1;
+    jsctx->journal_seq = seq;
+    jsctx->journal_connected = true;
+    jsctx->journal_retry = JOURNAL_RETRY_MIN;
+    flux_future_reset (f);
+    return 0;
+}
+
+static void journal_continuation (flux_future_t *f, void *arg)
+{
+    struct info_ctx *ctx = arg;
+    struct job_state_ctx *jsctx = ctx->jsctx;
+    json_int_t seq;
+    json_t *transitions = NULL;
+    json_t *annotations = NULL;
+
+    if (!jsctx->journal_connected) {
+        if (journal_connected (ctx, f) < 0)
+            journal_reconnect (ctx, errno);
+        return;
+    }
+    if (flux_rpc_get_unpack (f, "{s:I s?o s?o}",
+                             "seq", &seq,
+                             "transitions", &transitions,
+                             "annotations", &annotations) < 0) {
+        journal_reconnect (ctx, errno);
         return;
     }
+    if (seq != jsctx->journal_seq + 1)
+        flux_log (ctx->h, LOG_ERR, "job-manager journal: expected seq=%ju,"
+                  " got %ju", (uintmax_t)jsctx->journal_seq + 1,
+                  (uintmax_t)seq);
+    jsctx->journal_seq = seq;
+    journal_process (ctx, transitions, annotations);
+    flux_future_reset (f);
+}
+
+int job_state_journal_start (struct info_ctx *ctx)
+{
+    struct job_state_ctx *jsctx = ctx->jsctx;
 
-    update_annotations (ctx, annotations);
+    if (!(jsctx->journal_timer = flux_timer_watcher_create (
+                                                flux_get_reactor (ctx->h),
+                                                0.,
+                                                0.,
+                                                journal_retry_cb,
+                                                ctx)))
+        return -1;
+    if (!(jsctx->journal_f = journal_request (ctx)))
+        return -1;
 
-    return;
+    /* Wait for the first response so that any job state transition
+     * not seen by job_state_init_from_kvs() is sent in the stream.
+     */
+    if (journal_connected (ctx, jsctx->journal_f) < 0) {
+        if (errno != ENOSYS) {
+            flux_log_error (ctx->h, "job-manager.events");
+            return -1;
+        }
+        journal_reconnect (ctx, errno);
+        return 0;
+    }
+    if (flux_future_then (jsctx->journal_f,
+                          -1.,
+                          journal_continuation,
+                          ctx) < 0)
+        return -1;
+    return 0;
 }
 
 void job_state_pause_cb (flux_t *h, flux_msg_handler_t *mh,
@@ -1342,14 +1827,14 @@ void job_state_unpause_cb (flux_t *h, flux_msg_handler_t *mh,
                            const flux_msg_t *msg, void *arg)
 {
     struct info_ctx *ctx = arg;
-    flux_msg_t *tmsg;
+    json_t *transitions;
 
     ctx->jsctx->pause = false;
 
-    tmsg = zlistx_first (ctx->jsctx->transitions);
-    while (tmsg) {
-        job_state_cb (h, mh, tmsg, ctx);
-        tmsg = zlistx_next (ctx->jsctx->transitions);
+    transitions = zlistx_first (ctx->jsctx->transitions);
+    while (transitions) {
+        update_jobs (ctx, transitions);
+        transitions = zlistx_next (ctx->jsctx->transitions);
     }
 
     if (flux_respond (h, msg, NULL) < 0) {
@@ -1480,6 +1965,7 @@ static struct job *eventlog_restart_parse (struct info_ctx *ctx,
     return job;
 
 error:
+    job_uncount (ctx, job);
     job_destroy (job);
     json_decref (a);
     return NULL;
@@ -1495,84 +1981,283 @@ static int depthfirst_count_depth (const char *s)
     return count;
 }
 
-static int depthfirst_map_one (struct info_ctx *ctx, const char *key,
-                               int dirskip)
+/* Read job 'id' from the KVS.  Returns job with state and data
+ * filled in per its eventlog, or NULL on error.
+ */
+static struct job *job_load_kvs (struct info_ctx *ctx, flux_jobid_t id)
 {
     struct job *job = NULL;
-    flux_jobid_t id;
     flux_future_t *f1 = NULL;
     flux_future_t *f2 = NULL;
     flux_future_t *f3 = NULL;
     const char *eventlog, *jobspec, *R;
     char path[64];
-    int rc = -1;
+    int saved_errno;
 
-    if (strlen (key) <= dirskip) {
-        errno = EINVAL;
-        return -1;
-    }
-    if (fluid_decode (key + dirskip + 1, &id, FLUID_STRING_DOTHEX) < 0)
-        return -1;
     if (flux_job_kvs_key (path, sizeof (path), id, "eventlog") < 0) {
         errno = EINVAL;
-        return -1;
+        return NULL;
     }
     if (!(f1 = flux_kvs_lookup (ctx->h, NULL, 0, path)))
-        goto done;
+        goto error;
     if (flux_kvs_lookup_get (f1, &eventlog) < 0)
-        goto done;
+        goto error;
 
     if (!(job = eventlog_restart_parse (ctx, eventlog, id)))
-        goto done;
+        goto error;
 
     if (flux_job_kvs_key (path, sizeof (path), id, "jobspec") < 0) {
         errno = EINVAL;
-        goto done;
+        goto error;
     }
     if (!(f2 = flux_kvs_lookup (ctx->h, NULL, 0, path)))
-        goto done;
+        goto error;
     if (flux_kvs_lookup_get (f2, &jobspec) < 0)
-        goto done;
+        goto error;
 
     if (jobspec_parse (ctx, job, jobspec) < 0)
-        goto done;
+        goto error;
 
     if (job->states_mask & FLUX_JOB_RUN) {
         if (flux_job_kvs_key (path, sizeof (path), id, "R") < 0) {
             errno = EINVAL;
-            return -1;
+            goto error;
         }
         if (!(f3 = flux_kvs_lookup (ctx->h, NULL, 0, path)))
-            goto done;
+            goto error;
         if (flux_kvs_lookup_get (f3, &R) < 0)
-            goto done;
+            goto error;
 
         if (R_lookup_parse (ctx, job, R) < 0)
-            goto done;
+            goto error;
     }
 
     if (job->states_mask & FLUX_JOB_INACTIVE) {
         if (eventlog_inactive_parse (ctx, job, eventlog) < 0)
-            goto done;
+            goto error;
 
         if (eventlog_inactive_finish (ctx, job) < 0)
-            goto done;
+            goto error;
+    }
+
+    flux_future_destroy (f1);
+    flux_future_destroy (f2);
+    flux_future_destroy (f3);
+    return job;
+error:
+    saved_errno = errno;
+    job_uncount (ctx, job);
+    job_destroy (job);
+    flux_future_destroy (f1);
+    flux_future_destroy (f2);
+    flux_future_destroy (f3);
+    errno = saved_errno;
+    return NULL;
+}
+
+/* Apply the inactive job retention limits while jobs are read at
+ * startup, so that memory use is bounded by the limits rather than by
+ * the number of jobs in the KVS.  Expired jobs are purged at once.
+ * Inactive jobs are added unsorted, so once there are twice as many as
+ * inactive_max_count, sort them and purge the oldest.
+ */
+static void init_retain_inactive (struct job_state_ctx *jsctx,
+                                  struct job *job)
+{
+    double now = flux_reactor_now (flux_get_reactor (jsctx->h));
+
+    if (job_expired (jsctx, job, now)) {
+        job_purge (jsctx, job);
+        return;
     }
+    if (jsctx->inactive_max_count > 0
+        && zlistx_size (jsctx->inactive) / 2 >= jsctx->inactive_max_count) {
+        zlistx_sort (jsctx->inactive);
+        job_state_purge_inactive (jsctx);
+    }
+}
+
+static int depthfirst_map_one (struct info_ctx *ctx, const char *key,
+                               int dirskip)
+{
+    struct job *job = NULL;
+    flux_jobid_t id;
+
+    if (strlen (key) <= dirskip) {
+        errno = EINVAL;
+        return -1;
+    }
+    if (fluid_decode (key + dirskip + 1, &id, FLUID_STRING_DOTHEX) < 0)
+        return -1;
+    if (!(job = job_load_kvs (ctx, id)))
+        return -1;
 
     if (zhashx_insert (ctx->jsctx->index, &job->id, job) < 0) {
         flux_log_error (ctx->h, "%s: zhashx_insert", __FUNCTION__);
-        goto done;
+        job_destroy (job);
+        return -1;
     }
     job_insert_list (ctx->jsctx, job, job->state);
+    if (job->state == FLUX_JOB_INACTIVE)
+        init_retain_inactive (ctx->jsctx, job);
 
-    rc = 1;
-done:
-    if (rc < 0)
-        job_destroy (job);
-    flux_future_destroy (f1);
-    flux_future_destroy (f2);
-    flux_future_destroy (f3);
-    return rc;
+    return 1;
+}
+
+/* State for an asynchronous read of an inactive job from the KVS.
+ * The eventlog, jobspec, and (if the job ran) R are looked up in turn,
+ * then the result future is fulfilled with the job.
+ */
+struct inactive_load {
+    struct info_ctx *ctx;
+    flux_jobid_t id;
+    struct job *job;
+    char *eventlog;
+    flux_future_t *f_lookup;
+};
+
+static const char *inactive_load_auxkey = "job-info::inactive_load";
+
+static void inactive_load_destroy (void *data)
+{
+    struct inactive_load *ld = data;
+    if (ld) {
+        int saved_errno = errno;
+        flux_future_destroy (ld->f_lookup);
+        job_destroy (ld->job);
+        free (ld->eventlog);
+        free (ld);
+        errno = saved_errno;
+    }
+}
+
+/* Look up 'key' of the job, calling 'cb' with the result future 'f'
+ * as argument.  Any previous lookup is destroyed.
+ */
+static int inactive_load_lookup (flux_future_t *f,
+                                 struct inactive_load *ld,
+                                 const char *key,
+                                 flux_continuation_f cb)
+{
+    char path[64];
+
+    flux_future_destroy (ld->f_lookup);
+    ld->f_lookup = NULL;
+    if (flux_job_kvs_key (path, sizeof (path), ld->id, key) < 0) {
+        errno = EINVAL;
+        return -1;
+    }
+    if (!(ld->f_lookup = flux_kvs_lookup (ld->ctx->h, NULL, 0, path))
+        || flux_future_then (ld->f_lookup, -1, cb, f) < 0)
+        return -1;
+    return 0;
+}
+
+static void inactive_load_finish (flux_future_t *f, struct inactive_load *ld)
+{
+    if (eventlog_inactive_parse (ld->ctx, ld->job, ld->eventlog) < 0
+        || eventlog_inactive_finish (ld->ctx, ld->job) < 0) {
+        flux_future_fulfill_error (f, errno, NULL);
+        return;
+    }
+    flux_future_fulfill (f, ld->job, job_destroy);
+    ld->job = NULL;
+}
+
+static void inactive_load_R_cb (flux_future_t *fl, void *arg)
+{
+    flux_future_t *f = arg;
+    struct inactive_load *ld = flux_future_aux_get (f, inactive_load_auxkey);
+    const char *R;
+
+    if (flux_kvs_lookup_get (fl, &R) < 0
+        || R_lookup_parse (ld->ctx, ld->job, R) < 0) {
+        flux_future_fulfill_error (f, errno, NULL);
+        return;
+    }
+    inactive_load_finish (f, ld);
+}
+
+static void inactive_load_jobspec_cb (flux_future_t *fl, void *arg)
+{
+    flux_future_t *f = arg;
+    struct inactive_load *ld = flux_future_aux_get (f, inactive_load_auxkey);
+    const char *jobspec;
+
+    if (flux_kvs_lookup_get (fl, &jobspec) < 0
+        || jobspec_parse (ld->ctx, ld->job, jobspec) < 0)
+        goto error;
+    if (ld->job->states_mask & FLUX_JOB_RUN) {
+        if (inactive_load_lookup (f, ld, "R", inactive_load_R_cb) < 0)
+            goto error;
+        return;
+    }
+    inactive_load_finish (f, ld);
+    return;
+error:
+    flux_future_fulfill_error (f, errno, NULL);
+}
+
+static void inactive_load_eventlog_cb (flux_future_t *fl, void *arg)
+{
+    flux_future_t *f = arg;
+    struct inactive_load *ld = flux_future_aux_get (f, inactive_load_auxkey);
+    const char *eventlog;
+
+    if (flux_kvs_lookup_get (fl, &eventlog) < 0)
+        goto error;
+    if (!(ld->job = eventlog_restart_parse (ld->ctx, eventlog, ld->id)))
+        goto error;
+    /* job is not tracked, undo state count from eventlog_restart_parse() */
+    job_uncount (ld->ctx, ld->job);
+    if (ld->job->state != FLUX_JOB_INACTIVE) {
+        errno = ENOENT;
+        goto error;
+    }
+    if (!(ld->eventlog = strdup (eventlog)))
+        goto error;
+    if (inactive_load_lookup (f, ld, "jobspec", inactive_load_jobspec_cb) < 0)
+        goto error;
+    return;
+error:
+    flux_future_fulfill_error (f, errno, NULL);
+}
+
+flux_future_t *job_state_load_inactive (struct info_ctx *ctx, flux_jobid_t id)
+{
+    flux_future_t *f;
+    struct inactive_load *ld;
+
+    if (!(f = flux_future_create (NULL, NULL)))
+        return NULL;
+    flux_future_set_flux (f, ctx->h);
+    if (!(ld = calloc (1, sizeof (*ld))))
+        goto error;
+    ld->ctx = ctx;
+    ld->id = id;
+    if (flux_future_aux_set (f,
+                             inactive_load_auxkey,
+                             ld,
+                             inactive_load_destroy) < 0) {
+        inactive_load_destroy (ld);
+        goto error;
+    }
+    if (inactive_load_lookup (f, ld, "eventlog", inactive_load_eventlog_cb) < 0)
+        goto error;
+    return f;
+error:
+    flux_future_destroy (f);
+    return NULL;
+}
+
+int job_state_load_inactive_get (flux_future_t *f, struct job **jobp)
+{
+    const void *job;
+
+    if (flux_future_get (f, &job) < 0)
+        return -1;
+    *jobp = (struct job *)job;
+    return 0;
 }
 
 static int depthfirst_map (struct info_ctx *ctx, const char *key,
@@ -1629,7 +2314,9 @@ int job_state_init_from_kvs (struct info_ctx *ctx)
 {
     const char *dirname = "job";
     int dirskip = strlen (dirname);
+    struct user_jobs *uj;
     int count;
+    int i;
 
     count = depthfirst_map (ctx, dirname, dirskip);
     if (count < 0)
@@ -1638,6 +2325,16 @@ int job_state_init_from_kvs (struct info_ctx *ctx)
 
     zlistx_sort (ctx->jsctx->running);
     zlistx_sort (ctx->jsctx->inactive);
+    uj = zhashx_first (ctx->jsctx->users);
+    while (uj) {
+        zlistx_sort (uj->running);
+        zlistx_sort (uj->inactive);
+        uj = zhashx_next (ctx->jsctx->users);
+    }
+    for (i = 0; i < JOB_RESULT_COUNT; i++)
+        zlistx_sort (ctx->jsctx->inactive_results[i]);
+
+    job_state_purge_inactive (ctx->jsctx);
     return 0;
 }
 
@@ -33,8 +33,32 @@
  * cannot yet be stored on one of the lists above.
  *
  * The list `futures` is used to store in process futures.
+ *
+ * To avoid scanning every job when a query filters on userid or
+ * job result, jobs are also indexed:
+ *
+ * - users - hash of userid to a `struct user_jobs`, which holds per-user
+ *   pending, running, and inactive lists sorted identically to the
+ *   lists above.
+ * - inactive_results - one list of inactive jobs per job result,
+ *   indexed by job_result_index(), sorted like the inactive list.
+ *
+ * Inactive jobs are compacted: data only needed while the job is
+ * active is released, strings are interned in `strings`, and
+ * annotations are kept encoded until requested.  The number and age
+ * of retained inactive jobs may be bounded, the oldest inactive jobs
+ * are purged first.  Purged jobs remain available in the KVS.
  */
 
+#define JOB_RESULT_COUNT 4
+
+struct user_jobs {
+    uint32_t userid;
+    zlistx_t *pending;
+    zlistx_t *running;
+    zlistx_t *inactive;
+};
+
 struct job_state_ctx {
     flux_t *h;
     zhashx_t *index;
@@ -44,6 +68,17 @@ struct job_state_ctx {
     zlistx_t *processing;
     zlistx_t *futures;
 
+    /* secondary indexes */
+    zhashx_t *users;
+    zlistx_t *inactive_results[JOB_RESULT_COUNT];
+
+    /* inactive job retention, 0 = unlimited */
+    int inactive_max_count;
+    double inactive_age_limit;
+    int inactive_purged;
+    flux_watcher_t *purge_timer;
+    zhashx_t *strings;
+
     /* count current jobs in what states */
     int depend_count;
     int sched_count;
@@ -55,6 +90,14 @@ struct job_state_ctx {
      * processing later */
     bool pause;
     zlistx_t *transitions;
+
+    /* job-manager journal stream, reconnected with increasing delay
+     * while the job-manager is not loaded */
+    flux_future_t *journal_f;
+    bool journal_connected;
+    json_int_t journal_seq;
+    flux_watcher_t *journal_timer;
+    double journal_retry;
 };
 
 struct job {
@@ -80,6 +123,12 @@ struct job {
     flux_job_result_t result;
     json_t *annotations;
 
+    /* compacted inactive job: name and exception strings are interned,
+     * json objects below are released, and annotations are encoded
+     */
+    bool compact;
+    char *annotations_compact;
+
     /* cache of job information */
     json_t *jobspec_job;
     json_t *jobspec_cmd;
@@ -99,6 +148,11 @@ struct job {
     unsigned int states_mask;
     void *list_handle;
 
+    /* handles into secondary indexes, NULL if not indexed */
+    zlistx_t *user_list;
+    void *user_list_handle;
+    void *result_list_handle;
+
     /* timestamp of when we enter the state
      *
      * associated eventlog entries when restarting
@@ -121,11 +175,17 @@ struct job_state_ctx *job_state_create (flux_t *h);
 
 void job_state_destroy (void *data);
 
-void job_state_cb (flux_t *h, flux_msg_handler_t *mh,
-                   const flux_msg_t *msg, void *arg);
+/* Comparators used to sort the pending, running, and inactive lists.
+ * N.B. zlistx_comparator_fn signature
+ */
+int job_priority_cmp (const void *a1, const void *a2);
+int job_running_cmp (const void *a1, const void *a2);
+int job_inactive_cmp (const void *a1, const void *a2);
 
-void job_annotations_cb (flux_t *h, flux_msg_handler_t *mh,
-                         const flux_msg_t *msg, void *arg);
+/* Map a single job result to an index into inactive_results[].
+ * Returns -1 if 'result' is not exactly one valid result.
+ */
+int job_result_index (int result);
 
 void job_state_pause_cb (flux_t *h, flux_msg_handler_t *mh,
                          const flux_msg_t *msg, void *arg);
@@ -133,8 +193,29 @@ void job_state_pause_cb (flux_t *h, flux_msg_handler_t *mh,
 void job_state_unpause_cb (flux_t *h, flux_msg_handler_t *mh,
                            const flux_msg_t *msg, void *arg);
 
+/* Begin receiving job state transitions and annotation updates from
+ * the job-manager journal.  This should be called before
+ * job_state_init_from_kvs() so that no updates are missed.
+ */
+int job_state_journal_start (struct info_ctx *ctx);
+
 int job_state_init_from_kvs (struct info_ctx *ctx);
 
+/* Purge inactive jobs beyond the configured retention limits.  If an
+ * age limit is set, a timer is armed to purge again when the oldest
+ * remaining job reaches it.
+ */
+void job_state_purge_inactive (struct job_state_ctx *jsctx);
+
+/* Read inactive job 'id' from the KVS, for jobs that have been purged.
+ * The returned future is fulfilled once the job has been read.  The job
+ * is not indexed, and is valid until the future is destroyed.
+ * job_state_load_inactive_get() fails with ENOENT if the job is not
+ * inactive.
+ */
+flux_future_t *job_state_load_inactive (struct info_ctx *ctx, flux_jobid_t id);
+int job_state_load_inactive_get (flux_future_t *f, struct job **jobp);
+
 #endif /* ! _FLUX_JOB_INFO_JOB_STATE_H */
 
 /*
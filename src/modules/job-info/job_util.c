@@ -157,9 +157,13 @@ json_t *job_to_json (struct job *job, json_t *attrs, job_info_error_t *errp)
             val = json_integer (job->result);
         }
         else if (!strcmp (attr, "annotations")) {
-            if (!job->annotations)
+            /* compacted inactive jobs keep annotations encoded */
+            if (job->annotations_compact)
+                val = json_loads (job->annotations_compact, 0, NULL);
+            else if (job->annotations)
+                val = json_incref (job->annotations);
+            else
                 continue;
-            val = json_incref (job->annotations);
         }
         else {
             seterror (errp, "%s is not a valid attribute", attr);
@@ -44,15 +44,124 @@ bool job_filter (struct job *job, uint32_t userid, int states, int results)
     return true;
 }
 
-/* Put jobs from list onto jobs array, breaking if max_entries has
- * been reached. Returns 1 if jobs array is full, 0 if continue, -1
- * one error with errno set:
+/* Jobs are returned from the pending, running, and inactive lists,
+ * in that order.  A cursor records the list and sort key of the last
+ * job returned, so that a later request can resume after it.  The
+ * cursor is opaque to callers.
+ */
+enum {
+    LIST_PENDING = 0,
+    LIST_RUNNING = 1,
+    LIST_INACTIVE = 2,
+    LIST_COUNT = 3,
+};
+
+#define LIST_DEFAULT_PAGE_SIZE 1000
+
+struct list_cursor {
+    int list;
+    bool resume;
+    struct job key;     /* id and sort key fields of last job returned */
+};
+
+static zlistx_comparator_fn *list_comparators[LIST_COUNT] = {
+    job_priority_cmp,
+    job_running_cmp,
+    job_inactive_cmp,
+};
+
+static void cursor_set (struct list_cursor *cursor, int list, struct job *job)
+{
+    cursor->list = list;
+    cursor->resume = true;
+    cursor->key.id = job->id;
+    cursor->key.priority = job->priority;
+    cursor->key.t_submit = job->t_submit;
+    cursor->key.t_run = job->t_run;
+    cursor->key.t_inactive = job->t_inactive;
+}
+
+static json_t *cursor_encode (struct list_cursor *cursor)
+{
+    json_t *o;
+
+    if (!(o = json_pack ("{s:i s:I s:i s:f s:f s:f}",
+                         "list", cursor->list,
+                         "id", cursor->key.id,
+                         "priority", cursor->key.priority,
+                         "t_submit", cursor->key.t_submit,
+                         "t_run", cursor->key.t_run,
+                         "t_inactive", cursor->key.t_inactive))) {
+        errno = ENOMEM;
+        return NULL;
+    }
+    return o;
+}
+
+static int cursor_decode (json_t *o, struct list_cursor *cursor)
+{
+    memset (cursor, 0, sizeof (*cursor));
+    if (json_unpack (o, "{s:i s:I s:i s:F s:F s:F}",
+                     "list", &cursor->list,
+                     "id", &cursor->key.id,
+                     "priority", &cursor->key.priority,
+                     "t_submit", &cursor->key.t_submit,
+                     "t_run", &cursor->key.t_run,
+                     "t_inactive", &cursor->key.t_inactive) < 0
+        || cursor->list < 0
+        || cursor->list >= LIST_COUNT) {
+        errno = EPROTO;
+        return -1;
+    }
+    cursor->resume = true;
+    return 0;
+}
+
+/* Return the first job on 'list' that sorts after the cursor job, and
+ * leave the list cursor on it so zlistx_next() continues from there.
+ * Jobs that compare equal to the cursor key are skipped only up to and
+ * including the cursor job itself.  If the cursor job is no longer on
+ * the list (e.g. it changed state), resume at the first equal job.
+ */
+static struct job *list_resume (zlistx_t *list,
+                                zlistx_comparator_fn *cmp,
+                                const struct job *key)
+{
+    struct job *job;
+    int nequal = 0;
+
+    job = zlistx_first (list);
+    while (job && cmp (job, key) < 0)
+        job = zlistx_next (list);
+    while (job && cmp (job, key) == 0) {
+        if (job->id == key->id)
+            return zlistx_next (list);
+        job = zlistx_next (list);
+        nequal++;
+    }
+    if (nequal > 0) {
+        if (!job)
+            job = zlistx_last (list);
+        else
+            job = zlistx_prev (list);
+        while (--nequal > 0)
+            job = zlistx_prev (list);
+    }
+    return job;
+}
+
+/* Put jobs from list onto jobs array, starting after 'cursor' if
+ * cursor->list matches 'listnum', breaking if max_entries has been
+ * reached.  The cursor is updated to the last job added.  Returns 1 if
+ * jobs array is full, 0 if continue, -1 one error with errno set:
  *
  * ENOMEM - out of memory
  */
 int get_jobs_from_list (json_t *jobs,
                         job_info_error_t *errp,
                         zlistx_t *list,
+                        int listnum,
+                        struct list_cursor *cursor,
                         int max_entries,
                         json_t *attrs,
                         uint32_t userid,
@@ -61,7 +170,10 @@ int get_jobs_from_list (json_t *jobs,
 {
     struct job *job;
 
-    job = zlistx_first (list);
+    if (cursor->list == listnum && cursor->resume)
+        job = list_resume (list, list_comparators[listnum], &cursor->key);
+    else
+        job = zlistx_first (list);
     while (job) {
         if (job_filter (job, userid, states, results)) {
             json_t *o;
@@ -72,6 +184,7 @@ int get_jobs_from_list (json_t *jobs,
                 errno = ENOMEM;
                 return -1;
             }
+            cursor_set (cursor, listnum, job);
             if (json_array_size (jobs) == max_entries)
                 return 1;
         }
@@ -81,9 +194,66 @@ int get_jobs_from_list (json_t *jobs,
     return 0;
 }
 
+/* Select the lists to scan for each of pending, running, and inactive.
+ * Use the per-user index if a userid was specified, and for inactive
+ * jobs the per-result index if exactly one result was requested.
+ * A NULL entry means there are no matching jobs on that list.
+ */
+static void get_lists (struct job_state_ctx *jsctx,
+                       uint32_t userid,
+                       int results,
+                       zlistx_t *lists[LIST_COUNT])
+{
+    if (userid != FLUX_USERID_UNKNOWN) {
+        struct user_jobs *uj = zhashx_lookup (jsctx->users, &userid);
+        lists[LIST_PENDING] = uj ? uj->pending : NULL;
+        lists[LIST_RUNNING] = uj ? uj->running : NULL;
+        lists[LIST_INACTIVE] = uj ? uj->inactive : NULL;
+    }
+    else {
+        int i = job_result_index (results);
+        lists[LIST_PENDING] = jsctx->pending;
+        lists[LIST_RUNNING] = jsctx->running;
+        lists[LIST_INACTIVE] = i >= 0 ? jsctx->inactive_results[i]
+                                      : jsctx->inactive;
+    }
+}
+
+/* Return true if any job after 'cursor' on the current list, or on
+ * any later list, matches the filter.
+ */
+static bool more_jobs (zlistx_t *lists[LIST_COUNT],
+                       const int state_masks[LIST_COUNT],
+                       struct list_cursor *cursor,
+                       uint32_t userid,
+                       int states,
+                       int results)
+{
+    struct job *job;
+    int i;
+
+    for (i = cursor->list; i < LIST_COUNT; i++) {
+        if (!(states & state_masks[i]) || !lists[i])
+            continue;
+        if (i == cursor->list && cursor->resume)
+            job = list_resume (lists[i], list_comparators[i], &cursor->key);
+        else
+            job = zlistx_first (lists[i]);
+        while (job) {
+            if (job_filter (job, userid, states, results))
+                return true;
+            job = zlistx_next (lists[i]);
+        }
+    }
+    return false;
+}
+
 /* Create a JSON array of 'job' objects.  'max_entries' determines the
- * max number of jobs to return, 0=unlimited.  Returns JSON object
- * which the caller must free.  On error, return NULL with errno set:
+ * max number of jobs to return, 0=unlimited.  If 'cursor' is non-NULL,
+ * resume after the job it refers to, and update it to the last job
+ * returned.  'more' is set true if the array filled and more matching
+ * jobs remain.  Returns JSON object which the caller must free.  On
+ * error, return NULL with errno set:
  *
  * EPROTO - malformed or empty attrs array, max_entries out of range
  * ENOMEM - out of memory
@@ -94,22 +264,39 @@ json_t *get_jobs (struct info_ctx *ctx,
                   json_t *attrs,
                   uint32_t userid,
                   int states,
-                  int results)
+                  int results,
+                  struct list_cursor *cursor,
+                  bool *more)
 {
+    int state_masks[LIST_COUNT] = { FLUX_JOB_PENDING,
+                                    FLUX_JOB_RUNNING,
+                                    FLUX_JOB_INACTIVE };
+    zlistx_t *lists[LIST_COUNT];
+    struct list_cursor tmp = { .list = LIST_PENDING };
     json_t *jobs = NULL;
     int saved_errno;
     int ret = 0;
+    int i;
 
     if (!(jobs = json_array ()))
         goto error_nomem;
 
+    if (!cursor)
+        cursor = &tmp;
+
+    get_lists (ctx->jsctx, userid, results, lists);
+
     /* We return jobs in the following order, pending, running,
      * inactive */
 
-    if (states & FLUX_JOB_PENDING) {
+    for (i = cursor->list; i < LIST_COUNT && !ret; i++) {
+        if (!(states & state_masks[i]) || !lists[i])
+            continue;
         if ((ret = get_jobs_from_list (jobs,
                                        errp,
-                                       ctx->jsctx->pending,
+                                       lists[i],
+                                       i,
+                                       cursor,
                                        max_entries,
                                        attrs,
                                        userid,
@@ -118,34 +305,14 @@ json_t *get_jobs (struct info_ctx *ctx,
             goto error;
     }
 
-    if (states & FLUX_JOB_RUNNING) {
-        if (!ret) {
-            if ((ret = get_jobs_from_list (jobs,
-                                           errp,
-                                           ctx->jsctx->running,
-                                           max_entries,
-                                           attrs,
-                                           userid,
-                                           states,
-                                           results)) < 0)
-                goto error;
-        }
+    if (more) {
+        (*more) = ret == 1 && more_jobs (lists,
+                                         state_masks,
+                                         cursor,
+                                         userid,
+                                         states,
+                                         results);
     }
-
-    if (states & FLUX_JOB_INACTIVE) {
-        if (!ret) {
-            if ((ret = get_jobs_from_list (jobs,
-                                           errp,
-                                           ctx->jsctx->inactive,
-                                           max_entries,
-                                           attrs,
-                                           userid,
-                                           states,
-                                           results)) < 0)
-                goto error;
-        }
-    }
-
     return jobs;
 
 error_nomem:
@@ -157,24 +324,204 @@ error:
     return NULL;
 }
 
+/* A streaming job-info.list request is answered with a series of
+ * responses of at most 'page_size' jobs each, one page per reactor loop,
+ * so a large listing does not delay other requests.  'max_entries' still
+ * limits the total number of jobs, 0=unlimited.  The stream is terminated
+ * with ENODATA.
+ */
+struct list_pager {
+    struct info_ctx *ctx;
+    const flux_msg_t *msg;
+    json_t *attrs;
+    uint32_t userid;
+    int states;
+    int results;
+    int max_entries;
+    int page_size;
+    int count;
+    struct list_cursor cursor;
+    flux_watcher_t *prep;
+    flux_watcher_t *check;
+    flux_watcher_t *idle;
+    void *handle;       /* handle in ctx->list_pagers */
+};
+
+static void list_pager_destroy (struct list_pager *lp)
+{
+    if (lp) {
+        int saved_errno = errno;
+        flux_watcher_destroy (lp->prep);
+        flux_watcher_destroy (lp->check);
+        flux_watcher_destroy (lp->idle);
+        flux_msg_decref (lp->msg);
+        json_decref (lp->attrs);
+        free (lp);
+        errno = saved_errno;
+    }
+}
+
+static void list_pager_destructor (void **item)
+{
+    if (item) {
+        list_pager_destroy (*item);
+        *item = NULL;
+    }
+}
+
+static void list_pager_prep_cb (flux_reactor_t *r, flux_watcher_t *w,
+                                int revents, void *arg)
+{
+    struct list_pager *lp = arg;
+    flux_watcher_start (lp->idle);
+}
+
+/* Send the next page.  When the listing is complete, or on error,
+ * terminate the stream and destroy the pager.
+ */
+static void list_pager_check_cb (flux_reactor_t *r, flux_watcher_t *w,
+                                 int revents, void *arg)
+{
+    struct list_pager *lp = arg;
+    struct info_ctx *ctx = lp->ctx;
+    job_info_error_t err = {{0}};
+    json_t *jobs;
+    bool more;
+    int n = lp->page_size;
+
+    flux_watcher_stop (lp->idle);
+    if (lp->max_entries && lp->max_entries - lp->count < n)
+        n = lp->max_entries - lp->count;
+    if (!(jobs = get_jobs (ctx, &err, n, lp->attrs, lp->userid,
+                           lp->states, lp->results, &lp->cursor, &more)))
+        goto error;
+    lp->count += json_array_size (jobs);
+    if (json_array_size (jobs) > 0
+        && flux_respond_pack (ctx->h, lp->msg, "{s:O}", "jobs", jobs) < 0) {
+        flux_log_error (ctx->h, "%s: flux_respond_pack", __FUNCTION__);
+        json_decref (jobs);
+        goto error;
+    }
+    json_decref (jobs);
+    if (more && (!lp->max_entries || lp->count < lp->max_entries))
+        return;
+    errno = ENODATA;
+error:
+    if (flux_respond_error (ctx->h, lp->msg, errno,
+                            errno == ENODATA ? NULL : err.text) < 0)
+        flux_log_error (ctx->h, "%s: flux_respond_error", __FUNCTION__);
+    zlistx_delete (ctx->list_pagers, lp->handle);
+}
+
+static int list_pager_start (struct info_ctx *ctx,
+                             const flux_msg_t *msg,
+                             int max_entries,
+                             int page_size,
+                             json_t *attrs,
+                             uint32_t userid,
+                             int states,
+                             int results,
+                             struct list_cursor *cursor)
+{
+    flux_reactor_t *r = flux_get_reactor (ctx->h);
+    struct list_pager *lp;
+
+    if (!(lp = calloc (1, sizeof (*lp))))
+        return -1;
+    lp->ctx = ctx;
+    lp->msg = flux_msg_incref (msg);
+    lp->attrs = json_incref (attrs);
+    lp->userid = userid;
+    lp->states = states;
+    lp->results = results;
+    lp->max_entries = max_entries;
+    lp->page_size = page_size;
+    lp->cursor = *cursor;
+    if (!(lp->prep = flux_prepare_watcher_create (r, list_pager_prep_cb, lp))
+        || !(lp->check = flux_check_watcher_create (r,
+                                                    list_pager_check_cb,
+                                                    lp))
+        || !(lp->idle = flux_idle_watcher_create (r, NULL, NULL)))
+        goto error;
+    if (!(lp->handle = zlistx_add_end (ctx->list_pagers, lp))) {
+        errno = ENOMEM;
+        goto error;
+    }
+    flux_watcher_start (lp->prep);
+    flux_watcher_start (lp->check);
+    return 0;
+error:
+    list_pager_destroy (lp);
+    return -1;
+}
+
+/* Stop streaming listings to 'sender', e.g. on disconnect.
+ */
+void list_pagers_cancel (struct info_ctx *ctx, const char *sender)
+{
+    struct list_pager *lp;
+
+    lp = zlistx_first (ctx->list_pagers);
+    while (lp) {
+        struct list_pager *next = zlistx_next (ctx->list_pagers);
+        char *route;
+
+        if (flux_msg_get_route_first (lp->msg, &route) == 0) {
+            if (!strcmp (route, sender))
+                zlistx_delete (ctx->list_pagers, lp->handle);
+            free (route);
+        }
+        lp = next;
+    }
+}
+
+int list_setup (struct info_ctx *ctx)
+{
+    if (!(ctx->list_pagers = zlistx_new ())) {
+        errno = ENOMEM;
+        return -1;
+    }
+    zlistx_set_destructor (ctx->list_pagers, list_pager_destructor);
+    return 0;
+}
+
+void list_cleanup (struct info_ctx *ctx)
+{
+    struct list_pager *lp;
+
+    while ((lp = zlistx_first (ctx->list_pagers))) {
+        if (flux_respond_error (ctx->h, lp->msg, ENOSYS, NULL) < 0)
+            flux_log_error (ctx->h, "%s: flux_respond_error", __FUNCTION__);
+        zlistx_delete (ctx->list_pagers, lp->handle);
+    }
+    zlistx_destroy (&ctx->list_pagers);
+}
+
 void list_cb (flux_t *h, flux_msg_handler_t *mh,
               const flux_msg_t *msg, void *arg)
 {
     struct info_ctx *ctx = arg;
-    job_info_error_t err;
+    job_info_error_t err = {{0}};
+    struct list_cursor cursor = { .list = LIST_PENDING };
     json_t *jobs = NULL;
     json_t *attrs;
+    json_t *cursor_in = NULL;
+    json_t *cursor_out = NULL;
     int max_entries;
+    int page_size = 0;
     uint32_t userid;
     int states;
     int results;
+    bool more;
 
-    if (flux_request_unpack (msg, NULL, "{s:i s:o s:i s:i s:i}",
+    if (flux_request_unpack (msg, NULL, "{s:i s:o s:i s:i s:i s?:o s?:i}",
                              "max_entries", &max_entries,
                              "attrs", &attrs,
                              "userid", &userid,
                              "states", &states,
-                             "results", &results) < 0) {
+                             "results", &results,
+                             "cursor", &cursor_in,
+                             "page_size", &page_size) < 0) {
         seterror (&err, "invalid payload: %s", flux_msg_last_error (msg));
         errno = EPROTO;
         goto error;
@@ -184,11 +531,21 @@ void list_cb (flux_t *h, flux_msg_handler_t *mh,
         errno = EPROTO;
         goto error;
     }
+    if (page_size < 0) {
+        seterror (&err, "invalid payload: page_size < 0 not allowed");
+        errno = EPROTO;
+        goto error;
+    }
     if (!json_is_array (attrs)) {
         seterror (&err, "invalid payload: attrs must be an array");
         errno = EPROTO;
         goto error;
     }
+    if (cursor_in && !json_is_null (cursor_in)
+                  && cursor_decode (cursor_in, &cursor) < 0) {
+        seterror (&err, "invalid payload: invalid cursor");
+        goto error;
+    }
     /* If user sets no states, assume they want all information */
     if (!states)
         states = (FLUX_JOB_PENDING
@@ -202,11 +559,37 @@ void list_cb (flux_t *h, flux_msg_handler_t *mh,
                    | FLUX_JOB_RESULT_CANCELLED
                    | FLUX_JOB_RESULT_TIMEOUT);
 
-    if (!(jobs = get_jobs (ctx, &err, max_entries,
-                           attrs, userid, states, results)))
+    if (flux_msg_is_streaming (msg)) {
+        if (!page_size)
+            page_size = LIST_DEFAULT_PAGE_SIZE;
+        if (list_pager_start (ctx, msg, max_entries, page_size,
+                              attrs, userid, states, results, &cursor) < 0)
+            goto error;
+        return;
+    }
+
+    if (!(jobs = get_jobs (ctx, &err, max_entries, attrs,
+                           userid, states, results, &cursor, &more)))
         goto error;
 
-    if (flux_respond_pack (h, msg, "{s:O}", "jobs", jobs) < 0) {
+    /* Only callers that asked for a cursor get one back, a null
+     * cursor indicates there are no more jobs to return.
+     */
+    if (cursor_in) {
+        if (more) {
+            if (!(cursor_out = cursor_encode (&cursor)))
+                goto error;
+        }
+        else
+            cursor_out = json_null ();
+        if (flux_respond_pack (h, msg, "{s:O s:o}",
+                               "jobs", jobs,
+                               "cursor", cursor_out) < 0) {
+            flux_log_error (h, "%s: flux_respond_pack", __FUNCTION__);
+            goto error;
+        }
+    }
+    else if (flux_respond_pack (h, msg, "{s:O}", "jobs", jobs) < 0) {
         flux_log_error (h, "%s: flux_respond_pack", __FUNCTION__);
         goto error;
     }
@@ -361,48 +744,105 @@ error_destroy:
     return -1;
 }
 
+/* Respond to list-id request with a job read from the KVS.
+ */
+static void list_id_respond_unloaded (struct info_ctx *ctx,
+                                      struct idsync_data *isd,
+                                      struct job *job)
+{
+    job_info_error_t err;
+    json_t *o;
+
+    if (!(o = job_to_json (job, isd->attrs, &err))) {
+        if (flux_respond_error (ctx->h, isd->msg, errno, err.text) < 0)
+            flux_log_error (ctx->h, "%s: flux_respond_error", __FUNCTION__);
+        return;
+    }
+    if (flux_respond_pack (ctx->h, isd->msg, "{s:O}", "job", o) < 0)
+        flux_log_error (ctx->h, "%s: flux_respond_pack", __FUNCTION__);
+    json_decref (o);
+}
+
+/* Job ID is legal.  Respond if job-info has seen the job by now,
+ * otherwise wait for it.
+ */
+static void check_id_valid_respond (struct info_ctx *ctx,
+                                    struct idsync_data *isd)
+{
+    struct job *job = zhashx_lookup (ctx->jsctx->index, &isd->id);
+    json_t *o;
+
+    if (!job || job->state == FLUX_JOB_NEW) {
+        /* Must wait for job-info to see state change */
+        if (wait_id_valid (ctx, isd) < 0)
+            flux_log_error (ctx->h, "%s: wait_id_valid", __FUNCTION__);
+        return;
+    }
+    if (!(o = get_job_by_id (ctx, NULL, isd->msg,
+                             isd->id, isd->attrs, NULL))) {
+        flux_log_error (ctx->h, "%s: get_job_by_id", __FUNCTION__);
+        return;
+    }
+    if (flux_respond_pack (ctx->h, isd->msg, "{s:O}", "job", o) < 0)
+        flux_log_error (ctx->h, "%s: flux_respond_pack", __FUNCTION__);
+    json_decref (o);
+}
+
+static void idsync_lookup_delete (struct info_ctx *ctx,
+                                  struct idsync_data *isd)
+{
+    void *handle;
+
+    /* delete will destroy struct idsync_data and futures within it */
+    if ((handle = zlistx_find (ctx->idsync_lookups, isd)))
+        zlistx_delete (ctx->idsync_lookups, handle);
+}
+
+static void load_inactive_continuation (flux_future_t *f, void *arg)
+{
+    struct idsync_data *isd = arg;
+    struct info_ctx *ctx = isd->ctx;
+    struct job *job;
+
+    if (job_state_load_inactive_get (f, &job) == 0)
+        /* Job was purged by retention policy, respond from KVS */
+        list_id_respond_unloaded (ctx, isd, job);
+    else
+        check_id_valid_respond (ctx, isd);
+    idsync_lookup_delete (ctx, isd);
+}
+
 void check_id_valid_continuation (flux_future_t *f, void *arg)
 {
     struct idsync_data *isd = arg;
     struct info_ctx *ctx = isd->ctx;
-    void *handle;
 
     if (flux_future_get (f, NULL) < 0) {
         if (flux_respond_error (ctx->h, isd->msg, errno, NULL) < 0)
             flux_log_error (ctx->h, "%s: flux_respond_error", __FUNCTION__);
         goto cleanup;
     }
-    else {
-        /* Job ID is legal.  Chance job-info has seen ID since this
-         * lookup was done */
-        struct job *job;
-        if (!(job = zhashx_lookup (ctx->jsctx->index, &isd->id))
-            || job->state == FLUX_JOB_NEW) {
-            /* Must wait for job-info to see state change */
-            if (wait_id_valid (ctx, isd) < 0)
-                flux_log_error (ctx->h, "%s: wait_id_valid", __FUNCTION__);
+    if (!zhashx_lookup (ctx->jsctx->index, &isd->id)
+        && ctx->jsctx->inactive_purged > 0) {
+        /* Job may have been purged, try to read it from the KVS */
+        if (!(isd->f_load = job_state_load_inactive (ctx, isd->id))
+            || flux_future_then (isd->f_load,
+                                 -1,
+                                 load_inactive_continuation,
+                                 isd) < 0) {
+            flux_log_error (ctx->h, "%s: job_state_load_inactive",
+                            __FUNCTION__);
+            if (flux_respond_error (ctx->h, isd->msg, errno, NULL) < 0)
+                flux_log_error (ctx->h, "%s: flux_respond_error",
+                                __FUNCTION__);
             goto cleanup;
         }
-        else {
-            json_t *o;
-            if (!(o = get_job_by_id (ctx, NULL, isd->msg,
-                                     isd->id, isd->attrs, NULL))) {
-                flux_log_error (ctx->h, "%s: get_job_by_id", __FUNCTION__);
-                goto cleanup;
-            }
-            if (flux_respond_pack (ctx->h, isd->msg, "{s:O}", "job", o) < 0) {
-                flux_log_error (ctx->h, "%s: flux_respond_pack", __FUNCTION__);
-                goto cleanup;
-            }
-        }
+        return;
     }
+    check_id_valid_respond (ctx, isd);
 
 cleanup:
-    /* delete will destroy struct idsync_data and future within it */
-    handle = zlistx_find (ctx->idsync_lookups, isd);
-    if (handle)
-        zlistx_delete (ctx->idsync_lookups, handle);
-    return;
+    idsync_lookup_delete (ctx, isd);
 }
 
 int check_id_valid (struct info_ctx *ctx,
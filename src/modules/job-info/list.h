@@ -15,6 +15,13 @@
 
 #include "info.h"
 
+int list_setup (struct info_ctx *ctx);
+void list_cleanup (struct info_ctx *ctx);
+
+/* Stop streaming job-info.list responses to 'sender'.
+ */
+void list_pagers_cancel (struct info_ctx *ctx, const char *sender);
+
 void list_cb (flux_t *h, flux_msg_handler_t *mh,
               const flux_msg_t *msg, void *arg);
 
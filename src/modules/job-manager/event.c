@@ -31,6 +31,9 @@
  * - A KVS commit failure is handled as fatal to the job-manager
  * - event_job_action() is idempotent
  * - event_ctx_destroy() flushes batched eventlog updates before returning
+ * - Job state transitions and annotation updates are appended to the
+ *   journal once a batch commit completes.  Publishing them as job-state
+ *   and job-annotations events is optional.
  */
 
 #if HAVE_CONFIG_H
@@ -44,6 +47,7 @@
 #include "start.h"
 #include "drain.h"
 #include "wait.h"
+#include "journal.h"
 
 #include "event.h"
 
@@ -57,6 +61,7 @@ struct event {
     flux_watcher_t *timer;
     zlist_t *pending;
     zlist_t *pub_futures;
+    bool publish;
 };
 
 struct event_batch {
@@ -172,8 +177,37 @@ error:
     flux_reactor_stop_error (flux_get_reactor (ctx->h));
 }
 
+/* Append state transitions and annotation updates (if any) to the
+ * journal, and publish them as events if enabled.
+ */
+static void event_batch_notify (struct event_batch *batch)
+{
+    struct event *event = batch->event;
+    json_t *state_trans = NULL;
+    json_t *annotations = NULL;
+
+    if (batch->state_trans && json_array_size (batch->state_trans) > 0)
+        state_trans = batch->state_trans;
+    if (batch->annotations && json_array_size (batch->annotations) > 0)
+        annotations = batch->annotations;
+    if (!state_trans && !annotations)
+        return;
+    if (journal_append (event->ctx->journal, state_trans, annotations) < 0) {
+        flux_log_error (event->ctx->h, "%s: journal_append", __FUNCTION__);
+        flux_reactor_stop_error (flux_get_reactor (event->ctx->h));
+    }
+    if (event->publish) {
+        if (state_trans)
+            event_publish (event, "job-state", "transitions", state_trans);
+        if (annotations)
+            event_publish (event, "job-annotations", "annotations",
+                           annotations);
+    }
+}
+
 /* Besides cleaning up, this function has the following side effects:
- * - publish state transition event (if any)
+ * - notify journal listeners of state transitions (if any)
+ * - publish state transition event (if enabled)
  * - respond to deferred responses (if any)
  */
 void event_batch_destroy (struct event_batch *batch)
@@ -184,22 +218,9 @@ void event_batch_destroy (struct event_batch *batch)
         flux_kvs_txn_destroy (batch->txn);
         if (batch->f)
             (void)flux_future_wait_for (batch->f, -1);
-        if (batch->state_trans) {
-            if (json_array_size (batch->state_trans) > 0)
-                event_publish (batch->event,
-                               "job-state",
-                               "transitions",
-                               batch->state_trans);
-            json_decref (batch->state_trans);
-        }
-        if (batch->annotations) {
-            if (json_array_size (batch->annotations) > 0)
-                event_publish (batch->event,
-                               "job-annotations",
-                               "annotations",
-                               batch->annotations);
-            json_decref (batch->annotations);
-        }
+        event_batch_notify (batch);
+        json_decref (batch->state_trans);
+        json_decref (batch->annotations);
         if (batch->responses) {
             flux_msg_t *msg;
             flux_t *h = batch->event->ctx->h;
@@ -596,6 +617,11 @@ error:
     return -1;
 }
 
+void event_set_publish (struct event *event, bool publish)
+{
+    event->publish = publish;
+}
+
 /* Finalizes in-flight batch KVS commits and event pubs (synchronously).
  */
 void event_ctx_destroy (struct event *event)
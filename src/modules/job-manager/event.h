@@ -12,6 +12,7 @@
 #define _FLUX_JOB_MANAGER_EVENT_H
 
 #include <stdarg.h>
+#include <stdbool.h>
 #include <flux/core.h>
 #include <jansson.h>
 
@@ -55,6 +56,12 @@ int event_job_post_pack (struct event *event,
                          const char *context_fmt,
                          ...);
 
+/* Enable or disable publication of job-state and job-annotations events.
+ * State transitions and annotation updates are always sent to the
+ * journal (see journal.h).  Events are not published by default.
+ */
+void event_set_publish (struct event *event, bool publish);
+
 void event_ctx_destroy (struct event *event);
 struct event *event_ctx_create (struct job_manager *ctx);
 
@@ -28,6 +28,7 @@
 #include "drain.h"
 #include "wait.h"
 #include "annotate.h"
+#include "journal.h"
 
 #include "job-manager.h"
 
@@ -52,6 +53,70 @@ error:
         flux_log_error (h, "%s: flux_respond_error", __FUNCTION__);
 }
 
+/* A client has disconnected.  Remove any waiters and journal listeners
+ * registered by that client.
+ */
+static void disconnect_rpc (flux_t *h,
+                            flux_msg_handler_t *mh,
+                            const flux_msg_t *msg,
+                            void *arg)
+{
+    struct job_manager *ctx = arg;
+
+    wait_disconnect (ctx->wait, msg);
+    journal_disconnect (ctx->journal, msg);
+}
+
+/* Configure job state notification from config file, then module
+ * arguments, in that order.
+ */
+static int process_config (struct job_manager *ctx, int argc, char **argv)
+{
+    flux_conf_error_t err;
+    int journal_size = JOURNAL_SIZE_DEFAULT;
+    int publish_events = 0;
+    char *endptr;
+    int i;
+
+    if (flux_conf_unpack (flux_get_conf (ctx->h),
+                          &err,
+                          "{s?{s?i s?b}}",
+                          "job-manager",
+                            "journal-size", &journal_size,
+                            "publish-events", &publish_events) < 0) {
+        flux_log (ctx->h, LOG_ERR,
+                  "error reading job-manager config: %s",
+                  err.errbuf);
+        return -1;
+    }
+
+    /* module params override config file */
+    for (i = 0; i < argc; i++) {
+        if (strncmp (argv[i], "journal-size=", 13) == 0) {
+            errno = 0;
+            journal_size = strtol (argv[i] + 13, &endptr, 10);
+            if (errno != 0 || *endptr != '\0') {
+                flux_log (ctx->h, LOG_ERR, "invalid %s", argv[i]);
+                errno = EINVAL;
+                return -1;
+            }
+        }
+        else if (strcmp (argv[i], "publish-events") == 0)
+            publish_events = 1;
+        else {
+            flux_log (ctx->h, LOG_ERR, "unknown option: %s", argv[i]);
+            errno = EINVAL;
+            return -1;
+        }
+    }
+    if (journal_set_size (ctx->journal, journal_size) < 0) {
+        flux_log (ctx->h, LOG_ERR, "invalid journal-size: %d", journal_size);
+        return -1;
+    }
+    event_set_publish (ctx->event, publish_events ? true : false);
+    return 0;
+}
+
 static const struct flux_msg_handler_spec htab[] = {
     {
         FLUX_MSGTYPE_REQUEST,
@@ -71,6 +136,12 @@ static const struct flux_msg_handler_spec htab[] = {
         getinfo_handle_request,
         FLUX_ROLE_USER
     },
+    {
+        FLUX_MSGTYPE_REQUEST,
+        "job-manager.disconnect",
+        disconnect_rpc,
+        0
+    },
     FLUX_MSGHANDLER_TABLE_END,
 };
 
@@ -89,10 +160,16 @@ int mod_main (flux_t *h, int argc, char **argv)
     }
     zhashx_set_destructor (ctx.active_jobs, job_destructor);
     zhashx_set_duplicator (ctx.active_jobs, job_duplicator);
+    if (!(ctx.journal = journal_ctx_create (&ctx))) {
+        flux_log_error (h, "error creating journal");
+        goto done;
+    }
     if (!(ctx.event = event_ctx_create (&ctx))) {
         flux_log_error (h, "error creating event batcher");
         goto done;
     }
+    if (process_config (&ctx, argc, argv) < 0)
+        goto done;
     if (!(ctx.submit = submit_ctx_create (&ctx))) {
         flux_log_error (h, "error creating submit interface");
         goto done;
@@ -153,6 +230,7 @@ done:
     alloc_ctx_destroy (ctx.alloc);
     submit_ctx_destroy (ctx.submit);
     event_ctx_destroy (ctx.event);
+    journal_ctx_destroy (ctx.journal);
     zhashx_destroy (&ctx.active_jobs);
     return rc;
 }
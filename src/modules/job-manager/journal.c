@@ -0,0 +1,296 @@
+/************************************************************\
+ * Copyright 2026 Lawrence Livermore National Security, LLC
+ * (c.f. AUTHORS, NOTICE.LLNS, COPYING)
+ *
+ * This file is part of the Flux resource manager framework.
+ * For details, see https://github.com/flux-framework.
+ *
+ * SPDX-License-Identifier: LGPL-3.0
+\************************************************************/
+
+/* journal.c - stream job state transitions and annotation updates
+ *
+ * Each batch of job state transitions and annotation updates is
+ * appended to the journal as an entry with a sequence number, starting
+ * at 1 when the job-manager is loaded:
+ *
+ *   {"seq":I, "transitions"?:[[I,s,f],...], "annotations"?:[[I,o],...]}
+ *
+ * The "transitions" and "annotations" arrays have the same form as the
+ * payloads of the job-state and job-annotations events.
+ *
+ * Consumers send a job-manager.events streaming request:
+ *
+ *   {"seq"?:I}
+ *
+ * The first response is {"seq":I}, after which entries are sent in
+ * order, starting at seq + 1.  If "seq" is omitted, the stream begins
+ * with the next entry appended.  Otherwise, retained entries after "seq"
+ * are replayed first, so a consumer may resume where it left off.  The
+ * number of retained entries is bounded; if entries after "seq" have been
+ * dropped, the request fails with EOVERFLOW.
+ *
+ * The stream ends with ENODATA when the job-manager is unloaded.
+ * Listeners are removed on disconnect.
+ */
+
+#if HAVE_CONFIG_H
+#include "config.h"
+#endif
+#include <czmq.h>
+#include <jansson.h>
+#include <flux/core.h>
+
+#include "journal.h"
+
+struct journal {
+    struct job_manager *ctx;
+    flux_msg_handler_t **handlers;
+    zlistx_t *listeners;
+    zlist_t *entries;       // retained entries, oldest first
+    int size;               // max number of retained entries
+    json_int_t seq;         // sequence number of last entry
+};
+
+static void journal_respond_entry (struct journal *journal,
+                                   const flux_msg_t *msg,
+                                   const char *s)
+{
+    if (flux_respond (journal->ctx->h, msg, s) < 0)
+        flux_log_error (journal->ctx->h, "%s: flux_respond", __FUNCTION__);
+}
+
+static void journal_trim (struct journal *journal)
+{
+    json_t *entry;
+
+    while (zlist_size (journal->entries) > (size_t)journal->size) {
+        entry = zlist_pop (journal->entries);
+        json_decref (entry);
+    }
+}
+
+int journal_append (struct journal *journal,
+                    json_t *transitions,
+                    json_t *annotations)
+{
+    json_t *entry;
+    char *s = NULL;
+    const flux_msg_t *msg;
+
+    if (!journal)
+        return 0;
+    if (!(entry = json_pack ("{s:I}", "seq", journal->seq + 1)))
+        goto nomem;
+    if (transitions && json_object_set (entry,
+                                        "transitions",
+                                        transitions) < 0)
+        goto nomem;
+    if (annotations && json_object_set (entry,
+                                        "annotations",
+                                        annotations) < 0)
+        goto nomem;
+    journal->seq++;
+
+    /* Encode the entry once for all listeners.
+     */
+    if (zlistx_size (journal->listeners) > 0) {
+        if (!(s = json_dumps (entry, JSON_COMPACT)))
+            goto nomem;
+        msg = zlistx_first (journal->listeners);
+        while (msg) {
+            journal_respond_entry (journal, msg, s);
+            msg = zlistx_next (journal->listeners);
+        }
+        free (s);
+    }
+    if (journal->size > 0) {
+        if (zlist_append (journal->entries, entry) < 0)
+            goto nomem;
+        journal_trim (journal);
+    }
+    else
+        json_decref (entry);
+    return 0;
+nomem:
+    json_decref (entry);
+    errno = ENOMEM;
+    return -1;
+}
+
+int journal_set_size (struct journal *journal, int size)
+{
+    if (size < 0) {
+        errno = EINVAL;
+        return -1;
+    }
+    journal->size = size;
+    journal_trim (journal);
+    return 0;
+}
+
+/* Replay retained entries with sequence number greater than 'seq'.
+ */
+static int journal_replay (struct journal *journal,
+                           const flux_msg_t *msg,
+                           json_int_t seq)
+{
+    json_t *entry;
+    json_int_t entry_seq = journal->seq - zlist_size (journal->entries) + 1;
+    char *s;
+
+    entry = zlist_first (journal->entries);
+    while (entry) {
+        if (entry_seq > seq) {
+            if (!(s = json_dumps (entry, JSON_COMPACT))) {
+                errno = ENOMEM;
+                return -1;
+            }
+            journal_respond_entry (journal, msg, s);
+            free (s);
+        }
+        entry_seq++;
+        entry = zlist_next (journal->entries);
+    }
+    return 0;
+}
+
+/* Return true if all entries after 'seq' are still retained.
+ */
+static bool journal_can_resume (struct journal *journal, json_int_t seq)
+{
+    json_int_t oldest = journal->seq - zlist_size (journal->entries) + 1;
+
+    return seq + 1 >= oldest;
+}
+
+static void events_handle_request (flux_t *h,
+                                   flux_msg_handler_t *mh,
+                                   const flux_msg_t *msg,
+                                   void *arg)
+{
+    struct job_manager *ctx = arg;
+    struct journal *journal = ctx->journal;
+    json_int_t seq = -1;
+    const char *errstr = NULL;
+
+    if (flux_request_unpack (msg, NULL, "{s?I}", "seq", &seq) < 0)
+        goto error;
+    if (!flux_msg_is_streaming (msg)) {
+        errno = EPROTO;
+        goto error;
+    }
+    if (seq > journal->seq) {
+        errstr = "sequence number is beyond the end of the journal";
+        errno = EINVAL;
+        goto error;
+    }
+    if (seq >= 0 && !journal_can_resume (journal, seq)) {
+        errstr = "journal entries after sequence number are not retained";
+        errno = EOVERFLOW;
+        goto error;
+    }
+    if (seq < 0)
+        seq = journal->seq;
+    if (!zlistx_add_end (journal->listeners,
+                         (void *)flux_msg_incref (msg))) {
+        flux_msg_decref (msg);
+        errno = ENOMEM;
+        goto error;
+    }
+    if (flux_respond_pack (h, msg, "{s:I}", "seq", seq) < 0)
+        flux_log_error (h, "%s: flux_respond_pack", __FUNCTION__);
+    if (journal_replay (journal, msg, seq) < 0)
+        flux_log_error (h, "%s: journal_replay", __FUNCTION__);
+    return;
+error:
+    if (flux_respond_error (h, msg, errno, errstr) < 0)
+        flux_log_error (h, "%s: flux_respond_error", __FUNCTION__);
+}
+
+void journal_disconnect (struct journal *journal, const flux_msg_t *msg)
+{
+    char *sender;
+    char *l_sender;
+    const flux_msg_t *req;
+
+    if (flux_msg_get_route_first (msg, &sender) < 0)
+        return;
+    req = zlistx_first (journal->listeners);
+    while (req) {
+        if (flux_msg_get_route_first (req, &l_sender) == 0) {
+            if (!strcmp (sender, l_sender)) {
+                zlistx_detach_cur (journal->listeners);
+                flux_msg_decref (req);
+            }
+            free (l_sender);
+        }
+        req = zlistx_next (journal->listeners);
+    }
+    free (sender);
+}
+
+void journal_ctx_destroy (struct journal *journal)
+{
+    if (journal) {
+        int saved_errno = errno;
+        flux_t *h = journal->ctx->h;
+
+        flux_msg_handler_delvec (journal->handlers);
+        if (journal->listeners) {
+            const flux_msg_t *msg;
+
+            while ((msg = zlistx_detach (journal->listeners, NULL))) {
+                if (flux_respond_error (h, msg, ENODATA, NULL) < 0)
+                    flux_log_error (h, "%s: flux_respond_error",
+                                    __FUNCTION__);
+                flux_msg_decref (msg);
+            }
+            zlistx_destroy (&journal->listeners);
+        }
+        if (journal->entries) {
+            json_t *entry;
+
+            while ((entry = zlist_pop (journal->entries)))
+                json_decref (entry);
+            zlist_destroy (&journal->entries);
+        }
+        free (journal);
+        errno = saved_errno;
+    }
+}
+
+static const struct flux_msg_handler_spec htab[] = {
+    {
+        .typemask = FLUX_MSGTYPE_REQUEST,
+        .topic_glob = "job-manager.events",
+        .cb = events_handle_request,
+        .rolemask = 0
+    },
+    FLUX_MSGHANDLER_TABLE_END,
+};
+
+struct journal *journal_ctx_create (struct job_manager *ctx)
+{
+    struct journal *journal;
+
+    if (!(journal = calloc (1, sizeof (*journal))))
+        return NULL;
+    journal->ctx = ctx;
+    journal->size = JOURNAL_SIZE_DEFAULT;
+    if (!(journal->listeners = zlistx_new ())
+        || !(journal->entries = zlist_new ()))
+        goto nomem;
+    if (flux_msg_handler_addvec (ctx->h, htab, ctx, &journal->handlers) < 0)
+        goto error;
+    return journal;
+nomem:
+    errno = ENOMEM;
+error:
+    journal_ctx_destroy (journal);
+    return NULL;
+}
+
+/*
+ * vi:tabstop=4 shiftwidth=4 expandtab
+ */
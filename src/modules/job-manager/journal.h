@@ -0,0 +1,44 @@
+/************************************************************\
+ * Copyright 2026 Lawrence Livermore National Security, LLC
+ * (c.f. AUTHORS, NOTICE.LLNS, COPYING)
+ *
+ * This file is part of the Flux resource manager framework.
+ * For details, see https://github.com/flux-framework.
+ *
+ * SPDX-License-Identifier: LGPL-3.0
+\************************************************************/
+
+#ifndef _FLUX_JOB_MANAGER_JOURNAL_H
+#define _FLUX_JOB_MANAGER_JOURNAL_H
+
+#include <flux/core.h>
+#include <jansson.h>
+
+#include "job-manager.h"
+
+#define JOURNAL_SIZE_DEFAULT 1024
+
+/* Append an entry of job state 'transitions' and/or 'annotations'
+ * updates, either of which may be NULL, to the journal and send it
+ * to all listeners.
+ */
+int journal_append (struct journal *journal,
+                    json_t *transitions,
+                    json_t *annotations);
+
+/* Set the maximum number of entries retained for resuming listeners.
+ */
+int journal_set_size (struct journal *journal, int size);
+
+/* Remove listeners registered by the sender of disconnect request 'msg'.
+ */
+void journal_disconnect (struct journal *journal, const flux_msg_t *msg);
+
+struct journal *journal_ctx_create (struct job_manager *ctx);
+void journal_ctx_destroy (struct journal *journal);
+
+#endif /* ! _FLUX_JOB_MANAGER_JOURNAL_H */
+
+/*
+ * vi:tabstop=4 shiftwidth=4 expandtab
+ */
@@ -299,13 +299,9 @@ error:
 
 /* A client has disconnected.  Destroy any waiters registered by that client.
  */
-static void disconnect_rpc (flux_t *h,
-                            flux_msg_handler_t *mh,
-                            const flux_msg_t *msg,
-                            void *arg)
+void wait_disconnect (struct waitjob *wait, const flux_msg_t *msg)
 {
-    struct job_manager *ctx = arg;
-    struct waitjob *wait = ctx->wait;
+    struct job_manager *ctx = wait->ctx;
     char *sender;
     char *w_sender;
     struct job *job;
@@ -407,12 +403,6 @@ static const struct flux_msg_handler_spec htab[] = {
         .cb = wait_rpc,
         .rolemask = 0
     },
-    {
-        .typemask = FLUX_MSGTYPE_REQUEST,
-        .topic_glob = "job-manager.disconnect",
-        .cb = disconnect_rpc,
-        .rolemask = 0
-    },
     FLUX_MSGHANDLER_TABLE_END,
 };
 
@@ -50,6 +50,8 @@ struct commit {
     json_t *keys;               // keys changed by commit
                                 //  empty if data originates from getroot RPC
                                 //  or kvs.namespace-<NS>-created event
+    json_t *values;             // new values of some keys, may be NULL
+    json_t *appends;            // data appended to some keys, may be NULL
 };
 
 
@@ -74,6 +76,8 @@ struct watch_ctx {
     flux_t *h;
     flux_msg_handler_t **handlers;
     zhash_t *namespaces;        // hash of monitored namespaces
+    int lookups;                // lookups sent for watcher responses
+    int inline_responses;       // watcher responses from setroot values
 };
 
 static void watcher_destroy (struct watcher *w)
@@ -125,6 +129,8 @@ static void commit_destroy (struct commit *commit)
         free (commit->rootref);
         if (commit->keys)
             json_decref (commit->keys);
+        json_decref (commit->values);
+        json_decref (commit->appends);
         free (commit);
         errno = saved_errno;
     }
@@ -368,6 +374,27 @@ static int handle_append_response (flux_t *h,
     return 0;
 }
 
+/* Like handle_append_response(), but 'val' holds only the data appended
+ * since the last response.
+ */
+static int handle_append_data_response (flux_t *h,
+                                        struct watcher *w,
+                                        json_t *val)
+{
+    int len;
+
+    if (treeobj_decode_val (val, NULL, &len) < 0) {
+        flux_log_error (h, "%s: treeobj_decode_val", __FUNCTION__);
+        return -1;
+    }
+    if (flux_respond_pack (h, w->request, "{ s:O }", "val", val) < 0) {
+        flux_log_error (h, "%s: flux_respond_pack", __FUNCTION__);
+        return -1;
+    }
+    w->append_offset += len;
+    return 0;
+}
+
 static int handle_normal_response (flux_t *h,
                                    struct watcher *w,
                                    json_t *val)
@@ -579,6 +606,52 @@ error:
     return NULL;
 }
 
+/* If the setroot event included the new value of the watched key, respond
+ * from it rather than looking the key up.  This is only possible once the
+ * watcher has responded, if no lookups are in flight (responses must be
+ * sent in commit order), and if the watcher wants the plain value.
+ * Appended data alone suffices only for FLUX_KVS_WATCH_APPEND.
+ * Return 1 if handled, 0 if a lookup is needed, -1 on error.
+ */
+static int process_inline_response (struct ns_monitor *nsm, struct watcher *w)
+{
+    flux_t *h = nsm->ctx->h;
+    json_t *val;
+    bool append = false;
+    int rc;
+
+    if (w->rootseq == -1
+        || !w->responded
+        || zlist_size (w->lookups) > 0
+        || (w->flags & (FLUX_KVS_TREEOBJ
+                        | FLUX_KVS_READDIR
+                        | FLUX_KVS_READLINK)))
+        return 0;
+    if (!(val = json_object_get (nsm->commit->values, w->key))) {
+        if (!(w->flags & FLUX_KVS_WATCH_APPEND)
+            || !(val = json_object_get (nsm->commit->appends, w->key)))
+            return 0;
+        append = true;
+    }
+    w->rootseq = nsm->commit->rootseq;
+    /* initial rpc already returned this or a later root */
+    if (nsm->commit->rootseq <= w->initial_rootseq || w->mute)
+        return 1;
+    if (append)
+        rc = handle_append_data_response (h, w, val);
+    else if ((w->flags & FLUX_KVS_WATCH_FULL)
+             || (w->flags & FLUX_KVS_WATCH_UNIQ))
+        rc = handle_compare_response (h, w, val);
+    else if (w->flags & FLUX_KVS_WATCH_APPEND)
+        rc = handle_append_response (h, w, val);
+    else
+        rc = handle_normal_response (h, w, val);
+    if (rc < 0)
+        return -1;
+    nsm->ctx->inline_responses++;
+    return 1;
+}
+
 static int process_lookup_response (struct ns_monitor *nsm, struct watcher *w)
 {
     flux_future_t *f;
@@ -600,6 +673,7 @@ static int process_lookup_response (struct ns_monitor *nsm, struct watcher *w)
         return -1;
     }
     w->rootseq = nsm->commit->rootseq;
+    nsm->ctx->lookups++;
     return 0;
 }
 
@@ -662,11 +736,17 @@ static void watcher_respond (struct ns_monitor *nsm, struct watcher *w)
      *
      * Note on FLUX_KVS_WATCH_FULL: A lookup / comparison is done on every
      * change.
+     *
+     * Optimization: if the kvs included the new value of the key in the
+     * setroot event, respond with it directly and skip the lookup.
      */
     if (w->rootseq == -1
         || (w->flags & FLUX_KVS_WATCH_FULL)
         || array_match (nsm->commit->keys, w->key)) {
-        if (process_lookup_response (nsm, w) < 0)
+        int rc;
+        if ((rc = process_inline_response (nsm, w)) < 0)
+            goto error_respond;
+        if (rc == 0 && process_lookup_response (nsm, w) < 0)
             goto error_respond;
     }
     return;
@@ -844,14 +924,18 @@ static void setroot_cb (flux_t *h, flux_msg_handler_t *mh,
     const char *rootref;
     int owner;
     json_t *keys;
+    json_t *values = NULL;
+    json_t *appends = NULL;
     struct commit *commit;
 
-    if (flux_event_unpack (msg, NULL, "{s:s s:i s:s s:i s:o}",
+    if (flux_event_unpack (msg, NULL, "{s:s s:i s:s s:i s:o s?o s?o}",
                            "namespace", &ns,
                            "rootseq", &rootseq,
                            "rootref", &rootref,
                            "owner", &owner,
-                           "keys", &keys) < 0) {
+                           "keys", &keys,
+                           "values", &values,
+                           "appends", &appends) < 0) {
         flux_log_error (h, "%s: flux_event_unpack", __FUNCTION__);
         return;
     }
@@ -863,6 +947,8 @@ static void setroot_cb (flux_t *h, flux_msg_handler_t *mh,
         nsm->errnum = errno;
         goto done;
     }
+    commit->values = json_incref (values);
+    commit->appends = json_incref (appends);
     commit_destroy (nsm->commit);
     nsm->commit = commit;
     if (nsm->owner == FLUX_USERID_UNKNOWN)
@@ -1072,9 +1158,11 @@ static void stats_cb (flux_t *h, flux_msg_handler_t *mh,
         watchers += zlist_size (nsm->watchers);
         nsm = zhash_next (ctx->namespaces);
     }
-    if (flux_respond_pack (h, msg, "{s:i s:i s:O}",
+    if (flux_respond_pack (h, msg, "{s:i s:i s:i s:i s:O}",
                            "watchers", watchers,
                            "namespace-count", (int)zhash_size (ctx->namespaces),
+                           "lookups", ctx->lookups,
+                           "inline-responses", ctx->inline_responses,
                            "namespaces", stats) < 0)
         flux_log_error (h, "%s: flux_respond_pack", __FUNCTION__);
     json_decref (stats);
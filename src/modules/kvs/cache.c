@@ -31,6 +31,7 @@
 #include "src/common/libutil/tstat.h"
 #include "src/common/libutil/log.h"
 #include "src/common/libutil/iterators.h"
+#include "src/common/libutil/lru_cache.h"
 #include "src/common/libkvs/kvs_util_private.h"
 
 #include "waitqueue.h"
@@ -50,10 +51,30 @@ struct cache_entry {
     int errnum;
     char *blobref;
     int refcount;
+    bool warm;              /* inserted ahead of use, not yet looked up */
 };
 
+/* Maximum number of path memo entries.
+ */
+#define CACHE_MEMO_MAX 8192
+
+/* Maximum number of warm entries tracked.
+ */
+#define CACHE_WARM_MAX 4096
+
 struct cache {
     zhashx_t *zhx;
+    lru_cache_t *memo;
+    int memo_hits;
+    int memo_misses;
+    lru_cache_t *warm;      /* ref => struct warm_ref */
+    int warm_hits;
+    int warm_evictions;
+};
+
+struct warm_ref {
+    struct cache *cache;
+    char ref[];
 };
 
 struct cache_entry *cache_entry_create (const char *ref)
@@ -305,6 +326,10 @@ struct cache_entry *cache_lookup (struct cache *cache, const char *ref,
     struct cache_entry *entry = zhashx_lookup (cache->zhx, ref);
     if (entry && current_epoch > entry->lastuse_epoch)
         entry->lastuse_epoch = current_epoch;
+    if (entry && entry->warm) {
+        entry->warm = false;
+        cache->warm_hits++;
+    }
     return entry;
 }
 
@@ -435,6 +460,185 @@ done:
     return rc;
 }
 
+static char *memo_key (const char *dirref, const char *path)
+{
+    char *key;
+
+    if (asprintf (&key, "%s:%s", dirref, path) < 0) {
+        errno = ENOMEM;
+        return NULL;
+    }
+    return key;
+}
+
+const json_t *cache_memo_lookup (struct cache *cache,
+                                 const char *dirref,
+                                 const char *path)
+{
+    json_t *dirent = NULL;
+    char *key;
+
+    if (!cache || !dirref || !path) {
+        errno = EINVAL;
+        return NULL;
+    }
+    if (!(key = memo_key (dirref, path)))
+        return NULL;
+    if ((dirent = lru_cache_get (cache->memo, key)))
+        cache->memo_hits++;
+    else {
+        cache->memo_misses++;
+        errno = ENOENT;
+    }
+    free (key);
+    return dirent;
+}
+
+int cache_memo_insert (struct cache *cache,
+                       const char *dirref,
+                       const char *path,
+                       const json_t *dirent)
+{
+    char *key;
+    int rc = -1;
+
+    if (!cache || !dirref || !path || !dirent) {
+        errno = EINVAL;
+        return -1;
+    }
+    if (!(key = memo_key (dirref, path)))
+        return -1;
+    if (lru_cache_put (cache->memo, key, json_incref ((json_t *)dirent)) < 0) {
+        int saved_errno = errno;
+        json_decref ((json_t *)dirent);
+        errno = saved_errno;
+        goto done;
+    }
+    rc = 0;
+done:
+    free (key);
+    return rc;
+}
+
+void cache_memo_get_stats (struct cache *cache,
+                           int *size,
+                           int *hits,
+                           int *misses)
+{
+    if (size)
+        *size = cache ? lru_cache_size (cache->memo) : 0;
+    if (hits)
+        *hits = cache ? cache->memo_hits : 0;
+    if (misses)
+        *misses = cache ? cache->memo_misses : 0;
+}
+
+void cache_memo_clear_stats (struct cache *cache)
+{
+    if (cache) {
+        cache->memo_hits = 0;
+        cache->memo_misses = 0;
+    }
+}
+
+static void memo_dirent_destroy (void *arg)
+{
+    json_decref (arg);
+}
+
+/* A ref fell out of the warm set.  If its entry was never looked up,
+ * it was not needed, so remove it unless it is otherwise in use.
+ */
+static void warm_ref_destroy (void *arg)
+{
+    struct warm_ref *wr = arg;
+    struct cache *cache = wr->cache;
+    struct cache_entry *entry;
+
+    if (cache->zhx
+        && (entry = zhashx_lookup (cache->zhx, wr->ref))
+        && entry->warm
+        && !entry->dirty
+        && !entry->refcount
+        && (!entry->waitlist_notdirty
+            || !wait_queue_length (entry->waitlist_notdirty))
+        && (!entry->waitlist_valid
+            || !wait_queue_length (entry->waitlist_valid))) {
+        zhashx_delete (cache->zhx, wr->ref);
+        cache->warm_evictions++;
+    }
+    free (wr);
+}
+
+int cache_insert_warm (struct cache *cache,
+                       const char *ref,
+                       const void *data,
+                       int len)
+{
+    struct cache_entry *entry = NULL;
+    struct warm_ref *wr = NULL;
+    int saved_errno;
+
+    if (!cache || !ref || (data && len <= 0) || (!data && len)) {
+        errno = EINVAL;
+        return -1;
+    }
+    if (zhashx_lookup (cache->zhx, ref))
+        return 0;
+    if (!(entry = cache_entry_create (ref))
+        || cache_entry_set_raw (entry, data, len) < 0)
+        goto error;
+    entry->warm = true;
+    if (!(wr = calloc (1, sizeof (*wr) + strlen (ref) + 1))) {
+        errno = ENOMEM;
+        goto error;
+    }
+    wr->cache = cache;
+    strcpy (wr->ref, ref);
+    /* A ref already in the warm set is stale (its entry expired), so
+     * replace it.  Do this before inserting the new entry, so that it
+     * is not the one removed.
+     */
+    (void)lru_cache_remove (cache->warm, ref);
+    if (cache_insert (cache, entry) < 0)
+        goto error;
+    if (lru_cache_put (cache->warm, ref, wr) < 0) {
+        saved_errno = errno;
+        zhashx_delete (cache->zhx, ref); /* destroys entry */
+        free (wr);
+        errno = saved_errno;
+        return -1;
+    }
+    return 0;
+error:
+    saved_errno = errno;
+    free (wr);
+    cache_entry_destroy (entry);
+    errno = saved_errno;
+    return -1;
+}
+
+void cache_warm_get_stats (struct cache *cache,
+                           int *size,
+                           int *hits,
+                           int *evictions)
+{
+    if (size)
+        *size = cache ? lru_cache_size (cache->warm) : 0;
+    if (hits)
+        *hits = cache ? cache->warm_hits : 0;
+    if (evictions)
+        *evictions = cache ? cache->warm_evictions : 0;
+}
+
+void cache_warm_clear_stats (struct cache *cache)
+{
+    if (cache) {
+        cache->warm_hits = 0;
+        cache->warm_evictions = 0;
+    }
+}
+
 const char *cache_entry_get_blobref (struct cache_entry *entry)
 {
     return entry ? entry->blobref : NULL;
@@ -463,13 +667,30 @@ struct cache *cache_create (void)
     zhashx_set_key_destructor (cache->zhx, NULL);
     zhashx_set_key_duplicator (cache->zhx, NULL);
     zhashx_set_destructor (cache->zhx, cache_entry_destroy_wrapper);
+    if (!(cache->memo = lru_cache_create (CACHE_MEMO_MAX))) {
+        cache_destroy (cache);
+        errno = ENOMEM;
+        return NULL;
+    }
+    lru_cache_set_free_f (cache->memo, memo_dirent_destroy);
+    if (!(cache->warm = lru_cache_create (CACHE_WARM_MAX))) {
+        cache_destroy (cache);
+        errno = ENOMEM;
+        return NULL;
+    }
+    lru_cache_set_free_f (cache->warm, warm_ref_destroy);
     return cache;
 }
 
 void cache_destroy (struct cache *cache)
 {
     if (cache) {
+        /* N.B. zhx is NULL by the time warm refs are destroyed */
         zhashx_destroy (&cache->zhx);
+        if (cache->memo)
+            lru_cache_destroy (cache->memo);
+        if (cache->warm)
+            lru_cache_destroy (cache->warm);
         free (cache);
     }
 }
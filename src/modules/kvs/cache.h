@@ -149,6 +149,56 @@ int cache_expire_entries (struct cache *cache, int current_epoch, int thresh);
 int cache_get_stats (struct cache *cache, tstat_t *ts, int *size,
                      int *incomplete, int *dirty);
 
+/* Path memo - map a directory blobref and a '.' separated path within
+ * that directory to the dirent found there.  Tree objects are content
+ * addressed, so a memo entry stays correct when the root changes.
+ * Callers must only memoize paths that were resolved without following
+ * symlinks.  The memo is bounded and evicts least recently used entries.
+ *
+ * cache_memo_lookup() returns NULL on a miss, or a dirent that remains
+ * valid only until the next memo insert.  Take a reference if it must
+ * be held longer.
+ */
+const json_t *cache_memo_lookup (struct cache *cache,
+                                 const char *dirref,
+                                 const char *path);
+int cache_memo_insert (struct cache *cache,
+                       const char *dirref,
+                       const char *path,
+                       const json_t *dirent);
+
+/* Obtain/clear memo statistics.
+ */
+void cache_memo_get_stats (struct cache *cache,
+                           int *size,
+                           int *hits,
+                           int *misses);
+void cache_memo_clear_stats (struct cache *cache);
+
+/* Warm entries - entries inserted before anything asks for them,
+ * e.g. new objects pushed to followers in setroot events.  An entry is
+ * warm until it is first looked up.  The most recently inserted warm
+ * refs are tracked in a bounded LRU set; an entry whose ref falls out
+ * of the set while still warm, and not otherwise in use, is removed.
+ *
+ * cache_insert_warm() inserts a valid entry for 'ref' holding a copy
+ * of 'data'.  If 'ref' is already cached it silently succeeds.
+ * Returns 0 on success, -1 on error.
+ */
+int cache_insert_warm (struct cache *cache,
+                       const char *ref,
+                       const void *data,
+                       int len);
+
+/* Obtain/clear warm entry statistics: refs tracked, entries looked up
+ * while warm, and entries removed unused.
+ */
+void cache_warm_get_stats (struct cache *cache,
+                           int *size,
+                           int *hits,
+                           int *evictions);
+void cache_warm_clear_stats (struct cache *cache);
+
 /* Destroy wait_t's on the waitqueue_t of any cache entry
  * if they meet match criteria.
  */
@@ -27,6 +27,7 @@
 #include "src/common/libutil/blobref.h"
 #include "src/common/libutil/monotime.h"
 #include "src/common/libutil/tstat.h"
+#include "src/common/libutil/workpool.h"
 #include "src/common/libkvs/treeobj.h"
 #include "src/common/libkvs/kvs_txn_private.h"
 #include "src/common/libkvs/kvs_util_private.h"
@@ -55,6 +56,30 @@ const int max_namespace_age = 1000;
  */
 const bool event_includes_rootdir = true;
 
+/* Limits on the size of one content.load-batch or content.store-batch
+ * request.  Larger batches are split.
+ */
+static const int content_batch_max_count = 256;
+static const int content_batch_max_bytes = 1024*1024*16;
+
+/* New objects are encoded and hashed on the kvs thread unless
+ * unroll-threads=N (N > 0) is given, which starts a pool of N worker
+ * threads on a namespace leader.  The pool is off by default, since it
+ * has not been shown to lower commit latency, and handing small commits
+ * to threads can raise it.
+ */
+
+/* New objects up to this size are candidates for pushing to followers
+ * in the setroot event, when enabled with cache-warm-bytes=N.
+ */
+static const int cache_warm_object_max = 4096;
+
+/* New values up to this size (base64 encoded) are candidates for
+ * inclusion in the setroot event for kvs-watch, when enabled with
+ * inline-values-bytes=N.
+ */
+static const int inline_value_max = 1024;
+
 typedef struct {
     struct cache *cache;    /* blobref => cache_entry */
     kvsroot_mgr_t *krm;
@@ -66,6 +91,10 @@ typedef struct {
     flux_watcher_t *idle_w;
     flux_watcher_t *check_w;
     int transaction_merge;
+    int unroll_threads;
+    struct workpool *workpool;  /* for kvstxn_unroll() */
+    int cache_warm_bytes;       /* max object bytes per setroot event */
+    int inline_values_bytes;    /* max value bytes per setroot event */
     bool events_init;            /* flag */
     const char *hash_name;
     unsigned int seq;           /* for commit transactions */
@@ -78,6 +107,7 @@ struct kvs_cb_data {
     int errnum;
     bool ready;
     char *sender;
+    zlist_t *batch;         /* refs to load or entries to store */
 };
 
 static void transaction_prep_cb (flux_reactor_t *r, flux_watcher_t *w,
@@ -95,6 +125,7 @@ static void freectx (void *arg)
     if (ctx) {
         cache_destroy (ctx->cache);
         kvsroot_mgr_destroy (ctx->krm);
+        workpool_destroy (ctx->workpool);
         flux_watcher_destroy (ctx->prep_w);
         flux_watcher_destroy (ctx->check_w);
         flux_watcher_destroy (ctx->idle_w);
@@ -136,22 +167,25 @@ static kvs_ctx_t *getctx (flux_t *h)
             saved_errno = errno;
             goto error;
         }
+        /* Watchers are started on rank 0, and on other ranks when they
+         * first lead a namespace.  See leader_init().
+         */
+        ctx->prep_w = flux_prepare_watcher_create (r, transaction_prep_cb, ctx);
+        if (!ctx->prep_w) {
+            saved_errno = errno;
+            goto error;
+        }
+        ctx->check_w = flux_check_watcher_create (r, transaction_check_cb, ctx);
+        if (!ctx->check_w) {
+            saved_errno = errno;
+            goto error;
+        }
+        ctx->idle_w = flux_idle_watcher_create (r, NULL, NULL);
+        if (!ctx->idle_w) {
+            saved_errno = errno;
+            goto error;
+        }
         if (ctx->rank == 0) {
-            ctx->prep_w = flux_prepare_watcher_create (r, transaction_prep_cb, ctx);
-            if (!ctx->prep_w) {
-                saved_errno = errno;
-                goto error;
-            }
-            ctx->check_w = flux_check_watcher_create (r, transaction_check_cb, ctx);
-            if (!ctx->check_w) {
-                saved_errno = errno;
-                goto error;
-            }
-            ctx->idle_w = flux_idle_watcher_create (r, NULL, NULL);
-            if (!ctx->idle_w) {
-                saved_errno = errno;
-                goto error;
-            }
             flux_watcher_start (ctx->prep_w);
             flux_watcher_start (ctx->check_w);
         }
@@ -168,6 +202,23 @@ error:
     return NULL;
 }
 
+/* Prepare a rank other than 0 to apply transactions, the first time it
+ * leads a namespace.  Call before the root is created, so that its
+ * kvstxn manager picks up the worker pool.  If the pool cannot be
+ * created, objects are encoded in the kvs thread.
+ */
+static void leader_init (kvs_ctx_t *ctx)
+{
+    if (!ctx->workpool && ctx->unroll_threads > 0) {
+        if (!(ctx->workpool = workpool_create (ctx->unroll_threads)))
+            flux_log_error (ctx->h, "workpool_create");
+        else
+            kvsroot_mgr_set_workpool (ctx->krm, ctx->workpool);
+    }
+    flux_watcher_start (ctx->prep_w);
+    flux_watcher_start (ctx->check_w);
+}
+
 /*
  * event subscribe/unsubscribe
  */
@@ -301,7 +352,7 @@ static void getroot_completion (flux_future_t *f, void *arg)
     flux_msg_t *msg = NULL;
     const char *ns;
     int rootseq, flags;
-    uint32_t owner;
+    uint32_t owner, leader;
     const char *ref;
     struct kvsroot *root;
     int save_errno;
@@ -315,12 +366,13 @@ static void getroot_completion (flux_future_t *f, void *arg)
         goto error;
     }
 
-    /* N.B. owner read into uint32_t */
-    if (flux_rpc_get_unpack (f, "{ s:i s:i s:s s:i }",
+    /* N.B. owner and leader read into uint32_t */
+    if (flux_rpc_get_unpack (f, "{ s:i s:i s:s s:i s:i }",
                              "owner", &owner,
                              "rootseq", &rootseq,
                              "rootref", &ref,
-                             "flags", &flags) < 0) {
+                             "flags", &flags,
+                             "leader", &leader) < 0) {
         if (errno != ENOTSUP)
             flux_log_error (ctx->h, "%s: flux_rpc_get_unpack", __FUNCTION__);
         goto error;
@@ -330,6 +382,12 @@ static void getroot_completion (flux_future_t *f, void *arg)
      * response.  Not relevant if namespace in process of being removed. */
     if (!(root = kvsroot_mgr_lookup_root (ctx->krm, ns))) {
 
+        /* The leader's copy of the root is initialized the same way
+         * as a follower's, before its first transaction is applied.
+         */
+        if (leader == ctx->rank)
+            leader_init (ctx);
+
         if (!(root = kvsroot_mgr_create_root (ctx->krm,
                                               ctx->cache,
                                               ctx->hash_name,
@@ -339,6 +397,7 @@ static void getroot_completion (flux_future_t *f, void *arg)
             flux_log_error (ctx->h, "%s: kvsroot_mgr_create_root", __FUNCTION__);
             goto error;
         }
+        root->leader = leader;
 
         if (event_subscribe (ctx, ns) < 0) {
             save_errno = errno;
@@ -468,16 +527,17 @@ static void content_load_cache_entry_error (kvs_ctx_t *ctx,
         flux_log (ctx->h, LOG_ERR, "%s: cache_remove_entry", __FUNCTION__);
 }
 
-static void content_load_completion (flux_future_t *f, void *arg)
+/* Handle the result of loading 'blobref'.  If 'errnum' is nonzero,
+ * the load failed.
+ */
+static void content_load_result (kvs_ctx_t *ctx,
+                                 const char *blobref,
+                                 const void *data,
+                                 int size,
+                                 int errnum)
 {
-    kvs_ctx_t *ctx = arg;
-    const void *data;
-    int size;
-    const char *blobref;
     struct cache_entry *entry;
 
-    blobref = flux_future_aux_get (f, "ref");
-
     /* should be impossible for lookup to fail, cache entry created
      * earlier, and cache_expire_entries() could not have removed it
      * b/c it is not yet valid.  But check and log incase there is
@@ -485,13 +545,14 @@ static void content_load_completion (flux_future_t *f, void *arg)
      */
     if (!(entry = cache_lookup (ctx->cache, blobref, ctx->epoch))) {
         flux_log (ctx->h, LOG_ERR, "%s: cache_lookup", __FUNCTION__);
-        goto done;
+        return;
     }
 
-    if (flux_content_load_get (f, &data, &size) < 0) {
-        flux_log_error (ctx->h, "%s: flux_content_load_get", __FUNCTION__);
-        content_load_cache_entry_error (ctx, entry, errno, blobref);
-        goto done;
+    if (errnum != 0) {
+        flux_log (ctx->h, LOG_ERR, "%s: flux_content_load_batch_get: %s",
+                  __FUNCTION__, flux_strerror (errnum));
+        content_load_cache_entry_error (ctx, entry, errnum, blobref);
+        return;
     }
 
     /* If cache_entry_set_raw() fails, it's a pretty terrible error
@@ -501,34 +562,80 @@ static void content_load_completion (flux_future_t *f, void *arg)
     if (cache_entry_set_raw (entry, data, size) < 0) {
         flux_log_error (ctx->h, "%s: cache_entry_set_raw", __FUNCTION__);
         content_load_cache_entry_error (ctx, entry, errno, blobref);
-        goto done;
+        return;
     }
+}
 
-done:
+static void content_load_completion (flux_future_t *f, void *arg)
+{
+    kvs_ctx_t *ctx = arg;
+    char **refs = flux_future_aux_get (f, "refs");
+    const void *data;
+    int size;
+    int i;
+
+    for (i = 0; refs[i] != NULL; i++) {
+        if (flux_content_load_batch_get (f, i, &data, &size) < 0)
+            content_load_result (ctx, refs[i], NULL, 0, errno);
+        else
+            content_load_result (ctx, refs[i], data, size, 0);
+    }
     flux_future_destroy (f);
 }
 
-/* Send content load request and setup contination to handle response.
+/* Create a future that is already fulfilled with an error, so that
+ * a batch that could not be sent fails its waiters from the reactor,
+ * the same way a failed RPC would.
+ */
+static flux_future_t *errored_future (kvs_ctx_t *ctx, int errnum)
+{
+    flux_future_t *f;
+
+    if (!(f = flux_future_create (NULL, NULL)))
+        return NULL;
+    flux_future_set_flux (f, ctx->h);
+    flux_future_fulfill_error (f, errnum, NULL);
+    return f;
+}
+
+static void refs_destroy (void *arg)
+{
+    char **refs = arg;
+    int i;
+
+    if (refs) {
+        for (i = 0; refs[i] != NULL; i++)
+            free (refs[i]);
+        free (refs);
+    }
+}
+
+/* Send one load-batch request for up to 'count' refs popped from 'l',
+ * and setup continuation to handle response.
  */
-static int content_load_request_send (kvs_ctx_t *ctx, const char *ref)
+static int content_load_batch_send (kvs_ctx_t *ctx, zlist_t *l, int count)
 {
     flux_future_t *f = NULL;
-    char *refcpy;
+    char **refs;
     int saved_errno;
+    int i;
 
-    if (!(f = flux_content_load (ctx->h, ref, 0))) {
-        flux_log_error (ctx->h, "%s: flux_content_load", __FUNCTION__);
-        goto error;
-    }
-    if (!(refcpy = strdup (ref))) {
+    if (!(refs = calloc (count + 1, sizeof (refs[0])))) {
         errno = ENOMEM;
-        goto error;
+        return -1;
+    }
+    for (i = 0; i < count; i++)
+        refs[i] = zlist_pop (l);
+    if (!(f = flux_content_load_batch (ctx->h, (const char **)refs, count, 0))) {
+        flux_log_error (ctx->h, "%s: flux_content_load_batch", __FUNCTION__);
+        if (!(f = errored_future (ctx, errno)))
+            goto error;
     }
-    if (flux_future_aux_set (f, "ref", refcpy, free) < 0) {
+    if (flux_future_aux_set (f, "refs", refs, refs_destroy) < 0) {
         flux_log_error (ctx->h, "%s: flux_future_aux_set", __FUNCTION__);
-        free (refcpy);
         goto error;
     }
+    refs = NULL; // owned by 'f' now
     if (flux_future_then (f, -1., content_load_completion, ctx) < 0) {
         flux_log_error (ctx->h, "%s: flux_future_then", __FUNCTION__);
         goto error;
@@ -536,16 +643,42 @@ static int content_load_request_send (kvs_ctx_t *ctx, const char *ref)
     return 0;
 error:
     saved_errno = errno;
+    refs_destroy (refs);
     flux_future_destroy (f);
     errno = saved_errno;
     return -1;
 }
 
-/* Return 0 on success, -1 on error.  Set stall variable appropriately
+/* Send load requests for the refs collected by load() in as few
+ * load-batch RPCs as possible.  The list is emptied.
+ * Return 0 on success, -1 on error.
+ */
+static int content_load_flush (kvs_ctx_t *ctx, zlist_t *l)
+{
+    int count;
+    int rc = 0;
+
+    while ((count = zlist_size (l)) > 0) {
+        if (count > content_batch_max_count)
+            count = content_batch_max_count;
+        if (content_load_batch_send (ctx, l, count) < 0)
+            rc = -1;
+    }
+    return rc;
+}
+
+/* Return 0 on success, -1 on error.  Set stall variable appropriately.
+ * If the entry is not cached, its ref is added to 'batch', and
+ * the caller must send it with content_load_flush().
  */
-static int load (kvs_ctx_t *ctx, const char *ref, wait_t *wait, bool *stall)
+static int load (kvs_ctx_t *ctx,
+                 const char *ref,
+                 wait_t *wait,
+                 zlist_t *batch,
+                 bool *stall)
 {
     struct cache_entry *entry = cache_lookup (ctx->cache, ref, ctx->epoch);
+    char *refcpy;
     int saved_errno, ret;
 
     assert (wait != NULL);
@@ -564,10 +697,10 @@ static int load (kvs_ctx_t *ctx, const char *ref, wait_t *wait, bool *stall)
             cache_entry_destroy (entry);
             return -1;
         }
-        if (content_load_request_send (ctx, ref) < 0) {
-            saved_errno = errno;
-            flux_log_error (ctx->h, "%s: content_load_request_send",
-                            __FUNCTION__);
+        if (!(refcpy = strdup (ref)) || zlist_append (batch, refcpy) < 0) {
+            free (refcpy);
+            saved_errno = ENOMEM;
+            flux_log_error (ctx->h, "%s: zlist_append", __FUNCTION__);
             /* cache entry just created, should always work */
             ret = cache_remove_entry (ctx->cache, ref);
             assert (ret == 1);
@@ -609,18 +742,19 @@ static int load (kvs_ctx_t *ctx, const char *ref, wait_t *wait, bool *stall)
  * store/write
  */
 
-static void content_store_completion (flux_future_t *f, void *arg)
+/* Handle the result of storing the entry for 'cache_blobref'.
+ * If 'blobref' is NULL, the store failed with errno set.
+ */
+static void content_store_result (kvs_ctx_t *ctx,
+                                  const char *cache_blobref,
+                                  const char *blobref)
 {
-    kvs_ctx_t *ctx = arg;
     struct cache_entry *entry;
-    const char *cache_blobref, *blobref;
     int ret;
 
-    cache_blobref = flux_future_aux_get (f, "cache_blobref");
-    assert (cache_blobref);
-
-    if (flux_content_store_get (f, &blobref) < 0) {
-        flux_log_error (ctx->h, "%s: flux_content_store_get", __FUNCTION__);
+    if (!blobref) {
+        flux_log_error (ctx->h, "%s: flux_content_store_batch_get",
+                        __FUNCTION__);
         goto error;
     }
 
@@ -658,13 +792,9 @@ static void content_store_completion (flux_future_t *f, void *arg)
                         __FUNCTION__);
         goto error;
     }
-
-    flux_future_destroy (f);
     return;
 
 error:
-    flux_future_destroy (f);
-
     /* failure on store, inform all waiters, must destroy entry
      * afterwards, as future loads/stores may believe content is ok.
      * cache_remove_entry() will not work if a waiter is still there.
@@ -700,29 +830,92 @@ error:
         flux_log (ctx->h, LOG_ERR, "%s: cache_remove_entry", __FUNCTION__);
 }
 
-static int content_store_request_send (kvs_ctx_t *ctx, const char *blobref,
-                                       const void *data, int len)
+static void content_store_completion (flux_future_t *f, void *arg)
 {
-    flux_future_t *f;
-    int saved_errno, rc = -1;
+    kvs_ctx_t *ctx = arg;
+    const char **cache_blobrefs = flux_future_aux_get (f, "cache_blobrefs");
+    const char *blobref;
+    int i;
 
-    if (!(f = flux_content_store (ctx->h, data, len, 0)))
-        goto error;
-    if (flux_future_aux_set (f, "cache_blobref", (void *)blobref, NULL) < 0) {
-        saved_errno = errno;
-        flux_future_destroy (f);
-        errno = saved_errno;
-        goto error;
+    for (i = 0; cache_blobrefs[i] != NULL; i++) {
+        if (flux_content_store_batch_get (f, i, &blobref) < 0)
+            blobref = NULL;
+        content_store_result (ctx, cache_blobrefs[i], blobref);
     }
-    if (flux_future_then (f, -1., content_store_completion, ctx) < 0) {
-        saved_errno = errno;
-        flux_future_destroy (f);
-        errno = saved_errno;
+    flux_future_destroy (f);
+}
+
+/* Send one store-batch request for entries popped from 'l', up to the
+ * batch limits, and setup continuation to handle response.
+ * The entries are dirty, so their blobrefs and data remain valid until
+ * the store completes.
+ */
+static int content_store_batch_send (kvs_ctx_t *ctx, zlist_t *l)
+{
+    int max = zlist_size (l);
+    flux_future_t *f = NULL;
+    const char **cache_blobrefs = NULL;
+    const void **bufs = NULL;
+    int *lens = NULL;
+    struct cache_entry *entry;
+    int count = 0;
+    int bytes = 0;
+    int saved_errno;
+
+    if (max > content_batch_max_count)
+        max = content_batch_max_count;
+    if (!(cache_blobrefs = calloc (max + 1, sizeof (cache_blobrefs[0])))
+        || !(bufs = calloc (max, sizeof (bufs[0])))
+        || !(lens = calloc (max, sizeof (lens[0])))) {
+        errno = ENOMEM;
         goto error;
     }
-
-    rc = 0;
+    while (count < max && bytes < content_batch_max_bytes) {
+        entry = zlist_pop (l);
+        /* cache_entry_get_raw() was checked by kvstxn_cache_cb() */
+        (void)cache_entry_get_raw (entry, &bufs[count], &lens[count]);
+        cache_blobrefs[count] = cache_entry_get_blobref (entry);
+        bytes += lens[count];
+        count++;
+    }
+    if (!(f = flux_content_store_batch (ctx->h, bufs, lens, count, 0))) {
+        flux_log_error (ctx->h, "%s: flux_content_store_batch", __FUNCTION__);
+        if (!(f = errored_future (ctx, errno)))
+            goto error;
+    }
+    if (flux_future_aux_set (f, "cache_blobrefs", cache_blobrefs, free) < 0)
+        goto error;
+    cache_blobrefs = NULL; // owned by 'f' now
+    if (flux_future_then (f, -1., content_store_completion, ctx) < 0)
+        goto error;
+    free (bufs);
+    free (lens);
+    return 0;
 error:
+    saved_errno = errno;
+    flux_future_destroy (f);
+    free (cache_blobrefs);
+    free (bufs);
+    free (lens);
+    errno = saved_errno;
+    return -1;
+}
+
+/* Send the dirty entries collected by kvstxn_cache_cb() in as few
+ * store-batch RPCs as possible.  The list is emptied.
+ * Return 0 on success, -1 on error.
+ */
+static int content_store_flush (kvs_ctx_t *ctx, zlist_t *l)
+{
+    int rc = 0;
+
+    while (zlist_size (l) > 0) {
+        if (content_store_batch_send (ctx, l) < 0) {
+            flux_log_error (ctx->h, "%s: content_store_batch_send",
+                            __FUNCTION__);
+            rc = -1;
+        }
+    }
     return rc;
 }
 
@@ -731,7 +924,7 @@ static int kvstxn_load_cb (kvstxn_t *kt, const char *ref, void *data)
     struct kvs_cb_data *cbd = data;
     bool stall;
 
-    if (load (cbd->ctx, ref, cbd->wait, &stall) < 0) {
+    if (load (cbd->ctx, ref, cbd->wait, cbd->batch, &stall) < 0) {
         cbd->errnum = errno;
         flux_log_error (cbd->ctx->h, "%s: load", __FUNCTION__);
         return -1;
@@ -741,8 +934,8 @@ static int kvstxn_load_cb (kvstxn_t *kt, const char *ref, void *data)
     return 0;
 }
 
-/* Flush to content cache asynchronously and push wait onto cache
- * object's wait queue.
+/* Add entry to the batch to be flushed to content cache asynchronously
+ * and push wait onto cache object's wait queue.
  */
 static int kvstxn_cache_cb (kvstxn_t *kt, struct cache_entry *entry, void *data)
 {
@@ -764,19 +957,25 @@ static int kvstxn_cache_cb (kvstxn_t *kt, struct cache_entry *entry, void *data)
     blobref = cache_entry_get_blobref (entry);
     assert (blobref);
 
-    if (content_store_request_send (cbd->ctx,
-                                    blobref,
-                                    storedata,
-                                    storedatalen) < 0) {
-        cbd->errnum = errno;
-        flux_log_error (cbd->ctx->h, "%s: content_store_request_send",
-                        __FUNCTION__);
+    /* Not critical if this fails, followers fault the object in on demand.
+     */
+    if (cbd->ctx->cache_warm_bytes > 0
+        && storedatalen <= cache_warm_object_max) {
+        if (kvstxn_add_warm_ref (kt, blobref) < 0)
+            flux_log_error (cbd->ctx->h, "%s: kvstxn_add_warm_ref",
+                            __FUNCTION__);
+    }
+
+    if (zlist_append (cbd->batch, entry) < 0) {
+        cbd->errnum = ENOMEM;
+        flux_log (cbd->ctx->h, LOG_ERR, "%s: zlist_append", __FUNCTION__);
         kvstxn_cleanup_dirty_cache_entry (kt, entry);
         return -1;
     }
     if (cache_entry_wait_notdirty (entry, cbd->wait) < 0) {
         cbd->errnum = errno;
         flux_log_error (cbd->ctx->h, "cache_entry_wait_notdirty");
+        zlist_remove (cbd->batch, entry);
         kvstxn_cleanup_dirty_cache_entry (kt, entry);
         return -1;
     }
@@ -789,23 +988,209 @@ static void flux_msg_destroy_wrapper (void *arg)
     flux_msg_destroy (msg);
 }
 
+/* Build an array of val treeobjs containing the objects named by
+ * 'warm_refs', up to ctx->cache_warm_bytes of object data, for followers
+ * to insert into their caches.  The root directory is skipped if it is
+ * sent separately.
+ */
+static json_t *warm_objects_create (kvs_ctx_t *ctx, struct kvsroot *root,
+                                    json_t *warm_refs)
+{
+    json_t *objects;
+    json_t *value;
+    size_t index;
+    int total = 0;
+
+    if (!(objects = json_array ())) {
+        errno = ENOMEM;
+        return NULL;
+    }
+    json_array_foreach (warm_refs, index, value) {
+        const char *ref = json_string_value (value);
+        struct cache_entry *entry;
+        const void *data;
+        int len;
+        json_t *o;
+
+        if (!ref || (event_includes_rootdir && !strcmp (ref, root->ref)))
+            continue;
+        if (!(entry = cache_lookup (ctx->cache, ref, ctx->epoch))
+            || cache_entry_get_raw (entry, &data, &len) < 0)
+            continue;
+        if (len > ctx->cache_warm_bytes - total)
+            continue;
+        if (!(o = treeobj_create_val (data, len)))
+            goto error;
+        if (json_array_append_new (objects, o) < 0) {
+            json_decref (o);
+            errno = ENOMEM;
+            goto error;
+        }
+        total += len;
+    }
+    return objects;
+error:
+    json_decref (objects);
+    return NULL;
+}
+
+/* Add each parent path of normalized 'key' to 'parents'.
+ */
+static int add_parent_paths (json_t *parents, const char *key)
+{
+    char *cpy;
+    char *p;
+
+    if (!(cpy = strdup (key)))
+        return -1;
+    while ((p = strrchr (cpy, '.'))) {
+        *p = '\0';
+        if (json_object_set_new (parents, cpy, json_true ()) < 0) {
+            free (cpy);
+            errno = ENOMEM;
+            return -1;
+        }
+    }
+    free (cpy);
+    return 0;
+}
+
+/* Return true if any parent path of normalized 'key' is in 'paths'.
+ */
+static bool parent_path_match (json_t *paths, const char *key)
+{
+    char *cpy;
+    char *p;
+    bool match = false;
+
+    if (!(cpy = strdup (key)))
+        return true;
+    while (!match && (p = strrchr (cpy, '.'))) {
+        *p = '\0';
+        if (json_object_get (paths, cpy))
+            match = true;
+    }
+    free (cpy);
+    return match;
+}
+
+/* Build objects mapping keys changed by 'ops' to their new val treeobj
+ * ('values'), or for appends, to the val treeobj appended ('appends'),
+ * so kvs-watch can answer watchers of these keys without a lookup.
+ * A key is included only if it is the target of exactly one op, and no
+ * op in the transaction targets a parent or child path, so that the op
+ * determines the key's value.  Values are limited to inline_value_max
+ * bytes each and ctx->inline_values_bytes in total.
+ */
+static int inline_values_create (kvs_ctx_t *ctx,
+                                 json_t *ops,
+                                 json_t **valuesp,
+                                 json_t **appendsp)
+{
+    json_t *counts = NULL;
+    json_t *parents = NULL;
+    json_t *values = NULL;
+    json_t *appends = NULL;
+    json_t *op;
+    size_t index;
+    char *norm = NULL;
+    int total = 0;
+    int saved_errno;
+
+    if (!(values = json_object ())
+        || !(appends = json_object ())
+        || !(counts = json_object ())
+        || !(parents = json_object ())) {
+        errno = ENOMEM;
+        goto error;
+    }
+    if (ctx->inline_values_bytes == 0)
+        goto done;
+    json_array_foreach (ops, index, op) {
+        const char *key;
+        int flags;
+        json_t *dirent;
+        json_int_t count;
+
+        if (txn_decode_op (op, &key, &flags, &dirent) < 0
+            || !(norm = kvs_util_normalize_key (key, NULL))
+            || add_parent_paths (parents, norm) < 0)
+            goto error;
+        count = json_integer_value (json_object_get (counts, norm));
+        if (json_object_set_new (counts, norm, json_integer (count + 1)) < 0) {
+            errno = ENOMEM;
+            goto error;
+        }
+        free (norm);
+        norm = NULL;
+    }
+    json_array_foreach (ops, index, op) {
+        const char *key;
+        int flags;
+        json_t *dirent;
+        const char *data;
+        int len;
+
+        if (txn_decode_op (op, &key, &flags, &dirent) < 0
+            || !(norm = kvs_util_normalize_key (key, NULL)))
+            goto error;
+        if (json_integer_value (json_object_get (counts, norm)) == 1
+            && !json_object_get (parents, norm)
+            && !parent_path_match (counts, norm)
+            && (flags & ~FLUX_KVS_APPEND) == 0
+            && treeobj_is_val (dirent)
+            && (data = json_string_value (treeobj_get_data (dirent)))
+            && (len = strlen (data)) <= inline_value_max
+            && len <= ctx->inline_values_bytes - total) {
+            if (json_object_set ((flags & FLUX_KVS_APPEND) ? appends : values,
+                                 norm,
+                                 dirent) < 0) {
+                errno = ENOMEM;
+                goto error;
+            }
+            total += len;
+        }
+        free (norm);
+        norm = NULL;
+    }
+done:
+    json_decref (counts);
+    json_decref (parents);
+    *valuesp = values;
+    *appendsp = appends;
+    return 0;
+error:
+    saved_errno = errno;
+    free (norm);
+    json_decref (counts);
+    json_decref (parents);
+    json_decref (values);
+    json_decref (appends);
+    errno = saved_errno;
+    return -1;
+}
+
 static int setroot_event_send (kvs_ctx_t *ctx, struct kvsroot *root,
-                               json_t *names, json_t *keys)
+                               json_t *names, json_t *keys, json_t *ops,
+                               json_t *warm_refs)
 {
     const json_t *root_dir = NULL;
     json_t *nullobj = NULL;
+    json_t *objects = NULL;
+    json_t *values = NULL;
+    json_t *appends = NULL;
     flux_msg_t *msg = NULL;
     char *setroot_topic = NULL;
     int saved_errno, rc = -1;
 
-    assert (ctx->rank == 0);
+    assert (root->leader == ctx->rank);
 
     if (event_includes_rootdir) {
         struct cache_entry *entry;
 
         if ((entry = cache_lookup (ctx->cache, root->ref, ctx->epoch)))
             root_dir = cache_entry_get_treeobj (entry);
-        assert (root_dir != NULL); // root entry is always in cache on rank 0
+        assert (root_dir != NULL); // root entry is always in cache on leader
     }
     else {
         if (!(nullobj = json_null ())) {
@@ -816,6 +1201,18 @@ static int setroot_event_send (kvs_ctx_t *ctx, struct kvsroot *root,
         root_dir = nullobj;
     }
 
+    if (!(objects = warm_objects_create (ctx, root, warm_refs))) {
+        saved_errno = errno;
+        flux_log_error (ctx->h, "%s: warm_objects_create", __FUNCTION__);
+        goto done;
+    }
+
+    if (inline_values_create (ctx, ops, &values, &appends) < 0) {
+        saved_errno = errno;
+        flux_log_error (ctx->h, "%s: inline_values_create", __FUNCTION__);
+        goto done;
+    }
+
     if (asprintf (&setroot_topic, "kvs.namespace-%s-setroot", root->ns_name) < 0) {
         saved_errno = ENOMEM;
         flux_log_error (ctx->h, "%s: asprintf", __FUNCTION__);
@@ -823,14 +1220,17 @@ static int setroot_event_send (kvs_ctx_t *ctx, struct kvsroot *root,
     }
 
     if (!(msg = flux_event_pack (setroot_topic,
-                                 "{ s:s s:i s:s s:O s:O s:O s:i}",
+                                 "{ s:s s:i s:s s:O s:O s:O s:i s:O s:O s:O}",
                                  "namespace", root->ns_name,
                                  "rootseq", root->seq,
                                  "rootref", root->ref,
                                  "names", names,
                                  "rootdir", root_dir,
                                  "keys", keys,
-                                 "owner", root->owner))) {
+                                 "owner", root->owner,
+                                 "objects", objects,
+                                 "values", values,
+                                 "appends", appends))) {
         saved_errno = errno;
         flux_log_error (ctx->h, "%s: flux_event_pack", __FUNCTION__);
         goto done;
@@ -848,6 +1248,9 @@ done:
     free (setroot_topic);
     flux_msg_destroy (msg);
     json_decref (nullobj);
+    json_decref (objects);
+    json_decref (values);
+    json_decref (appends);
     if (rc < 0)
         errno = saved_errno;
     return rc;
@@ -915,8 +1318,8 @@ static void kvstxn_wait_error_cb (wait_t *w, int errnum, void *arg)
     kvstxn_set_aux_errnum (kt, errnum);
 }
 
-/* Write all the ops for a particular commit/fence request (rank 0
- * only).  The setroot event will cause responses to be sent to the
+/* Write all the ops for a particular commit/fence request (namespace
+ * leader only).  The setroot event will cause responses to be sent to the
  * transaction requests and clean up the treq_t state.  This
  * function is idempotent.
  */
@@ -928,6 +1331,7 @@ static void kvstxn_apply (kvstxn_t *kt)
     wait_t *wait = NULL;
     int errnum = 0;
     kvstxn_process_t ret;
+    int iter_rc;
     bool fallback = false;
 
     ns = kvstxn_get_namespace (kt);
@@ -944,6 +1348,12 @@ static void kvstxn_apply (kvstxn_t *kt)
     root = kvsroot_mgr_lookup_root (ctx->krm, ns);
     assert (root);
 
+    /* If this transaction was processed in the pipeline against a root
+     * that was never published (e.g. the transaction ahead of it
+     * failed), start it over against the current root.
+     */
+    (void)kvstxn_rebase (kt, root->ref);
+
     if (root->remove) {
         flux_log (ctx->h, LOG_DEBUG, "%s: namespace %s removed", __FUNCTION__,
                   ns);
@@ -975,8 +1385,19 @@ static void kvstxn_apply (kvstxn_t *kt)
         cbd.ctx = ctx;
         cbd.wait = wait;
         cbd.errnum = 0;
+        if (!(cbd.batch = zlist_new ())) {
+            errnum = ENOMEM;
+            goto done;
+        }
 
-        if (kvstxn_iter_missing_refs (kt, kvstxn_load_cb, &cbd) < 0) {
+        /* Refs that were added to the batch have waiters, so send them
+         * even if the iteration failed part way.
+         */
+        iter_rc = kvstxn_iter_missing_refs (kt, kvstxn_load_cb, &cbd);
+        if (content_load_flush (ctx, cbd.batch) < 0)
+            flux_log_error (ctx->h, "%s: content_load_flush", __FUNCTION__);
+        zlist_destroy (&cbd.batch);
+        if (iter_rc < 0) {
             errnum = cbd.errnum;
 
             /* rpcs already in flight, stall for them to complete */
@@ -1005,8 +1426,19 @@ static void kvstxn_apply (kvstxn_t *kt)
         cbd.ctx = ctx;
         cbd.wait = wait;
         cbd.errnum = 0;
+        if (!(cbd.batch = zlist_new ())) {
+            errnum = ENOMEM;
+            goto done;
+        }
 
-        if (kvstxn_iter_dirty_cache_entries (kt, kvstxn_cache_cb, &cbd) < 0) {
+        /* Entries that were added to the batch have waiters, so send them
+         * even if the iteration failed part way.
+         */
+        iter_rc = kvstxn_iter_dirty_cache_entries (kt, kvstxn_cache_cb, &cbd);
+        if (content_store_flush (ctx, cbd.batch) < 0)
+            flux_log_error (ctx->h, "%s: content_store_flush", __FUNCTION__);
+        zlist_destroy (&cbd.batch);
+        if (iter_rc < 0) {
             errnum = cbd.errnum;
 
             /* rpcs already in flight, stall for them to complete */
@@ -1028,6 +1460,14 @@ static void kvstxn_apply (kvstxn_t *kt)
      * event for "eventual consistency" of other nodes.
      */
 done:
+    /* Transactions are published in order.  If others are ahead of this
+     * one, it is finished off when it reaches the head of the queue.
+     */
+    if (kvstxn_mgr_defer_transaction (root->ktm, kt)) {
+        wait_destroy (wait);
+        return;
+    }
+
     if (errnum == 0) {
         json_t *names = kvstxn_get_names (kt);
         int count;
@@ -1038,7 +1478,12 @@ done:
                       count, opcount);
         }
         setroot (ctx, root, kvstxn_get_newroot_ref (kt), root->seq + 1);
-        setroot_event_send (ctx, root, names, kvstxn_get_keys (kt));
+        setroot_event_send (ctx,
+                            root,
+                            names,
+                            kvstxn_get_keys (kt),
+                            kvstxn_get_ops (kt),
+                            kvstxn_get_warm_refs (kt));
     } else {
         fallback = kvstxn_fallback_mergeable (kt);
 
@@ -1058,6 +1503,12 @@ done:
      * N.B. treq_t remains in the treq_mgr_t hash until event is received.
      */
     kvstxn_mgr_remove_transaction (root->ktm, kt, fallback);
+
+    /* The next transaction may have completed while this one was
+     * in progress.  Replay it now that it is at the head.
+     */
+    if ((kt = kvstxn_mgr_get_deferred_transaction (root->ktm)))
+        kvstxn_apply (kt);
     return;
 
 stall:
@@ -1208,6 +1659,7 @@ static int heartbeat_root_cb (struct kvsroot *root, void *arg)
         }
     }
     else if (ctx->rank != 0
+             && root->leader != ctx->rank
              && !root->remove
              && strcasecmp (root->ns_name, KVS_PRIMARY_NAMESPACE)
              && (ctx->epoch - root->last_update_epoch) > max_namespace_age
@@ -1215,8 +1667,9 @@ static int heartbeat_root_cb (struct kvsroot *root, void *arg)
              && !treq_mgr_transactions_count (root->trm)
              && !kvstxn_mgr_ready_transaction_count (root->ktm)) {
         /* remove a root if it not the primary one, has timed out
-         * on a follower node, and it does not have any watchers,
-         * and no one is trying to write/change something.
+         * on a follower node that does not lead it, and it does not
+         * have any watchers, and no one is trying to write/change
+         * something.
          */
         start_root_remove (ctx, root->ns_name);
     }
@@ -1249,7 +1702,7 @@ static int lookup_load_cb (lookup_t *lh, const char *ref, void *data)
     struct kvs_cb_data *cbd = data;
     bool stall;
 
-    if (load (cbd->ctx, ref, cbd->wait, &stall) < 0) {
+    if (load (cbd->ctx, ref, cbd->wait, cbd->batch, &stall) < 0) {
         cbd->errnum = errno;
         flux_log_error (cbd->ctx->h, "%s: load", __FUNCTION__);
         return -1;
@@ -1282,6 +1735,7 @@ static lookup_t *lookup_common (flux_t *h, flux_msg_handler_t *mh,
     lookup_process_t lret;
     int rc = -1;
     int ret;
+    int iter_rc;
 
     /* if lookup_handle exists in msg as aux data, is a replay */
     lh = flux_msg_aux_get (msg, "lookup_handle");
@@ -1394,8 +1848,19 @@ static lookup_t *lookup_common (flux_t *h, flux_msg_handler_t *mh,
         cbd.ctx = ctx;
         cbd.wait = wait;
         cbd.errnum = 0;
+        if (!(cbd.batch = zlist_new ())) {
+            errno = ENOMEM;
+            goto done;
+        }
 
-        if (lookup_iter_missing_refs (lh, lookup_load_cb, &cbd) < 0) {
+        /* Refs that were added to the batch have waiters, so send them
+         * even if the iteration failed part way.
+         */
+        iter_rc = lookup_iter_missing_refs (lh, lookup_load_cb, &cbd);
+        if (content_load_flush (ctx, cbd.batch) < 0)
+            flux_log_error (ctx->h, "%s: content_load_flush", __FUNCTION__);
+        zlist_destroy (&cbd.batch);
+        if (iter_rc < 0) {
             /* rpcs already in flight, stall for them to complete */
             if (wait_get_usecount (wait) > 0) {
                 lookup_set_aux_errnum (lh, cbd.errnum);
@@ -1554,7 +2019,7 @@ static void finalize_transaction_bynames (kvs_ctx_t *ctx, struct kvsroot *root,
     }
 }
 
-/* kvs.relaycommit (rank 0 only, no response).
+/* kvs.relaycommit (namespace leader only, no response).
  */
 static void relaycommit_request_cb (flux_t *h, flux_msg_handler_t *mh,
                                     const flux_msg_t *msg, void *arg)
@@ -1564,6 +2029,7 @@ static void relaycommit_request_cb (flux_t *h, flux_msg_handler_t *mh,
     const char *ns;
     const char *name;
     int flags;
+    bool stall = false;
     json_t *ops = NULL;
 
     if (flux_request_unpack (msg, NULL, "{ s:o s:s s:s s:i }",
@@ -1575,11 +2041,20 @@ static void relaycommit_request_cb (flux_t *h, flux_msg_handler_t *mh,
         return;
     }
 
-    /* namespace must exist given we are on rank 0 */
-    if (!(root = kvsroot_mgr_lookup_root_safe (ctx->krm, ns))) {
+    /* A leader other than rank 0 may not have initialized the root
+     * yet, in which case the request is requeued once it has.
+     */
+    if (!(root = getroot (ctx, ns, mh, msg, NULL, relaycommit_request_cb, &stall))) {
+        if (stall)
+            return;
         flux_log (h, LOG_ERR, "%s: namespace %s not available",
                   __FUNCTION__, ns);
-        errno = ENOTSUP;
+        goto error;
+    }
+    if (root->leader != ctx->rank) {
+        flux_log (h, LOG_ERR, "%s: namespace %s is led by rank %u",
+                  __FUNCTION__, ns, root->leader);
+        errno = EPROTO;
         goto error;
     }
 
@@ -1653,7 +2128,7 @@ static void commit_request_cb (flux_t *h, flux_msg_handler_t *mh,
     if (treq_add_request_copy (tr, msg) < 0)
         goto error;
 
-    if (ctx->rank == 0) {
+    if (root->leader == ctx->rank) {
         /* we use this flag to indicate if a treq has been added to
          * the ready queue.  We don't need to call
          * treq_count_reached() b/c this is a commit and nprocs is 1
@@ -1672,8 +2147,9 @@ static void commit_request_cb (flux_t *h, flux_msg_handler_t *mh,
     else {
         flux_future_t *f;
 
-        /* route to rank 0 as instance owner */
-        if (!(f = flux_rpc_pack (h, "kvs.relaycommit", 0, FLUX_RPC_NORESPONSE,
+        /* route to the namespace leader */
+        if (!(f = flux_rpc_pack (h, "kvs.relaycommit", root->leader,
+                                 FLUX_RPC_NORESPONSE,
                                  "{ s:O s:s s:s s:i }",
                                  "ops", ops,
                                  "name", treq_get_name (tr),
@@ -1692,7 +2168,7 @@ error:
 }
 
 
-/* kvs.relayfence (rank 0 only, no response).
+/* kvs.relayfence (namespace leader only, no response).
  */
 static void relayfence_request_cb (flux_t *h, flux_msg_handler_t *mh,
                                    const flux_msg_t *msg, void *arg)
@@ -1702,6 +2178,7 @@ static void relayfence_request_cb (flux_t *h, flux_msg_handler_t *mh,
     const char *ns;
     const char *name;
     int saved_errno, nprocs, flags;
+    bool stall = false;
     json_t *ops = NULL;
     treq_t *tr;
 
@@ -1715,11 +2192,20 @@ static void relayfence_request_cb (flux_t *h, flux_msg_handler_t *mh,
         return;
     }
 
-    /* namespace must exist given we are on rank 0 */
-    if (!(root = kvsroot_mgr_lookup_root_safe (ctx->krm, ns))) {
+    /* A leader other than rank 0 may not have initialized the root
+     * yet, in which case the request is requeued once it has.
+     */
+    if (!(root = getroot (ctx, ns, mh, msg, NULL, relayfence_request_cb, &stall))) {
+        if (stall)
+            return;
         flux_log (h, LOG_ERR, "%s: namespace %s not available",
                   __FUNCTION__, ns);
-        errno = ENOTSUP;
+        goto error;
+    }
+    if (root->leader != ctx->rank) {
+        flux_log (h, LOG_ERR, "%s: namespace %s is led by rank %u",
+                  __FUNCTION__, ns, root->leader);
+        errno = EPROTO;
         goto error;
     }
 
@@ -1843,10 +2329,10 @@ static void fence_request_cb (flux_t *h, flux_msg_handler_t *mh,
     if (treq_add_request_copy (tr, msg) < 0)
         goto error;
 
-    /* If we happen to be on rank 0, perform equivalent of
+    /* If we happen to be the namespace leader, perform equivalent of
      * relayfence_request_cb() here instead of sending an RPC
      */
-    if (ctx->rank == 0) {
+    if (root->leader == ctx->rank) {
 
         if (treq_add_request_ops (tr, ops) < 0) {
             flux_log_error (h, "%s: treq_add_request_ops", __FUNCTION__);
@@ -1876,8 +2362,9 @@ static void fence_request_cb (flux_t *h, flux_msg_handler_t *mh,
     else {
         flux_future_t *f;
 
-        /* route to rank 0 as instance owner */
-        if (!(f = flux_rpc_pack (h, "kvs.relayfence", 0, FLUX_RPC_NORESPONSE,
+        /* route to the namespace leader */
+        if (!(f = flux_rpc_pack (h, "kvs.relayfence", root->leader,
+                                 FLUX_RPC_NORESPONSE,
                                  "{ s:O s:s s:s s:i s:i }",
                                  "ops", ops,
                                  "name", name,
@@ -1980,12 +2467,13 @@ static void getroot_request_cb (flux_t *h, flux_msg_handler_t *mh,
         }
     }
 
-    /* N.B. owner cast into int */
-    if (flux_respond_pack (h, msg, "{ s:i s:i s:s s:i }",
+    /* N.B. owner and leader cast into int */
+    if (flux_respond_pack (h, msg, "{ s:i s:i s:s s:i s:i }",
                            "owner", root->owner,
                            "rootseq", root->seq,
                            "rootref", root->ref,
-                           "flags", root->flags) < 0)
+                           "flags", root->flags,
+                           "leader", root->leader) < 0)
         flux_log_error (h, "%s: flux_respond_pack", __FUNCTION__);
     return;
 error:
@@ -2067,10 +2555,38 @@ done:
     free (data);
 }
 
+/* Optimization: new objects from the transaction are optionally included
+ * in the kvs.namespace-<NS>-setroot event.  Insert them into the local
+ * cache, where they are evicted early if not used.  If there are
+ * complications, just skip the object.  Not critical.
+ */
+static void prime_cache_with_objects (kvs_ctx_t *ctx, json_t *objects)
+{
+    json_t *o;
+    size_t index;
+
+    json_array_foreach (objects, index, o) {
+        char ref[BLOBREF_MAX_STRING_SIZE];
+        void *data = NULL;
+        int len;
+
+        if (treeobj_decode_val (o, &data, &len) < 0) {
+            flux_log (ctx->h, LOG_ERR, "%s: invalid object", __FUNCTION__);
+            continue;
+        }
+        if (blobref_hash (ctx->hash_name, data, len, ref, sizeof (ref)) < 0)
+            flux_log_error (ctx->h, "%s: blobref_hash", __FUNCTION__);
+        else if (cache_insert_warm (ctx->cache, ref, data, len) < 0)
+            flux_log_error (ctx->h, "%s: cache_insert_warm", __FUNCTION__);
+        free (data);
+    }
+}
+
 /* Alter the (rootref, rootseq) in response to a setroot event.
  */
 static void setroot_event_process (kvs_ctx_t *ctx, struct kvsroot *root,
                                    json_t *names, json_t *rootdir,
+                                   json_t *objects,
                                    const char *rootref, int rootseq)
 {
     int errnum = 0;
@@ -2093,6 +2609,11 @@ static void setroot_event_process (kvs_ctx_t *ctx, struct kvsroot *root,
     if (!json_is_null (rootdir))
         prime_cache_with_rootdir (ctx, rootdir);
 
+    /* The leader already has the objects in its cache.
+     */
+    if (objects && root->leader != ctx->rank)
+        prime_cache_with_objects (ctx, objects);
+
     setroot (ctx, root, rootref, rootseq);
 }
 
@@ -2106,13 +2627,15 @@ static void setroot_event_cb (flux_t *h, flux_msg_handler_t *mh,
     const char *rootref;
     json_t *rootdir = NULL;
     json_t *names = NULL;
+    json_t *objects = NULL;
 
-    if (flux_event_unpack (msg, NULL, "{ s:s s:i s:s s:o s:o }",
+    if (flux_event_unpack (msg, NULL, "{ s:s s:i s:s s:o s:o s?o }",
                            "namespace", &ns,
                            "rootseq", &rootseq,
                            "rootref", &rootref,
                            "names", &names,
-                           "rootdir", &rootdir) < 0) {
+                           "rootdir", &rootdir,
+                           "objects", &objects) < 0) {
         flux_log_error (ctx->h, "%s: flux_event_unpack", __FUNCTION__);
         return;
     }
@@ -2151,7 +2674,13 @@ static void setroot_event_cb (flux_t *h, flux_msg_handler_t *mh,
         return;
     }
 
-    setroot_event_process (ctx, root, names, rootdir, rootref, rootseq);
+    setroot_event_process (ctx,
+                           root,
+                           names,
+                           rootdir,
+                           objects,
+                           rootref,
+                           rootseq);
 }
 
 static bool disconnect_cmp (const flux_msg_t *msg, void *arg)
@@ -2233,6 +2762,8 @@ static void stats_get_cb (flux_t *h, flux_msg_handler_t *mh,
     tstat_t ts = { .min = 0.0, .max = 0.0, .M = 0.0, .S = 0.0, .newM = 0.0,
                    .newS = 0.0, .n = 0 };
     int size = 0, incomplete = 0, dirty = 0;
+    int memo_size = 0, memo_hits = 0, memo_misses = 0;
+    int warm_size = 0, warm_hits = 0, warm_evictions = 0;
     double scale = 1E-3;
 
     if (flux_request_decode (msg, NULL, NULL) < 0)
@@ -2242,6 +2773,11 @@ static void stats_get_cb (flux_t *h, flux_msg_handler_t *mh,
     if (kvsroot_mgr_root_count (ctx->krm) > 0) {
         if (cache_get_stats (ctx->cache, &ts, &size, &incomplete, &dirty) < 0)
             goto error;
+        cache_memo_get_stats (ctx->cache, &memo_size, &memo_hits, &memo_misses);
+        cache_warm_get_stats (ctx->cache,
+                              &warm_size,
+                              &warm_hits,
+                              &warm_evictions);
     }
 
     if (!(tstats = json_pack ("{ s:i s:f s:f s:f s:f }",
@@ -2252,12 +2788,18 @@ static void stats_get_cb (flux_t *h, flux_msg_handler_t *mh,
                               "max", tstat_max (&ts)*scale)))
         goto nomem;
 
-    if (!(cstats = json_pack ("{ s:f s:O s:i s:i s:i }",
+    if (!(cstats = json_pack ("{ s:f s:O s:i s:i s:i s:i s:i s:i s:i s:i s:i }",
                               "obj size total (MiB)", (double)size/1048576,
                               "obj size (KiB)", tstats,
                               "#obj dirty", dirty,
                               "#obj incomplete", incomplete,
-                              "#faults", ctx->faults)))
+                              "#faults", ctx->faults,
+                              "#memo entries", memo_size,
+                              "#memo hits", memo_hits,
+                              "#memo misses", memo_misses,
+                              "#warm entries", warm_size,
+                              "#warm hits", warm_hits,
+                              "#warm evictions", warm_evictions)))
         goto nomem;
 
     if (!(nsstats = json_object ()))
@@ -2314,6 +2856,8 @@ static int stats_clear_root_cb (struct kvsroot *root, void *arg)
 static void stats_clear (kvs_ctx_t *ctx)
 {
     ctx->faults = 0;
+    cache_memo_clear_stats (ctx->cache);
+    cache_warm_clear_stats (ctx->cache);
 
     if (kvsroot_mgr_iter_roots (ctx->krm, stats_clear_root_cb, NULL) < 0)
         flux_log_error (ctx->h, "%s: kvsroot_mgr_iter_roots", __FUNCTION__);
@@ -2338,8 +2882,13 @@ static void stats_clear_request_cb (flux_t *h, flux_msg_handler_t *mh,
         flux_log_error (h, "%s: flux_respond", __FUNCTION__);
 }
 
+/* Create namespace 'ns' with transactions applied on rank 'leader'.
+ * Rank 0 keeps a copy of every root, updated by setroot events like a
+ * follower's when the namespace is led elsewhere.  The leader
+ * initializes its copy on demand, via kvs.getroot.
+ */
 static int namespace_create (kvs_ctx_t *ctx, const char *ns,
-                             uint32_t owner, int flags)
+                             uint32_t owner, uint32_t leader, int flags)
 {
     struct kvsroot *root;
     json_t *rootdir = NULL;
@@ -2366,6 +2915,7 @@ static int namespace_create (kvs_ctx_t *ctx, const char *ns,
         flux_log_error (ctx->h, "%s: kvsroot_mgr_create_root", __FUNCTION__);
         return -1;
     }
+    root->leader = leader;
 
     if (!(rootdir = treeobj_create_dir ())) {
         flux_log_error (ctx->h, "%s: treeobj_create_dir", __FUNCTION__);
@@ -2429,24 +2979,35 @@ static void namespace_create_request_cb (flux_t *h, flux_msg_handler_t *mh,
 {
     kvs_ctx_t *ctx = arg;
     const char *ns;
-    uint32_t owner;
+    uint32_t owner, size;
+    uint32_t leader = 0;
     int flags;
 
     assert (ctx->rank == 0);
 
-    /* N.B. owner read into uint32_t */
-    if (flux_request_unpack (msg, NULL, "{ s:s s:i s:i }",
+    /* N.B. owner and rank read into uint32_t */
+    if (flux_request_unpack (msg, NULL, "{ s:s s:i s:i s?i }",
                              "namespace", &ns,
                              "owner", &owner,
-                             "flags", &flags) < 0) {
+                             "flags", &flags,
+                             "rank", &leader) < 0) {
         flux_log_error (h, "%s: flux_request_unpack", __FUNCTION__);
         goto error;
     }
 
+    if (flux_get_size (h, &size) < 0) {
+        flux_log_error (h, "%s: flux_get_size", __FUNCTION__);
+        goto error;
+    }
+    if (leader >= size) {
+        errno = EINVAL;
+        goto error;
+    }
+
     if (owner == FLUX_USERID_UNKNOWN)
         owner = getuid ();
 
-    if (namespace_create (ctx, ns, owner, flags) < 0)
+    if (namespace_create (ctx, ns, owner, leader, flags) < 0)
         goto error;
 
     if (flux_respond (h, msg, NULL) < 0)
@@ -2714,18 +3275,26 @@ static void setroot_unpause_process_msg (kvs_ctx_t *ctx, struct kvsroot *root,
     const char *rootref;
     json_t *rootdir = NULL;
     json_t *names = NULL;
+    json_t *objects = NULL;
 
-    if (flux_event_unpack (msg, NULL, "{ s:s s:i s:s s:o s:o }",
+    if (flux_event_unpack (msg, NULL, "{ s:s s:i s:s s:o s:o s?o }",
                            "namespace", &ns,
                            "rootseq", &rootseq,
                            "rootref", &rootref,
                            "names", &names,
-                           "rootdir", &rootdir) < 0) {
+                           "rootdir", &rootdir,
+                           "objects", &objects) < 0) {
         flux_log_error (ctx->h, "%s: flux_event_unpack", __FUNCTION__);
         return;
     }
 
-    setroot_event_process (ctx, root, names, rootdir, rootref, rootseq);
+    setroot_event_process (ctx,
+                           root,
+                           names,
+                           rootdir,
+                           objects,
+                           rootref,
+                           rootseq);
     return;
 }
 
@@ -2826,6 +3395,12 @@ static void process_args (kvs_ctx_t *ctx, int ac, char **av)
     for (i = 0; i < ac; i++) {
         if (strncmp (av[i], "transaction-merge=", 13) == 0)
             ctx->transaction_merge = strtoul (av[i]+13, NULL, 10);
+        else if (strncmp (av[i], "unroll-threads=", 15) == 0)
+            ctx->unroll_threads = strtoul (av[i]+15, NULL, 10);
+        else if (strncmp (av[i], "cache-warm-bytes=", 17) == 0)
+            ctx->cache_warm_bytes = strtoul (av[i]+17, NULL, 10);
+        else if (strncmp (av[i], "inline-values-bytes=", 20) == 0)
+            ctx->inline_values_bytes = strtoul (av[i]+20, NULL, 10);
         else
             flux_log (ctx->h, LOG_ERR, "Unknown option `%s'", av[i]);
     }
@@ -2975,6 +3550,14 @@ int mod_main (flux_t *h, int argc, char **argv)
         char rootref[BLOBREF_MAX_STRING_SIZE];
         uint32_t owner = getuid ();
 
+        if (ctx->unroll_threads > 0) {
+            if (!(ctx->workpool = workpool_create (ctx->unroll_threads))) {
+                flux_log_error (h, "workpool_create");
+                goto done;
+            }
+            kvsroot_mgr_set_workpool (ctx->krm, ctx->workpool);
+        }
+
         /* Look for a checkpoint and use it if found.
          * Otherwise start the primary root namespace with an empty directory.
          */
@@ -30,6 +30,7 @@ struct kvsroot_mgr {
     bool iterating_roots;
     flux_t *h;
     void *arg;
+    struct workpool *wp;
 };
 
 kvsroot_mgr_t *kvsroot_mgr_create (flux_t *h, void *arg)
@@ -71,6 +72,11 @@ void kvsroot_mgr_destroy (kvsroot_mgr_t *krm)
     }
 }
 
+void kvsroot_mgr_set_workpool (kvsroot_mgr_t *krm, struct workpool *wp)
+{
+    krm->wp = wp;
+}
+
 int kvsroot_mgr_root_count (kvsroot_mgr_t *krm)
 {
     return zhash_size (krm->roothash);
@@ -128,6 +134,7 @@ struct kvsroot *kvsroot_mgr_create_root (kvsroot_mgr_t *krm,
         flux_log_error (krm->h, "kvstxn_mgr_create");
         goto error;
     }
+    kvstxn_mgr_set_workpool (root->ktm, krm->wp);
 
     if (!(root->trm = treq_mgr_create ())) {
         flux_log_error (krm->h, "treq_mgr_create");
@@ -25,6 +25,7 @@ typedef struct kvsroot_mgr kvsroot_mgr_t;
 struct kvsroot {
     char *ns_name;
     uint32_t owner;
+    uint32_t leader;        /* rank that applies transactions */
     int seq;
     char ref[BLOBREF_MAX_STRING_SIZE];
     kvstxn_mgr_t *ktm;
@@ -46,6 +47,11 @@ kvsroot_mgr_t *kvsroot_mgr_create (flux_t *h, void *arg);
 
 void kvsroot_mgr_destroy (kvsroot_mgr_t *krm);
 
+/* set worker pool passed to kvstxn_mgr_set_workpool() for roots
+ * created after this call
+ */
+void kvsroot_mgr_set_workpool (kvsroot_mgr_t *krm, struct workpool *wp);
+
 int kvsroot_mgr_root_count (kvsroot_mgr_t *krm);
 
 struct kvsroot *kvsroot_mgr_create_root (kvsroot_mgr_t *krm,
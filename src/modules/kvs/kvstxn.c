@@ -25,6 +25,7 @@
 
 #include "src/common/libutil/macros.h"
 #include "src/common/libutil/blobref.h"
+#include "src/common/libutil/errno_safe.h"
 #include "src/common/libkvs/treeobj.h"
 #include "src/common/libkvs/kvs_txn_private.h"
 #include "src/common/libkvs/kvs_util_private.h"
@@ -34,6 +35,12 @@
 #define KVSTXN_PROCESSING      0x01
 #define KVSTXN_MERGED          0x02 /* kvstxn is a merger of transactions */
 #define KVSTXN_MERGE_COMPONENT 0x04 /* kvstxn is member of a merger */
+#define KVSTXN_DEFERRED        0x08 /* kvstxn waits for those ahead of it */
+
+/* Maximum number of transactions that may have computed a new root
+ * but not yet completed, before the next ready transaction is started.
+ */
+#define KVSTXN_PIPELINE_MAX 8
 
 struct kvstxn_mgr {
     struct cache *cache;
@@ -41,6 +48,7 @@ struct kvstxn_mgr {
     const char *hash_name;
     int noop_stores;            /* for kvs.stats.get, etc.*/
     zlist_t *ready;
+    struct workpool *wp;        /* for kvstxn_unroll(), may be NULL */
     flux_t *h;
     void *aux;
 };
@@ -52,11 +60,13 @@ struct kvstxn {
     json_t *ops;
     json_t *keys;
     json_t *names;
+    json_t *warm_refs;          /* new objects to push to followers */
     int flags;
     json_t *rootcpy;   /* working copy of root dir */
     const json_t *rootdir;      /* source of rootcpy above */
     struct cache_entry *entry;  /* for reference counting rootdir above */
     char newroot[BLOBREF_MAX_STRING_SIZE];
+    char base[BLOBREF_MAX_STRING_SIZE]; /* root the ops were applied to */
     zlist_t *missing_refs_list;
     zlist_t *dirty_cache_entries_list;
     int internal_flags;
@@ -77,6 +87,7 @@ static void kvstxn_destroy (kvstxn_t *kt)
         json_decref (kt->ops);
         json_decref (kt->keys);
         json_decref (kt->names);
+        json_decref (kt->warm_refs);
         json_decref (kt->rootcpy);
         cache_entry_decref (kt->entry);
         if (kt->missing_refs_list)
@@ -191,6 +202,37 @@ json_t *kvstxn_get_keys (kvstxn_t *kt)
     return NULL;
 }
 
+int kvstxn_add_warm_ref (kvstxn_t *kt, const char *ref)
+{
+    json_t *s;
+
+    if (!kt || !ref) {
+        errno = EINVAL;
+        return -1;
+    }
+    if (!kt->warm_refs) {
+        if (!(kt->warm_refs = json_array ()))
+            goto error_enomem;
+    }
+    if (!(s = json_string (ref)))
+        goto error_enomem;
+    if (json_array_append_new (kt->warm_refs, s) < 0) {
+        json_decref (s);
+        goto error_enomem;
+    }
+    return 0;
+error_enomem:
+    errno = ENOMEM;
+    return -1;
+}
+
+json_t *kvstxn_get_warm_refs (kvstxn_t *kt)
+{
+    if (kt->state == KVSTXN_STATE_FINISHED)
+        return kt->warm_refs;
+    return NULL;
+}
+
 /* On error we should cleanup anything on the dirty cache list
  * that has not yet been passed to the user.  Because this has not
  * been passed to the user, there should be no waiters and the
@@ -238,20 +280,78 @@ static void cleanup_dirty_cache_list (kvstxn_t *kt)
         kvstxn_cleanup_dirty_cache_entry (kt, entry);
 }
 
-/* Store object 'o' under key 'ref' in local cache.
- * Object reference is still owned by the caller.
+/* Return kvstxn to its initial state, so its ops are applied again
+ * from scratch.
+ */
+static void kvstxn_reset (kvstxn_t *kt)
+{
+    char *ref;
+
+    while ((ref = zlist_pop (kt->missing_refs_list)))
+        free (ref);
+    cleanup_dirty_cache_list (kt);
+    json_decref (kt->rootcpy);
+    kt->rootcpy = NULL;
+    json_decref (kt->keys);
+    kt->keys = NULL;
+    json_decref (kt->warm_refs);
+    kt->warm_refs = NULL;
+    cache_entry_decref (kt->entry);
+    kt->entry = NULL;
+    kt->rootdir = NULL;
+    kt->newroot[0] = '\0';
+    kt->base[0] = '\0';
+    kt->errnum = 0;
+    kt->aux_errnum = 0;
+    kt->blocked = 0;
+    kt->internal_flags &= ~KVSTXN_DEFERRED;
+    kt->state = KVSTXN_STATE_INIT;
+}
+
+/* A kvstxn is in the pipeline once it has computed its new root and
+ * is only waiting for content stores to complete, or to be published.
+ */
+static bool kvstxn_pipelined (kvstxn_t *kt)
+{
+    return (kt->state >= KVSTXN_STATE_PRE_FINISHED
+            && !kt->errnum
+            && !kt->aux_errnum);
+}
+
+/* Return the root that 'kt' should apply its ops to.  This is the new
+ * root of the nearest transaction ahead of it in the pipeline, or
+ * 'rootdir_ref' if there is none.
+ */
+static const char *kvstxn_pipeline_base (kvstxn_t *kt, const char *rootdir_ref)
+{
+    kvstxn_t *prev = NULL;
+    kvstxn_t *tmp;
+
+    tmp = zlist_first (kt->ktm->ready);
+    while (tmp && tmp != kt) {
+        if (!(tmp->internal_flags & KVSTXN_MERGE_COMPONENT))
+            prev = tmp;
+        tmp = zlist_next (kt->ktm->ready);
+    }
+    if (tmp && prev && kvstxn_pipelined (prev))
+        return prev->newroot;
+    return rootdir_ref;
+}
+
+/* Encode object 'o' for storage and compute its blobref in 'ref'.
  * 'is_raw' indicates this data is a json string w/ base64 value and
  * should be flushed to the content store as raw data after it is
  * decoded.  Otherwise, the json object should be a treeobj.
- * Returns -1 on error, 0 on success entry already there, 1 on success
- * entry needs to be flushed to content store
+ * On success, '*datap' is set to the encoded data, which the caller
+ * must free.  This does not touch the kvstxn or the cache, so it may be
+ * called from the unroll worker pool.
+ * Returns 0 on success, -1 on error with errno set.
  */
-static int store_cache (kvstxn_t *kt, int current_epoch, json_t *o,
-                        bool is_raw, char *ref, int ref_len,
-                        struct cache_entry **entryp)
+static int encode_object (const char *hash_name, json_t *o, bool is_raw,
+                          char **datap, size_t *lenp,
+                          char *ref, int ref_len)
 {
-    struct cache_entry *entry;
-    int saved_errno, rc;
+    int saved_errno;
     const char *xdata;
     char *data = NULL;
     size_t xlen, len;
@@ -262,7 +362,7 @@ static int store_cache (kvstxn_t *kt, int current_epoch, json_t *o,
         len = BASE64_DECODE_SIZE (xlen);
         if (len > 0) {
             if (!(data = malloc (len))) {
-                flux_log_error (kt->ktm->h, "malloc");
+                errno = ENOMEM;
                 goto error;
             }
             if (sodium_base642bin ((unsigned char *)data, len, xdata, xlen,
@@ -274,25 +374,44 @@ static int store_cache (kvstxn_t *kt, int current_epoch, json_t *o,
         }
     }
     else {
-        if (treeobj_validate (o) < 0 || !(data = treeobj_encode (o))) {
-            flux_log_error (kt->ktm->h, "%s: treeobj_encode", __FUNCTION__);
+        if (treeobj_validate (o) < 0 || !(data = treeobj_encode (o)))
             goto error;
-        }
         len = strlen (data);
     }
-    if (blobref_hash (kt->ktm->hash_name, data, len, ref, ref_len) < 0) {
-        flux_log_error (kt->ktm->h, "%s: blobref_hash", __FUNCTION__);
+    if (blobref_hash (hash_name, data, len, ref, ref_len) < 0)
         goto error;
-    }
+    *datap = data;
+    *lenp = len;
+    return 0;
+
+ error:
+    saved_errno = errno;
+    free (data);
+    errno = saved_errno;
+    return -1;
+}
+
+/* Store encoded 'data' under key 'ref' in local cache.
+ * Data is still owned by the caller.
+ * Returns -1 on error, 0 on success entry already there, 1 on success
+ * entry needs to be flushed to content store
+ */
+static int store_cache_data (kvstxn_t *kt, int current_epoch,
+                             const char *data, size_t len, const char *ref,
+                             struct cache_entry **entryp)
+{
+    struct cache_entry *entry;
+    int rc;
+
     if (!(entry = cache_lookup (kt->ktm->cache, ref, current_epoch))) {
         if (!(entry = cache_entry_create (ref))) {
             flux_log_error (kt->ktm->h, "%s: cache_entry_create", __FUNCTION__);
-            goto error;
+            return -1;
         }
         if (cache_insert (kt->ktm->cache, entry) < 0) {
             cache_entry_destroy (entry);
             flux_log_error (kt->ktm->h, "%s: cache_insert", __FUNCTION__);
-            goto error;
+            return -1;
         }
     }
     if (cache_entry_get_valid (entry)) {
@@ -304,74 +423,121 @@ static int store_cache (kvstxn_t *kt, int current_epoch, json_t *o,
             int ret;
             ret = cache_remove_entry (kt->ktm->cache, ref);
             assert (ret == 1);
-            goto error;
+            return -1;
         }
         if (cache_entry_set_dirty (entry, true) < 0) {
             flux_log_error (kt->ktm->h, "%s: cache_entry_set_dirty",__FUNCTION__);
             int ret;
             ret = cache_remove_entry (kt->ktm->cache, ref);
             assert (ret == 1);
-            goto error;
+            return -1;
         }
         rc = 1;
     }
     *entryp = entry;
-    free (data);
     return rc;
+}
 
- error:
-    saved_errno = errno;
-    free (data);
-    errno = saved_errno;
-    return -1;
+/* Store object 'o' under key 'ref' in local cache.
+ * Object reference is still owned by the caller.
+ * 'is_raw' is as described in encode_object() above.
+ * Returns -1 on error, 0 on success entry already there, 1 on success
+ * entry needs to be flushed to content store
+ */
+static int store_cache (kvstxn_t *kt, int current_epoch, json_t *o,
+                        bool is_raw, char *ref, int ref_len,
+                        struct cache_entry **entryp)
+{
+    char *data;
+    size_t len;
+    int rc;
+
+    if (encode_object (kt->ktm->hash_name, o, is_raw,
+                       &data, &len, ref, ref_len) < 0) {
+        if (errno != EPROTO)
+            flux_log_error (kt->ktm->h, "%s: encode_object", __FUNCTION__);
+        return -1;
+    }
+    rc = store_cache_data (kt, current_epoch, data, len, ref, entryp);
+    ERRNO_SAFE_WRAP (free, data);
+    return rc;
 }
 
-/* Store DIRVAL objects, converting them to DIRREFs.
- * Store (large) FILEVAL objects, converting them to FILEREFs.
- * Return 0 on success, -1 on error
+/* An object found by kvstxn_unroll() that must be stored, then
+ * replaced by a reference in its parent directory.
  */
-static int kvstxn_unroll (kvstxn_t *kt, int current_epoch, json_t *dir)
+struct unroll_item {
+    json_t *dir_data;           /* data of parent directory */
+    const char *name;           /* key of object in 'dir_data' */
+    json_t *o;                  /* dir, or val data if 'is_raw' */
+    bool is_raw;
+    int height;                 /* 0 if 'o' contains no other items */
+    int seq;                    /* order found, keeps sort stable */
+    char *data;                 /* set by unroll_encode() */
+    size_t len;
+    char ref[BLOBREF_MAX_STRING_SIZE];
+    int errnum;
+};
+
+struct unroll {
+    struct unroll_item *items;
+    int count;
+    int size;
+};
+
+static int unroll_add (struct unroll *u, json_t *dir_data, const char *name,
+                       json_t *o, bool is_raw, int height)
+{
+    struct unroll_item *item;
+
+    if (u->count == u->size) {
+        int nsize = u->size ? u->size * 2 : 16;
+        struct unroll_item *nitems;
+
+        if (!(nitems = realloc (u->items, nsize * sizeof (u->items[0])))) {
+            errno = ENOMEM;
+            return -1;
+        }
+        u->items = nitems;
+        u->size = nsize;
+    }
+    item = &u->items[u->count];
+    memset (item, 0, sizeof (*item));
+    item->dir_data = dir_data;
+    item->name = name;
+    item->o = o;
+    item->is_raw = is_raw;
+    item->height = height;
+    item->seq = u->count++;
+    return 0;
+}
+
+/* Find DIRVAL and (large) FILEVAL objects in 'dir', depth first.
+ * The height of a directory is one more than the greatest height of
+ * the items in it, so every item is higher than those it contains.
+ */
+static int unroll_collect (struct unroll *u, json_t *dir, int *heightp)
 {
     json_t *dir_entry;
     json_t *dir_data;
-    json_t *ktmp;
-    char ref[BLOBREF_MAX_STRING_SIZE];
-    int ret;
-    struct cache_entry *entry;
-    void *iter;
+    const char *name;
+    int height = 0;
 
     assert (treeobj_is_dir (dir));
 
     if (!(dir_data = treeobj_get_data (dir)))
         return -1;
 
-    iter = json_object_iter (dir_data);
-
-    /* Do not use json_object_foreach(), unsafe to modify via
-     * json_object_set() while iterating.
-     */
-    while (iter) {
-        dir_entry = json_object_iter_value (iter);
+    /* N.B. nothing is modified while iterating, see kvstxn_unroll() */
+    json_object_foreach (dir_data, name, dir_entry) {
         if (treeobj_is_dir (dir_entry)) {
-            if (kvstxn_unroll (kt, current_epoch, dir_entry) < 0) /* depth first */
-                return -1;
-            if ((ret = store_cache (kt, current_epoch, dir_entry,
-                                    false, ref, sizeof (ref), &entry)) < 0)
-                return -1;
-            if (ret) {
-                if (zlist_push (kt->dirty_cache_entries_list, entry) < 0) {
-                    kvstxn_cleanup_dirty_cache_entry (kt, entry);
-                    errno = ENOMEM;
-                    return -1;
-                }
-            }
-            if (!(ktmp = treeobj_create_dirref (ref)))
-                return -1;
-            if (json_object_iter_set_new (dir, iter, ktmp) < 0) {
-                json_decref (ktmp);
-                errno = ENOMEM;
+            int h;
+
+            if (unroll_collect (u, dir_entry, &h) < 0
+                || unroll_add (u, dir_data, name, dir_entry, false, h) < 0)
                 return -1;
-            }
+            if (height < h + 1)
+                height = h + 1;
         }
         else if (treeobj_is_val (dir_entry)) {
             json_t *val_data;
@@ -383,31 +549,136 @@ static int kvstxn_unroll (kvstxn_t *kt, int current_epoch, json_t *dir)
             str = json_string_value (val_data);
             assert (str);
             if (strlen (str) > BLOBREF_MAX_STRING_SIZE) {
-                if ((ret = store_cache (kt, current_epoch, val_data,
-                                        true, ref, sizeof (ref), &entry)) < 0)
+                if (unroll_add (u, dir_data, name, val_data, true, 0) < 0)
                     return -1;
-                if (ret) {
-                    if (zlist_push (kt->dirty_cache_entries_list, entry) < 0) {
-                        kvstxn_cleanup_dirty_cache_entry (kt, entry);
-                        errno = ENOMEM;
-                        return -1;
-                    }
-                }
-                if (!(ktmp = treeobj_create_valref (ref)))
-                    return -1;
-                if (json_object_iter_set_new (dir, iter, ktmp) < 0) {
-                    json_decref (ktmp);
-                    errno = ENOMEM;
-                    return -1;
-                }
+                if (height < 1)
+                    height = 1;
             }
         }
-        iter = json_object_iter_next (dir_data, iter);
     }
+    *heightp = height;
+    return 0;
+}
+
+static int unroll_cmp (const void *a, const void *b)
+{
+    const struct unroll_item *i1 = a;
+    const struct unroll_item *i2 = b;
 
+    if (i1->height != i2->height)
+        return i1->height < i2->height ? -1 : 1;
+    return i1->seq < i2->seq ? -1 : (i1->seq > i2->seq);
+}
+
+/* workpool_f - runs in a worker thread.
+ */
+static void unroll_encode (void *arg, void *data)
+{
+    struct unroll_item *item = arg;
+    const char *hash_name = data;
+
+    if (encode_object (hash_name, item->o, item->is_raw,
+                       &item->data, &item->len,
+                       item->ref, sizeof (item->ref)) < 0)
+        item->errnum = errno ? errno : EINVAL;
+}
+
+/* Add an encoded item to the cache and replace it in its parent
+ * directory with a DIRREF or VALREF.
+ */
+static int unroll_store (kvstxn_t *kt, int current_epoch,
+                         struct unroll_item *item)
+{
+    struct cache_entry *entry;
+    json_t *ktmp;
+    int ret;
+
+    if (item->errnum) {
+        errno = item->errnum;
+        if (errno != EPROTO)
+            flux_log_error (kt->ktm->h, "%s: encode_object", __FUNCTION__);
+        return -1;
+    }
+    if ((ret = store_cache_data (kt, current_epoch, item->data, item->len,
+                                 item->ref, &entry)) < 0)
+        return -1;
+    if (ret) {
+        if (zlist_push (kt->dirty_cache_entries_list, entry) < 0) {
+            kvstxn_cleanup_dirty_cache_entry (kt, entry);
+            errno = ENOMEM;
+            return -1;
+        }
+    }
+    if (item->is_raw)
+        ktmp = treeobj_create_valref (item->ref);
+    else
+        ktmp = treeobj_create_dirref (item->ref);
+    if (!ktmp)
+        return -1;
+    if (json_object_set_new (item->dir_data, item->name, ktmp) < 0) {
+        errno = ENOMEM;
+        return -1;
+    }
     return 0;
 }
 
+/* Store DIRVAL objects, converting them to DIRREFs.
+ * Store (large) FILEVAL objects, converting them to FILEREFs.
+ *
+ * Items are found first, then encoded and hashed a level at a time,
+ * lowest first, so the items of each level are independent of each
+ * other and can be processed by the worker pool in parallel.  Only
+ * the calling thread touches the cache, and replaces items with
+ * references once each level is done.
+ * Return 0 on success, -1 on error
+ */
+static int kvstxn_unroll (kvstxn_t *kt, int current_epoch, json_t *dir)
+{
+    struct unroll u = { .items = NULL, .count = 0, .size = 0 };
+    void **batch = NULL;
+    int height;
+    int i, j, k;
+    int saved_errno;
+    int rc = -1;
+
+    if (unroll_collect (&u, dir, &height) < 0)
+        goto done;
+    if (u.count == 0) {
+        rc = 0;
+        goto done;
+    }
+    qsort (u.items, u.count, sizeof (u.items[0]), unroll_cmp);
+    if (!(batch = calloc (u.count, sizeof (batch[0])))) {
+        errno = ENOMEM;
+        goto done;
+    }
+    for (i = 0; i < u.count; i = j) {
+        int n = 0;
+
+        for (j = i; j < u.count && u.items[j].height == u.items[i].height; j++)
+            batch[n++] = &u.items[j];
+        if (workpool_map (kt->ktm->wp,
+                          batch,
+                          n,
+                          unroll_encode,
+                          (void *)kt->ktm->hash_name) < 0)
+            goto done;
+        for (k = i; k < j; k++) {
+            if (unroll_store (kt, current_epoch, &u.items[k]) < 0)
+                goto done;
+        }
+    }
+    rc = 0;
+done:
+    saved_errno = errno;
+    for (i = 0; i < u.count; i++)
+        free (u.items[i].data);
+    free (u.items);
+    free (batch);
+    errno = saved_errno;
+    return rc;
+}
+
 static int kvstxn_val_data_to_cache (kvstxn_t *kt, int current_epoch,
                                      json_t *val, char *ref, int ref_len)
 {
@@ -836,6 +1107,9 @@ kvstxn_process_t kvstxn_process (kvstxn_t *kt,
     if (kt->errnum)
         return KVSTXN_PROCESS_ERROR;
 
+    /* Caller is no longer waiting on anything for this kvstxn */
+    kt->blocked = 0;
+
     if (!(kt->internal_flags & KVSTXN_PROCESSING)) {
         kt->errnum = EINVAL;
         return KVSTXN_PROCESS_ERROR;
@@ -853,14 +1127,27 @@ kvstxn_process_t kvstxn_process (kvstxn_t *kt,
         if (zlist_first (kt->missing_refs_list))
             goto stall_load;
 
+        /* If transactions ahead of this one have computed new roots
+         * but not yet completed, apply ops to the newest of them.
+         */
+        if (kt->state == KVSTXN_STATE_INIT) {
+            const char *base = kvstxn_pipeline_base (kt, rootdir_ref);
+
+            if (strlen (base) >= sizeof (kt->base)) {
+                kt->errnum = EINVAL;
+                return KVSTXN_PROCESS_ERROR;
+            }
+            strcpy (kt->base, base);
+        }
+
         kt->state = KVSTXN_STATE_LOAD_ROOT;
 
         if (!(entry = cache_lookup (kt->ktm->cache,
-                                    rootdir_ref,
+                                    kt->base,
                                     current_epoch))
             || !cache_entry_get_valid (entry)) {
 
-            if (add_missing_ref (kt, rootdir_ref) < 0) {
+            if (add_missing_ref (kt, kt->base) < 0) {
                 kt->errnum = errno;
                 return KVSTXN_PROCESS_ERROR;
             }
@@ -1130,6 +1417,11 @@ kvstxn_mgr_t *kvstxn_mgr_create (struct cache *cache,
     return NULL;
 }
 
+void kvstxn_mgr_set_workpool (kvstxn_mgr_t *ktm, struct workpool *wp)
+{
+    ktm->wp = wp;
+}
+
 void kvstxn_mgr_destroy (kvstxn_mgr_t *ktm)
 {
     if (ktm) {
@@ -1167,11 +1459,50 @@ int kvstxn_mgr_add_transaction (kvstxn_mgr_t *ktm,
     return 0;
 }
 
+/* Position the ready queue cursor on 'kt'.
+ * Returns false if 'kt' is not in the ready queue.
+ */
+static bool kvstxn_mgr_seek (kvstxn_mgr_t *ktm, kvstxn_t *kt)
+{
+    kvstxn_t *tmp;
+
+    tmp = zlist_first (ktm->ready);
+    while (tmp && tmp != kt)
+        tmp = zlist_next (ktm->ready);
+    return tmp != NULL;
+}
+
+/* Return the first transaction in the ready queue that is not in the
+ * pipeline, and the number of pipelined transactions ahead of it.
+ * On return, the ready queue cursor is positioned on the transaction.
+ */
+static kvstxn_t *kvstxn_mgr_first_unpipelined (kvstxn_mgr_t *ktm, int *depth)
+{
+    kvstxn_t *kt;
+    int count = 0;
+
+    kt = zlist_first (ktm->ready);
+    while (kt) {
+        if (!(kt->internal_flags & KVSTXN_MERGE_COMPONENT)) {
+            if (!kvstxn_pipelined (kt))
+                break;
+            count++;
+        }
+        kt = zlist_next (ktm->ready);
+    }
+    if (depth)
+        *depth = count;
+    return kt;
+}
+
 bool kvstxn_mgr_transaction_ready (kvstxn_mgr_t *ktm)
 {
     kvstxn_t *kt;
+    int depth;
 
-    if ((kt = zlist_first (ktm->ready)) && !kt->blocked)
+    if ((kt = kvstxn_mgr_first_unpipelined (ktm, &depth))
+        && !kt->blocked
+        && depth < KVSTXN_PIPELINE_MAX)
         return true;
     return false;
 }
@@ -1179,13 +1510,57 @@ bool kvstxn_mgr_transaction_ready (kvstxn_mgr_t *ktm)
 kvstxn_t *kvstxn_mgr_get_ready_transaction (kvstxn_mgr_t *ktm)
 {
     if (kvstxn_mgr_transaction_ready (ktm)) {
-        kvstxn_t *kt = zlist_first (ktm->ready);
+        kvstxn_t *kt = kvstxn_mgr_first_unpipelined (ktm, NULL);
         kt->internal_flags |= KVSTXN_PROCESSING;
         return kt;
     }
     return NULL;
 }
 
+/* Return the transaction at the head of the pipeline, i.e. the oldest
+ * transaction in the ready queue.
+ */
+static kvstxn_t *kvstxn_mgr_head (kvstxn_mgr_t *ktm)
+{
+    kvstxn_t *kt;
+
+    kt = zlist_first (ktm->ready);
+    while (kt && (kt->internal_flags & KVSTXN_MERGE_COMPONENT))
+        kt = zlist_next (ktm->ready);
+    return kt;
+}
+
+bool kvstxn_mgr_defer_transaction (kvstxn_mgr_t *ktm, kvstxn_t *kt)
+{
+    if (kvstxn_mgr_head (ktm) == kt)
+        return false;
+    kt->internal_flags |= KVSTXN_DEFERRED;
+    kt->blocked = 1;
+    return true;
+}
+
+kvstxn_t *kvstxn_mgr_get_deferred_transaction (kvstxn_mgr_t *ktm)
+{
+    kvstxn_t *kt;
+
+    if ((kt = kvstxn_mgr_head (ktm))
+        && (kt->internal_flags & KVSTXN_DEFERRED)) {
+        kt->internal_flags &= ~KVSTXN_DEFERRED;
+        return kt;
+    }
+    return NULL;
+}
+
+bool kvstxn_rebase (kvstxn_t *kt, const char *rootdir_ref)
+{
+    if (kt->base[0] == '\0'
+        || !strcmp (kt->base, rootdir_ref)
+        || kvstxn_mgr_head (kt->ktm) != kt)
+        return false;
+    kvstxn_reset (kt);
+    return true;
+}
+
 void kvstxn_mgr_remove_transaction (kvstxn_mgr_t *ktm, kvstxn_t *kt,
                                     bool fallback)
 {
@@ -1195,10 +1570,15 @@ void kvstxn_mgr_remove_transaction (kvstxn_mgr_t *ktm, kvstxn_t *kt,
         if (kt->internal_flags & KVSTXN_MERGED)
             kvstxn_is_merged = true;
 
+        /* Position the cursor on kt, so that after its removal
+         * zlist_next() returns the transaction that followed it.
+         */
+        if (!kvstxn_mgr_seek (ktm, kt))
+            return;
         zlist_remove (ktm->ready, kt);
 
         if (kvstxn_is_merged) {
-            kvstxn_t *kt_tmp = zlist_first (ktm->ready);
+            kvstxn_t *kt_tmp = zlist_next (ktm->ready);
             while (kt_tmp && (kt_tmp->internal_flags & KVSTXN_MERGE_COMPONENT)) {
                 if (fallback) {
                     kt_tmp->internal_flags &= ~KVSTXN_MERGE_COMPONENT;
@@ -1292,6 +1672,49 @@ static int kvstxn_merge (kvstxn_t *dest, kvstxn_t *src)
  * set after A=3.
  */
 
+/* Insert 'kt' into the ready queue ahead of 'before'.
+ */
+static int kvstxn_mgr_insert_before (kvstxn_mgr_t *ktm,
+                                     kvstxn_t *before,
+                                     kvstxn_t *kt)
+{
+    zlist_t *ahead;
+    kvstxn_t *tmp;
+    int rc = -1;
+
+    if (!(ahead = zlist_new ())) {
+        errno = ENOMEM;
+        return -1;
+    }
+    /* Pop transactions ahead of 'before', then push them back after
+     * 'kt'.  zlist_pop() does not call the item free function.
+     */
+    while ((tmp = zlist_first (ktm->ready)) && tmp != before) {
+        (void)zlist_pop (ktm->ready);
+        if (zlist_push (ahead, tmp) < 0) {
+            errno = ENOMEM;
+            goto restore;
+        }
+    }
+    if (zlist_push (ktm->ready, kt) < 0) {
+        errno = ENOMEM;
+        goto restore;
+    }
+    zlist_freefn (ktm->ready, kt, (zlist_free_fn *)kvstxn_destroy, false);
+    rc = 0;
+restore:
+    while ((tmp = zlist_pop (ahead))) {
+        if (zlist_push (ktm->ready, tmp) < 0) {
+            /* cannot restore the queue, so at least don't leak */
+            kvstxn_destroy (tmp);
+            continue;
+        }
+        zlist_freefn (ktm->ready, tmp, (zlist_free_fn *)kvstxn_destroy, false);
+    }
+    zlist_destroy (&ahead);
+    return rc;
+}
+
 int kvstxn_mgr_merge_ready_transactions (kvstxn_mgr_t *ktm)
 {
     kvstxn_t *first, *second, *new;
@@ -1299,8 +1722,9 @@ int kvstxn_mgr_merge_ready_transactions (kvstxn_mgr_t *ktm)
     int count = 0;
 
     /* transaction must still be in state where merged in ops can be
-     * applied */
-    first = zlist_first (ktm->ready);
+     * applied.  Transactions in the pipeline are skipped.
+     */
+    first = kvstxn_mgr_first_unpipelined (ktm, NULL);
     if (!first
         || first->errnum != 0
         || first->aux_errnum != 0
@@ -1319,7 +1743,8 @@ int kvstxn_mgr_merge_ready_transactions (kvstxn_mgr_t *ktm)
         return -1;
     new->internal_flags |= KVSTXN_MERGED;
 
-    nextkt = zlist_first (ktm->ready);
+    nextkt = first;
+    (void)kvstxn_mgr_seek (ktm, first);
     do {
         int ret;
 
@@ -1337,16 +1762,15 @@ int kvstxn_mgr_merge_ready_transactions (kvstxn_mgr_t *ktm)
     /* if count is zero, checks at beginning of function are invalid */
     assert (count);
 
-    if (zlist_push (ktm->ready, new) < 0) {
+    if (kvstxn_mgr_insert_before (ktm, first, new) < 0) {
         kvstxn_destroy (new);
         return -1;
     }
-    zlist_freefn (ktm->ready, new, (zlist_free_fn *)kvstxn_destroy, false);
 
-    /* first is the new merged kvstxn_t, so we want to start our loop with
-     * the second kvstxn_t
+    /* new is the merged kvstxn_t, so we want to start our loop with
+     * the kvstxn_t after it
      */
-    nextkt = zlist_first (ktm->ready);
+    (void)kvstxn_mgr_seek (ktm, new);
     nextkt = zlist_next (ktm->ready);
     do {
         /* Wipe out KVSTXN_PROCESSING flag if user previously got
@@ -14,6 +14,8 @@
 #include <flux/core.h>
 #include <czmq.h>
 
+#include "src/common/libutil/workpool.h"
+
 #include "cache.h"
 
 typedef struct kvstxn_mgr kvstxn_mgr_t;
@@ -74,6 +76,15 @@ const char *kvstxn_get_newroot_ref (kvstxn_t *kt);
  * (i.e. kvstxn_process() returns KVSTXN_PROCESS_FINISHED) */
 json_t *kvstxn_get_keys (kvstxn_t *kt);
 
+/* Record the blobref of a new object stored by this transaction, that
+ * the caller may later push to followers along with the new root.
+ * kvstxn_get_warm_refs() returns a json array of the recorded refs,
+ * or NULL if none were recorded or the process state is not complete.
+ * Recorded refs are discarded if the transaction is restarted.
+ */
+int kvstxn_add_warm_ref (kvstxn_t *kt, const char *ref);
+json_t *kvstxn_get_warm_refs (kvstxn_t *kt);
+
 /* Primary transaction processing function.
  *
  * Pass in a kvstxn_t that was obtained via
@@ -94,6 +105,10 @@ json_t *kvstxn_get_keys (kvstxn_t *kt);
  *
  * on completion, call kvstxn_get_newroot_ref() to get reference to
  * new root to be stored.
+ *
+ * If transactions ahead of this one in the ready queue have finished
+ * but not yet been published, ops are applied to the newest of their
+ * new roots instead of 'rootdir_ref'.  See kvstxn_rebase() below.
  */
 kvstxn_process_t kvstxn_process (kvstxn_t *kt,
                                  int current_epoch,
@@ -122,6 +137,13 @@ int kvstxn_iter_dirty_cache_entries (kvstxn_t *kt,
  */
 void kvstxn_cleanup_dirty_cache_entry (kvstxn_t *kt, struct cache_entry *entry);
 
+/* If 'kt' is at the head of the ready queue, but its ops were applied
+ * to a root other than 'rootdir_ref' (e.g. a transaction ahead of it
+ * failed), discard its progress so it is processed again from the
+ * start.  Returns true if 'kt' was reset.
+ */
+bool kvstxn_rebase (kvstxn_t *kt, const char *rootdir_ref);
+
 /*
  * kvstxn_mgr_t API
  */
@@ -135,6 +157,13 @@ kvstxn_mgr_t *kvstxn_mgr_create (struct cache *ktache,
 
 void kvstxn_mgr_destroy (kvstxn_mgr_t *ktm);
 
+/* Encode and hash new objects in parallel using 'wp' while
+ * processing transactions.  The pool is not owned by the kvstxn
+ * manager, and may be shared.  If unset, all work is done by the
+ * calling thread.
+ */
+void kvstxn_mgr_set_workpool (kvstxn_mgr_t *ktm, struct workpool *wp);
+
 /* kvstxn_mgr_add_transaction() will internally create a kvstxn_t and
  * store it in the queue of ready to process transactions.
  *
@@ -153,9 +182,27 @@ bool kvstxn_mgr_transaction_ready (kvstxn_mgr_t *ktm);
 
 /* if kvstxn_mgr_transactions_ready() is true, return a ready
  * transaction to process
+ *
+ * Up to KVSTXN_PIPELINE_MAX transactions may be in progress at once.
+ * While earlier transactions stall on loads or stores, later ones are
+ * handed out and processed against their predecessors' new roots.
  */
 kvstxn_t *kvstxn_mgr_get_ready_transaction (kvstxn_mgr_t *ktm);
 
+/* Transactions must be published in queue order.  If 'kt' has
+ * completed (or failed) but is not at the head of the ready queue,
+ * mark it deferred and return true; the caller should then leave it
+ * alone until kvstxn_mgr_get_deferred_transaction() returns it.
+ * Returns false if 'kt' is at the head and may be published now.
+ */
+bool kvstxn_mgr_defer_transaction (kvstxn_mgr_t *ktm, kvstxn_t *kt);
+
+/* After the head transaction is removed, return the new head if it
+ * was deferred, or NULL.  The caller should finish it as if
+ * kvstxn_process() had just returned.
+ */
+kvstxn_t *kvstxn_mgr_get_deferred_transaction (kvstxn_mgr_t *ktm);
+
 /* remove a transaction from the kvstxn manager after it is done
  * processing
  *
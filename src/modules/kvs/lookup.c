@@ -44,6 +44,16 @@ typedef struct {
     json_t *tmp_dirent;         /* tmp dirent that may need to be created */
     zlist_t *pathcomps;
 
+    /* Path memo state.  'memo_path' is the path less its last
+     * component, 'memo_dirent' holds a reference on a dirent taken
+     * from the memo, and 'memo_ok' is cleared if a symlink is followed
+     * at this level, as its target may depend on another namespace.
+     */
+    char *memo_path;
+    json_t *memo_dirent;
+    bool memo_checked;
+    bool memo_ok;
+
     /* If 'dirent' field is set and depends on cache entry not
      * expiring, use this to manage grabbing/giving up reference to
      * cache entry. */
@@ -158,6 +168,8 @@ static void walk_level_destroy (void *data)
         json_decref (wl->root_dirent);
         json_decref (wl->tmp_dirent);
         free (wl->path_copy);
+        free (wl->memo_path);
+        json_decref (wl->memo_dirent);
         cache_entry_decref (wl->entry);
         free (wl);
     }
@@ -178,6 +190,7 @@ static walk_level_t *walk_level_create (const char *root_ref,
                                         int depth)
 {
     walk_level_t *wl = calloc (1, sizeof (*wl));
+    const char *lastdot;
     int saved_errno;
 
     if (!wl) {
@@ -201,6 +214,13 @@ static walk_level_t *walk_level_create (const char *root_ref,
         saved_errno = errno;
         goto error;
     }
+    if ((lastdot = strrchr (path, '.'))) {
+        if (!(wl->memo_path = strndup (path, lastdot - path))) {
+            saved_errno = ENOMEM;
+            goto error;
+        }
+    }
+    wl->memo_ok = true;
     walk_level_update_dirent (wl, wl->root_dirent, NULL);
 
     return wl;
@@ -211,6 +231,30 @@ static walk_level_t *walk_level_create (const char *root_ref,
     return NULL;
 }
 
+/* If the directory containing the last path component of this level was
+ * memoized by an earlier lookup, skip directly to it.  The memo is not
+ * consulted until the level's root directory is in the cache, so it is
+ * always loaded (and checked to be a directory) as in a full walk.
+ * Returns the path component to process next.
+ */
+static char *walk_level_memo_skip (lookup_t *lh, walk_level_t *wl)
+{
+    struct cache_entry *entry;
+    const json_t *dirent;
+
+    if (!(entry = cache_lookup (lh->cache, wl->root_ref, lh->current_epoch))
+        || !cache_entry_get_valid (entry))
+        return zlist_head (wl->pathcomps);
+    wl->memo_checked = true;
+    if ((dirent = cache_memo_lookup (lh->cache, wl->root_ref, wl->memo_path))) {
+        wl->memo_dirent = json_incref ((json_t *)dirent);
+        walk_level_update_dirent (wl, wl->memo_dirent, NULL);
+        while (zlist_size (wl->pathcomps) > 1)
+            zlist_pop (wl->pathcomps);
+    }
+    return zlist_head (wl->pathcomps);
+}
+
 static walk_level_t *walk_levels_push (lookup_t *lh,
                                        const char *root_ref,
                                        const char *path,
@@ -371,6 +415,11 @@ static lookup_process_t walk (lookup_t *lh)
     while ((pathcomp = zlist_head (wl->pathcomps))) {
         struct cache_entry *entry = NULL;
 
+        if (wl->memo_path
+            && !wl->memo_checked
+            && wl->dirent == wl->root_dirent)
+            pathcomp = walk_level_memo_skip (lh, wl);
+
         /* Get directory of dirent */
 
         if (treeobj_is_dirref (wl->dirent)) {
@@ -460,6 +509,7 @@ static lookup_process_t walk (lookup_t *lh)
             walk_level_t *wltmp = NULL;
             lookup_process_t sret;
 
+            wl->memo_ok = false;
             sret = walk_symlink (lh, wl, entry, dirent_tmp, pathcomp, &wltmp);
             if (sret == LOOKUP_PROCESS_ERROR)
                 goto error;
@@ -472,9 +522,21 @@ static lookup_process_t walk (lookup_t *lh)
                 continue;
             }
         }
-        else
+        else {
             walk_level_update_dirent (wl, dirent_tmp, entry);
 
+            /* Memoize the directory containing the last path component.
+             * Failure only costs a future memo miss, so it is ignored.
+             */
+            if (wl->memo_path
+                && wl->memo_ok
+                && zlist_size (wl->pathcomps) == 2)
+                (void)cache_memo_insert (lh->cache,
+                                         wl->root_ref,
+                                         wl->memo_path,
+                                         wl->dirent);
+        }
+
         if (last_pathcomp (wl->pathcomps, pathcomp)
             && wl->depth) {
             /* Unwind "recursive" step */
@@ -700,6 +700,116 @@ void cache_expiration_tests (void)
     cache_destroy (cache);
 }
 
+void cache_memo_tests (void)
+{
+    struct cache *cache;
+    json_t *dirent;
+    const json_t *o;
+    int size, hits, misses;
+
+    ok ((cache = cache_create ()) != NULL,
+        "cache_create works");
+
+    errno = 0;
+    ok (cache_memo_lookup (NULL, "ref", "a.b") == NULL && errno == EINVAL,
+        "cache_memo_lookup fails with EINVAL on bad input");
+    errno = 0;
+    ok (cache_memo_insert (cache, "ref", "a.b", NULL) < 0 && errno == EINVAL,
+        "cache_memo_insert fails with EINVAL on bad input");
+
+    errno = 0;
+    ok (cache_memo_lookup (cache, "ref", "a.b") == NULL && errno == ENOENT,
+        "cache_memo_lookup of missing path fails with ENOENT");
+
+    dirent = treeobj_create_dirref ("dirref-xyz");
+    ok (cache_memo_insert (cache, "ref", "a.b", dirent) == 0,
+        "cache_memo_insert works");
+    errno = 0;
+    ok (cache_memo_insert (cache, "ref", "a.b", dirent) < 0 && errno == EEXIST,
+        "cache_memo_insert of existing path fails with EEXIST");
+    json_decref (dirent);
+
+    ok ((o = cache_memo_lookup (cache, "ref", "a.b")) != NULL
+        && treeobj_is_dirref (o)
+        && !strcmp (treeobj_get_blobref (o, 0), "dirref-xyz"),
+        "cache_memo_lookup returns memoized dirent");
+    ok (cache_memo_lookup (cache, "ref2", "a.b") == NULL,
+        "cache_memo_lookup under a different dirref misses");
+    ok (cache_memo_lookup (cache, "ref", "a") == NULL,
+        "cache_memo_lookup of a different path misses");
+
+    cache_memo_get_stats (cache, &size, &hits, &misses);
+    ok (size == 1 && hits == 1 && misses == 3,
+        "cache_memo_get_stats reports size=1 hits=1 misses=3");
+    cache_memo_clear_stats (cache);
+    cache_memo_get_stats (cache, &size, &hits, &misses);
+    ok (size == 1 && hits == 0 && misses == 0,
+        "cache_memo_clear_stats clears hits and misses");
+
+    cache_destroy (cache);
+}
+
+/* N.B. must match CACHE_WARM_MAX in cache.c */
+#define WARM_MAX 4096
+
+void cache_warm_tests (void)
+{
+    struct cache *cache;
+    struct cache_entry *e;
+    const void *data;
+    char ref[64];
+    int len, size, hits, evictions;
+    int i, errors;
+
+    ok ((cache = cache_create ()) != NULL,
+        "cache_create works");
+
+    errno = 0;
+    ok (cache_insert_warm (NULL, "ref", "data", 4) < 0 && errno == EINVAL,
+        "cache_insert_warm fails with EINVAL on bad input");
+    errno = 0;
+    ok (cache_insert_warm (cache, "ref", NULL, 4) < 0 && errno == EINVAL,
+        "cache_insert_warm fails with EINVAL on bad data");
+
+    ok (cache_insert_warm (cache, "warm-0", "data-0", 6) == 0,
+        "cache_insert_warm works");
+    ok (cache_insert_warm (cache, "warm-0", "data-0", 6) == 0,
+        "cache_insert_warm of existing entry succeeds");
+    ok ((e = cache_lookup (cache, "warm-0", 1)) != NULL
+        && cache_entry_get_valid (e)
+        && cache_entry_get_raw (e, &data, &len) == 0
+        && len == 6 && !memcmp (data, "data-0", 6),
+        "cache_lookup of warm entry returns its data");
+
+    errors = 0;
+    for (i = 1; i < WARM_MAX + 10; i++) {
+        snprintf (ref, sizeof (ref), "warm-%d", i);
+        if (cache_insert_warm (cache, ref, "data", 4) < 0)
+            errors++;
+    }
+    ok (errors == 0,
+        "cache_insert_warm of %d more entries works", WARM_MAX + 9);
+    ok (cache_lookup (cache, "warm-0", 1) != NULL,
+        "looked up entry was kept after falling out of the warm set");
+    ok (cache_lookup (cache, "warm-1", 1) == NULL
+        && cache_lookup (cache, "warm-9", 1) == NULL,
+        "unused entries were removed after falling out of the warm set");
+    ok (cache_lookup (cache, "warm-10", 1) != NULL,
+        "entries in the warm set were kept");
+    ok (cache_count_entries (cache) == WARM_MAX + 1,
+        "cache contains %d entries", WARM_MAX + 1);
+
+    cache_warm_get_stats (cache, &size, &hits, &evictions);
+    ok (size == WARM_MAX && hits == 2 && evictions == 9,
+        "cache_warm_get_stats reports size=%d hits=2 evictions=9", WARM_MAX);
+    cache_warm_clear_stats (cache);
+    cache_warm_get_stats (cache, &size, &hits, &evictions);
+    ok (size == WARM_MAX && hits == 0 && evictions == 0,
+        "cache_warm_clear_stats clears hits and evictions");
+
+    cache_destroy (cache);
+}
+
 int main (int argc, char *argv[])
 {
     plan (NO_PLAN);
@@ -712,6 +822,8 @@ int main (int argc, char *argv[])
     cache_expiration_tests ();
     cache_blobref_tests ();
     cache_remove_entry_tests ();
+    cache_memo_tests ();
+    cache_warm_tests ();
 
     done_testing ();
     return (0);
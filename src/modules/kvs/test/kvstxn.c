@@ -3364,6 +3364,340 @@ void kvstxn_process_fallback_merge (void)
     cache_destroy (cache);
 }
 
+void kvstxn_process_pipeline (void)
+{
+    struct cache *cache;
+    kvsroot_mgr_t *krm;
+    kvstxn_mgr_t *ktm;
+    kvstxn_t *kt1, *kt2;
+    char rootref[BLOBREF_MAX_STRING_SIZE];
+    char newroot1[BLOBREF_MAX_STRING_SIZE];
+    const char *newroot;
+
+    cache = create_cache_with_empty_rootdir (rootref, sizeof (rootref));
+
+    ok ((krm = kvsroot_mgr_create (NULL, NULL)) != NULL,
+        "kvsroot_mgr_create works");
+
+    setup_kvsroot (krm, KVS_PRIMARY_NAMESPACE, cache, ref_dummy);
+
+    ok ((ktm = kvstxn_mgr_create (cache,
+                                  KVS_PRIMARY_NAMESPACE,
+                                  "sha1",
+                                  NULL,
+                                  &test_global)) != NULL,
+        "kvstxn_mgr_create works");
+
+    /*
+     * Second transaction is processed while the first is stalled on
+     * dirty cache entries, and is published after it.
+     */
+
+    create_ready_kvstxn (ktm, "transaction1", "key1", "1", 0, 0);
+    create_ready_kvstxn (ktm, "transaction2", "key2", "2", 0, 0);
+
+    ok ((kt1 = kvstxn_mgr_get_ready_transaction (ktm)) != NULL,
+        "kvstxn_mgr_get_ready_transaction returns ready kvstxn");
+
+    ok (kvstxn_process (kt1, 1, rootref) == KVSTXN_PROCESS_DIRTY_CACHE_ENTRIES,
+        "kvstxn_process returns KVSTXN_PROCESS_DIRTY_CACHE_ENTRIES");
+
+    ok (kvstxn_iter_dirty_cache_entries (kt1, cache_noop_cb, NULL) == 0,
+        "kvstxn_iter_dirty_cache_entries works for dirty cache entries");
+
+    ok (kvstxn_mgr_transaction_ready (ktm) == true,
+        "kvstxn_mgr_transaction_ready says a kvstxn is ready while first stalls");
+
+    ok ((kt2 = kvstxn_mgr_get_ready_transaction (ktm)) != NULL
+        && kt2 != kt1,
+        "kvstxn_mgr_get_ready_transaction returns second kvstxn");
+
+    ok (kvstxn_process (kt2, 1, rootref) == KVSTXN_PROCESS_DIRTY_CACHE_ENTRIES,
+        "kvstxn_process returns KVSTXN_PROCESS_DIRTY_CACHE_ENTRIES");
+
+    ok (kvstxn_iter_dirty_cache_entries (kt2, cache_noop_cb, NULL) == 0,
+        "kvstxn_iter_dirty_cache_entries works for dirty cache entries");
+
+    ok (kvstxn_process (kt2, 1, rootref) == KVSTXN_PROCESS_FINISHED,
+        "kvstxn_process returns KVSTXN_PROCESS_FINISHED on second kvstxn");
+
+    ok (kvstxn_mgr_defer_transaction (ktm, kt2) == true,
+        "kvstxn_mgr_defer_transaction defers second kvstxn");
+
+    ok (kvstxn_mgr_get_deferred_transaction (ktm) == NULL,
+        "kvstxn_mgr_get_deferred_transaction returns NULL, head not deferred");
+
+    ok (kvstxn_mgr_transaction_ready (ktm) == false,
+        "kvstxn_mgr_transaction_ready says no kvstxns are ready");
+
+    ok (kvstxn_process (kt1, 1, rootref) == KVSTXN_PROCESS_FINISHED,
+        "kvstxn_process returns KVSTXN_PROCESS_FINISHED on first kvstxn");
+
+    ok (kvstxn_mgr_defer_transaction (ktm, kt1) == false,
+        "kvstxn_mgr_defer_transaction does not defer head kvstxn");
+
+    ok ((newroot = kvstxn_get_newroot_ref (kt1)) != NULL,
+        "kvstxn_get_newroot_ref returns != NULL when processing complete");
+
+    strcpy (newroot1, newroot);
+
+    kvstxn_mgr_remove_transaction (ktm, kt1, false);
+
+    ok (kvstxn_mgr_get_deferred_transaction (ktm) == kt2,
+        "kvstxn_mgr_get_deferred_transaction returns second kvstxn");
+
+    ok (kvstxn_rebase (kt2, newroot1) == false,
+        "kvstxn_rebase does nothing, kvstxn applied to published root");
+
+    ok (kvstxn_process (kt2, 1, newroot1) == KVSTXN_PROCESS_FINISHED,
+        "kvstxn_process returns KVSTXN_PROCESS_FINISHED on second kvstxn");
+
+    ok ((newroot = kvstxn_get_newroot_ref (kt2)) != NULL,
+        "kvstxn_get_newroot_ref returns != NULL when processing complete");
+
+    verify_value (cache, krm, KVS_PRIMARY_NAMESPACE, newroot, "key1", "1");
+    verify_value (cache, krm, KVS_PRIMARY_NAMESPACE, newroot, "key2", "2");
+
+    strcpy (rootref, newroot);
+
+    kvstxn_mgr_remove_transaction (ktm, kt2, false);
+
+    /*
+     * First transaction fails after the second was applied to its new
+     * root.  The second must be started over on the published root.
+     */
+
+    create_ready_kvstxn (ktm, "transaction3", "key3", "3", 0, 0);
+    create_ready_kvstxn (ktm, "transaction4", "key4", "4", 0, 0);
+
+    ok ((kt1 = kvstxn_mgr_get_ready_transaction (ktm)) != NULL,
+        "kvstxn_mgr_get_ready_transaction returns ready kvstxn");
+
+    ok (kvstxn_process (kt1, 1, rootref) == KVSTXN_PROCESS_DIRTY_CACHE_ENTRIES,
+        "kvstxn_process returns KVSTXN_PROCESS_DIRTY_CACHE_ENTRIES");
+
+    ok (kvstxn_iter_dirty_cache_entries (kt1, cache_noop_cb, NULL) == 0,
+        "kvstxn_iter_dirty_cache_entries works for dirty cache entries");
+
+    ok ((kt2 = kvstxn_mgr_get_ready_transaction (ktm)) != NULL
+        && kt2 != kt1,
+        "kvstxn_mgr_get_ready_transaction returns second kvstxn");
+
+    ok (kvstxn_process (kt2, 1, rootref) == KVSTXN_PROCESS_DIRTY_CACHE_ENTRIES,
+        "kvstxn_process returns KVSTXN_PROCESS_DIRTY_CACHE_ENTRIES");
+
+    ok (kvstxn_iter_dirty_cache_entries (kt2, cache_noop_cb, NULL) == 0,
+        "kvstxn_iter_dirty_cache_entries works for dirty cache entries");
+
+    ok (kvstxn_process (kt2, 1, rootref) == KVSTXN_PROCESS_FINISHED,
+        "kvstxn_process returns KVSTXN_PROCESS_FINISHED on second kvstxn");
+
+    ok (kvstxn_mgr_defer_transaction (ktm, kt2) == true,
+        "kvstxn_mgr_defer_transaction defers second kvstxn");
+
+    ok (kvstxn_set_aux_errnum (kt1, EIO) == EIO,
+        "kvstxn_set_aux_errnum fails first kvstxn");
+
+    kvstxn_mgr_remove_transaction (ktm, kt1, false);
+
+    ok (kvstxn_mgr_get_deferred_transaction (ktm) == kt2,
+        "kvstxn_mgr_get_deferred_transaction returns second kvstxn");
+
+    ok (kvstxn_rebase (kt2, rootref) == true,
+        "kvstxn_rebase resets kvstxn applied to unpublished root");
+
+    ok (kvstxn_process (kt2, 1, rootref) == KVSTXN_PROCESS_DIRTY_CACHE_ENTRIES,
+        "kvstxn_process returns KVSTXN_PROCESS_DIRTY_CACHE_ENTRIES");
+
+    ok (kvstxn_iter_dirty_cache_entries (kt2, cache_noop_cb, NULL) == 0,
+        "kvstxn_iter_dirty_cache_entries works for dirty cache entries");
+
+    ok (kvstxn_process (kt2, 1, rootref) == KVSTXN_PROCESS_FINISHED,
+        "kvstxn_process returns KVSTXN_PROCESS_FINISHED on second kvstxn");
+
+    ok ((newroot = kvstxn_get_newroot_ref (kt2)) != NULL,
+        "kvstxn_get_newroot_ref returns != NULL when processing complete");
+
+    verify_value (cache, krm, KVS_PRIMARY_NAMESPACE, newroot, "key2", "2");
+    verify_value (cache, krm, KVS_PRIMARY_NAMESPACE, newroot, "key3", NULL);
+    verify_value (cache, krm, KVS_PRIMARY_NAMESPACE, newroot, "key4", "4");
+
+    kvstxn_mgr_remove_transaction (ktm, kt2, false);
+
+    ok (kvstxn_mgr_get_ready_transaction (ktm) == NULL,
+        "kvstxn_mgr_get_ready_transaction returns NULL, no more kvstxns");
+
+    kvstxn_mgr_destroy (ktm);
+    kvsroot_mgr_destroy (krm);
+    cache_destroy (cache);
+}
+
+/* Process a transaction that creates many sibling directories and
+ * large values, with and without a worker pool, and return the new root.
+ */
+void process_unroll_transaction (struct workpool *wp, char *newroot, int len)
+{
+    struct cache *cache;
+    kvstxn_mgr_t *ktm;
+    kvstxn_t *kt;
+    char rootref[BLOBREF_MAX_STRING_SIZE];
+    char key[64];
+    char val[16];
+    char bigval[BLOBREF_MAX_STRING_SIZE * 4];
+    json_t *ops;
+    int count = 0;
+    int i;
+
+    cache = create_cache_with_empty_rootdir (rootref, sizeof (rootref));
+
+    ok ((ktm = kvstxn_mgr_create (cache,
+                                  KVS_PRIMARY_NAMESPACE,
+                                  "sha1",
+                                  NULL,
+                                  &test_global)) != NULL,
+        "kvstxn_mgr_create works");
+
+    kvstxn_mgr_set_workpool (ktm, wp);
+
+    ops = json_array ();
+    for (i = 0; i < 64; i++) {
+        snprintf (key, sizeof (key), "dir%d.subdir.key", i);
+        snprintf (val, sizeof (val), "%d", i);
+        ops_append (ops, key, val, 0);
+        memset (bigval, 'a' + i % 26, sizeof (bigval) - 1);
+        bigval[sizeof (bigval) - 1] = '\0';
+        snprintf (key, sizeof (key), "dir%d.big", i);
+        ops_append (ops, key, bigval, 0);
+    }
+
+    ok (kvstxn_mgr_add_transaction (ktm, "transaction1", ops, 0) == 0,
+        "kvstxn_mgr_add_transaction works");
+
+    json_decref (ops);
+
+    ok ((kt = kvstxn_mgr_get_ready_transaction (ktm)) != NULL,
+        "kvstxn_mgr_get_ready_transaction returns ready kvstxn");
+
+    ok (kvstxn_process (kt, 1, rootref) == KVSTXN_PROCESS_DIRTY_CACHE_ENTRIES,
+        "kvstxn_process returns KVSTXN_PROCESS_DIRTY_CACHE_ENTRIES");
+
+    ok (kvstxn_iter_dirty_cache_entries (kt, cache_count_dirty_cb, &count) == 0,
+        "kvstxn_iter_dirty_cache_entries works for dirty cache entries");
+
+    /* 64 dirN, 64 dirN.subdir, 26 distinct big values, and the root */
+    ok (count == 64 + 64 + 26 + 1,
+        "correct number of cache entries were dirty");
+
+    ok (kvstxn_process (kt, 1, rootref) == KVSTXN_PROCESS_FINISHED,
+        "kvstxn_process returns KVSTXN_PROCESS_FINISHED");
+
+    ok (kvstxn_get_newroot_ref (kt) != NULL
+        && strlen (kvstxn_get_newroot_ref (kt)) < len,
+        "kvstxn_get_newroot_ref returns != NULL when processing complete");
+
+    strcpy (newroot, kvstxn_get_newroot_ref (kt));
+
+    kvstxn_mgr_remove_transaction (ktm, kt, false);
+    kvstxn_mgr_destroy (ktm);
+    cache_destroy (cache);
+}
+
+void kvstxn_process_workpool (void)
+{
+    struct workpool *wp;
+    char newroot1[BLOBREF_MAX_STRING_SIZE];
+    char newroot2[BLOBREF_MAX_STRING_SIZE];
+
+    process_unroll_transaction (NULL, newroot1, sizeof (newroot1));
+
+    ok ((wp = workpool_create (4)) != NULL,
+        "workpool_create works");
+
+    process_unroll_transaction (wp, newroot2, sizeof (newroot2));
+
+    ok (strcmp (newroot1, newroot2) == 0,
+        "new root is the same with and without a worker pool");
+
+    workpool_destroy (wp);
+}
+
+int cache_add_warm_ref_cb (kvstxn_t *kt, struct cache_entry *entry, void *data)
+{
+    int *count = data;
+    if (kvstxn_add_warm_ref (kt, cache_entry_get_blobref (entry)) < 0)
+        return -1;
+    if (count)
+        (*count)++;
+    return 0;
+}
+
+void kvstxn_process_warm_refs (void)
+{
+    struct cache *cache;
+    kvsroot_mgr_t *krm;
+    int count = 0;
+    kvstxn_mgr_t *ktm;
+    kvstxn_t *kt;
+    char rootref[BLOBREF_MAX_STRING_SIZE];
+    json_t *refs;
+    json_t *value;
+    size_t index;
+    bool found;
+
+    cache = create_cache_with_empty_rootdir (rootref, sizeof (rootref));
+
+    ok ((krm = kvsroot_mgr_create (NULL, NULL)) != NULL,
+        "kvsroot_mgr_create works");
+
+    setup_kvsroot (krm, KVS_PRIMARY_NAMESPACE, cache, ref_dummy);
+
+    ok ((ktm = kvstxn_mgr_create (cache,
+                                  KVS_PRIMARY_NAMESPACE,
+                                  "sha1",
+                                  NULL,
+                                  &test_global)) != NULL,
+        "kvstxn_mgr_create works");
+
+    create_ready_kvstxn (ktm, "transaction1", "key1", "1", 0, 0);
+
+    ok ((kt = kvstxn_mgr_get_ready_transaction (ktm)) != NULL,
+        "kvstxn_mgr_get_ready_transaction returns ready kvstxn");
+
+    errno = 0;
+    ok (kvstxn_add_warm_ref (kt, NULL) < 0 && errno == EINVAL,
+        "kvstxn_add_warm_ref fails with EINVAL on bad input");
+
+    ok (kvstxn_process (kt, 1, rootref) == KVSTXN_PROCESS_DIRTY_CACHE_ENTRIES,
+        "kvstxn_process returns KVSTXN_PROCESS_DIRTY_CACHE_ENTRIES");
+
+    ok (kvstxn_iter_dirty_cache_entries (kt, cache_add_warm_ref_cb, &count) == 0,
+        "kvstxn_iter_dirty_cache_entries works with kvstxn_add_warm_ref");
+
+    ok (kvstxn_get_warm_refs (kt) == NULL,
+        "kvstxn_get_warm_refs returns NULL before processing complete");
+
+    ok (kvstxn_process (kt, 1, rootref) == KVSTXN_PROCESS_FINISHED,
+        "kvstxn_process returns KVSTXN_PROCESS_FINISHED");
+
+    ok ((refs = kvstxn_get_warm_refs (kt)) != NULL
+        && json_array_size (refs) == count,
+        "kvstxn_get_warm_refs returns all recorded refs");
+
+    found = false;
+    json_array_foreach (refs, index, value) {
+        if (!strcmp (json_string_value (value), kvstxn_get_newroot_ref (kt)))
+            found = true;
+    }
+    ok (found == true,
+        "new root ref was recorded");
+
+    kvstxn_mgr_remove_transaction (ktm, kt, false);
+
+    kvstxn_mgr_destroy (ktm);
+    kvsroot_mgr_destroy (krm);
+    cache_destroy (cache);
+}
+
 int main (int argc, char *argv[])
 {
     plan (NO_PLAN);
@@ -3403,6 +3737,9 @@ int main (int argc, char *argv[])
     kvstxn_process_append_errors ();
     kvstxn_process_append_no_duplicate ();
     kvstxn_process_fallback_merge ();
+    kvstxn_process_pipeline ();
+    kvstxn_process_workpool ();
+    kvstxn_process_warm_refs ();
 
     done_testing ();
     return (0);
@@ -3499,6 +3499,152 @@ void lookup_stall_ref_expire_cache_entries (void) {
     json_decref (root);
 }
 
+/* lookup tests on path memo */
+void lookup_memo (void) {
+    json_t *root;
+    json_t *dirref1;
+    json_t *dirref2;
+    json_t *test;
+    struct cache *cache;
+    kvsroot_mgr_t *krm;
+    lookup_t *lh;
+    char dirref1_ref[BLOBREF_MAX_STRING_SIZE];
+    char dirref2_ref[BLOBREF_MAX_STRING_SIZE];
+    char root_ref[BLOBREF_MAX_STRING_SIZE];
+    int size, hits, misses;
+
+    ok ((cache = cache_create ()) != NULL,
+        "cache_create works");
+    ok ((krm = kvsroot_mgr_create (NULL, NULL)) != NULL,
+        "kvsroot_mgr_create works");
+
+    /* This cache is
+     *
+     * dirref2_ref
+     * "val" : val to "foo"
+     *
+     * dirref1_ref
+     * "dirref2" : dirref to dirref2_ref
+     *
+     * root_ref
+     * "dirref1" : dirref to dirref1_ref
+     * "symlink" : symlink to "dirref1"
+     */
+
+    dirref2 = treeobj_create_dir ();
+    _treeobj_insert_entry_val (dirref2, "val", "foo", 3);
+    treeobj_hash ("sha1", dirref2, dirref2_ref, sizeof (dirref2_ref));
+    (void)cache_insert (cache, create_cache_entry_treeobj (dirref2_ref, dirref2));
+
+    dirref1 = treeobj_create_dir ();
+    _treeobj_insert_entry_dirref (dirref1, "dirref2", dirref2_ref);
+    treeobj_hash ("sha1", dirref1, dirref1_ref, sizeof (dirref1_ref));
+    (void)cache_insert (cache, create_cache_entry_treeobj (dirref1_ref, dirref1));
+
+    root = treeobj_create_dir ();
+    _treeobj_insert_entry_dirref (root, "dirref1", dirref1_ref);
+    _treeobj_insert_entry_symlink (root, "symlink", NULL, "dirref1");
+    treeobj_hash ("sha1", root, root_ref, sizeof (root_ref));
+    (void)cache_insert (cache, create_cache_entry_treeobj (root_ref, root));
+
+    setup_kvsroot (krm, KVS_PRIMARY_NAMESPACE, cache, root_ref, 0);
+
+    /* first lookup walks every directory and memoizes dirref1.dirref2 */
+    ok ((lh = lookup_create (cache,
+                             krm,
+                             1,
+                             KVS_PRIMARY_NAMESPACE,
+                             NULL,
+                             0,
+                             "dirref1.dirref2.val",
+                             owner_cred,
+                             0,
+                             NULL)) != NULL,
+        "lookup_create dirref1.dirref2.val");
+    test = treeobj_create_val ("foo", 3);
+    check_value (lh, test, "dirref1.dirref2.val #1");
+    json_decref (test);
+
+    cache_memo_get_stats (cache, &size, &hits, &misses);
+    ok (size == 1 && hits == 0 && misses == 1,
+        "memo has 1 entry after first lookup");
+
+    /* with dirref1 gone from the cache, a second lookup succeeds
+     * because it skips directly to dirref2 */
+    ok (cache_remove_entry (cache, dirref1_ref) == 1,
+        "cache_remove_entry removed dirref1");
+    ok ((lh = lookup_create (cache,
+                             krm,
+                             1,
+                             KVS_PRIMARY_NAMESPACE,
+                             NULL,
+                             0,
+                             "dirref1.dirref2.val",
+                             owner_cred,
+                             0,
+                             NULL)) != NULL,
+        "lookup_create dirref1.dirref2.val");
+    test = treeobj_create_val ("foo", 3);
+    check_value (lh, test, "dirref1.dirref2.val #2");
+    json_decref (test);
+
+    cache_memo_get_stats (cache, &size, &hits, &misses);
+    ok (size == 1 && hits == 1 && misses == 1,
+        "memo hit on second lookup");
+
+    /* a path through a symlink is not memoized, so it must load dirref1 */
+    ok ((lh = lookup_create (cache,
+                             krm,
+                             1,
+                             KVS_PRIMARY_NAMESPACE,
+                             NULL,
+                             0,
+                             "symlink.dirref2.val",
+                             owner_cred,
+                             0,
+                             NULL)) != NULL,
+        "lookup_create symlink.dirref2.val");
+    check_stall (lh, EAGAIN, 1, dirref1_ref, "symlink.dirref2.val stall");
+
+    (void)cache_insert (cache, create_cache_entry_treeobj (dirref1_ref, dirref1));
+
+    test = treeobj_create_val ("foo", 3);
+    check_value (lh, test, "symlink.dirref2.val");
+    json_decref (test);
+
+    cache_memo_get_stats (cache, &size, &hits, &misses);
+    ok (size == 1,
+        "path through symlink was not memoized");
+
+    /* the memo is not used until the root directory is cached */
+    ok (cache_remove_entry (cache, root_ref) == 1,
+        "cache_remove_entry removed root");
+    ok ((lh = lookup_create (cache,
+                             krm,
+                             1,
+                             KVS_PRIMARY_NAMESPACE,
+                             NULL,
+                             0,
+                             "dirref1.dirref2.val",
+                             owner_cred,
+                             0,
+                             NULL)) != NULL,
+        "lookup_create dirref1.dirref2.val");
+    check_stall (lh, EAGAIN, 1, root_ref, "dirref1.dirref2.val stall on root");
+
+    (void)cache_insert (cache, create_cache_entry_treeobj (root_ref, root));
+
+    test = treeobj_create_val ("foo", 3);
+    check_value (lh, test, "dirref1.dirref2.val #3");
+    json_decref (test);
+
+    cache_destroy (cache);
+    kvsroot_mgr_destroy (krm);
+    json_decref (dirref1);
+    json_decref (dirref2);
+    json_decref (root);
+}
+
 int main (int argc, char *argv[])
 {
     plan (NO_PLAN);
@@ -3521,6 +3667,7 @@ int main (int argc, char *argv[])
     lookup_stall_ref ();
     lookup_stall_namespace_removed ();
     lookup_stall_ref_expire_cache_entries ();
+    lookup_memo ();
 
     done_testing ();
     return (0);
@@ -27,15 +27,8 @@ int rutil_idset_sub (struct idset *ids1, const struct idset *ids2)
         errno = EINVAL;
         return -1;
     }
-    if (ids2) {
-        unsigned int id;
-        id = idset_first (ids2);
-        while (id != IDSET_INVALID_ID) {
-            if (idset_clear (ids1, id) < 0)
-                return -1;
-            id = idset_next (ids2, id);
-        }
-    }
+    if (ids2)
+        return idset_subtract (ids1, ids2);
     return 0;
 }
 
@@ -45,15 +38,8 @@ int rutil_idset_add (struct idset *ids1, const struct idset *ids2)
         errno = EINVAL;
         return -1;
     }
-    if (ids2) {
-        unsigned int id;
-        id = idset_first (ids2);
-        while (id != IDSET_INVALID_ID) {
-            if (idset_set (ids1, id) < 0)
-                return -1;
-            id = idset_next (ids2, id);
-        }
-    }
+    if (ids2)
+        return idset_add (ids1, ids2);
     return 0;
 }
 
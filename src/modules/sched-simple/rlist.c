@@ -24,9 +24,19 @@
 #include "rlist.h"
 #include "libjj.h"
 
+/*  Availability buckets start small and grow to the highest rank added,
+ *   so sparse buckets on large instances stay small.
+ */
+static const size_t bucket_initial_size = 64;
+
 void rlist_destroy (struct rlist *rl)
 {
     if (rl) {
+        int i;
+        for (i = 0; i < rl->nbuckets; i++)
+            idset_destroy (rl->buckets[i]);
+        free (rl->buckets);
+        zhashx_destroy (&rl->rank_index);
         zlistx_destroy (&rl->nodes);
         free (rl);
     }
@@ -38,18 +48,125 @@ static void rn_free_fn (void **x)
     *x = NULL;
 }
 
+static size_t rank_hasher (const void *key)
+{
+    return *(const uint32_t *) key;
+}
+
+static int rank_cmp (const void *key1, const void *key2)
+{
+    uint32_t a = *(const uint32_t *) key1;
+    uint32_t b = *(const uint32_t *) key2;
+    return (a > b) - (a < b);
+}
+
 struct rlist *rlist_create (void)
 {
     struct rlist *rl = calloc (1, sizeof (*rl));
-    if (!(rl->nodes = zlistx_new ()))
+    if (!rl)
+        return NULL;
+    if (!(rl->nodes = zlistx_new ())
+        || !(rl->rank_index = zhashx_new ()))
         goto err;
     zlistx_set_destructor (rl->nodes, rn_free_fn);
+
+    /*  rank_index keys point to the rank member of the indexed rnode,
+     *   which is owned by rl->nodes.
+     */
+    zhashx_set_key_hasher (rl->rank_index, rank_hasher);
+    zhashx_set_key_comparator (rl->rank_index, rank_cmp);
+    zhashx_set_key_duplicator (rl->rank_index, NULL);
+    zhashx_set_key_destructor (rl->rank_index, NULL);
     return (rl);
 err:
     rlist_destroy (rl);
     return (NULL);
 }
 
+/*  Add up node `n` to the availability bucket for its current number
+ *   of available cores. Down nodes are not tracked in any bucket.
+ */
+static int rlist_bucket_add (struct rlist *rl, struct rnode *n)
+{
+    size_t avail;
+
+    if (!n->up)
+        return 0;
+    avail = rnode_avail (n);
+    if (avail >= rl->nbuckets) {
+        int i;
+        int size = avail + 1;
+        struct idset **new;
+        if (!(new = realloc (rl->buckets, size * sizeof (*new))))
+            return -1;
+        for (i = rl->nbuckets; i < size; i++)
+            new[i] = NULL;
+        rl->buckets = new;
+        rl->nbuckets = size;
+    }
+    if (!rl->buckets[avail]
+        && !(rl->buckets[avail] = idset_create (bucket_initial_size,
+                                                IDSET_FLAG_AUTOGROW)))
+        return -1;
+    return idset_set (rl->buckets[avail], n->rank);
+}
+
+/*  Remove node `n` from its availability bucket. This must be called
+ *   before any change to the availability or up/down state of `n`,
+ *   followed by rlist_bucket_add() after the change.
+ */
+static void rlist_bucket_remove (struct rlist *rl, struct rnode *n)
+{
+    size_t avail = rnode_avail (n);
+    if (n->up && avail < rl->nbuckets && rl->buckets[avail])
+        (void) idset_clear (rl->buckets[avail], n->rank);
+}
+
+/*  Append rnode `n` to rlist `rl` and add it to the rank and availability
+ *   indexes. On failure, `n` is not added and remains owned by the caller.
+ */
+static int rlist_insert (struct rlist *rl, struct rnode *n)
+{
+    void *handle;
+
+    if (!(handle = zlistx_add_end (rl->nodes, n)))
+        return -1;
+    if (zhashx_insert (rl->rank_index, &n->rank, n) < 0) {
+        zlistx_detach (rl->nodes, handle);
+        errno = EEXIST;
+        return -1;
+    }
+    if (rlist_bucket_add (rl, n) < 0) {
+        zhashx_delete (rl->rank_index, &n->rank);
+        zlistx_detach (rl->nodes, handle);
+        return -1;
+    }
+    return 0;
+}
+
+struct rlist *rlist_copy (const struct rlist *orig)
+{
+    struct rnode *n;
+    struct rlist *rl = rlist_create ();
+    if (!rl)
+        return NULL;
+    n = zlistx_first (orig->nodes);
+    while (n) {
+        n = rnode_copy (n);
+        if (!n || rlist_insert (rl, n) < 0) {
+            rnode_destroy (n);
+            goto fail;
+        }
+        n = zlistx_next (orig->nodes);
+    }
+    rl->total = orig->total;
+    rl->avail = orig->avail;
+    return rl;
+fail:
+    rlist_destroy (rl);
+    return NULL;
+}
+
 struct rlist *rlist_copy_empty (const struct rlist *orig)
 {
     struct rnode *n;
@@ -59,8 +176,10 @@ struct rlist *rlist_copy_empty (const struct rlist *orig)
     n = zlistx_first (orig->nodes);
     while (n) {
         n = rnode_create_idset (n->rank, n->ids);
-        if (!n || !zlistx_add_end (rl->nodes, n))
+        if (!n || rlist_insert (rl, n) < 0) {
+            rnode_destroy (n);
             goto fail;
+        }
         rl->total += rnode_count (n);
         n = zlistx_next (orig->nodes);
     }
@@ -81,8 +200,10 @@ struct rlist *rlist_copy_down (const struct rlist *orig)
     while (n) {
         if (!n->up) {
             n = rnode_create_idset (n->rank, n->ids);
-            if (!n || !zlistx_add_end (rl->nodes, n))
+            if (!n || rlist_insert (rl, n) < 0) {
+                rnode_destroy (n);
                 goto fail;
+            }
             rl->total += rnode_count (n);
         }
         n = zlistx_next (orig->nodes);
@@ -94,26 +215,10 @@ fail:
     return NULL;
 }
 
-static struct idset *idset_subtract (const struct idset *orig, struct idset *x)
-{
-    struct idset *ids = idset_copy (orig);
-    unsigned int i;
-
-    if (!ids)
-        return NULL;
-
-    i = idset_first (x);
-    while (i != IDSET_INVALID_ID) {
-        idset_clear (ids, i);
-        i = idset_next (x, i);
-    }
-    return ids;
-}
-
 static struct rnode *rnode_create_alloc (const struct rnode *n)
 {
     struct rnode *result;
-    struct idset *ids = idset_subtract (n->ids, n->avail);
+    struct idset *ids = idset_difference (n->ids, n->avail);
     if (!ids)
         return NULL;
     result = rnode_create_idset (n->rank, ids);
@@ -132,8 +237,10 @@ struct rlist *rlist_copy_allocated (const struct rlist *orig)
         int nalloc = idset_count (n->ids) - idset_count (n->avail);
         if (nalloc > 0) {
             n = rnode_create_alloc (n);
-            if (!n || !zlistx_add_end (rl->nodes, n))
+            if (!n || rlist_insert (rl, n) < 0) {
+                rnode_destroy (n);
                 goto fail;
+            }
             rl->total += nalloc;
         }
         n = zlistx_next (orig->nodes);
@@ -147,13 +254,7 @@ fail:
 
 static struct rnode *rlist_find_rank (struct rlist *rl, uint32_t rank)
 {
-    struct rnode *n = zlistx_first (rl->nodes);
-    while (n) {
-        if (n->rank == rank)
-            return (n);
-        n = zlistx_next (rl->nodes);
-    }
-    return NULL;
+    return zhashx_lookup (rl->rank_index, &rank);
 }
 
 /*  Compare two values from idset_first()/idset_next():
@@ -194,32 +295,20 @@ static int idset_cmp (struct idset *set1, struct idset *set2)
 
 static int idset_add_set (struct idset *set, struct idset *new)
 {
-    unsigned int i = idset_first (new);
-    while (i != IDSET_INVALID_ID) {
-        if (idset_test (set, i)) {
-            errno = EEXIST;
-            return -1;
-        }
-        if (idset_set (set, i) < 0)
-            return -1;
-        i = idset_next (new, i);
+    if (idset_has_intersection (set, new)) {
+        errno = EEXIST;
+        return -1;
     }
-    return 0;
+    return idset_add (set, new);
 }
 
 static int idset_remove_set (struct idset *set, struct idset *remove)
 {
-    unsigned int i = idset_first (remove);
-    while (i != IDSET_INVALID_ID) {
-        if (!idset_test (set, i)) {
-            errno = ENOENT;
-            return -1;
-        }
-        if (idset_clear (set, i) < 0)
-            return -1;
-        i = idset_next (remove, i);
+    if (!idset_is_subset (remove, set)) {
+        errno = ENOENT;
+        return -1;
     }
-    return 0;
+    return idset_subtract (set, remove);
 }
 
 static int rlist_add_rnode (struct rlist *rl, struct rnode *n)
@@ -228,12 +317,16 @@ static int rlist_add_rnode (struct rlist *rl, struct rnode *n)
     if (found) {
         if (idset_add_set (found->ids, n->ids) < 0)
             return (-1);
+        rlist_bucket_remove (rl, found);
         if (idset_add_set (found->avail, n->avail) < 0) {
             idset_remove_set (found->ids, n->ids);
+            rlist_bucket_add (rl, found);
             return (-1);
         }
+        if (rlist_bucket_add (rl, found) < 0)
+            return (-1);
     }
-    else if (!zlistx_add_end (rl->nodes, n))
+    else if (rlist_insert (rl, n) < 0)
         return -1;
     rl->total += rnode_count (n);
     if (n->up)
@@ -607,16 +700,6 @@ static int by_rank (const void *item1, const void *item2)
     return (x->rank - y->rank);
 }
 
-static int by_avail (const void *item1, const void *item2)
-{
-    int n;
-    const struct rnode *x = item1;
-    const struct rnode *y = item2;
-    if ((n = rnode_avail (x) - rnode_avail (y)) == 0)
-        n = by_rank (x, y);
-    return n;
-}
-
 static int by_used (const void *item1, const void *item2)
 {
     int n;
@@ -630,7 +713,17 @@ static int by_used (const void *item1, const void *item2)
 static int rlist_rnode_alloc (struct rlist *rl, struct rnode *n,
                               int count, struct idset **idsetp)
 {
-    if (!n || rnode_alloc (n, count, idsetp) < 0)
+    int rc;
+    if (!n)
+        return -1;
+    rlist_bucket_remove (rl, n);
+    rc = rnode_alloc (n, count, idsetp);
+    if (rlist_bucket_add (rl, n) < 0) {
+        if (rc == 0)
+            idset_destroy (*idsetp);
+        return -1;
+    }
+    if (rc < 0)
         return -1;
     rl->avail -= idset_count (*idsetp);
     return 0;
@@ -647,113 +740,189 @@ static uint32_t rlist_rnode_rank (struct rlist *rl)
 }
 #endif
 
-static struct rnode *rlist_first (struct rlist *rl)
+/*
+ *  Allocate as many of `*slots` slots of size cores_per_slot as will fit
+ *   on node `n`, appending allocated cores to `result`.
+ */
+static int rlist_rnode_alloc_slots (struct rlist *rl,
+                                    struct rnode *n,
+                                    int cores_per_slot,
+                                    int *slots,
+                                    struct rlist *result)
+{
+    while (*slots > 0) {
+        int rc;
+        struct idset *ids = NULL;
+        if (rlist_rnode_alloc (rl, n, cores_per_slot, &ids) < 0)
+            return (errno == ENOSPC ? 0 : -1);
+        rc = rlist_append_idset (result, n->rank, ids);
+        idset_destroy (ids);
+        if (rc < 0)
+            return -1;
+        (*slots)--;
+    }
+    return 0;
+}
+
+/*
+ *  Return the lowest ranked up node with rank greater than `prev` with
+ *   at least `count` cores available, or the lowest ranked such node if
+ *   `prev` is IDSET_INVALID_ID.
+ */
+static struct rnode *rlist_next_fit (struct rlist *rl,
+                                     unsigned int prev,
+                                     int count)
 {
-    return zlistx_first (rl->nodes);
+    int i;
+    unsigned int rank = IDSET_INVALID_ID;
+
+    for (i = count; i < rl->nbuckets; i++) {
+        unsigned int next;
+        if (!rl->buckets[i])
+            continue;
+        if (prev == IDSET_INVALID_ID)
+            next = idset_first (rl->buckets[i]);
+        else
+            next = idset_next (rl->buckets[i], prev);
+        if (next < rank)
+            rank = next;
+    }
+    if (rank == IDSET_INVALID_ID)
+        return NULL;
+    return rlist_find_rank (rl, rank);
 }
 
-static struct rnode *rlist_next (struct rlist *rl)
+static struct rlist *rlist_alloc_unwind (struct rlist *rl,
+                                         struct rlist *result)
 {
-    return zlistx_next (rl->nodes);
+    rlist_free (rl, result);
+    rlist_destroy (result);
+    errno = ENOSPC;
+    return NULL;
 }
 
 /*
  *  Allocate the first available N slots of size cores_per_slot from
- *   resource list rl after sorting the nodes with the current sort strategy.
+ *   resource list rl in rank order.
  */
 static struct rlist * rlist_alloc_first_fit (struct rlist *rl,
                                              int cores_per_slot,
                                              int slots)
 {
-    int rc;
-    struct idset *ids = NULL;
     struct rnode *n = NULL;
     struct rlist *result = NULL;
 
-    zlistx_sort (rl->nodes);
-
-    if (!(n = rlist_first (rl)))
+    if (!(n = rlist_next_fit (rl, IDSET_INVALID_ID, cores_per_slot))) {
+        errno = ENOSPC;
         return NULL;
-
+    }
     if (!(result = rlist_create ()))
         return NULL;
 
-    /* 2. assign slots to first nodes where they fit
+    /*  Assign slots to first nodes where they fit. Each node is left
+     *   with fewer than cores_per_slot cores available (or slots == 0),
+     *   so advance to the next node with enough cores after rank.
      */
     while (n && slots) {
-        /*  Try to allocate a slot on this node. If we fail with ENOSPC,
-         *   then advance to the next node and try again.
-         */
-        if ((rc = rlist_rnode_alloc (rl, n, cores_per_slot, &ids)) < 0) {
-            if (errno != ENOSPC)
-                goto unwind;
-            n = rlist_next (rl);
-            continue;
-        }
-        /*  Append the allocated cores to the result set and continue
-         *   if needed
-         */
-        rc = rlist_append_idset (result, n->rank, ids);
-        idset_destroy (ids);
-        if (rc < 0)
-            goto unwind;
-        slots--;
+        if (rlist_rnode_alloc_slots (rl, n, cores_per_slot,
+                                     &slots, result) < 0)
+            return rlist_alloc_unwind (rl, result);
+        n = rlist_next_fit (rl, n->rank, cores_per_slot);
     }
-    if (slots != 0) {
-unwind:
-        rlist_free (rl, result);
-        rlist_destroy (result);
-        errno = ENOSPC;
+    if (slots != 0)
+        return rlist_alloc_unwind (rl, result);
+    return result;
+}
+
+/*
+ *  Allocate `slots` of size cores_per_slot from rlist `rl`, visiting
+ *   nodes in order of available cores, ascending if `ascending` is true,
+ *   otherwise descending, and by rank for nodes with equal available cores.
+ *
+ *  Only buckets with at least cores_per_slot available cores are visited.
+ *   A node that has been allocated from is left with fewer than
+ *   cores_per_slot cores (or slots == 0), so it moves to a bucket which
+ *   is not visited again.
+ */
+static struct rlist * rlist_alloc_by_avail (struct rlist *rl,
+                                            int cores_per_slot,
+                                            int slots,
+                                            bool ascending)
+{
+    int i;
+    struct rlist *result = NULL;
+
+    if (!(result = rlist_create ()))
         return NULL;
+
+    for (i = 0; i < rl->nbuckets - cores_per_slot && slots; i++) {
+        int b = ascending ? cores_per_slot + i : rl->nbuckets - 1 - i;
+        unsigned int rank;
+
+        if (!rl->buckets[b])
+            continue;
+        rank = idset_first (rl->buckets[b]);
+        while (rank != IDSET_INVALID_ID && slots) {
+            struct rnode *n = rlist_find_rank (rl, rank);
+            if (rlist_rnode_alloc_slots (rl, n, cores_per_slot,
+                                         &slots, result) < 0)
+                return rlist_alloc_unwind (rl, result);
+            rank = idset_next (rl->buckets[b], rank);
+        }
     }
+    if (slots != 0)
+        return rlist_alloc_unwind (rl, result);
     return result;
 }
 
 /*
  *  Allocate `slots` of size cores_per_slot from rlist `rl` and return
- *   the result. Sorts the node list by smallest available first, so that
+ *   the result. Visits nodes with smallest available first, so that
  *   we get something like "best fit". (minimize nodes used)
  */
 static struct rlist * rlist_alloc_best_fit (struct rlist *rl,
                                             int cores_per_slot,
                                             int slots)
 {
-    zlistx_set_comparator (rl->nodes, by_avail);
-    return rlist_alloc_first_fit (rl, cores_per_slot, slots);
+    return rlist_alloc_by_avail (rl, cores_per_slot, slots, true);
 }
 
 /*
  *  Allocate `slots` of size cores_per_slot from rlist `rl` and return
- *   the result. Sorts the node list by least utilized first, so that
+ *   the result. Visits nodes with least utilized first, so that
  *   we get something like "worst fit". (Spread jobs across nodes)
  */
 static struct rlist * rlist_alloc_worst_fit (struct rlist *rl,
                                              int cores_per_slot,
                                              int slots)
 {
-    zlistx_set_comparator (rl->nodes, by_used);
-    return rlist_alloc_first_fit (rl, cores_per_slot, slots);
+    return rlist_alloc_by_avail (rl, cores_per_slot, slots, false);
 }
 
 
+/*  Return a list of the first `nnodes` up nodes, least utilized first.
+ */
 static zlistx_t *rlist_get_nnodes (struct rlist *rl, int nnodes)
 {
-    struct rnode *n;
+    int i;
     zlistx_t *l = zlistx_new ();
     if (!l)
         return NULL;
-    n = zlistx_first (rl->nodes);
-    while (nnodes > 0) {
-        if (n == NULL) {
-            errno = ENOSPC;
-            goto err;
-        }
-        if (n->up) {
-            if (zlistx_add_end (l, n) < 0)
+    for (i = rl->nbuckets - 1; i >= 0 && nnodes > 0; i--) {
+        unsigned int rank;
+        if (!rl->buckets[i])
+            continue;
+        rank = idset_first (rl->buckets[i]);
+        while (rank != IDSET_INVALID_ID && nnodes > 0) {
+            if (!zlistx_add_end (l, rlist_find_rank (rl, rank)))
                 goto err;
             nnodes--;
+            rank = idset_next (rl->buckets[i], rank);
         }
-        n = zlistx_next (rl->nodes);
+    }
+    if (nnodes > 0) {
+        errno = ENOSPC;
+        goto err;
     }
     return (l);
 err:
@@ -783,12 +952,7 @@ static struct rlist *rlist_alloc_nnodes (struct rlist *rl, int nnodes,
     if (!(result = rlist_create ()))
         return NULL;
 
-    /* 1. sort rank list by used cores ascending:
-     */
-    zlistx_set_comparator (rl->nodes, by_used);
-    zlistx_sort (rl->nodes);
-
-    /* 2. get a list of the first up n nodes
+    /* 1. get a list of the first up n nodes by used cores ascending
      */
     if (!(cl = rlist_get_nnodes (rl, nnodes)))
         goto unwind;
@@ -799,7 +963,7 @@ static struct rlist *rlist_alloc_nnodes (struct rlist *rl, int nnodes,
     zlistx_set_comparator (cl, by_used);
 
     /*
-     * 3. divide slots across all nodes, placing each slot
+     * 2. divide slots across all nodes, placing each slot
      *    on most empty node first
      */
     while (slots > 0) {
@@ -849,9 +1013,6 @@ static struct rlist *rlist_try_alloc (struct rlist *rl, const char *mode,
         return NULL;
     }
 
-    /*  Reset default sort to order nodes by "rank" */
-    zlistx_set_comparator (rl->nodes, by_rank);
-
     if (nnodes > 0)
         result = rlist_alloc_nnodes (rl, nnodes, cores_per_slot, slots);
     else if (mode == NULL || strcmp (mode, "worst-fit") == 0)
@@ -919,12 +1080,15 @@ struct rlist *rlist_alloc (struct rlist *rl, const char *mode,
 
 static int rlist_free_rnode (struct rlist *rl, struct rnode *n)
 {
+    int rc;
     struct rnode *rnode = rlist_find_rank (rl, n->rank);
     if (!rnode) {
         errno = ENOENT;
         return -1;
     }
-    if (rnode_free_idset (rnode, n->ids) < 0)
+    rlist_bucket_remove (rl, rnode);
+    rc = rnode_free_idset (rnode, n->ids);
+    if (rlist_bucket_add (rl, rnode) < 0 || rc < 0)
         return -1;
     if (rnode->up)
         rl->avail += idset_count (n->ids);
@@ -933,12 +1097,15 @@ static int rlist_free_rnode (struct rlist *rl, struct rnode *n)
 
 static int rlist_alloc_rnode (struct rlist *rl, struct rnode *n)
 {
+    int rc;
     struct rnode *rnode = rlist_find_rank (rl, n->rank);
     if (!rnode) {
         errno = ENOENT;
         return -1;
     }
-    if (rnode_alloc_idset (rnode, n->avail) < 0)
+    rlist_bucket_remove (rl, rnode);
+    rc = rnode_alloc_idset (rnode, n->avail);
+    if (rlist_bucket_add (rl, rnode) < 0 || rc < 0)
         return -1;
     rl->avail -= idset_count (n->avail);
     return 0;
@@ -1012,7 +1179,10 @@ static int rlist_mark_all (struct rlist *rl, bool up)
     while (n) {
         if (n->up != up)
             count += idset_count (n->avail);
+        rlist_bucket_remove (rl, n);
         n->up = up;
+        if (rlist_bucket_add (rl, n) < 0)
+            return -1;
         n = zlistx_next (rl->nodes);
     }
     return count;
@@ -1030,7 +1200,12 @@ static int rlist_mark_state (struct rlist *rl, bool up, const char *ids)
         struct rnode *n = rlist_find_rank (rl, i);
         if (n->up != up)
             count += idset_count (n->avail);
+        rlist_bucket_remove (rl, n);
         n->up = up;
+        if (rlist_bucket_add (rl, n) < 0) {
+            idset_destroy (idset);
+            return -1;
+        }
         i = idset_next (idset, i);
     }
     idset_destroy (idset);
@@ -1044,6 +1219,8 @@ int rlist_mark_down (struct rlist *rl, const char *ids)
         count = rlist_mark_all (rl, false);
     else
         count = rlist_mark_state (rl, false, ids);
+    if (count < 0)
+        return -1;
     rl->avail -= count;
     return 0;
 }
@@ -1055,6 +1232,8 @@ int rlist_mark_up (struct rlist *rl, const char *ids)
         count = rlist_mark_all (rl, true);
     else
         count = rlist_mark_state (rl, true, ids);
+    if (count < 0)
+        return -1;
     rl->avail += count;
     return 0;
 }
@@ -24,6 +24,15 @@ struct rlist {
     int total;
     int avail;
     zlistx_t *nodes;
+
+    /*  Index of nodes by rank */
+    zhashx_t *rank_index;
+
+    /*  Up nodes grouped by number of available cores, i.e. buckets[i]
+     *   is the set of ranks with exactly i cores available.
+     */
+    struct idset **buckets;
+    int nbuckets;
 };
 
 /*  Create an empty rlist object */
@@ -37,6 +46,9 @@ int rlist_mark_down (struct rlist *rl, const char *ids);
  */
 int rlist_mark_up (struct rlist *rl, const char *ids);
 
+/*  Create a copy of rlist rl, including allocated and down resources */
+struct rlist *rlist_copy (const struct rlist *rl);
+
 /*  Create a copy of rlist rl with all cores available */
 struct rlist *rlist_copy_empty (const struct rlist *rl);
 
@@ -61,6 +61,22 @@ fail:
     return NULL;
 }
 
+struct rnode *rnode_copy (const struct rnode *orig)
+{
+    struct rnode *n = calloc (1, sizeof (*n));
+    if (n == NULL)
+        return NULL;
+    n->rank = orig->rank;
+    if (!(n->ids = idset_copy (orig->ids))
+        || !(n->avail = idset_copy (orig->avail)))
+        goto fail;
+    n->up = orig->up;
+    return (n);
+fail:
+    rnode_destroy (n);
+    return NULL;
+}
+
 struct rnode *rnode_create_count (uint32_t rank, int count)
 {
     struct rnode *n = calloc (1, sizeof (*n));
@@ -109,36 +125,26 @@ int rnode_alloc (struct rnode *n, int count, struct idset **setp)
  */
 static bool alloc_ids_valid (struct rnode *n, struct idset *ids)
 {
-    unsigned int i = idset_first (ids);
-    while (i != IDSET_INVALID_ID) {
-        if (!idset_test (n->ids, i)) {
-            errno = ENOENT;
-            return false;
-        }
-        if (!idset_test (n->avail, i)) {
-            errno = EEXIST;
-            return false;
-        }
-        i = idset_next (ids, i);
+    if (!idset_is_subset (ids, n->ids)) {
+        errno = ENOENT;
+        return false;
+    }
+    if (!idset_is_subset (ids, n->avail)) {
+        errno = EEXIST;
+        return false;
     }
     return (true);
 }
 
 int rnode_alloc_idset (struct rnode *n, struct idset *ids)
 {
-    unsigned int i;
     if (!ids) {
         errno = EINVAL;
         return -1;
     }
     if (!alloc_ids_valid (n, ids))
         return -1;
-    i = idset_first (ids);
-    while (i != IDSET_INVALID_ID) {
-        idset_clear (n->avail, i);
-        i = idset_next (ids, i);
-    }
-    return 0;
+    return idset_subtract (n->avail, ids);
 }
 
 /*
@@ -147,36 +153,26 @@ int rnode_alloc_idset (struct rnode *n, struct idset *ids)
  */
 static bool free_ids_valid (struct rnode *n, struct idset *ids)
 {
-    unsigned int i = idset_first (ids);
-    while (i != IDSET_INVALID_ID) {
-        if (!idset_test (n->ids, i)) {
-            errno = ENOENT;
-            return false;
-        }
-        if (idset_test (n->avail, i)) {
-            errno = EEXIST;
-            return false;
-        }
-        i = idset_next (ids, i);
+    if (!idset_is_subset (ids, n->ids)) {
+        errno = ENOENT;
+        return false;
+    }
+    if (idset_has_intersection (ids, n->avail)) {
+        errno = EEXIST;
+        return false;
     }
     return (true);
 }
 
 int rnode_free_idset (struct rnode *n, struct idset *ids)
 {
-    unsigned int i;
     if (!ids) {
         errno = EINVAL;
         return -1;
     }
     if (!free_ids_valid (n, ids))
         return -1;
-    i = idset_first (ids);
-    while (i != IDSET_INVALID_ID) {
-        idset_set (n->avail, i);
-        i = idset_next (ids, i);
-    }
-    return 0;
+    return idset_add (n->avail, ids);
 }
 
 int rnode_free (struct rnode *n, const char *s)
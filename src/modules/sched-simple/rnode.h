@@ -40,6 +40,11 @@ struct rnode *rnode_create (uint32_t rank, const char *ids);
  */
 struct rnode *rnode_create_count (uint32_t rank, int count);
 
+/*  Create a copy of resource node `n`, including available ids
+ *   and up/down state.
+ */
+struct rnode *rnode_copy (const struct rnode *n);
+
 /*  Destroy rnode object
  */
 void rnode_destroy (struct rnode *n);
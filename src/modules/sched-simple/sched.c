@@ -11,6 +11,7 @@
 #if HAVE_CONFIG_H
 #include "config.h"
 #endif
+#include <limits.h>
 #include <czmq.h>
 #include <flux/core.h>
 #include <flux/idset.h>
@@ -30,6 +31,14 @@ struct jobreq {
     flux_jobid_t id;
     struct jj_counts jj;
     int errnum;
+    double t_estimate;      /* reserved start time, 0 if none */
+};
+
+/*  An allocated job, tracked in backfill mode only */
+struct allocation {
+    flux_jobid_t id;
+    double expiration;      /* 0 if allocation does not expire */
+    struct rlist *alloc;
 };
 
 struct simple_sched {
@@ -43,6 +52,10 @@ struct simple_sched {
     zlistx_t *queue;        /* job queue */
     schedutil_t *util_ctx;
 
+    int backfill_depth;     /* backfill lookahead depth, 0 disables */
+    zlistx_t *allocations;  /* allocations sorted by expiration */
+    struct jobreq *reserved;/* blocked job holding reservation */
+
     flux_watcher_t *prep;
     flux_watcher_t *check;
     flux_watcher_t *idle;
@@ -61,6 +74,10 @@ static void jobreq_destructor (void **x)
     jobreq_destroy (*x);
 }
 
+/*  Default number of jobs behind a blocked job considered for backfill
+ */
+#define BACKFILL_DEPTH_DEFAULT 32
+
 #define NUMCMP(a,b) ((a)==(b)?0:((a)<(b)?-1:1))
 
 /* Taken from modules/job-manager/job.c */
@@ -75,6 +92,13 @@ static int jobreq_cmp (const void *x, const void *y)
     return rc;
 }
 
+static void jobreq_dequeue (struct simple_sched *ss, struct jobreq *job)
+{
+    if (job == ss->reserved)
+        ss->reserved = NULL;
+    zlistx_delete (ss->queue, job->handle);
+}
+
 static struct jobreq *
 jobreq_find (struct simple_sched *ss, flux_jobid_t id)
 {
@@ -110,6 +134,69 @@ err:
     return NULL;
 }
 
+static void allocation_destroy (struct allocation *a)
+{
+    if (a) {
+        rlist_destroy (a->alloc);
+        free (a);
+    }
+}
+
+static void allocation_destructor (void **x)
+{
+    allocation_destroy (*x);
+}
+
+/*  Sort allocations by expiration, with non-expiring allocations last.
+ */
+static int allocation_cmp (const void *x, const void *y)
+{
+    const struct allocation *a1 = x;
+    const struct allocation *a2 = y;
+
+    if (a1->expiration == a2->expiration)
+        return 0;
+    if (a1->expiration == 0.)
+        return 1;
+    if (a2->expiration == 0.)
+        return -1;
+    return NUMCMP (a1->expiration, a2->expiration);
+}
+
+/*  Track allocation `alloc` of job `id`. On success, `alloc` is owned
+ *   by the allocations list.
+ */
+static int allocation_add (struct simple_sched *ss,
+                           flux_jobid_t id,
+                           double expiration,
+                           struct rlist *alloc)
+{
+    struct allocation *a = calloc (1, sizeof (*a));
+    if (!a)
+        return -1;
+    a->id = id;
+    a->expiration = expiration;
+    if (!zlistx_insert (ss->allocations, a, false)) {
+        free (a);
+        errno = ENOMEM;
+        return -1;
+    }
+    a->alloc = alloc;
+    return 0;
+}
+
+static void allocation_remove (struct simple_sched *ss, flux_jobid_t id)
+{
+    struct allocation *a = zlistx_first (ss->allocations);
+    while (a) {
+        if (a->id == id) {
+            zlistx_delete (ss->allocations, zlistx_cursor (ss->allocations));
+            return;
+        }
+        a = zlistx_next (ss->allocations);
+    }
+}
+
 static void simple_sched_destroy (flux_t *h, struct simple_sched *ss)
 {
     struct jobreq *job = zlistx_first (ss->queue);
@@ -119,6 +206,7 @@ static void simple_sched_destroy (flux_t *h, struct simple_sched *ss)
     }
     flux_future_destroy (ss->acquire_f);
     zlistx_destroy (&ss->queue);
+    zlistx_destroy (&ss->allocations);
     flux_watcher_destroy (ss->prep);
     flux_watcher_destroy (ss->check);
     flux_watcher_destroy (ss->idle);
@@ -177,10 +265,77 @@ out:
     return (s);
 }
 
+/*  Return the expiration of allocation R, or 0 if there is none.
+ */
+static double R_expiration (const char *R)
+{
+    json_t *o;
+    double expiration = 0.;
+
+    if ((o = json_loads (R, 0, NULL))) {
+        (void) json_unpack (o, "{s:{s?F}}",
+                            "execution",
+                             "expiration", &expiration);
+        json_decref (o);
+    }
+    return expiration;
+}
+
+/*  Respond to the alloc request for `job` with allocation `alloc`, which
+ *   becomes owned by the scheduler, and remove `job` from the queue.
+ */
+static void alloc_respond_success (flux_t *h,
+                                   struct simple_sched *ss,
+                                   struct jobreq *job,
+                                   struct rlist *alloc,
+                                   const char *R,
+                                   double now)
+{
+    int rc;
+    char *s = rlist_dumps (alloc);
+
+    /*  Clear any reservation estimate published while job was blocked
+     */
+    if (job->t_estimate > 0.)
+        rc = schedutil_alloc_respond_success_pack (ss->util_ctx,
+                                                   job->msg,
+                                                   R,
+                                                   "{ s:{s:s s:n} }",
+                                                   "sched",
+                                                   "resource_summary", s,
+                                                   "t_estimate");
+    else
+        rc = schedutil_alloc_respond_success_pack (ss->util_ctx,
+                                                   job->msg,
+                                                   R,
+                                                   "{ s:{s:s} }",
+                                                   "sched",
+                                                   "resource_summary", s);
+    if (rc < 0)
+        flux_log_error (h, "schedutil_alloc_respond_success_pack");
+
+    flux_log (h, LOG_DEBUG, "alloc: %ju: %s", (uintmax_t) job->id, s);
+    free (s);
+
+    if (ss->backfill_depth > 0) {
+        double duration = job->jj.duration;
+        if (allocation_add (ss,
+                            job->id,
+                            duration > 0. ? now + duration : 0.,
+                            alloc) < 0) {
+            flux_log_error (h, "alloc: %ju: allocation_add",
+                            (uintmax_t) job->id);
+            rlist_destroy (alloc);
+        }
+    }
+    else
+        rlist_destroy (alloc);
+    jobreq_dequeue (ss, job);
+}
+
 static int try_alloc (flux_t *h, struct simple_sched *ss)
 {
     int rc = -1;
-    char *s = NULL;
     struct rlist *alloc = NULL;
     struct jj_counts *jj = NULL;
     char *R = NULL;
@@ -201,7 +356,6 @@ static int try_alloc (flux_t *h, struct simple_sched *ss)
             if (rlist_free (ss->rlist, alloc) < 0)
                 flux_log_error (h, "try_alloc: rlist_free");
             rlist_destroy (alloc);
-            alloc = NULL;
         } else if (errno == ENOSPC)
             return rc;
         else if (errno == EOVERFLOW)
@@ -210,28 +364,201 @@ static int try_alloc (flux_t *h, struct simple_sched *ss)
                                           job->msg,
                                           note) < 0)
             flux_log_error (h, "schedutil_alloc_respond_deny");
-        goto out;
+        jobreq_dequeue (ss, job);
+        return rc;
     }
-    s = rlist_dumps (alloc);
+    alloc_respond_success (h, ss, job, alloc, R, now);
+    free (R);
+    return 0;
+}
 
-    if (schedutil_alloc_respond_success_pack (ss->util_ctx,
-                                              job->msg,
-                                              R,
-                                              "{ s:{s:s} }",
-                                              "sched", "resource_summary", s) < 0)
-        flux_log_error (h, "schedutil_alloc_respond_success_pack");
+/*  Return true if `job` can be allocated at time `t`, assuming that all
+ *   allocations expiring at or before `t` have been freed.
+ */
+static bool reservation_fits (struct simple_sched *ss,
+                              struct jobreq *job,
+                              double t)
+{
+    bool result = false;
+    struct rlist *rl;
+    struct rlist *alloc;
+    struct allocation *a;
+    struct jj_counts *jj = &job->jj;
+
+    if (!(rl = rlist_copy (ss->rlist)))
+        return false;
+    a = zlistx_first (ss->allocations);
+    while (a && a->expiration > 0. && a->expiration <= t) {
+        if (rlist_free (rl, a->alloc) < 0)
+            goto out;
+        a = zlistx_next (ss->allocations);
+    }
+    if ((alloc = rlist_alloc (rl, ss->mode,
+                              jj->nnodes, jj->nslots, jj->slot_size))) {
+        rlist_destroy (alloc);
+        result = true;
+    }
+out:
+    rlist_destroy (rl);
+    return result;
+}
 
-    flux_log (h, LOG_DEBUG, "alloc: %ju: %s", (uintmax_t) job->id, s);
-    rc = 0;
+/*  Find the earliest time at which `job` can be allocated by freeing
+ *   current allocations in order of expiration.
+ *  Returns 0 with the start time in `tp` on success, or -1 with errno
+ *   set to ENOSPC if no start time can be determined, e.g. because
+ *   resources needed by `job` are held by allocations with no expiration.
+ */
+static int reservation_find (struct simple_sched *ss,
+                             struct jobreq *job,
+                             double *tp)
+{
+    int rc = -1;
+    struct rlist *rl;
+    struct rlist *alloc;
+    struct allocation *a;
+    struct jj_counts *jj = &job->jj;
 
+    if (!(rl = rlist_copy (ss->rlist)))
+        return -1;
+    a = zlistx_first (ss->allocations);
+    while (a && a->expiration > 0.) {
+        double expiration = a->expiration;
+
+        /*  Free all allocations with this expiration before trying
+         */
+        while (a && a->expiration == expiration) {
+            if (rlist_free (rl, a->alloc) < 0)
+                goto out;
+            a = zlistx_next (ss->allocations);
+        }
+        if ((alloc = rlist_alloc (rl, ss->mode,
+                                  jj->nnodes, jj->nslots, jj->slot_size))) {
+            rlist_destroy (alloc);
+            *tp = expiration;
+            rc = 0;
+            goto out;
+        }
+        if (errno != ENOSPC)
+            goto out;
+    }
+    errno = ENOSPC;
 out:
-    zlistx_delete (ss->queue, job->handle);
-    rlist_destroy (alloc);
-    free (R);
-    free (s);
+    rlist_destroy (rl);
     return rc;
 }
 
+/*  Publish estimated start time `t` for pending job, or clear it if t == 0.
+ */
+static void jobreq_set_estimate (struct simple_sched *ss,
+                                 struct jobreq *job,
+                                 double t)
+{
+    int rc;
+
+    if (job->t_estimate == t)
+        return;
+    if (t > 0.)
+        rc = schedutil_alloc_respond_annotate_pack (ss->util_ctx,
+                                                    job->msg,
+                                                    "{ s:{s:f} }",
+                                                    "sched",
+                                                    "t_estimate", t);
+    else
+        rc = schedutil_alloc_respond_annotate_pack (ss->util_ctx,
+                                                    job->msg,
+                                                    "{ s:{s:n} }",
+                                                    "sched",
+                                                    "t_estimate");
+    if (rc < 0)
+        flux_log_error (ss->h, "schedutil_alloc_respond_annotate_pack");
+    job->t_estimate = t;
+}
+
+/*  Move the reservation to `job` with start time `t`.
+ */
+static void reservation_update (struct simple_sched *ss,
+                                struct jobreq *job,
+                                double t)
+{
+    if (ss->reserved && ss->reserved != job)
+        jobreq_set_estimate (ss, ss->reserved, 0.);
+    ss->reserved = job;
+    jobreq_set_estimate (ss, job, t);
+}
+
+/*  Allocate `job` now if it does not delay the reservation of `head`
+ *   at time `t_start`, i.e. it completes before `t_start`, or the
+ *   resources it uses are not needed by `head`.
+ */
+static int try_backfill_job (flux_t *h,
+                             struct simple_sched *ss,
+                             struct jobreq *head,
+                             struct jobreq *job,
+                             double now,
+                             double t_start)
+{
+    struct rlist *alloc;
+    char *R;
+    struct jj_counts *jj = &job->jj;
+
+    if (!(alloc = rlist_alloc (ss->rlist, ss->mode,
+                               jj->nnodes, jj->nslots, jj->slot_size)))
+        return -1;
+    if (!(jj->duration > 0. && now + jj->duration <= t_start)
+        && !reservation_fits (ss, head, t_start))
+        goto undo;
+    if (!(R = Rstring_create (alloc, now, jj->duration))) {
+        flux_log (h, LOG_ERR, "backfill: error generating R");
+        goto undo;
+    }
+    flux_log (h, LOG_DEBUG, "backfill: %ju", (uintmax_t) job->id);
+    alloc_respond_success (h, ss, job, alloc, R, now);
+    free (R);
+    return 0;
+undo:
+    if (rlist_free (ss->rlist, alloc) < 0)
+        flux_log_error (h, "backfill: rlist_free");
+    rlist_destroy (alloc);
+    return -1;
+}
+
+/*  EASY backfill: the blocked job at the head of the queue reserves
+ *   resources at the earliest time they are known to become free, and
+ *   up to backfill_depth jobs behind it may be allocated now if they do
+ *   not delay that reservation.
+ */
+static void try_backfill (flux_t *h, struct simple_sched *ss)
+{
+    struct jobreq *head = zlistx_first (ss->queue);
+    struct jobreq *job;
+    double now = flux_reactor_now (flux_get_reactor (h));
+    double t_start;
+    int depth = 0;
+
+    if (!head)
+        return;
+    if (reservation_find (ss, head, &t_start) < 0) {
+        if (errno != ENOSPC)
+            flux_log_error (h, "backfill: reservation_find");
+        reservation_update (ss, head, 0.);
+        return;
+    }
+    if (head->t_estimate != t_start)
+        flux_log (h, LOG_DEBUG, "reserve: %ju: start=%.1f",
+                  (uintmax_t) head->id, t_start);
+    reservation_update (ss, head, t_start);
+
+    job = zlistx_next (ss->queue);
+    while (job && depth++ < ss->backfill_depth) {
+        /*  Advance cursor first, since job may be removed from queue
+         */
+        struct jobreq *next = zlistx_next (ss->queue);
+        (void) try_backfill_job (h, ss, head, job, now, t_start);
+        job = next;
+    }
+}
+
 static void prep_cb (flux_reactor_t *r, flux_watcher_t *w,
                      int revents, void *arg)
 {
@@ -253,8 +580,11 @@ static void check_cb (flux_reactor_t *r, flux_watcher_t *w,
     /* See if we can fulfill alloc for a pending job
      * If current head of queue can't be allocated, stop the prep
      *  watcher, i.e. block. O/w, retry on next loop.
+     * In backfill mode, try jobs behind a blocked head before blocking.
      */
     if (try_alloc (ss->h, ss) < 0 && errno == ENOSPC) {
+        if (ss->backfill_depth > 0)
+            try_backfill (ss->h, ss);
         flux_watcher_stop (ss->prep);
         flux_watcher_stop (ss->check);
     }
@@ -282,12 +612,16 @@ static int try_free (flux_t *h, struct simple_sched *ss, const char *R)
 void free_cb (flux_t *h, const flux_msg_t *msg, const char *R, void *arg)
 {
     struct simple_sched *ss = arg;
+    flux_jobid_t id;
 
     if (try_free (h, ss, R) < 0) {
         if (flux_respond_error (h, msg, errno, NULL) < 0)
             flux_log_error (h, "free_cb: flux_respond_error");
         return;
     }
+    if (ss->backfill_depth > 0
+        && schedutil_free_request_decode (msg, &id) == 0)
+        allocation_remove (ss, id);
     if (schedutil_free_respond (ss->util_ctx, msg) < 0)
         flux_log_error (h, "free_cb: schedutil_free_respond");
 
@@ -348,7 +682,7 @@ static void cancel_cb (flux_t *h,
             flux_log_error (h, "alloc_respond_cancel");
             return;
         }
-        zlistx_delete (ss->queue, job->handle);
+        jobreq_dequeue (ss, job);
     }
 }
 
@@ -372,8 +706,15 @@ static int hello_cb (flux_t *h,
     s = rlist_dumps (alloc);
     if ((rc = rlist_set_allocated (ss->rlist, alloc)) < 0)
         flux_log_error (h, "hello: rlist_remove (%s)", s);
-    else
+    else {
         flux_log (h, LOG_DEBUG, "hello: alloc %s", s);
+        if (ss->backfill_depth > 0) {
+            if (allocation_add (ss, id, R_expiration (R), alloc) < 0)
+                flux_log_error (h, "hello: allocation_add");
+            else
+                alloc = NULL;
+        }
+    }
     free (s);
     rlist_destroy (alloc);
     return 0;
@@ -595,11 +936,35 @@ static int process_args (flux_t *h, struct simple_sched *ss,
         else if (strcmp ("sched-PUs", argv[i]) == 0) {
             ss->sched_pus = true;
         }
+        else if (strcmp ("backfill", argv[i]) == 0) {
+            ss->backfill_depth = BACKFILL_DEPTH_DEFAULT;
+        }
+        else if (strncmp ("backfill=", argv[i], 9) == 0) {
+            char *endptr;
+            long depth;
+
+            errno = 0;
+            depth = strtol (argv[i]+9, &endptr, 10);
+            if (errno != 0
+                || *endptr != '\0'
+                || depth <= 0
+                || depth > INT_MAX) {
+                flux_log (h, LOG_ERR, "invalid backfill depth: %s",
+                          argv[i]+9);
+                errno = EINVAL;
+                return -1;
+            }
+            ss->backfill_depth = depth;
+        }
         else {
             flux_log_error (h, "Unknown module option: '%s'", argv[i]);
             return -1;
         }
     }
+    /*  Backfill requires visibility of jobs behind the head of the queue
+     */
+    if (ss->backfill_depth > 0)
+        ss->single = false;
     return 0;
 }
 
@@ -643,6 +1008,11 @@ int mod_main (flux_t *h, int argc, char **argv)
     zlistx_set_comparator (ss->queue, jobreq_cmp);
     zlistx_set_destructor (ss->queue, jobreq_destructor);
 
+    if (!(ss->allocations = zlistx_new ()))
+        goto done;
+    zlistx_set_comparator (ss->allocations, allocation_cmp);
+    zlistx_set_destructor (ss->allocations, allocation_destructor);
+
     /* Let `flux module load simple-sched` return before synchronous
      * initialization with resource and job-manager modules.
      */
@@ -13,6 +13,7 @@
 #include <jansson.h>
 
 #include "src/common/libtap/tap.h"
+#include "src/common/libutil/monotime.h"
 #include "rlist.h"
 
 struct testalloc {
@@ -720,6 +721,93 @@ static void test_updown ()
     rlist_destroy (rl2);
 }
 
+static void test_copy (void)
+{
+    struct rlist *rl = NULL;
+    struct rlist *copy = NULL;
+    struct rlist *alloc = NULL;
+    struct rlist *alloc2 = NULL;
+    char *R = R_create (4, 4);
+    if (!R || !(rl = rlist_from_R (R)))
+        BAIL_OUT ("rlist_from_R failed");
+    free (R);
+
+    if (!(alloc = rlist_alloc (rl, "first-fit", 0, 6, 1)))
+        BAIL_OUT ("rlist_alloc failed");
+    ok (rlist_mark_down (rl, "3") == 0,
+        "rlist_mark_down (3) works");
+
+    ok ((copy = rlist_copy (rl)) != NULL,
+        "rlist_copy works");
+    ok (copy->total == rl->total && copy->avail == rl->avail,
+        "rlist_copy: total=%d avail=%d", copy->total, copy->avail);
+    ok (copy->avail == 6,
+        "rlist_copy: allocated and down cores are not available");
+
+    ok (rlist_free (copy, alloc) == 0,
+        "rlist_free of original allocation from copy works");
+    ok (copy->avail == 12,
+        "rlist_copy: copy avail == %d", copy->avail);
+    ok (rl->avail == 4,
+        "rlist_copy: original avail unchanged == %d", rl->avail);
+
+    ok ((alloc2 = rlist_alloc (copy, "first-fit", 0, 3, 3)) != NULL,
+        "rlist_alloc from copy works");
+    ok (rlist_alloc (rl, "first-fit", 0, 3, 3) == NULL && errno == ENOSPC,
+        "same rlist_alloc from original fails with ENOSPC");
+
+    rlist_destroy (alloc);
+    rlist_destroy (alloc2);
+    rlist_destroy (copy);
+    rlist_destroy (rl);
+}
+
+/*  Time allocation and free of many small jobs on a large rlist.
+ *   Allocation and free should not scale with the number of nodes.
+ */
+static void test_timing (int nnodes, int cores, int njobs)
+{
+    const char *modes[] = { "first-fit", "best-fit", "worst-fit", NULL };
+    const char **mode;
+    struct rlist **allocs;
+    struct rlist *rl;
+    char *R;
+
+    if (!(R = R_create (nnodes, cores)) || !(rl = rlist_from_R (R)))
+        BAIL_OUT ("R_create (ranks=%d, cores=%d) failed", nnodes, cores);
+    free (R);
+    if (!(allocs = calloc (njobs, sizeof (*allocs))))
+        BAIL_OUT ("calloc failed");
+
+    for (mode = modes; *mode != NULL; mode++) {
+        struct timespec t0;
+        int i;
+        int count = 0;
+
+        monotime (&t0);
+        for (i = 0; i < njobs; i++) {
+            if ((allocs[i] = rlist_alloc (rl, *mode, 0, 1, 4)))
+                count++;
+        }
+        ok (count == njobs,
+            "timing: %s: %d allocs on %d nodes in %.3fms",
+            *mode, count, nnodes, monotime_since (t0));
+
+        monotime (&t0);
+        count = 0;
+        for (i = 0; i < njobs; i++) {
+            if (allocs[i] && rlist_free (rl, allocs[i]) == 0)
+                count++;
+            rlist_destroy (allocs[i]);
+        }
+        ok (count == njobs && rl->avail == rl->total,
+            "timing: %s: %d frees on %d nodes in %.3fms",
+            *mode, count, nnodes, monotime_since (t0));
+    }
+    free (allocs);
+    rlist_destroy (rl);
+}
+
 int main (int ac, char *av[])
 {
     plan (NO_PLAN);
@@ -733,6 +821,8 @@ int main (int ac, char *av[])
     test_issue2473 ();
     test_by_rank_coreids ();
     test_updown ();
+    test_copy ();
+    test_timing (16384, 32, 4096);
 
     done_testing ();
 }
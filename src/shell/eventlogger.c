@@ -202,6 +202,19 @@ static int append_wait (struct eventlogger *ev,
     return eventlogger_flush (ev);
 }
 
+static int eventlog_batch_add_entry (struct eventlog_batch *batch,
+                                     json_t *entry)
+{
+    if (zlist_append (batch->entries, entry) < 0)
+        return -1;
+    json_incref (entry);
+    zlist_freefn (batch->entries,
+                  entry,
+                  (zlist_free_fn *) json_decref,
+                  true);
+    return 0;
+}
+
 static int append_async (struct eventlogger *ev,
                          const char *path,
                          json_t *entry,
@@ -216,15 +229,7 @@ static int append_async (struct eventlogger *ev,
                           path,
                           entrystr) < 0)
             return -1;
-
-    if (zlist_append (batch->entries, entry) < 0)
-        return -1;
-    json_incref (entry);
-    zlist_freefn (batch->entries,
-                  entry,
-                  (zlist_free_fn *) json_decref,
-                  true);
-    return 0;
+    return eventlog_batch_add_entry (batch, entry);
 }
 
 int eventlogger_append_entry (struct eventlogger *ev,
@@ -246,6 +251,79 @@ int eventlogger_append_entry (struct eventlogger *ev,
     return rc;
 }
 
+/*  Encode all entries in the array 'entries' as one string.
+ */
+static char *entries_encode (json_t *entries)
+{
+    size_t index;
+    json_t *entry;
+    char *buf = NULL;
+    size_t len = 0;
+
+    json_array_foreach (entries, index, entry) {
+        char *entrystr;
+        size_t n;
+        char *new;
+
+        if (!(entrystr = eventlog_entry_encode (entry)))
+            goto error;
+        n = strlen (entrystr);
+        if (!(new = realloc (buf, len + n + 1))) {
+            free (entrystr);
+            errno = ENOMEM;
+            goto error;
+        }
+        buf = new;
+        memcpy (buf + len, entrystr, n + 1);
+        len += n;
+        free (entrystr);
+    }
+    return buf;
+error:
+    free (buf);
+    return NULL;
+}
+
+int eventlogger_append_entries (struct eventlogger *ev,
+                                int flags,
+                                const char *path,
+                                json_t *entries)
+{
+    struct eventlog_batch *batch;
+    size_t index;
+    json_t *entry;
+    char *entriesstr = NULL;
+    int rc = -1;
+
+    if (!ev || !path || !json_is_array (entries)) {
+        errno = EINVAL;
+        return -1;
+    }
+    if (json_array_size (entries) == 0)
+        return 0;
+    if (!(entriesstr = entries_encode (entries)))
+        return -1;
+
+    if (flags & EVENTLOGGER_FLAG_WAIT) {
+        rc = append_wait (ev, path, entriesstr);
+        goto out;
+    }
+    if (!(batch = eventlog_batch_get (ev))
+        || flux_kvs_txn_put (batch->txn,
+                             FLUX_KVS_APPEND,
+                             path,
+                             entriesstr) < 0)
+        goto out;
+    json_array_foreach (entries, index, entry) {
+        if (eventlog_batch_add_entry (batch, entry) < 0)
+            goto out;
+    }
+    rc = 0;
+out:
+    free (entriesstr);
+    return rc;
+}
+
 int eventlogger_append (struct eventlogger *ev,
                         int flags,
                         const char *path,
@@ -58,6 +58,14 @@ int eventlogger_append_entry (struct eventlogger *ev,
                               const char *path,
                               json_t *entry);
 
+/*  Append all entries in the JSON array 'entries' to the eventlog at
+ *   'path' with a single KVS append operation.
+ */
+int eventlogger_append_entries (struct eventlogger *ev,
+                                int flags,
+                                const char *path,
+                                json_t *entries);
+
 int eventlogger_set_commit_timeout (struct eventlogger *ev, double timeout);
 
 int eventlogger_flush (struct eventlogger *ev);
@@ -13,6 +13,8 @@
 #if HAVE_CONFIG_H
 #include "config.h"
 #endif
+#include <stdlib.h>
+#include <string.h>
 #include <flux/core.h>
 #include <jansson.h>
 
@@ -124,8 +126,23 @@ static char *optparse_check_and_loadfile (optparse_t *p, const char *name)
     return NULL;
 }
 
+/*  Return a copy of jobspec or R passed by job-exec in environment
+ *   variable 'name', or NULL if not set. The variable is removed from
+ *   the environment so that it is not inherited by tasks.
+ */
+static char *getenv_jobinfo (const char *name)
+{
+    const char *val;
+    char *result = NULL;
+
+    if ((val = getenv (name)) && !(result = strdup (val)))
+        shell_die_errno (1, "strdup");
+    (void) unsetenv (name);
+    return result;
+}
+
 /*  Fetch jobinfo (jobspec, R) from job-info service if not provided on
- *   command line, and parse.
+ *   command line or by job-exec, and parse.
  */
 static int shell_init_jobinfo (flux_shell_t *shell,
                                struct shell_info *info,
@@ -187,6 +204,8 @@ struct shell_info *shell_info_create (flux_shell_t *shell)
     struct shell_info *info;
     char *R = NULL;
     char *jobspec = NULL;
+    char *env_R;
+    char *env_jobspec;
     const char *per_resource = NULL;
     int per_resource_count = -1;
     int broker_rank = shell->broker_rank;
@@ -202,6 +221,19 @@ struct shell_info *shell_info_create (flux_shell_t *shell)
     jobspec = optparse_check_and_loadfile (shell->p, "jobspec");
     R = optparse_check_and_loadfile (shell->p, "resources");
 
+    /*  Otherwise use jobspec and/or R passed in environment by job-exec:
+     */
+    env_jobspec = getenv_jobinfo ("FLUX_JOB_JOBSPEC");
+    env_R = getenv_jobinfo ("FLUX_JOB_R");
+    if (!jobspec)
+        jobspec = env_jobspec;
+    else
+        free (env_jobspec);
+    if (!R)
+        R = env_R;
+    else
+        free (env_R);
+
     if (shell_init_jobinfo (shell, info, jobspec, R) < 0)
         goto error;
 
@@ -38,6 +38,13 @@
  * - In standalone mode, output is written to the shell's stdout/stderr not KVS
  * - The number of in-flight write requests on each shell is limited to
  *   shell_output_hwm, to avoid matchtag exhaustion, etc. for chatty tasks.
+ * - Each shell coalesces task output into a batch, sent as a single write
+ *   request of the form {"data":[ioencode,...]} when output.send-size
+ *   bytes of data are buffered or output.send-timeout seconds after the
+ *   first output was buffered, whichever comes first.  Outstanding output
+ *   is sent at shell_output_destroy().
+ * - The leader appends each batch received to the output eventlog with
+ *   a single KVS append, and writes file output with writev(2).
  */
 
 #if HAVE_CONFIG_H
@@ -45,6 +52,7 @@
 #endif
 #include <stdio.h>
 #include <string.h>
+#include <sys/uio.h>
 #include <jansson.h>
 #include <flux/core.h>
 
@@ -78,6 +86,11 @@ struct shell_output {
     flux_shell_t *shell;
     struct eventlogger *ev;
     double batch_timeout;
+    double send_timeout;
+    int send_size;
+    json_t *send_batch;
+    int send_bytes;
+    flux_watcher_t *send_timer;
     int refcount;
     int eof_pending;
     zlist_t *pending_writes;
@@ -93,6 +106,13 @@ struct shell_output {
 static const int shell_output_lwm = 100;
 static const int shell_output_hwm = 1000;
 
+static const double shell_output_send_timeout = 0.05;
+static const int shell_output_send_size = 65536;
+
+/* Max number of iovecs passed to a single writev(2) of file output.
+ */
+#define SHELL_OUTPUT_IOV_MAX 64
+
 /* Pause/resume output on 'stream' of 'task'.
  */
 static void shell_output_control_task (struct shell_task *task,
@@ -312,34 +332,107 @@ static int entry_output_is_kvs (struct shell_output *out, json_t *entry)
 
 static int shell_output_kvs (struct shell_output *out)
 {
+    json_t *entries;
     json_t *entry;
     size_t index;
+    int rc = -1;
+
+    if (!(entries = json_array ()))
+        return shell_log_errn (ENOMEM, "json_array");
     json_array_foreach (out->output, index, entry) {
-        if (entry_output_is_kvs (out, entry) &&
-            eventlogger_append_entry (out->ev, 0, "output", entry) < 0) {
-            return shell_log_errno ("eventlogger_append");
+        if (entry_output_is_kvs (out, entry)
+            && json_array_append (entries, entry) < 0) {
+            shell_log_errn (ENOMEM, "json_array_append");
+            goto out;
         }
     }
-    return 0;
+    if (eventlogger_append_entries (out->ev, 0, "output", entries) < 0) {
+        shell_log_errno ("eventlogger_append_entries");
+        goto out;
+    }
+    rc = 0;
+out:
+    json_decref (entries);
+    return rc;
 }
 
-static int shell_output_write_fd (int fd, const void *buf, size_t len)
+/* File output pending a writev(2) to 'fd'.  Each iov_base was allocated
+ * with malloc and is freed once written.
+ */
+struct shell_output_iov {
+    int fd;
+    int iovcnt;
+    struct iovec iov[SHELL_OUTPUT_IOV_MAX];
+};
+
+static int shell_output_writev_fd (int fd, struct iovec *iov, int iovcnt)
 {
-    size_t count = 0;
-    int n = 0;
-    while (count < len) {
-        if ((n = write (fd, buf + count, len - count)) < 0) {
+    ssize_t n;
+
+    while (iovcnt > 0) {
+        if ((n = writev (fd, iov, iovcnt)) < 0) {
             if (errno != EINTR)
                 return -1;
             continue;
         }
-        count += n;
+        while (iovcnt > 0 && (size_t)n >= iov->iov_len) {
+            n -= iov->iov_len;
+            iov++;
+            iovcnt--;
+        }
+        if (iovcnt > 0) {
+            iov->iov_base = (char *)iov->iov_base + n;
+            iov->iov_len -= n;
+        }
+    }
+    return 0;
+}
+
+static int shell_output_iov_flush (struct shell_output_iov *v)
+{
+    struct iovec iov[SHELL_OUTPUT_IOV_MAX];
+    int saved_errno;
+    int rc;
+    int i;
+
+    /* Write from a copy, since a short write adjusts iov_base.
+     */
+    memcpy (iov, v->iov, v->iovcnt * sizeof (iov[0]));
+    rc = shell_output_writev_fd (v->fd, iov, v->iovcnt);
+    saved_errno = errno;
+    for (i = 0; i < v->iovcnt; i++)
+        free (v->iov[i].iov_base);
+    v->iovcnt = 0;
+    errno = saved_errno;
+    return rc;
+}
+
+/* Queue 'len' bytes of 'buf' for writing to 'fd', taking ownership
+ * of 'buf'.  Pending output is written first if it is for a different fd
+ * or the iovec array is full.
+ */
+static int shell_output_iov_add (struct shell_output_iov *v,
+                                 int fd,
+                                 char *buf,
+                                 int len)
+{
+    if (v->iovcnt > 0
+        && (v->fd != fd || v->iovcnt == SHELL_OUTPUT_IOV_MAX)) {
+        if (shell_output_iov_flush (v) < 0) {
+            free (buf);
+            return -1;
+        }
     }
-    return n;
+    v->fd = fd;
+    v->iov[v->iovcnt].iov_base = buf;
+    v->iov[v->iovcnt].iov_len = len;
+    v->iovcnt++;
+    return 0;
 }
 
 static int shell_output_file (struct shell_output *out)
 {
+    struct shell_output_iov v = { .fd = -1, .iovcnt = 0 };
     json_t *entry;
     size_t index;
 
@@ -348,7 +441,7 @@ static int shell_output_file (struct shell_output *out)
         const char *name;
         if (eventlog_entry_parse (entry, NULL, &name, &context) < 0) {
             shell_log_errno ("eventlog_entry_parse");
-            return -1;
+            goto error;
         }
         if (!strcmp (name, "data")) {
             struct shell_output_type_file *ofp;
@@ -359,7 +452,7 @@ static int shell_output_file (struct shell_output *out)
             int len = 0;
             if (iodecode (context, &stream, &rank, &data, &len, NULL) < 0) {
                 shell_log_errno ("iodecode");
-                return -1;
+                goto error;
             }
             if (!strcmp (stream, "stdout")) {
                 output_type = out->stdout_type;
@@ -373,24 +466,38 @@ static int shell_output_file (struct shell_output *out)
                 if (ofp->label) {
                     char *buf = NULL;
                     int buflen;
-                    if ((buflen = asprintf (&buf, "%s: ", rank)) < 0)
-                        return -1;
-                    if (shell_output_write_fd (ofp->fdp->fd, buf, buflen) < 0) {
-                        free (buf);
-                        return -1;
+                    if ((buflen = asprintf (&buf, "%s: ", rank)) < 0) {
+                        free (data);
+                        goto error;
+                    }
+                    if (shell_output_iov_add (&v, ofp->fdp->fd,
+                                              buf, buflen) < 0) {
+                        free (data);
+                        goto error;
                     }
-                    free (buf);
                 }
-                if (shell_output_write_fd (ofp->fdp->fd, data, len) < 0)
-                    return -1;
+                if (shell_output_iov_add (&v, ofp->fdp->fd, data, len) < 0)
+                    goto error;
             }
-            free (data);
+            else
+                free (data);
         }
     }
+    if (v.iovcnt > 0 && shell_output_iov_flush (&v) < 0)
+        return -1;
     return 0;
+error:
+    if (v.iovcnt > 0) {
+        int saved_errno = errno;
+        int i;
+        for (i = 0; i < v.iovcnt; i++)
+            free (v.iov[i].iov_base);
+        errno = saved_errno;
+    }
+    return -1;
 }
 
-/* Convert 'iodecode' object to an valid RFC 24 data event.
+/* Convert each 'iodecode' object in a batch to a valid RFC 24 data event.
  * N.B. the iodecode object is a valid "context" for the event.
  */
 static void shell_output_write_cb (flux_t *h,
@@ -399,21 +506,32 @@ static void shell_output_write_cb (flux_t *h,
                                    void *arg)
 {
     struct shell_output *out = arg;
-    bool eof = false;
+    int eof_count = 0;
+    json_t *data;
     json_t *o;
     json_t *entry;
+    size_t index;
 
-    if (flux_request_unpack (msg, NULL, "o", &o) < 0)
-        goto error;
-    if (iodecode (o, NULL, NULL, NULL, NULL, &eof) < 0)
+    if (flux_request_unpack (msg, NULL, "{s:o}", "data", &data) < 0)
         goto error;
-    if (!(entry = eventlog_entry_pack (0., "data", "O", o))) // increfs 'o'
-        goto error;
-    if (json_array_append_new (out->output, entry) < 0) {
-        json_decref (entry);
-        errno = ENOMEM;
+    if (!json_is_array (data)) {
+        errno = EPROTO;
         goto error;
     }
+    json_array_foreach (data, index, o) {
+        bool eof = false;
+        if (iodecode (o, NULL, NULL, NULL, NULL, &eof) < 0)
+            goto error;
+        if (!(entry = eventlog_entry_pack (0., "data", "O", o))) // increfs 'o'
+            goto error;
+        if (json_array_append_new (out->output, entry) < 0) {
+            json_decref (entry);
+            errno = ENOMEM;
+            goto error;
+        }
+        if (eof)
+            eof_count++;
+    }
     /* Error failing to commit is a fatal error.  Should be cleaner in
      * future. Issue #2378 */
     if ((out->stdout_type == FLUX_OUTPUT_TYPE_TERM
@@ -435,8 +553,9 @@ static void shell_output_write_cb (flux_t *h,
         shell_log_error ("json_array_clear failed");
         goto error;
     }
-    if (eof) {
-        if (--out->eof_pending == 0) {
+    if (eof_count > 0) {
+        out->eof_pending -= eof_count;
+        if (out->eof_pending == 0) {
             flux_msg_handler_stop (mh);
             if (flux_shell_remove_completion_ref (out->shell, "output.write") < 0)
                 shell_log_errno ("flux_shell_remove_completion_ref");
@@ -455,6 +574,7 @@ static void shell_output_write_cb (flux_t *h,
 error:
     if (flux_respond_error (out->shell->h, msg, errno, NULL) < 0)
         shell_log_errno ("flux_respond");
+    (void)json_array_clear (out->output);
 }
 
 static void shell_output_write_completion (flux_future_t *f, void *arg)
@@ -470,30 +590,34 @@ static void shell_output_write_completion (flux_future_t *f, void *arg)
         shell_output_control (out, false);
 }
 
-static int shell_output_write (struct shell_output *out,
-                               int rank,
-                               const char *stream,
-                               const char *data,
-                               int len,
-                               bool eof)
+/* Send the current batch of output to the leader shell.
+ */
+static int shell_output_send (struct shell_output *out)
 {
     flux_future_t *f = NULL;
-    json_t *o = NULL;
-    char rankstr[64];
+    json_t *batch = out->send_batch;
 
-    snprintf (rankstr, sizeof (rankstr), "%d", rank);
-    if (!(o = ioencode (stream, rankstr, data, len, eof))) {
-        shell_log_errno ("ioencode");
+    if (json_array_size (batch) == 0)
+        return 0;
+    flux_watcher_stop (out->send_timer);
+    if (!(out->send_batch = json_array ())) {
+        out->send_batch = batch;
+        errno = ENOMEM;
         return -1;
     }
-
-    if (!(f = flux_shell_rpc_pack (out->shell, "write", 0, 0, "O", o)))
+    out->send_bytes = 0;
+
+    if (!(f = flux_shell_rpc_pack (out->shell,
+                                   "write",
+                                   0,
+                                   0,
+                                   "{s:o}",
+                                   "data", batch)))
         goto error;
     if (flux_future_then (f, -1, shell_output_write_completion, out) < 0)
         goto error;
     if (zlist_append (out->pending_writes, f) < 0)
         shell_log_error ("zlist_append failed");
-    json_decref (o);
 
     if (zlist_size (out->pending_writes) >= shell_output_hwm)
         shell_output_control (out, true);
@@ -501,10 +625,55 @@ static int shell_output_write (struct shell_output *out,
 
 error:
     flux_future_destroy (f);
-    json_decref (o);
     return -1;
 }
 
+static void shell_output_send_timer_cb (flux_reactor_t *r,
+                                        flux_watcher_t *w,
+                                        int revents,
+                                        void *arg)
+{
+    struct shell_output *out = arg;
+
+    if (shell_output_send (out) < 0)
+        shell_log_errno ("shell_output_send");
+}
+
+/* Add output to the current batch.  The batch is sent once it holds
+ * send_size bytes of data, otherwise send_timeout after the first output
+ * was added.
+ */
+static int shell_output_write (struct shell_output *out,
+                               int rank,
+                               const char *stream,
+                               const char *data,
+                               int len,
+                               bool eof)
+{
+    json_t *o = NULL;
+    char rankstr[64];
+
+    snprintf (rankstr, sizeof (rankstr), "%d", rank);
+    if (!(o = ioencode (stream, rankstr, data, len, eof))) {
+        shell_log_errno ("ioencode");
+        return -1;
+    }
+    if (json_array_append_new (out->send_batch, o) < 0) {
+        json_decref (o);
+        errno = ENOMEM;
+        return -1;
+    }
+    out->send_bytes += len;
+
+    if (out->send_bytes >= out->send_size || out->send_timeout == 0.)
+        return shell_output_send (out);
+    if (json_array_size (out->send_batch) == 1) {
+        flux_timer_watcher_reset (out->send_timer, out->send_timeout, 0.);
+        flux_watcher_start (out->send_timer);
+    }
+    return 0;
+}
+
 static void shell_output_type_file_cleanup (struct shell_output_type_file *ofp)
 {
     if (ofp->path)
@@ -515,6 +684,12 @@ void shell_output_destroy (struct shell_output *out)
 {
     if (out) {
         int saved_errno = errno;
+        if (out->send_batch && out->pending_writes) {
+            if (shell_output_send (out) < 0)
+                shell_log_errno ("shell_output_send");
+        }
+        json_decref (out->send_batch);
+        flux_watcher_destroy (out->send_timer);
         if (out->pending_writes) {
             flux_future_t *f;
 
@@ -874,6 +1049,41 @@ static int output_eventlogger_start (struct shell_output *out)
     return 0;
 }
 
+static int shell_output_send_setup (struct shell_output *out)
+{
+    flux_reactor_t *r = flux_get_reactor (out->shell->h);
+
+    out->send_timeout = shell_output_send_timeout;
+    out->send_size = shell_output_send_size;
+
+    if (flux_shell_getopt_unpack (out->shell,
+                                  "output",
+                                  "{s?F s?i}",
+                                  "send-timeout", &out->send_timeout,
+                                  "send-size", &out->send_size) < 0)
+        return shell_log_errno ("invalid output.send-timeout/send-size option");
+    if (out->send_timeout < 0. || out->send_size < 0)
+        return shell_log_errn (EINVAL,
+                               "output.send-timeout and send-size"
+                               " must not be negative");
+
+    shell_debug ("send timeout = %.3fs, send size = %d",
+                 out->send_timeout,
+                 out->send_size);
+
+    if (!(out->send_batch = json_array ())) {
+        errno = ENOMEM;
+        return -1;
+    }
+    if (!(out->send_timer = flux_timer_watcher_create (r,
+                                                       out->send_timeout,
+                                                       0.,
+                                                       shell_output_send_timer_cb,
+                                                       out)))
+        return -1;
+    return 0;
+}
+
 struct shell_output *shell_output_create (flux_shell_t *shell)
 {
     struct shell_output *out;
@@ -895,6 +1105,8 @@ struct shell_output *shell_output_create (flux_shell_t *shell)
 
     if (!(out->pending_writes = zlist_new ()))
         goto error;
+    if (shell_output_send_setup (out) < 0)
+        goto error;
     if (shell->info->shell_rank == 0) {
         if (output_type_requires_service (out->stdout_type)
             || output_type_requires_service (out->stderr_type)) {
@@ -42,10 +42,17 @@
  * distributes KVS data that was "put" so that it is available to "get".
  * A local hash captures key-value pairs as they are put.  If the entire
  * job runs under one shell, the barrier is a no-op, and the gets are
- * serviced only from the cache.  Otherwise, the barrier dumps the hash
- * into a Flux KVS txn and commits it with a flux_kvs_fence(), using
- * the number of shells as "nprocs".  Gets are serviced from the cache,
- * with fall-through to a flux_kvs_lookup().
+ * serviced only from the cache.  Otherwise, by default (pmi.kvs=exchange),
+ * the barrier contributes key-value pairs put since the last barrier to
+ * a tree-based allgather among the job's shells (see pmi_exchange.c),
+ * which leaves all pairs in every shell's cache, so gets are serviced
+ * only from the cache.  The degree of the tree may be set with
+ * pmi.exchange.k (default 2).
+ *
+ * With pmi.kvs=native, the barrier instead dumps the hash into a Flux KVS
+ * txn and commits it with a flux_kvs_fence(), using the number of shells
+ * as "nprocs".  Gets are serviced from the cache, with fall-through to
+ * a flux_kvs_lookup().
  *
  * If shell->verbose is true (shell --verbose flag was provided), the
  * protocol engine emits client and server telemetry to stderr, and
@@ -57,7 +64,7 @@
  * - 64-bit Flux job id's are assigned to integer-typed PMI appnum
  * - PMI publish, unpublish, lookup, spawn are not implemented
  * - Although multiple cycles of put / barrier / get are supported, the
- *   the barrier rewrites data from previous cycles to the Flux KVS.
+ *   the native barrier rewrites data from previous cycles to the Flux KVS.
  * - PMI_Abort() is implemented as log message + exit in the client code.
  *   It does not reach this module.
  * - Teardown of the subprocess channel is deferred until task completion,
@@ -71,6 +78,7 @@
 #include <stdlib.h>
 #include <czmq.h>
 #include <assert.h>
+#include <jansson.h>
 #include <flux/core.h>
 
 #include "src/common/libpmi/simple_server.h"
@@ -79,15 +87,20 @@
 #include "builtins.h"
 #include "internal.h"
 #include "task.h"
+#include "pmi_exchange.h"
 
 #define FQ_KVS_KEY_MAX (SIMPLE_KVS_KEY_MAX + 128)
 
+static const int default_exchange_k = 2;
+
 struct shell_pmi {
     flux_shell_t *shell;
     struct pmi_simple_server *server;
     zhashx_t *kvs;
     zhashx_t *locals;
     int cycle;      // count cycles of put / barrier / get
+    struct pmi_exchange *exchange;  // NULL if using native KVS
+    json_t *pending;    // pairs put since last exchange (exchange only)
 };
 
 static void shell_pmi_abort (void *arg,
@@ -108,7 +121,16 @@ static int shell_pmi_kvs_put (void *arg,
                               const char *val)
 {
     struct shell_pmi *pmi = arg;
-
+    json_t *o;
+
+    if (pmi->exchange) {
+        if (!(o = json_string (val))
+            || json_object_set_new (pmi->pending, key, o) < 0) {
+            json_decref (o);
+            shell_log_errn (ENOMEM, "pmi kvs put");
+            return -1;
+        }
+    }
     zhashx_update (pmi->kvs, key, (char *)val);
     return 0;
 }
@@ -150,8 +172,9 @@ static int shell_pmi_kvs_key (char *buf,
 }
 
 /* Lookup a key: first try the local hash.   If that fails and the
- * job spans multiple shells, do a KVS lookup in the job's private
- * KVS namespace and handle the response in kvs_lookup_continuation().
+ * job spans multiple shells using the native KVS, do a KVS lookup in the
+ * job's private KVS namespace and handle the response in
+ * kvs_lookup_continuation().
  */
 static int shell_pmi_kvs_get (void *arg,
                               void *cli,
@@ -166,7 +189,7 @@ static int shell_pmi_kvs_get (void *arg,
         pmi_simple_server_kvs_get_complete (pmi->server, cli, val);
         return 0;
     }
-    if (pmi->shell->info->shell_size > 1) {
+    if (pmi->shell->info->shell_size > 1 && !pmi->exchange) {
         char nkey[FQ_KVS_KEY_MAX];
         flux_future_t *f = NULL;
 
@@ -207,6 +230,37 @@ static void kvs_fence_continuation (flux_future_t *f, void *arg)
     flux_future_destroy (f);
 }
 
+static void exchange_cb (struct pmi_exchange *pex, void *arg)
+{
+    struct shell_pmi *pmi = arg;
+    const json_t *dict;
+    const char *key;
+    json_t *val;
+    int rc = -1;
+
+    if (pmi_exchange_has_error (pex)
+        || !(dict = pmi_exchange_get_dict (pex)))
+        goto done;
+    json_object_foreach ((json_t *)dict, key, val) {
+        const char *s = json_string_value (val);
+        if (s)
+            zhashx_update (pmi->kvs, key, (char *)s);
+    }
+    rc = 0;
+done:
+    pmi_simple_server_barrier_complete (pmi->server, rc);
+}
+
+static int shell_pmi_barrier_exchange (struct shell_pmi *pmi)
+{
+    if (pmi_exchange (pmi->exchange, pmi->pending, exchange_cb, pmi) < 0) {
+        shell_log_errno ("pmi_exchange");
+        return -1; // cause PMI_Barrier() to fail
+    }
+    json_object_clear (pmi->pending);
+    return 0;
+}
+
 static int shell_pmi_barrier_enter (void *arg)
 {
     struct shell_pmi *pmi = arg;
@@ -222,6 +276,8 @@ static int shell_pmi_barrier_enter (void *arg)
         pmi_simple_server_barrier_complete (pmi->server, 0);
         return 0;
     }
+    if (pmi->exchange)
+        return shell_pmi_barrier_exchange (pmi);
     snprintf (name, sizeof (name), "pmi.%ju.%d",
              (uintmax_t)pmi->shell->jobid,
              pmi->cycle++);
@@ -398,6 +454,8 @@ static void pmi_destroy (struct shell_pmi *pmi)
     if (pmi) {
         int saved_errno = errno;
         pmi_simple_server_destroy (pmi->server);
+        pmi_exchange_destroy (pmi->exchange);
+        json_decref (pmi->pending);
         zhashx_destroy (&pmi->kvs);
         zhashx_destroy (&pmi->locals);
         free (pmi);
@@ -433,6 +491,40 @@ static struct pmi_simple_ops shell_pmi_ops = {
 };
 
 
+/* Set up the tree-based exchange unless pmi.kvs=native was specified.
+ */
+static int init_exchange (struct shell_pmi *pmi)
+{
+    flux_shell_t *shell = pmi->shell;
+    const char *kvs = "exchange";
+    int k = default_exchange_k;
+
+    if (flux_shell_getopt_unpack (shell,
+                                  "pmi",
+                                  "{s?s s?{s?i}}",
+                                  "kvs", &kvs,
+                                  "exchange", "k", &k) < 0)
+        return shell_log_errn (EINVAL, "invalid pmi shell option");
+    if (!strcmp (kvs, "native"))
+        return 0;
+    if (strcmp (kvs, "exchange") != 0)
+        return shell_log_errn (EINVAL, "unknown pmi.kvs type '%s'", kvs);
+    if (k < 1)
+        return shell_log_errn (EINVAL, "pmi.exchange.k must be at least 1");
+    if (shell->info->shell_size == 1)
+        return 0;
+    if (!(pmi->exchange = pmi_exchange_create (shell, k))) {
+        shell_log_errno ("pmi_exchange_create");
+        return -1;
+    }
+    if (!(pmi->pending = json_object ())) {
+        errno = ENOMEM;
+        return -1;
+    }
+    shell_debug ("pmi: using exchange with k=%d", k);
+    return 0;
+}
+
 static struct shell_pmi *pmi_create (flux_shell_t *shell)
 {
     struct shell_pmi *pmi;
@@ -443,6 +535,8 @@ static struct shell_pmi *pmi_create (flux_shell_t *shell)
     if (!(pmi = calloc (1, sizeof (*pmi))))
         return NULL;
     pmi->shell = shell;
+    if (init_exchange (pmi) < 0)
+        goto error;
 
     /* Use F58 representation of jobid for "kvsname", since the broker
      * will pull the kvsname and use it as the broker 'jobid' attribute.
@@ -0,0 +1,273 @@
+/************************************************************\
+ * Copyright 2026 Lawrence Livermore National Security, LLC
+ * (c.f. AUTHORS, NOTICE.LLNS, COPYING)
+ *
+ * This file is part of the Flux resource manager framework.
+ * For details, see https://github.com/flux-framework.
+ *
+ * SPDX-License-Identifier: LGPL-3.0
+\************************************************************/
+
+/* pmi_exchange.c - allgather PMI key-value pairs among the job's shells
+ *
+ * Shells are arranged in a tree of degree k rooted at shell rank 0, where
+ * the parent of shell rank r is (r - 1) / k.  Each shell waits for its own
+ * contribution and a "pmi-exchange" request from each of its children,
+ * then sends the union of those dicts to its parent in a "pmi-exchange"
+ * request:
+ *
+ *   {"dict":{key:val,...}}
+ *
+ * Once shell rank 0 has gathered all contributions, the full dict flows
+ * back down the tree as the response to each request, in the same form.
+ *
+ * A child's request for the next exchange may arrive before the local
+ * contribution to that exchange has been made.  It is held until then.
+ */
+
+#if HAVE_CONFIG_H
+#include "config.h"
+#endif
+#include <czmq.h>
+#include <jansson.h>
+#include <flux/core.h>
+
+#include "internal.h"
+#include "info.h"
+#include "pmi_exchange.h"
+
+struct pmi_exchange {
+    flux_shell_t *shell;
+    int k;
+    int rank;               // shell rank
+    int size;               // number of shells
+    int nchildren;
+    zlist_t *requests;      // pending requests from children
+    json_t *dict;           // key-value pairs gathered so far
+    bool local;             // local contribution has been made
+    flux_future_t *f;       // pending request to parent
+    bool has_error;
+    pmi_exchange_f cb;
+    void *arg;
+};
+
+static int parent_rank (struct pmi_exchange *pex)
+{
+    return pex->rank == 0 ? -1 : (pex->rank - 1) / pex->k;
+}
+
+static int child_count (struct pmi_exchange *pex)
+{
+    int first = pex->rank * pex->k + 1;
+    int n = pex->size - first;
+
+    if (n < 0)
+        return 0;
+    return n < pex->k ? n : pex->k;
+}
+
+static void exchange_respond (struct pmi_exchange *pex)
+{
+    flux_t *h = flux_shell_get_flux (pex->shell);
+    const flux_msg_t *msg;
+
+    while ((msg = zlist_pop (pex->requests))) {
+        if (pex->has_error) {
+            if (flux_respond_error (h, msg, EIO, "PMI exchange failed") < 0)
+                shell_log_errno ("flux_respond_error");
+        }
+        else {
+            if (flux_respond_pack (h, msg, "{s:O}", "dict", pex->dict) < 0)
+                shell_log_errno ("flux_respond_pack");
+        }
+        flux_msg_decref (msg);
+    }
+}
+
+/* All contributions are in (or the exchange failed).  Send the result
+ * to children, then notify the local user and reset for the next exchange.
+ */
+static void exchange_complete (struct pmi_exchange *pex)
+{
+    pmi_exchange_f cb = pex->cb;
+    void *arg = pex->arg;
+    json_t *dict;
+
+    exchange_respond (pex);
+    flux_future_destroy (pex->f);
+    pex->f = NULL;
+    pex->local = false;
+    pex->cb = NULL;
+    pex->arg = NULL;
+
+    if (cb)
+        cb (pex, arg);
+
+    if (!(dict = json_object ()))
+        shell_log_errn (ENOMEM, "json_object");
+    else {
+        json_decref (pex->dict);
+        pex->dict = dict;
+    }
+    pex->has_error = false;
+}
+
+static void exchange_parent_continuation (flux_future_t *f, void *arg)
+{
+    struct pmi_exchange *pex = arg;
+    json_t *dict;
+
+    if (flux_rpc_get_unpack (f, "{s:o}", "dict", &dict) < 0
+        || json_object_update (pex->dict, dict) < 0) {
+        shell_log_errno ("pmi-exchange");
+        pex->has_error = true;
+    }
+    exchange_complete (pex);
+}
+
+static void exchange_try_progress (struct pmi_exchange *pex)
+{
+    if (!pex->local
+        || pex->f != NULL
+        || zlist_size (pex->requests) < pex->nchildren)
+        return;
+    if (pex->rank == 0) {
+        exchange_complete (pex);
+        return;
+    }
+    if (!(pex->f = flux_shell_rpc_pack (pex->shell,
+                                        "pmi-exchange",
+                                        parent_rank (pex),
+                                        0,
+                                        "{s:O}",
+                                        "dict", pex->dict))
+        || flux_future_then (pex->f,
+                             -1.,
+                             exchange_parent_continuation,
+                             pex) < 0) {
+        shell_log_errno ("pmi-exchange");
+        pex->has_error = true;
+        exchange_complete (pex);
+    }
+}
+
+static void exchange_request_cb (flux_t *h,
+                                 flux_msg_handler_t *mh,
+                                 const flux_msg_t *msg,
+                                 void *arg)
+{
+    struct pmi_exchange *pex = arg;
+    json_t *dict;
+
+    if (flux_request_unpack (msg, NULL, "{s:o}", "dict", &dict) < 0)
+        goto error;
+    if (zlist_size (pex->requests) == pex->nchildren) {
+        errno = EPROTO;
+        goto error;
+    }
+    if (json_object_update (pex->dict, dict) < 0) {
+        errno = ENOMEM;
+        goto error;
+    }
+    if (zlist_append (pex->requests, (void *)flux_msg_incref (msg)) < 0) {
+        flux_msg_decref (msg);
+        errno = ENOMEM;
+        goto error;
+    }
+    exchange_try_progress (pex);
+    return;
+error:
+    if (flux_respond_error (h, msg, errno, NULL) < 0)
+        shell_log_errno ("flux_respond_error");
+}
+
+int pmi_exchange (struct pmi_exchange *pex,
+                  json_t *dict,
+                  pmi_exchange_f cb,
+                  void *arg)
+{
+    if (!pex || !json_is_object (dict) || !cb) {
+        errno = EINVAL;
+        return -1;
+    }
+    if (pex->local) {
+        errno = EINPROGRESS;
+        return -1;
+    }
+    if (json_object_update (pex->dict, dict) < 0) {
+        errno = ENOMEM;
+        return -1;
+    }
+    pex->local = true;
+    pex->cb = cb;
+    pex->arg = arg;
+    exchange_try_progress (pex);
+    return 0;
+}
+
+bool pmi_exchange_has_error (struct pmi_exchange *pex)
+{
+    return pex->has_error;
+}
+
+const json_t *pmi_exchange_get_dict (struct pmi_exchange *pex)
+{
+    return pex->has_error ? NULL : pex->dict;
+}
+
+void pmi_exchange_destroy (struct pmi_exchange *pex)
+{
+    if (pex) {
+        int saved_errno = errno;
+        if (pex->requests) {
+            const flux_msg_t *msg;
+            flux_t *h = flux_shell_get_flux (pex->shell);
+
+            while ((msg = zlist_pop (pex->requests))) {
+                if (flux_respond_error (h, msg, ECONNRESET, NULL) < 0)
+                    shell_log_errno ("flux_respond_error");
+                flux_msg_decref (msg);
+            }
+            zlist_destroy (&pex->requests);
+        }
+        flux_future_destroy (pex->f);
+        json_decref (pex->dict);
+        free (pex);
+        errno = saved_errno;
+    }
+}
+
+struct pmi_exchange *pmi_exchange_create (flux_shell_t *shell, int k)
+{
+    struct pmi_exchange *pex;
+
+    if (!shell || k < 1) {
+        errno = EINVAL;
+        return NULL;
+    }
+    if (!(pex = calloc (1, sizeof (*pex))))
+        return NULL;
+    pex->shell = shell;
+    pex->k = k;
+    pex->rank = shell->info->shell_rank;
+    pex->size = shell->info->shell_size;
+    pex->nchildren = child_count (pex);
+    if (!(pex->requests = zlist_new ())
+        || !(pex->dict = json_object ())) {
+        errno = ENOMEM;
+        goto error;
+    }
+    if (flux_shell_service_register (shell,
+                                     "pmi-exchange",
+                                     exchange_request_cb,
+                                     pex) < 0)
+        goto error;
+    return pex;
+error:
+    pmi_exchange_destroy (pex);
+    return NULL;
+}
+
+/*
+ * vi:tabstop=4 shiftwidth=4 expandtab
+ */
@@ -0,0 +1,46 @@
+/************************************************************\
+ * Copyright 2026 Lawrence Livermore National Security, LLC
+ * (c.f. AUTHORS, NOTICE.LLNS, COPYING)
+ *
+ * This file is part of the Flux resource manager framework.
+ * For details, see https://github.com/flux-framework.
+ *
+ * SPDX-License-Identifier: LGPL-3.0
+\************************************************************/
+
+#ifndef _SHELL_PMI_EXCHANGE_H
+#define _SHELL_PMI_EXCHANGE_H
+
+#include <jansson.h>
+#include <flux/shell.h>
+
+struct pmi_exchange;
+
+typedef void (*pmi_exchange_f)(struct pmi_exchange *pex, void *arg);
+
+/* Create an exchange among all shells of the job, using a tree of
+ * degree 'k' rooted at shell rank 0.
+ */
+struct pmi_exchange *pmi_exchange_create (flux_shell_t *shell, int k);
+void pmi_exchange_destroy (struct pmi_exchange *pex);
+
+/* Contribute 'dict', a JSON object of key-value pairs, to the exchange.
+ * 'cb' is called once the union of all shells' contributions is available
+ * via pmi_exchange_get_dict(), or the exchange has failed.
+ * Only one exchange may be in progress at a time.
+ */
+int pmi_exchange (struct pmi_exchange *pex,
+                  json_t *dict,
+                  pmi_exchange_f cb,
+                  void *arg);
+
+/* Valid in the pmi_exchange_f callback only.
+ */
+bool pmi_exchange_has_error (struct pmi_exchange *pex);
+const json_t *pmi_exchange_get_dict (struct pmi_exchange *pex);
+
+#endif /* !_SHELL_PMI_EXCHANGE_H */
+
+/*
+ * vi:tabstop=4 shiftwidth=4 expandtab
+ */
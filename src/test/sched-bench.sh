@@ -8,8 +8,8 @@ declare prog=$(basename $0)
 declare NNODES=8
 declare CPN=32
 
-declare -r long_opts="help,nnodes:,cores-per-node:,jobs:,noexec,sched-opts:verbose"
-declare -r short_opts="hvN:c:j:o:"
+declare -r long_opts="help,nnodes:,cores-per-node:,jobs:,noexec,launch,sched-opts:verbose"
+declare -r short_opts="hvN:c:j:o:L"
 declare -r usage="\
 \n\
 Usage: $prog [OPTIONS]\n\
@@ -22,7 +22,9 @@ Options:\n\
  -c, --cores-per-node=N  set simulated cores per node (default=${CPN})\n\
  -j, --jobs=NJOBS        set number of jobs to run (default nnodes*cpn)\n\
  -o, --sched-opts=OPTS   set scheduler module load options\n\
-     --noexec            do not simulate execution, just scheduling\n"
+     --noexec            do not simulate execution, just scheduling\n\
+ -L, --launch            measure job launch latency for 1,2,4..NNODES nodes\n\
+                         (requires a real instance of at least NNODES)\n"
 
 
 log() { local fmt=$1; shift; printf >&2 "$prog: $fmt" "$@"; }
@@ -39,6 +41,26 @@ log_timing_msg() {
     log "$name $NJOBS jobs in %.3fs (%.2f job/s)\n" $elapsed $jps
 }
 
+#  Print time from exec "starting" event to the job shell "shell.start"
+#   event, which covers shell startup including fetch of jobspec and R,
+#   for real jobs of 1, 2, 4, ... NNODES nodes.
+launch_latency() {
+    local size=$(flux getattr size)
+    local n=1
+    local id t
+
+    test $NNODES -le $size || die "instance size $size < $NNODES nodes\n"
+    while test $n -le $NNODES; do
+        id=$(flux mini submit -N $n -n $n true) || die "submit failed\n"
+        flux job wait-event $id clean >/dev/null
+        t=$(flux job eventlog -p guest.exec.eventlog $id | awk '
+            $2 == "starting"    { start = $1 }
+            $2 == "shell.start" { print $1 - start }')
+        log "launched %d node job in %.3fs\n" $n $t
+        n=$(($n*2))
+    done
+}
+
 GETOPTS=$(/usr/bin/getopt -u -o $short_opts -l $long_opts -n $prog -- $@)
 if test $? != 0; then
     echo  "$usage"
@@ -54,6 +76,7 @@ while true; do
       -j|--jobs)            NJOBS=$2;   shift 2 ;;
       -o|--sched-opts)      OPTS="$2";  shift 2 ;;
       --noexec)             NOEXEC=t;   shift   ;;
+      -L|--launch)          LAUNCH=t;   shift   ;;
       --)                   shift ; break ;     ;;
       -h|--help)            echo -e "$usage" ; exit 0           ;;
       *)                    die "Invalid option '$1'\n$usage"   ;;
@@ -64,6 +87,12 @@ done
 NJOBS=${NJOBS:-$((${NNODES}*${CPN}))}
 
 log "On branch $(git rev-parse --abbrev-ref HEAD): $(git describe)\n"
+
+if test "$LAUNCH" = "t"; then
+    launch_latency
+    exit 0
+fi
+
 log "starting with $NJOBS jobs across ${NNODES} nodes with ${CPN} cores/node.\n"
 log "broker.pid=$(flux getattr broker.pid)\n"
 
@@ -0,0 +1,125 @@
+/************************************************************\
+ * Copyright 2026 Lawrence Livermore National Security, LLC
+ * (c.f. AUTHORS, NOTICE.LLNS, COPYING)
+ *
+ * This file is part of the Flux resource manager framework.
+ * For details, see https://github.com/flux-framework.
+ *
+ * SPDX-License-Identifier: LGPL-3.0
+\************************************************************/
+
+/* batch - exercise content.load-batch and content.store-batch
+ *
+ * Usage: batch store FILE...
+ *        batch load BLOBREF...
+ *
+ * 'store' prints the blobref of each file.  'load' prints the blobref
+ * computed over each loaded blob, or the error, so that the output of
+ * a round trip can be compared with the input.
+ */
+
+#if HAVE_CONFIG_H
+#include "config.h"
+#endif
+#include <flux/core.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+
+#include "src/common/libutil/log.h"
+#include "src/common/libutil/blobref.h"
+#include "src/common/libutil/read_all.h"
+
+static void usage (void)
+{
+    fprintf (stderr, "Usage: batch store FILE...\n"
+                     "   or: batch load BLOBREF...\n");
+    exit (1);
+}
+
+static void store (flux_t *h, int count, char **files)
+{
+    const void **bufs;
+    int *lens;
+    flux_future_t *f;
+    const char *blobref;
+    int i;
+
+    if (!(bufs = calloc (count, sizeof (bufs[0])))
+        || !(lens = calloc (count, sizeof (lens[0]))))
+        log_msg_exit ("out of memory");
+    for (i = 0; i < count; i++) {
+        void *data;
+        int fd;
+
+        if ((fd = open (files[i], O_RDONLY)) < 0)
+            log_err_exit ("%s", files[i]);
+        if ((lens[i] = read_all (fd, &data)) < 0)
+            log_err_exit ("%s", files[i]);
+        close (fd);
+        bufs[i] = data;
+    }
+    if (!(f = flux_content_store_batch (h, bufs, lens, count, 0)))
+        log_err_exit ("flux_content_store_batch");
+    for (i = 0; i < count; i++) {
+        if (flux_content_store_batch_get (f, i, &blobref) < 0)
+            printf ("%s: %s\n", files[i], flux_strerror (errno));
+        else
+            printf ("%s\n", blobref);
+        free ((void *)bufs[i]);
+    }
+    flux_future_destroy (f);
+    free (bufs);
+    free (lens);
+}
+
+static void load (flux_t *h, int count, char **refs)
+{
+    const char *hashtype;
+    flux_future_t *f;
+    const void *data;
+    int len;
+    char blobref[BLOBREF_MAX_STRING_SIZE];
+    int i;
+
+    if (!(hashtype = flux_attr_get (h, "content.hash")))
+        log_err_exit ("content.hash");
+    if (!(f = flux_content_load_batch (h, (const char **)refs, count, 0)))
+        log_err_exit ("flux_content_load_batch");
+    for (i = 0; i < count; i++) {
+        if (flux_content_load_batch_get (f, i, &data, &len) < 0)
+            printf ("%s: %s\n", refs[i], flux_strerror (errno));
+        else {
+            if (blobref_hash (hashtype, data, len,
+                              blobref, sizeof (blobref)) < 0)
+                log_err_exit ("blobref_hash");
+            printf ("%s\n", blobref);
+        }
+    }
+    flux_future_destroy (f);
+}
+
+int main (int argc, char *argv[])
+{
+    flux_t *h;
+
+    if (argc < 3)
+        usage ();
+    if (!(h = flux_open (NULL, 0)))
+        log_err_exit ("flux_open");
+    if (!strcmp (argv[1], "store"))
+        store (h, argc - 2, argv + 2);
+    else if (!strcmp (argv[1], "load"))
+        load (h, argc - 2, argv + 2);
+    else
+        usage ();
+    flux_close (h);
+    return 0;
+}
+
+/*
+ * vi:tabstop=4 shiftwidth=4 expandtab
+ */
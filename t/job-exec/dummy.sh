@@ -12,8 +12,8 @@
 #  FLUX_KVS_NAMESPACE   Guest KVS namespace for this job
 #  NAMESPACE       Guest KVS directory for this job
 #  BROKER_RANK     Flux broker rank on which shell is executing
-#  JOBSPEC         Jobspec for this job
-#  R               Resource set for this job
+#  JOBSPEC         Jobspec for this job (from FLUX_JOB_JOBSPEC if set)
+#  R               Resource set for this job (from FLUX_JOB_R if set)
 #  NNODES          Total number of broker ranks (nodes) in this job
 #  DURATION        Duration in seconds from jobspec or 0.01s by default
 #  RANKLIST        Indexed array of broker ranks assigned this job
@@ -46,8 +46,8 @@ declare -r JOBID=$1
 #  Fetch read-only job information and verify all values found:
 #
 declare -r BROKER_RANK=$(flux getattr rank)
-declare -r JOBSPEC=$(flux job info $JOBID jobspec)
-declare -r R=$(flux job info $JOBID R)
+declare -r JOBSPEC=${FLUX_JOB_JOBSPEC:-$(flux job info $JOBID jobspec)}
+declare -r R=${FLUX_JOB_R:-$(flux job info $JOBID R)}
 
 for var in FLUX_KVS_NAMESPACE BROKER_RANK JOBSPEC R; do
     [[ -z "${!var}" ]] && die "Unable to determine ${var}!"
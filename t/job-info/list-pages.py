@@ -0,0 +1,37 @@
+###############################################################
+# Copyright 2026 Lawrence Livermore National Security, LLC
+# (c.f. AUTHORS, NOTICE.LLNS, COPYING)
+#
+# This file is part of the Flux resource manager framework.
+# For details, see https://github.com/flux-framework.
+#
+# SPDX-License-Identifier: LGPL-3.0
+###############################################################
+
+# Usage: flux python list-pages.py page_size [userid]
+#
+#  Stream all jobs from job-info.list in pages of at most page_size
+#  jobs and print their ids, exiting with error if a page is too large
+#
+
+import flux
+from flux import job
+import sys
+
+page_size = int(sys.argv[1])
+if len(sys.argv) > 2:
+    userid = int(sys.argv[2])
+else:
+    userid = flux.constants.FLUX_USERID_UNKNOWN
+
+h = flux.Flux()
+rpc = job.job_list_pages(h, max_entries=0, userid=userid, page_size=page_size)
+for page in rpc.pages():
+    if len(page) > page_size:
+        print(f"page of {len(page)} jobs exceeds {page_size}", file=sys.stderr)
+        sys.exit(1)
+    for j in page:
+        print(j["id"])
+
+
+# vim: tabstop=4 shiftwidth=4 expandtab
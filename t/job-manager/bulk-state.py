@@ -8,16 +8,24 @@
 # SPDX-License-Identifier: LGPL-3.0
 ###############################################################
 
-# Usage: flux python bulk-state.py njobs
+# Usage: flux python bulk-state.py [--events|--resume] njobs
 #
-# Submit njobs jobs while watching job state notification events.
-# Ensure that each job progresses through an expected set of states,
-# in order.
+# Submit njobs jobs while watching job state notifications from the
+# job-manager journal.  Ensure that each job progresses through an
+# expected set of states, in order.
+#
+# With --events, watch job-state events instead (job-manager must be
+# loaded with the publish-events option).
+#
+# With --resume, disconnect from the journal before submitting jobs,
+# wait for them to complete, then resume the journal where it left off.
 #
 
 import flux
 from flux import job
+from flux import constants
 from flux.job import JobspecV1
+import argparse
 import sys
 
 expected_states = ["NEW", "DEPEND", "SCHED", "RUN", "CLEANUP", "INACTIVE"]
@@ -31,44 +39,81 @@ def all_inactive(jobs):
     return True
 
 
-# For each job mentioned in a job-state event message, append a
-# new state to its entry in the jobs dictionary.
+# For each job mentioned in a job-state event message or journal entry,
+# append a new state to its entry in the jobs dictionary.
 # Ignore state notifications for jobs that are not already in the dict
-def parse_notification(jobs, msg):
-    for entry in msg.payload["transitions"]:
+def parse_notification(jobs, payload):
+    for entry in payload.get("transitions", []):
         jobid = entry[0]
         state = entry[1]
         if jobid in jobs:
             jobs[jobid].append(state)
 
 
+class Journal:
+    def __init__(self, h, seq=None):
+        payload = {} if seq is None else {"seq": seq}
+        self.rpc = h.rpc(
+            "job-manager.events", payload, flags=constants.FLUX_RPC_STREAMING
+        )
+        self.seq = self.rpc.get()["seq"]
+        self.rpc.reset()
+
+    def recv(self):
+        entry = self.rpc.get()
+        self.rpc.reset()
+        if entry["seq"] != self.seq + 1:
+            raise ValueError(
+                "expected seq={} got {}".format(self.seq + 1, entry["seq"])
+            )
+        self.seq = entry["seq"]
+        return entry
+
+
 # cmp() not defined in Python 3
 def cmp(a, b):
     return (a > b) - (a < b)
 
 
-if len(sys.argv) != 2:
-    njobs = 10
-else:
-    njobs = int(sys.argv[1])
+parser = argparse.ArgumentParser()
+group = parser.add_mutually_exclusive_group()
+group.add_argument("--events", action="store_true")
+group.add_argument("--resume", action="store_true")
+parser.add_argument("njobs", type=int, nargs="?", default=10)
+args = parser.parse_args()
 
-# Open connection to broker and subscribe to state notifications
+# Open connection to broker and start receiving state notifications
 h = flux.Flux()
-h.event_subscribe("job-state")
+if args.events:
+    h.event_subscribe("job-state")
+else:
+    journal = Journal(h)
 
 # Submit several test jobs, building dictionary by jobid,
 # where each entry contains a list of job states
 # N.B. no notification is provided for the NEW state
 jobspec = JobspecV1.from_command(["hostname"])
 jobs = {}
-for i in range(njobs):
-    jobid = job.submit(h, jobspec)
-    jobs[jobid] = ["NEW"]
+if args.resume:
+    seq = journal.seq
+    del journal
+    for i in range(args.njobs):
+        jobid = job.submit(h, jobspec, waitable=True)
+        jobs[jobid] = ["NEW"]
+    for jobid in jobs:
+        job.wait(h, jobid)
+    journal = Journal(h, seq)
+else:
+    for i in range(args.njobs):
+        jobid = job.submit(h, jobspec)
+        jobs[jobid] = ["NEW"]
 
-# Process events until all jobs have reached INACTIVE state.
+# Process notifications until all jobs have reached INACTIVE state.
 while not all_inactive(jobs):
-    event = h.event_recv()
-    parse_notification(jobs, event)
+    if args.events:
+        parse_notification(jobs, h.event_recv().payload)
+    else:
+        parse_notification(jobs, journal.recv())
 
 # Verify that each job advanced through the expected set of states, in order
 for jobid in jobs:
@@ -77,6 +122,7 @@ for jobid in jobs:
         sys.exit(1)
 
 # Unsubscribe to state notifications and close connection to broker.
-h.event_unsubscribe("job-state")
+if args.events:
+    h.event_unsubscribe("job-state")
 
 # vim: tabstop=4 shiftwidth=4 expandtab
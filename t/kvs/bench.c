@@ -0,0 +1,704 @@
+/************************************************************\
+ * Copyright 2026 Lawrence Livermore National Security, LLC
+ * (c.f. AUTHORS, NOTICE.LLNS, COPYING)
+ *
+ * This file is part of the Flux resource manager framework.
+ * For details, see https://github.com/flux-framework.
+ *
+ * SPDX-License-Identifier: LGPL-3.0
+\************************************************************/
+
+/* bench - kvs benchmarks
+ *
+ * Usage: bench [OPTIONS] [WORKLOAD...]
+ *
+ * Run each named workload (default: all) and print one JSON object
+ * to stdout with the throughput and latency distribution of each, e.g.
+ *
+ *   {"rank": 0, "size": 4, "results": [
+ *     {"workload": "commit", "count": 1000, "ops_per_sec": 2100.5,
+ *      "latency_ms": {"min": 0.3, "mean": 0.47, "p50": 0.45,
+ *                     "p99": 0.9, "p999": 1.6, "max": 2.1}}, ...]}
+ *
+ * so that results can be compared across releases.  Latency is measured
+ * per operation, and throughput is operations per second of elapsed
+ * wall-clock time, excluding untimed setup work (e.g. dropping the cache).
+ *
+ * The commit, wide, large, fence and append workloads keep --window=N
+ * operations outstanding (default 1), so throughput under concurrent
+ * load, e.g. with commits being merged, can be measured.  The other
+ * workloads always run one operation at a time.
+ */
+
+#if HAVE_CONFIG_H
+#include "config.h"
+#endif
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <inttypes.h>
+#include <jansson.h>
+#include <flux/core.h>
+#include <flux/optparse.h>
+
+#include "src/common/libutil/log.h"
+#include "src/common/libutil/monotime.h"
+
+static const char *usage_msg = "[OPTIONS] [WORKLOAD...]";
+static struct optparse_option opts[] =  {
+    { .name = "count", .key = 'c', .has_arg = 1, .arginfo = "N",
+      .usage = "Run N operations per workload (default 1000)",
+    },
+    { .name = "size", .key = 's', .has_arg = 1, .arginfo = "BYTES",
+      .usage = "Set value size for the large workload (default 1048576)",
+    },
+    { .name = "nprocs", .key = 'n', .has_arg = 1, .arginfo = "N",
+      .usage = "Set fence participants (default 16)",
+    },
+    { .name = "depth", .key = 'd', .has_arg = 1, .arginfo = "N",
+      .usage = "Set key depth for lookup workloads (default 16)",
+    },
+    { .name = "watchers", .key = 'w', .has_arg = 1, .arginfo = "N",
+      .usage = "Set number of watchers (default 16)",
+    },
+    { .name = "width", .key = 'k', .has_arg = 1, .arginfo = "N",
+      .usage = "Set keys per transaction for the wide workload (default 64)",
+    },
+    { .name = "window", .key = 'W', .has_arg = 1, .arginfo = "N",
+      .usage = "Keep N commits or fences outstanding (default 1)",
+    },
+    { .name = "prefix", .key = 'p', .has_arg = 1, .arginfo = "NAME",
+      .usage = "Use keys under NAME (default kvsbench-RANK)",
+    },
+    { .name = "list", .key = 'l', .has_arg = 0,
+      .usage = "List workloads and exit",
+    },
+    OPTPARSE_TABLE_END
+};
+
+struct bench {
+    flux_t *h;
+    int count;
+    int size;
+    int nprocs;
+    int depth;
+    int watchers;
+    int width;
+    int window;
+    char *prefix;
+};
+
+/* Latencies (in ms) of the operations of one workload, and the elapsed
+ * time (in ms) of its measured sections.
+ */
+struct latency {
+    double *ms;
+    int n;
+    int size;
+    struct timespec t0;
+    double elapsed;
+    struct timespec elapsed_t0;
+};
+
+static void latency_init (struct latency *l, int size)
+{
+    if (!(l->ms = calloc (size, sizeof (l->ms[0]))))
+        log_msg_exit ("out of memory");
+    l->n = 0;
+    l->size = size;
+    l->elapsed = 0.;
+}
+
+static void latency_start (struct latency *l)
+{
+    monotime (&l->t0);
+}
+
+static void latency_record (struct latency *l, struct timespec t0)
+{
+    if (l->n < l->size)
+        l->ms[l->n++] = monotime_since (t0);
+}
+
+static void latency_stop (struct latency *l)
+{
+    latency_record (l, l->t0);
+}
+
+/* Bracket a measured section of a workload.  Sections accumulate.
+ */
+static void elapsed_start (struct latency *l)
+{
+    monotime (&l->elapsed_t0);
+}
+
+static void elapsed_stop (struct latency *l)
+{
+    l->elapsed += monotime_since (l->elapsed_t0);
+}
+
+static int double_cmp (const void *a, const void *b)
+{
+    double x = *(const double *)a;
+    double y = *(const double *)b;
+
+    return x < y ? -1 : x > y ? 1 : 0;
+}
+
+/* Nearest rank percentile of sorted latencies.
+ */
+static double percentile (struct latency *l, double p)
+{
+    double r = p / 100. * l->n;
+    int i = (int)r;
+
+    if (i < r)
+        i++;
+    i--;
+    if (i < 0)
+        i = 0;
+    if (i >= l->n)
+        i = l->n - 1;
+    return l->ms[i];
+}
+
+static json_t *latency_summary (const char *name, struct latency *l)
+{
+    double total = 0.;
+    json_t *o;
+    int i;
+
+    if (l->n == 0)
+        log_msg_exit ("%s: no operations were measured", name);
+    qsort (l->ms, l->n, sizeof (l->ms[0]), double_cmp);
+    for (i = 0; i < l->n; i++)
+        total += l->ms[i];
+    if (!(o = json_pack ("{s:s s:i s:f s:{s:f s:f s:f s:f s:f s:f}}",
+                         "workload", name,
+                         "count", l->n,
+                         "ops_per_sec",
+                           l->elapsed > 0. ? l->n / (l->elapsed / 1E3) : 0.,
+                         "latency_ms",
+                           "min", l->ms[0],
+                           "mean", total / l->n,
+                           "p50", percentile (l, 50.),
+                           "p99", percentile (l, 99.),
+                           "p999", percentile (l, 99.9),
+                           "max", l->ms[l->n - 1])))
+        log_msg_exit ("%s: error creating summary", name);
+    return o;
+}
+
+static void commit (flux_t *h, flux_kvs_txn_t *txn)
+{
+    flux_future_t *f;
+
+    if (!(f = flux_kvs_commit (h, NULL, 0, txn))
+        || flux_future_get (f, NULL) < 0)
+        log_err_exit ("flux_kvs_commit");
+    flux_future_destroy (f);
+}
+
+static void put_int (flux_t *h, const char *key, int i)
+{
+    flux_kvs_txn_t *txn;
+
+    if (!(txn = flux_kvs_txn_create ())
+        || flux_kvs_txn_pack (txn, 0, key, "i", i) < 0)
+        log_err_exit ("error preparing %s", key);
+    commit (h, txn);
+    flux_kvs_txn_destroy (txn);
+}
+
+static void unlink_prefix (struct bench *b)
+{
+    flux_kvs_txn_t *txn;
+
+    if (!(txn = flux_kvs_txn_create ())
+        || flux_kvs_txn_unlink (txn, 0, b->prefix) < 0)
+        log_err_exit ("error preparing unlink of %s", b->prefix);
+    commit (b->h, txn);
+    flux_kvs_txn_destroy (txn);
+}
+
+/* Start operation i of a workload, returning a future that is
+ * fulfilled when it completes.
+ */
+typedef flux_future_t *(*op_start_f)(struct bench *b, int i, void *arg);
+
+struct window {
+    struct bench *b;
+    struct latency *l;
+    op_start_f start;
+    void *arg;
+    int next;           /* index of the next operation to start */
+    int done;           /* number of completed operations */
+};
+
+static void window_continuation (flux_future_t *f, void *arg);
+
+/* Start operations until 'window' are outstanding.
+ */
+static void window_fill (struct window *w)
+{
+    while (w->next < w->b->count
+           && w->next - w->done < w->b->window) {
+        struct timespec *t0;
+        flux_future_t *f;
+
+        if (!(t0 = malloc (sizeof (*t0))))
+            log_msg_exit ("out of memory");
+        monotime (t0);
+        if (!(f = w->start (w->b, w->next, w->arg))
+            || flux_future_aux_set (f, "bench::t0", t0, free) < 0
+            || flux_future_then (f, -1., window_continuation, w) < 0)
+            log_err_exit ("error starting operation %d", w->next);
+        w->next++;
+    }
+}
+
+static void window_continuation (flux_future_t *f, void *arg)
+{
+    struct window *w = arg;
+    struct timespec *t0 = flux_future_aux_get (f, "bench::t0");
+    const char *child;
+
+    /* A fence operation is a composite of one future per participant.
+     */
+    if ((child = flux_future_first_child (f))) {
+        do {
+            if (flux_future_get (flux_future_get_child (f, child), NULL) < 0)
+                log_err_exit ("operation %d failed", w->done);
+        } while ((child = flux_future_next_child (f)));
+    }
+    else if (flux_future_get (f, NULL) < 0)
+        log_err_exit ("operation %d failed", w->done);
+    latency_record (w->l, *t0);
+    flux_future_destroy (f);
+    w->done++;
+    window_fill (w);
+    if (w->done == w->b->count)
+        flux_reactor_stop (flux_get_reactor (w->b->h));
+}
+
+/* Run the workload's operations, keeping up to 'window' outstanding.
+ */
+static void window_run (struct bench *b,
+                        struct latency *l,
+                        op_start_f start,
+                        void *arg)
+{
+    struct window w = {
+        .b = b,
+        .l = l,
+        .start = start,
+        .arg = arg,
+    };
+
+    elapsed_start (l);
+    window_fill (&w);
+    if (flux_reactor_run (flux_get_reactor (b->h), 0) < 0)
+        log_err_exit ("flux_reactor_run");
+    elapsed_stop (l);
+    if (w.done < b->count)
+        log_msg_exit ("only %d of %d operations completed", w.done, b->count);
+}
+
+static flux_future_t *commit_start (struct bench *b, int i, void *arg)
+{
+    char key[256];
+    flux_kvs_txn_t *txn;
+    flux_future_t *f;
+
+    snprintf (key, sizeof (key), "%s.commit.key%d", b->prefix, i);
+    if (!(txn = flux_kvs_txn_create ())
+        || flux_kvs_txn_pack (txn, 0, key, "i", i) < 0)
+        log_err_exit ("error preparing %s", key);
+    f = flux_kvs_commit (b->h, NULL, 0, txn);
+    flux_kvs_txn_destroy (txn);
+    return f;
+}
+
+/* Commit one small key per transaction.
+ */
+static void bench_commit (struct bench *b, struct latency *l)
+{
+    window_run (b, l, commit_start, NULL);
+}
+
+static flux_future_t *wide_start (struct bench *b, int i, void *arg)
+{
+    char key[256];
+    flux_kvs_txn_t *txn;
+    flux_future_t *f;
+    int j;
+
+    if (!(txn = flux_kvs_txn_create ()))
+        log_err_exit ("flux_kvs_txn_create");
+    for (j = 0; j < b->width; j++) {
+        snprintf (key, sizeof (key), "%s.wide.op%d.dir%d.key",
+                  b->prefix, i, j);
+        if (flux_kvs_txn_pack (txn, 0, key, "i", j) < 0)
+            log_err_exit ("error preparing %s", key);
+    }
+    f = flux_kvs_commit (b->h, NULL, 0, txn);
+    flux_kvs_txn_destroy (txn);
+    return f;
+}
+
+/* Commit 'width' keys per transaction, each in a new directory, so that
+ * every commit stores many new directory objects.
+ */
+static void bench_wide (struct bench *b, struct latency *l)
+{
+    window_run (b, l, wide_start, NULL);
+}
+
+static flux_future_t *large_start (struct bench *b, int i, void *arg)
+{
+    char *val = arg;
+    char key[256];
+    flux_kvs_txn_t *txn;
+    flux_future_t *f;
+
+    snprintf (key, sizeof (key), "%s.large.key%d", b->prefix, i);
+    memcpy (val, &i, b->size < sizeof (i) ? b->size : sizeof (i));
+    if (!(txn = flux_kvs_txn_create ())
+        || flux_kvs_txn_put_raw (txn, 0, key, val, b->size) < 0)
+        log_err_exit ("error preparing %s", key);
+    f = flux_kvs_commit (b->h, NULL, 0, txn);
+    flux_kvs_txn_destroy (txn);
+    return f;
+}
+
+/* Commit one large raw value per transaction.  Each value differs so
+ * that every commit stores a new object.
+ */
+static void bench_large (struct bench *b, struct latency *l)
+{
+    char *val;
+
+    if (!(val = malloc (b->size)))
+        log_msg_exit ("out of memory");
+    memset (val, 'x', b->size);
+    window_run (b, l, large_start, val);
+    free (val);
+}
+
+static flux_future_t *fence_start (struct bench *b, int i, void *arg)
+{
+    flux_future_t *f;
+    char name[256];
+    char key[256];
+    int j;
+
+    if (!(f = flux_future_wait_all_create ()))
+        log_err_exit ("flux_future_wait_all_create");
+    flux_future_set_flux (f, b->h);
+    snprintf (name, sizeof (name), "%s-fence-%d", b->prefix, i);
+    for (j = 0; j < b->nprocs; j++) {
+        flux_kvs_txn_t *txn;
+        flux_future_t *fj;
+
+        snprintf (key, sizeof (key), "%s.fence.key%d.%d", b->prefix, i, j);
+        if (!(txn = flux_kvs_txn_create ())
+            || flux_kvs_txn_pack (txn, 0, key, "i", j) < 0)
+            log_err_exit ("error preparing %s", key);
+        if (!(fj = flux_kvs_fence (b->h, NULL, 0, name, b->nprocs, txn))
+            || flux_future_push (f, key, fj) < 0)
+            log_err_exit ("flux_kvs_fence");
+        flux_kvs_txn_destroy (txn);
+    }
+    return f;
+}
+
+/* Each operation is a fence with nprocs participants, each putting
+ * one key.  Latency is measured until all participants complete.
+ */
+static void bench_fence (struct bench *b, struct latency *l)
+{
+    window_run (b, l, fence_start, NULL);
+}
+
+/* Create the key used by the lookup workloads, 'depth' directories down.
+ */
+static char *create_deep_key (struct bench *b)
+{
+    char *key;
+    int len = strlen (b->prefix) + 16 + b->depth * 8;
+    int n, i;
+
+    if (!(key = malloc (len)))
+        log_msg_exit ("out of memory");
+    n = snprintf (key, len, "%s.lookup", b->prefix);
+    for (i = 0; i < b->depth; i++)
+        n += snprintf (key + n, len - n, ".d%d", i);
+    snprintf (key + n, len - n, ".key");
+    put_int (b->h, key, 42);
+    return key;
+}
+
+static void lookup (flux_t *h, const char *key)
+{
+    flux_future_t *f;
+    int i;
+
+    if (!(f = flux_kvs_lookup (h, NULL, 0, key))
+        || flux_kvs_lookup_get_unpack (f, "i", &i) < 0)
+        log_err_exit ("flux_kvs_lookup %s", key);
+    if (i != 42)
+        log_msg_exit ("%s has unexpected value %d", key, i);
+    flux_future_destroy (f);
+}
+
+/* Look up a deep key, with all its directories in the local kvs cache.
+ */
+static void bench_lookup (struct bench *b, struct latency *l)
+{
+    char *key = create_deep_key (b);
+    int i;
+
+    lookup (b->h, key);
+    elapsed_start (l);
+    for (i = 0; i < b->count; i++) {
+        latency_start (l);
+        lookup (b->h, key);
+        latency_stop (l);
+    }
+    elapsed_stop (l);
+    free (key);
+}
+
+/* Look up a deep key after dropping the local kvs cache, so that every
+ * directory on the path is faulted in from the content store.
+ */
+static void bench_cold_lookup (struct bench *b, struct latency *l)
+{
+    char *key = create_deep_key (b);
+    flux_future_t *f;
+    int i;
+
+    for (i = 0; i < b->count; i++) {
+        if (!(f = flux_rpc (b->h, "kvs.dropcache", NULL, FLUX_NODEID_ANY, 0))
+            || flux_future_get (f, NULL) < 0)
+            log_err_exit ("kvs.dropcache");
+        flux_future_destroy (f);
+        elapsed_start (l);
+        latency_start (l);
+        lookup (b->h, key);
+        latency_stop (l);
+        elapsed_stop (l);
+    }
+    free (key);
+}
+
+/* Wait for watcher 'f' to report 'value', skipping older values.
+ */
+static void watch_wait (flux_future_t *f, int value)
+{
+    int i;
+
+    do {
+        if (flux_kvs_lookup_get_unpack (f, "i", &i) < 0)
+            log_err_exit ("flux_kvs_lookup");
+        flux_future_reset (f);
+    } while (i < value);
+}
+
+/* Each operation commits a new value to a key with 'watchers' watchers.
+ * Latency is measured until all watchers have seen the new value.
+ */
+static void bench_watch (struct bench *b, struct latency *l)
+{
+    flux_future_t **f;
+    char key[256];
+    int i, j;
+
+    if (!(f = calloc (b->watchers, sizeof (f[0]))))
+        log_msg_exit ("out of memory");
+    snprintf (key, sizeof (key), "%s.watch.key", b->prefix);
+    put_int (b->h, key, 0);
+    for (j = 0; j < b->watchers; j++) {
+        if (!(f[j] = flux_kvs_lookup (b->h, NULL, FLUX_KVS_WATCH, key)))
+            log_err_exit ("flux_kvs_lookup");
+        watch_wait (f[j], 0);
+    }
+    elapsed_start (l);
+    for (i = 1; i <= b->count; i++) {
+        latency_start (l);
+        put_int (b->h, key, i);
+        for (j = 0; j < b->watchers; j++)
+            watch_wait (f[j], i);
+        latency_stop (l);
+    }
+    elapsed_stop (l);
+    for (j = 0; j < b->watchers; j++) {
+        if (flux_kvs_lookup_cancel (f[j]) < 0)
+            log_err_exit ("flux_kvs_lookup_cancel");
+        while (flux_kvs_lookup_get (f[j], NULL) == 0)
+            flux_future_reset (f[j]);
+        flux_future_destroy (f[j]);
+    }
+    free (f);
+}
+
+static flux_future_t *append_start (struct bench *b, int i, void *arg)
+{
+    char key[256];
+    char event[256];
+    flux_kvs_txn_t *txn;
+    flux_future_t *f;
+
+    snprintf (key, sizeof (key), "%s.append.eventlog", b->prefix);
+    snprintf (event,
+              sizeof (event),
+              "{\"timestamp\":%.6f,\"name\":\"bench\","
+              "\"context\":{\"seq\":%d}}\n",
+              flux_reactor_now (flux_get_reactor (b->h)),
+              i);
+    if (!(txn = flux_kvs_txn_create ())
+        || flux_kvs_txn_put (txn, FLUX_KVS_APPEND, key, event) < 0)
+        log_err_exit ("error preparing %s", key);
+    f = flux_kvs_commit (b->h, NULL, 0, txn);
+    flux_kvs_txn_destroy (txn);
+    return f;
+}
+
+/* Append one event per transaction to a growing eventlog.
+ */
+static void bench_append (struct bench *b, struct latency *l)
+{
+    window_run (b, l, append_start, NULL);
+}
+
+struct workload {
+    const char *name;
+    const char *desc;
+    void (*fn)(struct bench *b, struct latency *l);
+};
+
+static struct workload workloads[] = {
+    { "commit", "commit one small key per transaction", bench_commit },
+    { "wide", "commit N keys in new directories per transaction",
+      bench_wide },
+    { "large", "commit one large value per transaction", bench_large },
+    { "fence", "fence with N participants", bench_fence },
+    { "lookup", "look up a deep key", bench_lookup },
+    { "cold-lookup", "look up a deep key after kvs.dropcache",
+      bench_cold_lookup },
+    { "watch", "update a key watched by N watchers", bench_watch },
+    { "append", "append to an eventlog", bench_append },
+    { NULL, NULL, NULL },
+};
+
+static struct workload *workload_lookup (const char *name)
+{
+    struct workload *w;
+
+    for (w = &workloads[0]; w->name != NULL; w++)
+        if (!strcmp (w->name, name))
+            return w;
+    return NULL;
+}
+
+static json_t *run (struct bench *b, struct workload *w)
+{
+    struct latency l;
+    json_t *o;
+
+    latency_init (&l, b->count);
+    unlink_prefix (b);
+    w->fn (b, &l);
+    o = latency_summary (w->name, &l);
+    free (l.ms);
+    return o;
+}
+
+int main (int argc, char *argv[])
+{
+    optparse_t *p;
+    struct bench b;
+    uint32_t rank, size;
+    json_t *results;
+    json_t *o;
+    int optindex;
+    int i;
+
+    log_init ("bench");
+
+    if (!(p = optparse_create ("bench"))
+        || optparse_add_option_table (p, opts) != OPTPARSE_SUCCESS
+        || optparse_set (p, OPTPARSE_USAGE, usage_msg) != OPTPARSE_SUCCESS)
+        log_msg_exit ("error setting up option parsing");
+    if ((optindex = optparse_parse_args (p, argc, argv)) < 0)
+        exit (1);
+
+    if (optparse_hasopt (p, "list")) {
+        struct workload *w;
+        for (w = &workloads[0]; w->name != NULL; w++)
+            printf ("%-12s %s\n", w->name, w->desc);
+        exit (0);
+    }
+    for (i = optindex; i < argc; i++) {
+        if (!workload_lookup (argv[i]))
+            log_msg_exit ("unknown workload: %s", argv[i]);
+    }
+
+    memset (&b, 0, sizeof (b));
+    b.count = optparse_get_int (p, "count", 1000);
+    b.size = optparse_get_int (p, "size", 1048576);
+    b.nprocs = optparse_get_int (p, "nprocs", 16);
+    b.depth = optparse_get_int (p, "depth", 16);
+    b.watchers = optparse_get_int (p, "watchers", 16);
+    b.width = optparse_get_int (p, "width", 64);
+    b.window = optparse_get_int (p, "window", 1);
+    if (b.count < 1 || b.size < 1 || b.nprocs < 1 || b.depth < 0
+        || b.watchers < 1 || b.width < 1 || b.window < 1)
+        log_msg_exit ("invalid option value");
+
+    if (!(b.h = flux_open (NULL, 0)))
+        log_err_exit ("flux_open");
+    if (flux_get_rank (b.h, &rank) < 0 || flux_get_size (b.h, &size) < 0)
+        log_err_exit ("error getting rank and size");
+    if (optparse_hasopt (p, "prefix")) {
+        if (!(b.prefix = strdup (optparse_get_str (p, "prefix", NULL))))
+            log_msg_exit ("out of memory");
+    }
+    else if (asprintf (&b.prefix, "kvsbench-%"PRIu32, rank) < 0)
+        log_msg_exit ("out of memory");
+
+    if (!(results = json_array ()))
+        log_msg_exit ("out of memory");
+    if (optindex == argc) {
+        struct workload *w;
+        for (w = &workloads[0]; w->name != NULL; w++)
+            json_array_append_new (results, run (&b, w));
+    }
+    else {
+        for (i = optindex; i < argc; i++)
+            json_array_append_new (results, run (&b, workload_lookup (argv[i])));
+    }
+    unlink_prefix (&b);
+
+    if (!(o = json_pack ("{s:i s:i s:i s:O}",
+                         "rank", rank,
+                         "size", size,
+                         "window", b.window,
+                         "results", results)))
+        log_msg_exit ("error creating output");
+    if (json_dumpf (o, stdout, JSON_COMPACT) < 0)
+        log_msg_exit ("error writing output");
+    printf ("\n");
+
+    json_decref (o);
+    json_decref (results);
+    free (b.prefix);
+    flux_close (b.h);
+    optparse_destroy (p);
+    log_fini ();
+    return 0;
+}
+
+/*
+ * vi:tabstop=4 shiftwidth=4 expandtab
+ */
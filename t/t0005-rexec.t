@@ -115,6 +115,14 @@ test_expect_success 'basic rexec stdin / stdout long lines' '
         test_cmp expected output
 '
 
+# output exceeds the default 4M channel buffer, so the server must
+# wait for the client to return output credit
+test_expect_success 'rexec output larger than channel buffer' '
+        dd if=/dev/urandom bs=1M count=12 | base64 >large.expected &&
+        ${FLUX_BUILD_DIR}/t/rexec/rexec -r 1 cat large.expected >large.out &&
+        test_cmp large.expected large.out
+'
+
 # pipe in /dev/null, we don't care about stdin for this test
 test_expect_success 'rexec check channel FD created' '
 	${FLUX_BUILD_DIR}/t/rexec/rexec -i TEST_CHANNEL /usr/bin/env < /dev/null > output 2>&1 &&
@@ -10,6 +10,7 @@ test_under_flux ${SIZE} minimal
 echo "# $0: flux session size will be ${SIZE}"
 
 BLOBREF=${FLUX_BUILD_DIR}/t/kvs/blobref
+BATCH=${FLUX_BUILD_DIR}/t/content/batch
 RPC=${FLUX_BUILD_DIR}/t/request/rpc
 
 MAXBLOB=`flux getattr content.blob-size-limit`
@@ -181,6 +182,48 @@ test_expect_success 'store 1K blobs from all ranks using async RPC' '
 	flux exec -n flux content spam 1024 256 >/dev/null
 '
 
+# Batched store and load, on rank 0 and through the TBON from rank 3
+
+test_expect_success 'store-batch of several blobs works on rank 3' '
+	for i in 1 2 3 4 5; do
+		dd if=/dev/urandom count=$i bs=1024 >batch.$i.store 2>/dev/null
+	done &&
+	: >batch.empty.store &&
+	flux exec -n --rank 3 $BATCH store \
+		batch.1.store batch.2.store batch.3.store batch.4.store \
+		batch.5.store batch.empty.store batch.1.store >batch.3.hash &&
+	for f in batch.1 batch.2 batch.3 batch.4 batch.5 batch.empty batch.1; do
+		$BLOBREF $HASHFUN <$f.store
+	done >batch.3.expect &&
+	test_cmp batch.3.expect batch.3.hash
+'
+
+test_expect_success 'load-batch of those blobs works on all ranks' '
+	flux exec -n sh -c "$BATCH load $(cat batch.3.hash | tr "\n" " ")" \
+		| sort >batch.all.output &&
+	for i in `seq 1 ${SIZE}`; do cat batch.3.expect; done \
+		| sort >batch.all.expect &&
+	test_cmp batch.all.expect batch.all.output
+'
+
+test_expect_success 'load-batch reports per-item errors' '
+	MISSING=`echo batchmissing | $BLOBREF $HASHFUN` &&
+	GOOD=`head -1 batch.3.hash` &&
+	flux exec -n --rank 3 $BATCH load $GOOD $MISSING >batch.err.output &&
+	cat >batch.err.expect <<-EOF &&
+	$GOOD
+	$MISSING: No such file or directory
+	EOF
+	test_cmp batch.err.expect batch.err.output
+'
+
+test_expect_success 'load-batch request with short payload fails with EPROTO(71)' '
+	printf "x" | ${RPC} -r content.load-batch 71
+'
+test_expect_success 'store-batch request with short payload fails with EPROTO(71)' '
+	printf "x" | ${RPC} -r content.store-batch 71
+'
+
 test_expect_success 'load request with empty payload fails with EPROTO(71)' '
 	${RPC} content.load 71 </dev/null
 '
@@ -157,6 +157,71 @@ test_expect_success 'content-backing.load invalid blobref fails' '
         $RPC content-backing.load 2 <bad.blobref 2>load.err
 '
 
+test_expect_success 'content-sqlite stats report lz4 compression' '
+	test "$(flux module stats --parse compression content-sqlite)" = "\"lz4\"" &&
+	test $(flux module stats --parse "#lz4 stores" content-sqlite) -ge 0
+'
+
+test_expect_success 'reload content-sqlite with bad compression fails' '
+	test_must_fail flux module reload content-sqlite compression=foo &&
+	flux module load content-sqlite
+'
+
+# zstd support is optional (configure --with-zstd)
+if flux module reload content-sqlite compression=zstd 2>/dev/null; then
+	test_set_prereq ZSTD
+else
+	flux module load content-sqlite
+fi
+
+store_similar() {
+	local n=$1
+	for i in `seq 1 $n`; do \
+		for j in `seq 1 60`; do \
+			echo "{\"id\":$i,\"seq\":$j,\"name\":\"submit\",\"context\":{}}"; \
+		done | flux content store >/dev/null || return 1
+	done
+}
+
+test_expect_success ZSTD 'store similar blobs with zstd compression' '
+	store_similar 400 &&
+	flux content flush &&
+	test $(flux module stats --parse "#zstd stores" content-sqlite) -gt 0
+'
+
+test_expect_success ZSTD 'a zstd dictionary was trained' '
+	test $(flux module stats --parse "zstd dict" content-sqlite) -ne 0
+'
+
+test_expect_success ZSTD 'store and load blob with zstd dictionary' '
+	for j in `seq 1 60`; do \
+		echo "{\"id\":9999,\"seq\":$j,\"name\":\"finish\",\"context\":{}}"; \
+	done >zstd.store &&
+	flux content store --bypass-cache <zstd.store >zstd.hash &&
+	flux content load --bypass-cache $(cat zstd.hash) >zstd.load &&
+	test_cmp zstd.store zstd.load
+'
+
+test_expect_success ZSTD 'reload content-sqlite with lz4 compression' '
+	flux module reload content-sqlite compression=lz4 &&
+	test $(flux module stats --parse "#zstd dicts" content-sqlite) -ge 1
+'
+
+test_expect_success ZSTD 'zstd blob still loads with lz4 compression' '
+	flux content load --bypass-cache $(cat zstd.hash) >zstd.load2 &&
+	test_cmp zstd.store zstd.load2
+'
+
+test_expect_success 'lz4 blob still loads' '
+	HASHSTR=`cat 4k.0.hash` &&
+	flux content load --bypass-cache ${HASHSTR} >4k.0.load2 &&
+	test_cmp 4k.0.store 4k.0.load2
+'
+
+test_expect_success 'content-sqlite stats report a compression ratio' '
+	flux module stats --parse "compression ratio" content-sqlite
+'
+
 test_expect_success 'remove content-sqlite module on rank 0' '
 	flux module remove content-sqlite
 '
@@ -486,6 +486,18 @@ test_expect_success 'kvs: clear stats globally' '
         flux exec -n sh -c "flux module stats --parse \"namespace.primary.#no-op stores\" kvs | grep -q 0"
 '
 
+test_expect_success 'kvs: repeated lookup of a deep key hits the path memo' '
+        flux kvs unlink -Rf $DIR &&
+        flux kvs put $DIR.a.b.c.d=1 &&
+        flux module stats -c kvs &&
+        flux kvs get $DIR.a.b.c.d &&
+        flux kvs get $DIR.a.b.c.d &&
+        test $(flux module stats --parse "cache.#memo hits" kvs) -ge 1 &&
+        test $(flux module stats --parse "cache.#memo entries" kvs) -ge 1 &&
+        flux module stats -c kvs &&
+        test $(flux module stats --parse "cache.#memo hits" kvs) -eq 0
+'
+
 #
 # test fence api
 #
@@ -517,4 +529,31 @@ test_expect_success 'kvs: test invalid lookup rpc' '
         grep "flux_future_get: Protocol error" lookup_invalid_output
 '
 
+#
+# cache warming
+#
+
+test_expect_success 'kvs: reload kvs with cache-warm-bytes on rank 0' '
+        flux exec -r all flux module remove kvs-watch &&
+        flux exec -r all -x 0 flux module remove kvs &&
+        flux module reload kvs cache-warm-bytes=65536 &&
+        flux exec -r all -x 0 flux module load kvs &&
+        flux exec -r all flux module load kvs-watch
+'
+
+test_expect_success 'kvs: new objects are pushed to follower caches' '
+        flux kvs put $DIR.warm.a.b=1 &&
+        VERS=$(flux kvs version) &&
+        flux exec -n -r 1 flux kvs wait $VERS &&
+        flux exec -n -r 1 flux module stats -c kvs &&
+        test $(flux exec -n -r 1 \
+                flux module stats --parse "cache.#warm entries" kvs) -ge 1 &&
+        flux exec -n -r 1 flux kvs get $DIR.warm.a.b &&
+        test $(flux exec -n -r 1 \
+                flux module stats --parse "cache.#warm hits" kvs) -ge 1 &&
+        flux exec -n -r 1 flux module stats -c kvs &&
+        test $(flux exec -n -r 1 \
+                flux module stats --parse "cache.#warm hits" kvs) -eq 0
+'
+
 test_done
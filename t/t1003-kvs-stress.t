@@ -121,6 +121,62 @@ test_expect_success 'kvs: test that KVS_NO_MERGE works with kvs_commit()' '
 	test "$OUTPUT" = "${THREADS}"
 '
 
+# benchmark smoke tests, with small counts
+test_expect_success 'kvs: bench --list lists workloads' '
+	${FLUX_BUILD_DIR}/t/kvs/bench --list >bench.list &&
+	test $(wc -l <bench.list) -eq 8
+'
+
+test_expect_success 'kvs: bench fails on unknown workload' '
+	test_must_fail ${FLUX_BUILD_DIR}/t/kvs/bench nosuchworkload
+'
+
+test_expect_success HAVE_JQ 'kvs: bench runs all workloads' '
+	${FLUX_BUILD_DIR}/t/kvs/bench --count=10 --size=65536 \
+		--nprocs=4 --watchers=4 --depth=4 --width=8 >bench.json &&
+	jq -e ".results | length == 8" <bench.json &&
+	jq -e "[.results[] | .count == 10] | all" <bench.json &&
+	jq -e "[.results[].latency_ms | .p50 <= .p99 and .p99 <= .p999] \
+		| all" <bench.json
+'
+
+test_expect_success HAVE_JQ 'kvs: bench keeps a window of operations outstanding' '
+	${FLUX_BUILD_DIR}/t/kvs/bench --count=20 --window=8 --size=4096 \
+		--nprocs=4 commit large fence append >bench-window.json &&
+	jq -e ".window == 8" <bench-window.json &&
+	jq -e "[.results[] | .count == 20 and .ops_per_sec > 0] | all" \
+		<bench-window.json
+'
+
+# Compare wide commit latency with object unrolling done inline on the
+# kvs thread (the default) and on a pool of worker threads.  Results
+# are only reported, since they depend on the host.
+test_expect_success HAVE_JQ 'kvs: bench wide with and without unroll-threads' '
+	flux module reload kvs &&
+	${FLUX_BUILD_DIR}/t/kvs/bench --count=50 --width=256 --window=4 \
+		wide >bench-unroll0.json &&
+	flux module reload kvs unroll-threads=4 &&
+	${FLUX_BUILD_DIR}/t/kvs/bench --count=50 --width=256 --window=4 \
+		wide >bench-unroll.json &&
+	flux module reload kvs &&
+	for f in bench-unroll0.json bench-unroll.json; do
+		jq -r ".results[0].latency_ms | \"$f: p50=\\(.p50) p99=\\(.p99)\"" \
+			<$f || return 1
+	done
+'
+
+test_expect_success 'kvs: bench rejects an invalid window' '
+	test_must_fail ${FLUX_BUILD_DIR}/t/kvs/bench --window=0 commit
+'
+
+test_expect_success HAVE_JQ 'kvs: bench runs a workload on rank 1' '
+	flux exec -n -r 1 ${FLUX_BUILD_DIR}/t/kvs/bench --count=5 \
+		cold-lookup watch >bench1.json &&
+	jq -e ".rank == 1" <bench1.json &&
+	jq -e ".results[0].workload == \"cold-lookup\"" <bench1.json &&
+	jq -e ".results[1].workload == \"watch\"" <bench1.json
+'
+
 # All tests below assume transaction-merge=0
 
 # transaction-merge option test
@@ -279,6 +279,44 @@ test_expect_success 'kvs: namespace can be re-created after remove, recognized o
 	flux kvs namespace remove $NAMESPACETMP-ALL
 '
 
+#
+# Namespace led by a rank other than 0
+#
+
+NAMESPACELEADER=namespaceleader
+
+test_expect_success 'kvs: namespace create --rank fails on invalid rank' '
+	test_must_fail flux kvs namespace create --rank=${SIZE} $NAMESPACELEADER &&
+	test_must_fail flux kvs namespace create --rank=foo $NAMESPACELEADER
+'
+
+test_expect_success 'kvs: namespace create --rank=1 works' '
+	flux kvs namespace create --rank=1 $NAMESPACELEADER &&
+        flux kvs namespace list | grep $NAMESPACELEADER
+'
+
+test_expect_success 'kvs: put/get on rank 0 in namespace led by rank 1 works' '
+        flux kvs put --namespace=$NAMESPACELEADER $DIR.test=1 &&
+        test_kvs_key_namespace $NAMESPACELEADER $DIR.test 1
+'
+
+test_expect_success 'kvs: put on all ranks in namespace led by rank 1 works' '
+        flux exec -n sh -c "flux kvs put --namespace=$NAMESPACELEADER \
+                            $DIR.rank\$(flux getattr rank)=1 && \
+                         flux kvs version --namespace=$NAMESPACELEADER" \
+                         | sort -n | tail -1 > version &&
+        VERS=$(cat version) &&
+        flux exec -n sh -c "flux kvs wait --namespace=$NAMESPACELEADER ${VERS} && \
+                         flux kvs dir --namespace=$NAMESPACELEADER $DIR" \
+                         | grep rank | sort | uniq > output &&
+        test $(wc -l <output) -eq ${SIZE}
+'
+
+test_expect_success 'kvs: namespace led by rank 1 can be removed' '
+	flux kvs namespace remove $NAMESPACELEADER &&
+        get_kvs_namespace_fails_all_ranks_loop $NAMESPACELEADER $DIR.test
+'
+
 #
 # Namespace specification priority
 #
@@ -665,4 +665,69 @@ test_expect_success 'flux kvs get --watch allows owner access to guest ns' '
 test_expect_success 'kvs-watch.lookup request with empty payload fails with EPROTO(71)' '
 	${RPC} kvs-watch.lookup 71 </dev/null
 '
+#
+# values included in setroot events
+#
+
+test_expect_success 'reload kvs with inline-values-bytes on rank 0' '
+	flux exec -r all flux module remove kvs-watch &&
+	flux exec -r all -x 0 flux module remove kvs &&
+	flux module reload kvs inline-values-bytes=4096 &&
+	flux exec -r all -x 0 flux module load kvs &&
+	flux exec -r all flux module load kvs-watch
+'
+
+test_expect_success NO_CHAIN_LINT 'flux kvs get --watch is answered from setroot values' '
+	flux kvs unlink -Rf test &&
+	flux kvs put test.inline=1 &&
+	flux kvs get --watch --count=20 test.inline >inline.out &
+	pid=$! &&
+	$waitfile --count=1 --timeout=10 \
+		  --pattern="[0-9]+" inline.out >/dev/null &&
+	before=$(flux module stats --parse inline-responses kvs-watch) &&
+	for i in $(seq 2 20); \
+	    do flux kvs put --no-merge test.inline=$i; \
+	done &&
+	$waitfile --count=20 --timeout=10 --pattern="[0-9]+" inline.out &&
+	wait $pid &&
+	test_monotonicity <inline.out &&
+	test $(flux module stats --parse inline-responses kvs-watch) -gt $before
+'
+
+test_expect_success NO_CHAIN_LINT 'flux kvs get --watch --append is answered from setroot values' '
+	flux kvs unlink -Rf test &&
+	flux kvs put test.append.inline="abc" &&
+	flux kvs get --watch --append --count=4 \
+		     test.append.inline >inline_append.out 2>&1 &
+	pid=$! &&
+	$waitfile --count=1 --timeout=10 \
+		  --pattern="abc" inline_append.out >/dev/null &&
+	before=$(flux module stats --parse inline-responses kvs-watch) &&
+	flux kvs put --append test.append.inline="d" &&
+	flux kvs put --append test.append.inline="e" &&
+	flux kvs put --append test.append.inline="f" &&
+	wait $pid &&
+	cat >expected <<-EOF &&
+abc
+d
+e
+f
+	EOF
+	test_cmp expected inline_append.out &&
+	test $(flux module stats --parse inline-responses kvs-watch) -gt $before
+'
+
+test_expect_success NO_CHAIN_LINT 'flux kvs get --watch works on key set twice in one commit' '
+	flux kvs unlink -Rf test &&
+	flux kvs put test.twice=1 &&
+	flux kvs get --watch --count=2 test.twice >twice.out &
+	pid=$! &&
+	$waitfile --count=1 --timeout=10 \
+		  --pattern="[0-9]+" twice.out >/dev/null &&
+	flux kvs put test.twice=2 test.twice=3 &&
+	wait $pid &&
+	printf "1\n3\n" >twice.exp &&
+	test_cmp twice.exp twice.out
+'
+
 test_done
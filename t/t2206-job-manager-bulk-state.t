@@ -18,4 +18,53 @@ test_expect_success 'job-manager: all state events received (2 jobs from 4 ranks
 	run_timeout 10 flux exec -r all ${BULK_STATE} 2
 '
 
+test_expect_success 'job-manager: state events resumed from journal (5 jobs)' '
+	run_timeout 10 ${BULK_STATE} --resume 5
+'
+
+test_expect_success 'job-manager: journal request beyond end fails' '
+	cat >journal-seq.py <<-EOT &&
+	import flux, sys
+	from flux import constants
+	rpc = flux.Flux().rpc("job-manager.events", {"seq": int(sys.argv[1])},
+	                      flags=constants.FLUX_RPC_STREAMING)
+	print(rpc.get()["seq"])
+	EOT
+	test_must_fail flux python journal-seq.py 1000000
+'
+
+test_expect_success 'job-manager: reload job-manager with publish-events' '
+	flux module remove sched-simple &&
+	flux module remove job-exec &&
+	flux module reload job-manager publish-events &&
+	flux module load job-exec &&
+	flux module load sched-simple
+'
+
+test_expect_success 'job-manager: all state events received (5 jobs, events)' '
+	run_timeout 10 ${BULK_STATE} --events 5
+'
+
+test_expect_success 'job-manager: journal replays entries after reload (5 jobs)' '
+	run_timeout 10 ${BULK_STATE} --resume 5
+'
+
+test_expect_success 'job-manager: job-info tracks jobs after job-manager reload' '
+	jobid=$(flux job id $(flux mini submit hostname)) &&
+	flux job wait-event $jobid clean &&
+	run_timeout 10 sh -c "while ! flux job list --states=inactive \
+		| grep $jobid >/dev/null; do sleep 0.1; done"
+'
+
+test_expect_success 'job-manager: invalid journal-size is rejected' '
+	flux module remove sched-simple &&
+	flux module remove job-exec &&
+	flux module remove job-manager &&
+	test_must_fail flux module load job-manager journal-size=foo &&
+	test_must_fail flux module load job-manager journal-size=-1 &&
+	flux module load job-manager &&
+	flux module load job-exec &&
+	flux module load sched-simple
+'
+
 test_done
@@ -248,6 +248,51 @@ test_expect_success HAVE_JQ 'flux job list only completed jobs' '
         test_cmp completed.ids list_result_completed.out
 '
 
+test_expect_success HAVE_JQ 'flux job list with cursor returns all jobs in pages' '
+        id=$(id -u) &&
+        cursor=null &&
+        : > list_cursor.out &&
+        while true; do
+            $jq -j -c -n  "{max_entries:3, userid:${id}, states:0, results:0, attrs:[], cursor:${cursor}}" \
+              | $RPC job-info.list > list_cursor_page.out &&
+            test $($jq ".jobs | length" < list_cursor_page.out) -le 3 &&
+            $jq ".jobs[].id" < list_cursor_page.out >> list_cursor.out &&
+            cursor=$($jq -c .cursor < list_cursor_page.out) &&
+            test "$cursor" != "null" || break
+        done &&
+        test_cmp all.ids list_cursor.out
+'
+
+test_expect_success HAVE_JQ 'flux job list with cursor returns null cursor on exact last page' '
+        id=$(id -u) &&
+        n=$(wc -l < all.ids) &&
+        $jq -j -c -n  "{max_entries:${n}, userid:${id}, states:0, results:0, attrs:[], cursor:null}" \
+          | $RPC job-info.list > list_cursor_exact.out &&
+        test $($jq ".jobs | length" < list_cursor_exact.out) -eq ${n} &&
+        test "$($jq -c .cursor < list_cursor_exact.out)" = "null"
+'
+
+test_expect_success HAVE_JQ 'flux job list with invalid cursor fails' '
+        id=$(id -u) &&
+        $jq -j -c -n  "{max_entries:3, userid:${id}, states:0, results:0, attrs:[], cursor:{list:42}}" \
+          | test_must_fail $RPC job-info.list
+'
+
+test_expect_success 'flux job list streaming returns all jobs in pages' '
+        flux python ${SHARNESS_TEST_SRCDIR}/job-info/list-pages.py 4 \
+            > list_pages.out &&
+        test_cmp all.ids list_pages.out &&
+        flux python ${SHARNESS_TEST_SRCDIR}/job-info/list-pages.py 1 $(id -u) \
+            > list_pages_user.out &&
+        test_cmp all.ids list_pages_user.out
+'
+
+test_expect_success 'flux job list streaming for unknown user returns no jobs' '
+        flux python ${SHARNESS_TEST_SRCDIR}/job-info/list-pages.py 4 4242 \
+            > list_pages_nouser.out &&
+        test_must_be_empty list_pages_nouser.out
+'
+
 # Note: "pending" = "depend" & "sched", we also test just "sched"
 # state since we happen to know all these jobs are in the "sched"
 # state given checks above
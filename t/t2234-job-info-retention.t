@@ -0,0 +1,68 @@
+#!/bin/sh
+
+test_description='Test flux job info inactive job retention'
+
+. $(dirname $0)/sharness.sh
+
+test_under_flux 4 job
+
+test_expect_success 'submit jobs that complete' '
+	flux jobspec --format json srun -N1 hostname > hostname.json &&
+	for i in $(seq 1 4); do \
+		flux job submit hostname.json >> ids; \
+		flux job wait-event $(tail -n 1 ids) clean; \
+	done
+'
+test_expect_success 'all inactive jobs are retained by default' '
+	test $(flux job list -s inactive | wc -l) -eq 4 &&
+	test $(flux module stats --parse jobs.inactive_purged job-info) -eq 0
+'
+test_expect_success 'reload job-info with inactive-max-count=2' '
+	flux module reload job-info inactive-max-count=2
+'
+test_expect_success HAVE_JQ 'only the two most recent inactive jobs are retained' '
+	test $(flux job list -s inactive | wc -l) -eq 2 &&
+	tail -n 2 ids | tac | flux job id > retained.exp &&
+	flux job list -s inactive | jq .id > retained.out &&
+	test_cmp retained.exp retained.out &&
+	test $(flux module stats --parse jobs.inactive_purged job-info) -eq 2
+'
+test_expect_success HAVE_JQ 'new inactive jobs purge the oldest retained job' '
+	flux job submit hostname.json >> ids &&
+	flux job wait-event $(tail -n 1 ids) clean &&
+	tail -n 2 ids | tac | flux job id > retained2.exp &&
+	flux job list -s inactive | jq .id > retained2.out &&
+	test_cmp retained2.exp retained2.out
+'
+test_expect_success HAVE_JQ 'purged jobs can still be listed by id' '
+	id=$(head -n 1 ids) &&
+	flux job list-ids $id > purged.out &&
+	test $(jq .id < purged.out) -eq $(flux job id $id) &&
+	test $(jq .state < purged.out) -eq 32 &&
+	test $(jq .result < purged.out) -eq 1 &&
+	test "$(jq -r .name < purged.out)" = "hostname"
+'
+test_expect_success 'invalid inactive-max-count fails to load' '
+	flux module remove job-info &&
+	test_must_fail flux module load job-info inactive-max-count=foo
+'
+test_expect_success 'reload job-info with inactive-age-limit' '
+	flux module load job-info inactive-age-limit=1h &&
+	test $(flux job list -s inactive | wc -l) -eq 5 &&
+	flux module reload job-info inactive-age-limit=0.001s &&
+	test $(flux job list -s inactive | wc -l) -eq 0
+'
+test_expect_success 'inactive-age-limit purges jobs without new activity' '
+	flux job submit hostname.json >> ids &&
+	flux job wait-event $(tail -n 1 ids) clean &&
+	flux module reload job-info inactive-age-limit=5s &&
+	test $(flux job list -s inactive | wc -l) -eq 1 &&
+	count=1 &&
+	for i in $(seq 1 20); do \
+		sleep 0.5; \
+		count=$(flux job list -s inactive | wc -l); \
+		test $count -eq 0 && break; \
+	done &&
+	test $count -eq 0
+'
+test_done
@@ -0,0 +1,89 @@
+#!/bin/sh
+
+test_description='sched-simple backfill tests'
+
+. `dirname $0`/job-manager/sched-helper.sh
+
+# Append --logfile option if FLUX_TESTS_LOGFILE is set in environment:
+test -n "$FLUX_TESTS_LOGFILE" && set -- "$@" --logfile
+. $(dirname $0)/sharness.sh
+
+test_under_flux 1 job
+
+hwloc_by_rank='{"0": {"Core": 4, "cpuset": "0-3", "coreids": "0-3"}}'
+
+test_expect_success 'unload job-exec module to prevent job execution' '
+	flux module remove job-exec
+'
+test_expect_success 'sched-simple: load 4 core by_rank' '
+	flux kvs put resource.hwloc.by_rank="$(echo $hwloc_by_rank)" &&
+	flux module unload sched-simple &&
+	flux module reload resource &&
+	flux module load sched-simple
+'
+test_expect_success 'sched-simple: invalid backfill depth is rejected' '
+	flux module remove sched-simple &&
+	test_must_fail flux module load sched-simple backfill=0 &&
+	test_must_fail flux module load sched-simple backfill=foo &&
+	flux module load sched-simple
+'
+test_expect_success 'sched-simple: submit 2 core job with 10m time limit' '
+	flux mini submit -n2 -t 10m hostname >jobA.id &&
+	flux job wait-event --timeout=5.0 $(cat jobA.id) alloc
+'
+test_expect_success 'sched-simple: submit blocked 4 core job and 1 core job' '
+	flux mini submit -n4 -t 1m hostname >jobB.id &&
+	flux mini submit -n1 -t 1m hostname >jobC.id &&
+	flux job wait-event --timeout=5.0 $(cat jobC.id) submit
+'
+test_expect_success 'sched-simple: 1 core job is not run without backfill' '
+	jmgr_check_state $(cat jobB.id) S &&
+	jmgr_check_state $(cat jobC.id) S
+'
+test_expect_success 'sched-simple: reload sched-simple with backfill=1' '
+	flux module reload sched-simple backfill=1 &&
+	flux dmesg | grep "hello: alloc rank0/core\[0-1\]"
+'
+test_expect_success 'sched-simple: short job is backfilled' '
+	flux job wait-event --timeout=5.0 $(cat jobC.id) alloc &&
+	jmgr_check_state $(cat jobB.id) S
+'
+test_expect_success HAVE_JQ 'sched-simple: blocked job has start time estimate' '
+	jmgr_check_annotation_exists $(cat jobB.id) "sched.t_estimate"
+'
+test_expect_success 'sched-simple: submit 1 core jobs without and with limit' '
+	flux mini submit -n1 hostname >jobD.id &&
+	flux mini submit -n1 -t 1m hostname >jobE.id &&
+	flux job wait-event --timeout=5.0 $(cat jobE.id) submit
+'
+test_expect_success 'sched-simple: job that would delay reservation is not run' '
+	jmgr_check_state $(cat jobD.id) S
+'
+test_expect_success 'sched-simple: job beyond backfill depth is not run' '
+	jmgr_check_state $(cat jobE.id) S
+'
+test_expect_success 'sched-simple: reload sched-simple with backfill=2' '
+	flux module reload sched-simple backfill=2 &&
+	flux job wait-event --timeout=5.0 $(cat jobE.id) alloc &&
+	jmgr_check_state $(cat jobB.id) S &&
+	jmgr_check_state $(cat jobD.id) S
+'
+test_expect_success 'sched-simple: canceling running job allocates head job' '
+	flux job cancel $(cat jobA.id) &&
+	flux job cancel $(cat jobC.id) &&
+	flux job cancel $(cat jobE.id) &&
+	flux job wait-event --timeout=5.0 $(cat jobB.id) alloc &&
+	jmgr_check_state $(cat jobD.id) S
+'
+test_expect_success 'sched-simple: start time estimate cleared on alloc' '
+	flux job eventlog $(cat jobB.id) | grep "\"t_estimate\":null"
+'
+test_expect_success 'sched-simple: remove sched-simple and cancel jobs' '
+	flux module remove sched-simple &&
+	flux job cancelall -f
+'
+test_expect_success 'sched-simple: load sched-simple and wait for queue drain' '
+	flux module load sched-simple &&
+	run_timeout 30 flux queue drain
+'
+test_done
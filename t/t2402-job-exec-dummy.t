@@ -34,6 +34,15 @@ test_expect_success 'job-exec: execute dummy job shell across all ranks' '
 	test $(flux kvs get ${kvsdir}.test1.2) = 2 &&
 	test $(flux kvs get ${kvsdir}.test1.3) = 3
 '
+test_expect_success 'job-exec: job shells are passed jobspec and R' '
+	id=$(flux jobspec srun -N4 \
+	    "flux kvs put test-env.\$BROKER_RANK=\${#FLUX_JOB_R}" \
+	    | flux job submit) &&
+	flux job wait-event $id clean &&
+	kvsdir=$(flux job id --to=kvs $id).guest &&
+	test $(flux kvs get ${kvsdir}.test-env.0) -gt 0 &&
+	test $(flux kvs get ${kvsdir}.test-env.3) -gt 0
+'
 test_expect_success 'job-exec: job shell output sent to flux log' '
 	id=$(flux jobspec srun -n 1 "echo Hello from job \$JOBID" \
 	     | flux job submit) &&
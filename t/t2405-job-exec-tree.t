@@ -0,0 +1,102 @@
+#!/bin/sh
+
+test_description='Test flux job execution service with tree launch'
+
+. $(dirname $0)/sharness.sh
+
+skip_all_unless_have jq
+
+#  Configure dummy job shell and tree launch:
+if ! test -f tree.toml; then
+	cat <<-EOF >tree.toml
+	[exec]
+	job-shell = "$SHARNESS_TEST_SRCDIR/job-exec/dummy.sh"
+	launch = "tree"
+	EOF
+fi
+
+export FLUX_CONF_DIR=$(pwd)
+test_under_flux 4 job
+
+flux setattr log-stderr-level 1
+
+test_expect_success 'flux config get prints the configured launch mode' '
+	test "$(flux config get exec.launch)" = "tree"
+'
+test_expect_success 'flux config get prints default for an unset key' '
+	test "$(flux config get --default=direct exec.nosuchkey)" = "direct" &&
+	test_must_fail flux config get exec.nosuchkey
+'
+test_expect_success 'job-exec: load job-exec-relay on all ranks' '
+	flux exec -r all flux module load job-exec-relay
+'
+test_expect_success 'job-exec: tree launch executes job shell on all ranks' '
+	id=$(flux jobspec srun -N4 \
+	    "flux kvs put test1.\$BROKER_RANK=\$JOB_SHELL_RANK" \
+	    | flux job submit) &&
+	flux job wait-event $id clean &&
+	kvsdir=$(flux job id --to=kvs $id).guest &&
+	test $(flux kvs get ${kvsdir}.test1.0) = 0 &&
+	test $(flux kvs get ${kvsdir}.test1.1) = 1 &&
+	test $(flux kvs get ${kvsdir}.test1.2) = 2 &&
+	test $(flux kvs get ${kvsdir}.test1.3) = 3
+'
+test_expect_success 'job-exec: tree launch works on a subset of ranks' '
+	id=$(flux jobspec srun -N1 "flux kvs put test2=\$BROKER_RANK" \
+	    | flux job submit) &&
+	flux job wait-event $id clean &&
+	kvsdir=$(flux job id --to=kvs $id).guest &&
+	flux kvs get ${kvsdir}.test2
+'
+test_expect_success 'job-exec: tree launch sends job shell output to flux log' '
+	id=$(flux jobspec srun -N4 "echo Hello from \$BROKER_RANK" \
+	     | flux job submit) &&
+	flux job wait-event $id clean &&
+	flux dmesg | grep "$(flux job id $id): 3: stdout: Hello from 3"
+'
+test_expect_success 'job-exec: tree launch status is maximum exit code' '
+	id=$(flux jobspec srun -N4 "exit \$JOB_SHELL_RANK" | flux job submit) &&
+	flux job wait-event -vt 10 $id finish | grep status=768
+'
+test_expect_success 'job-exec: tree launch job exception kills job shells' '
+	id=$(flux jobspec srun -N4 sleep 300 | flux job submit) &&
+	flux job wait-event -vt 5 $id start &&
+	flux job cancel $id &&
+	flux job wait-event -vt 5 $id clean &&
+	flux job eventlog $id | grep status=15
+'
+test_expect_success 'job-exec: tree launch invalid job shell generates exception' '
+	id=$(flux jobspec srun -N4 /bin/true \
+	     | $jq ".attributes.system.exec.job_shell = \"/notthere\"" \
+	     | flux job submit) &&
+	flux job wait-event -vt 5 $id exception &&
+	flux job wait-event -vt 5 $id clean
+'
+test_expect_success 'job-exec: launch mode can be overridden in jobspec' '
+	flux dmesg -C &&
+	id=$(flux jobspec srun -N4 /bin/true \
+	     | $jq ".attributes.system.exec.bulkexec.launch = \"direct\"" \
+	     | flux job submit) &&
+	flux job wait-event -vt 10 $id finish | grep status=0
+'
+test_expect_success 'job-exec: tree launch fails ranks with no relay' '
+	flux exec -r 3 flux module remove job-exec-relay &&
+	id=$(flux jobspec srun -N4 /bin/true | flux job submit) &&
+	flux job wait-event -vt 10 $id exception &&
+	flux job wait-event -vt 10 $id clean &&
+	flux job eventlog $id | grep "rank=3 failed" &&
+	flux exec -r 3 flux module load job-exec-relay
+'
+test_expect_success 'job-exec: invalid launch mode causes module failure' '
+	test_expect_code 1 flux module reload job-exec launch=foo &&
+	flux module load job-exec
+'
+test_expect_success 'job-exec: job-exec is not loaded on rank 1' '
+	flux exec -r 1 flux module list >modlist.1 &&
+	grep "^job-exec-relay " modlist.1 &&
+	test_must_fail grep "^job-exec " modlist.1
+'
+test_expect_success 'job-exec: remove job-exec-relay' '
+	flux exec -r all flux module remove job-exec-relay
+'
+test_done
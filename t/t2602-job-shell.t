@@ -46,6 +46,13 @@ test_expect_success 'job-shell: execute 2 tasks per rank' '
 	flux kvs dir ${kvsdir}.guest.test2 | sort >test2.out &&
 	test_cmp test2.exp test2.out
 '
+test_expect_success 'job-shell: jobspec and R not passed to tasks' '
+        id=$(flux jobspec srun -N4 bash -c \
+            "test -z \"\$FLUX_JOB_JOBSPEC\$FLUX_JOB_R\"" \
+            | flux job submit) &&
+	flux job wait-event $id finish >noenv.finish.out &&
+	grep status=0 noenv.finish.out
+'
 test_expect_success 'job-shell: /bin/true exit code propagated' '
         id=$(flux jobspec srun -n1 /bin/true | flux job submit) &&
 	flux job wait-event $id finish >true.finish.out &&
@@ -103,6 +110,30 @@ test_expect_success 'job-shell: PMI KVS works' '
 	flux job attach $id >kvstest.out &&
 	grep "t phase" kvstest.out
 '
+test_expect_success 'job-shell: PMI KVS works with pmi.kvs=native' '
+	flux mini run -N4 -o pmi.kvs=native ${KVSTEST} >kvstest-native.out &&
+	grep "t phase" kvstest-native.out
+'
+test_expect_success 'job-shell: PMI KVS works with pmi.exchange.k=1' '
+	flux mini run -N4 -o pmi.exchange.k=1 ${KVSTEST} >kvstest-k1.out &&
+	grep "t phase" kvstest-k1.out
+'
+test_expect_success 'job-shell: PMI KVS works with pmi.exchange.k=3, 2 ppn' '
+	flux mini run -N4 -n8 -o pmi.exchange.k=3 ${KVSTEST} >kvstest-k3.out &&
+	grep "t phase" kvstest-k3.out
+'
+test_expect_success 'job-shell: PMI cliques are correct with pmi.kvs=native' '
+	flux mini run -N4 -n5 -o pmi.kvs=native ${PMI_INFO} -c \
+		>pmi_cliquen.raw &&
+	sort -snk1 <pmi_cliquen.raw >pmi_cliquen.out &&
+	test_cmp pmi_cliquex.exp pmi_cliquen.out
+'
+test_expect_success 'job-shell: invalid pmi.kvs type fails' '
+	test_must_fail flux mini run -N4 -o pmi.kvs=foo ${PMI_INFO}
+'
+test_expect_success 'job-shell: invalid pmi.exchange.k fails' '
+	test_must_fail flux mini run -N4 -o pmi.exchange.k=0 ${PMI_INFO}
+'
 test_expect_success 'job-exec: decrease kill timeout for tests' '
 	flux module reload job-exec kill-timeout=0.1
 '
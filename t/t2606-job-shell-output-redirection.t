@@ -318,4 +318,41 @@ test_expect_success NO_CHAIN_LINT 'job-shell: job attach waits if no kvs output
         flux job cancel $id &&
         ! wait $pid
 '
+
+test_expect_success 'job-shell: output is batched when send-size is large (file)' '
+        flux mini run -n4 \
+             --output=out29 --label-io \
+             --setopt "output.send-size=1048576" \
+             --setopt "output.send-timeout=2" \
+             seq 1 1000 &&
+        for i in 0 1 2 3; do
+            test $(grep -c "^$i: " out29) -eq 1000 || return 1
+        done &&
+        grep "^2: 1000\$" out29
+'
+
+test_expect_success 'job-shell: output batches preserve order (kvs)' '
+        id=$(flux mini submit -n4 \
+             --setopt "output.send-size=100" \
+             seq 1 1000) &&
+        flux job attach --label-io $id > out30 &&
+        for i in 0 1 2 3; do
+            grep "^$i: " out30 | sed "s/^$i: //" > out30.$i &&
+            seq 1 1000 | test_cmp - out30.$i || return 1
+        done
+'
+
+test_expect_success 'job-shell: output is not batched with send-timeout=0' '
+        flux mini run -n2 \
+             --output=out31 --label-io \
+             --setopt "output.send-timeout=0" \
+             seq 1 100 &&
+        test $(grep -c "^1: " out31) -eq 100
+'
+
+test_expect_success 'job-shell: invalid output.send-size is rejected' '
+        test_must_fail flux mini run -n1 \
+             --setopt "output.send-size=-1" \
+             true
+'
 test_done